@@ -74,6 +74,34 @@ COMBINE_SIGN_JSON=
 endif
 
 
+# Uncomment to record the boot timeline: proj_cm33_s and proj_cm33_ns mark the
+# end of each start up phase with the DWT cycle counter in shared SRAM, the
+# non-secure image prints it at the end of the start up and dfu_stats -b
+# reads it over the DFU transport. See shared/include/boot_time.h.
+#DEFINES+=BOOT_TIME
+
+# Uncomment to let proj_cm33_ns verify a downloaded image before the reset,
+# with a service of proj_cm33_s that it calls through non-secure callable
+# veneers. Set SECURE_VERIFY_KEY_FILE to the C file that "imgtool getpub -k
+# <signing key>" writes for the key the images are signed with. See
+# shared/include/secure_verify.h.
+#DEFINES+=SECURE_VERIFY
+SECURE_VERIFY_KEY_FILE?=
+
+# Uncomment to accept updates encrypted with "dfu_crypt" (tools/dfu_crypt).
+# proj_cm33_s decrypts the rows before they are written, with a transport key
+# that it keeps wrapped. Set SECURE_DECRYPT_WRAPPED_KEY to the bytes that
+# "dfu_crypt -w" prints, and override secure_decrypt_kek() in proj_cm33_s to
+# read the key encryption key from the secure key store. The default fails.
+# See shared/include/secure_decrypt.h.
+#DEFINES+=SECURE_DECRYPT
+#DEFINES+=SECURE_DECRYPT_WRAPPED_KEY=<24 bytes>
+
+# Import library of the veneers, written by the proj_cm33_s link and linked
+# into proj_cm33_ns
+SECURE_VERIFY_VENEERS=../proj_cm33_s/build/secure_verify_veneers.o
+
+
 # Building ifx-mcuboot with ARM compiler requries some
 # specific symbols. However, linking when ifx-mcuboot is 
 # added as a library to an existing project,
@@ -0,0 +1,136 @@
+/*******************************************************************************
+* File Name        : boot_time.c
+*
+* Description      : This file provides the non-secure side of the boot
+*                    timeline, see shared/include/boot_time.h. Prints the time
+*                    of each start up phase at the end of the start up and
+*                    serves the record to the host with a custom DFU command.
+*                    Enabled with DEFINES+=BOOT_TIME in common.mk.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#if defined(BOOT_TIME)
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <stdio.h>
+#include "cybsp.h"
+#include "cy_pdl.h"
+#include "boot_time.h"
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+#define BOOT_TIME_NAME(mark, name)  name,
+
+static const char *const boot_time_names[BOOT_TIME_MARK_COUNT] =
+{
+    BOOT_TIME_MARKS(BOOT_TIME_NAME)
+};
+
+#undef BOOT_TIME_NAME
+
+/*******************************************************************************
+* Function Name: boot_time_print
+********************************************************************************
+* Summary:
+*  Prints the time of each start up phase and the time since the secure
+*  main(). A phase is converted with the CPU clock at its end, so a phase in
+*  which the clock changes, such as the secure cybsp_init(), is approximate.
+*  Phases whose mark was not taken are merged into the next one.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void boot_time_print(void)
+{
+    volatile boot_time_record_t *record = BOOT_TIME_RECORD;
+    uint32_t last_cycles = 0U;
+    uint32_t total_us = 0U;
+
+    if (record->magic != BOOT_TIME_MAGIC)
+    {
+        printf("\r\n Boot timeline not available, secure image built without BOOT_TIME?\r\n");
+        return;
+    }
+
+    printf("\r\n Boot timeline, boot %lu, reset reason 0x%08lx\r\n",
+           (unsigned long)record->boot_count, (unsigned long)record->reset_reason);
+    for (uint32_t mark = 1U; mark < (uint32_t)BOOT_TIME_MARK_COUNT; mark++)
+    {
+        uint32_t cycles_per_us = record->clock_hz[mark] / 1000000U;
+        uint32_t phase_us;
+
+        if ((record->marks & (1UL << mark)) == 0U)
+        {
+            continue;
+        }
+        phase_us = (record->cycles[mark] - last_cycles) / ((cycles_per_us != 0U) ? cycles_per_us : 1U);
+        total_us += phase_us;
+        last_cycles = record->cycles[mark];
+
+        printf("  %-42s %6lu.%03lu ms %6lu.%03lu ms\r\n", boot_time_names[mark],
+               (unsigned long)(phase_us / 1000U), (unsigned long)(phase_us % 1000U),
+               (unsigned long)(total_us / 1000U), (unsigned long)(total_us % 1000U));
+    }
+}
+
+/*******************************************************************************
+* Function Name: boot_time_get
+********************************************************************************
+* Summary:
+*  Copies a part of the record, see BOOT_TIME_CMD_GET.
+*
+* Parameters:
+*  offset : Offset into the record
+*  data   : Destination
+*  size   : Size of data in bytes
+*
+* Return:
+*  Number of bytes copied, zero if offset is out of range or no record was
+*  started by the secure image
+*
+*******************************************************************************/
+uint32_t boot_time_get(uint32_t offset, uint8_t data[], uint32_t size)
+{
+    const volatile uint8_t *record = (const volatile uint8_t *)BOOT_TIME_RECORD;
+    uint32_t length = 0U;
+
+    if ((BOOT_TIME_RECORD->magic == BOOT_TIME_MAGIC) && (offset < BOOT_TIME_RECORD_SIZE))
+    {
+        length = BOOT_TIME_RECORD_SIZE - offset;
+        length = (length < size) ? length : size;
+        for (uint32_t i = 0U; i < length; i++)
+        {
+            data[i] = record[offset + i];
+        }
+    }
+
+    return length;
+}
+
+#endif /* defined(BOOT_TIME) */
+
+/* [] END OF FILE */
@@ -0,0 +1,85 @@
+/*******************************************************************************
+* File Name        : dfu_clock.c
+*
+* Description      : This file starts the DWT cycle counter that DFU_PERF,
+*                    DFU_TRACE, DFU_RECORD, DFU_BACKGROUND and DFU_XIP_QOS
+*                    take their time from, and converts cycles to
+*                    microseconds.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include "dfu_clock.h"
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static uint32_t clock_cycles_per_us = 1U;
+
+/*******************************************************************************
+* Function Name: dfu_clock_init
+********************************************************************************
+* Summary:
+*  Starts the DWT cycle counter and takes the CPU clock. Must be called after
+*  the CPU clock is set up; every module that uses the counter calls it from
+*  its init function. The counter is not cleared: its users only take
+*  differences, and the boot timeline (BOOT_TIME) runs on the same counter
+*  since the secure image started it.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void dfu_clock_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    clock_cycles_per_us = SystemCoreClock / 1000000U;
+    if (clock_cycles_per_us == 0U)
+    {
+        clock_cycles_per_us = 1U;
+    }
+}
+
+/*******************************************************************************
+* Function Name: dfu_clock_cycles_per_us
+********************************************************************************
+* Summary:
+*  Returns the number of counter cycles per microsecond, at least 1.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  Cycles per microsecond
+*
+*******************************************************************************/
+uint32_t dfu_clock_cycles_per_us(void)
+{
+    return clock_cycles_per_us;
+}
+
+/* [] END OF FILE */
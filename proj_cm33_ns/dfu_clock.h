@@ -0,0 +1,59 @@
+/*******************************************************************************
+* File Name        : dfu_clock.h
+*
+* Description      : This file is the public interface of dfu_clock.c, the
+*                    DWT cycle counter shared by the DFU timing modules.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef DFU_CLOCK_H
+#define DFU_CLOCK_H
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <stdint.h>
+#include "cy_pdl.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Current value of the cycle counter. A macro, so that it can be read from
+ * code that runs from RAM while the external flash cannot be read. */
+#define DFU_CLOCK_CYCLES()          (DWT->CYCCNT)
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void dfu_clock_init(void);
+uint32_t dfu_clock_cycles_per_us(void);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* DFU_CLOCK_H */
+
+/* [] END OF FILE */
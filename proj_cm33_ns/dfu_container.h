@@ -0,0 +1,89 @@
+/*******************************************************************************
+* File Name        : dfu_container.h
+*
+* Description      : This file defines the DFU update container, a binary form
+*                    of build/app_combined.hex that the post-build step writes
+*                    next to it. It is shared by the firmware and by the host
+*                    tools in tools/, which write and map it.
+*
+*                    All fields are little endian. The file is laid out as:
+*                    header, segment table, region table, optional table of
+*                    row CRC-32C, zero padding, and the payload. The payload
+*                    starts at a multiple of the row size and holds whole rows
+*                    in address order, so each row can be passed unchanged to
+*                    Cy_DFU_WriteData().
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef DFU_CONTAINER_H
+#define DFU_CONTAINER_H
+
+#include <stdint.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define DFU_CONTAINER_MAGIC             (0x43554644UL)  /* "DFUC" */
+#define DFU_CONTAINER_VERSION           (1U)
+
+/* The row CRC-32C table is present. The values are the ones Program Data
+ * and Verify Data carry, so a host does not compute them. */
+#define DFU_CONTAINER_FLAG_ROW_CRC      (0x00000001UL)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t magic;                     /* DFU_CONTAINER_MAGIC */
+    uint16_t version;                   /* DFU_CONTAINER_VERSION */
+    uint16_t header_size;               /* sizeof(dfu_container_header_t) */
+    uint32_t flags;                     /* DFU_CONTAINER_FLAG_xxx */
+    uint32_t row_size;                  /* flashRowLength of the script */
+    uint32_t row_count;
+    uint32_t segment_count;
+    uint32_t region_count;
+    uint32_t segment_offset;            /* File offsets of the tables */
+    uint32_t region_offset;
+    uint32_t row_crc_offset;            /* 0 without DFU_CONTAINER_FLAG_ROW_CRC */
+    uint32_t payload_offset;            /* Multiple of row_size */
+    uint32_t metadata_crc;              /* CRC-32C of the bytes before the payload, with this field 0 */
+} dfu_container_header_t;
+
+/* Consecutive rows. The rows of all segments follow each other in the
+ * payload, in address order. */
+typedef struct
+{
+    uint32_t address;                   /* Absolute address of the first row */
+    uint32_t first_row;                 /* Index of the first row in the payload */
+    uint32_t row_count;
+} dfu_container_segment_t;
+
+/* Rows that hold data other than 0xFF. Rows outside of all regions are
+ * erased flash and may be skipped where the target is known to be erased. */
+typedef struct
+{
+    uint32_t address;
+    uint32_t length;                    /* Multiple of row_size */
+} dfu_container_region_t;
+
+#endif /* DFU_CONTAINER_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,58 @@
+/*******************************************************************************
+* File Name        : dfu_crc.h
+*
+* Description      : This file is the public interface of dfu_crc.c, the
+*                    table driven CRC-16 used for DFU packet verification.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef DFU_CRC_H
+#define DFU_CRC_H
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Initial value of a running CRC-16-CCITT */
+#define DFU_CRC16_INIT      (0xFFFFU)
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+uint16_t dfu_crc16_update(uint16_t crc, const uint8_t data[], uint32_t length);
+uint16_t dfu_crc16_final(uint16_t crc);
+uint16_t dfu_packet_checksum(const uint8_t buffer[], uint32_t length);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* DFU_CRC_H */
+
+/* [] END OF FILE */
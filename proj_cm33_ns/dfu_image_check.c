@@ -0,0 +1,322 @@
+/*******************************************************************************
+* File Name        : dfu_image_check.c
+*
+* Description      : This file provides the early check of the images that DFU
+*                    writes to the update slots. The MCUboot image header is
+*                    checked when the first row of a slot arrives, and the
+*                    protected TLVs when the rows that hold them arrive, so an
+*                    image that the bootloader would refuse fails the session
+*                    at once instead of after the transfer and a reset. The
+*                    signature is left to the bootloader.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#if defined(DFU_IMAGE_CHECK)
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <stdbool.h>
+#include <string.h>
+#include "cy_dfu.h"
+#include "dfu_image_check.h"
+#include "dfu_trace.h"
+#include "mcuboot_image.h"
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t status;                            /* DFU_IMAGE_STATUS_xxx of the slot */
+    bool header_seen;                           /* Header row received and checked */
+    bool tlv_checked;
+    uint32_t tlv_offset;                        /* Protected TLV area in the slot */
+    uint32_t tlv_size;
+    uint32_t tlv_filled;                        /* Bytes of tlv received from its start */
+    uint8_t tlv[DFU_IMAGE_CHECK_MAX_TLV];
+    const uint8_t *running;                     /* Image running from the primary slot, or NULL */
+} image_check_slot_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static image_check_slot_t image_check_slots[DFU_IMAGE_CHECK_SLOTS];
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static uint32_t image_check_header(image_check_slot_t *slot, uint32_t slot_size, const uint8_t data[]);
+static uint32_t image_check_tlv(const image_check_slot_t *slot);
+static bool image_check_running_tlv(const image_check_slot_t *slot, uint16_t type, uint32_t *value);
+
+/*******************************************************************************
+* Function Name: dfu_image_check_reset
+********************************************************************************
+* Summary:
+*  Forgets all slots. Call it when a DFU session starts.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void dfu_image_check_reset(void)
+{
+    memset(image_check_slots, 0, sizeof(image_check_slots));
+}
+
+/*******************************************************************************
+* Function Name: dfu_image_check_row
+********************************************************************************
+* Summary:
+*  Checks a row before it is written to an update slot. The row at offset 0
+*  must hold the image header. The bytes of the protected TLV area are
+*  collected from the rows in address order and checked once all are in.
+*  Rows of a slot whose session starts after offset 0 are not checked.
+*
+* Parameters:
+*  slot      : Index of the update slot, the MCUboot image ID
+*  slot_size : Size of the update slot
+*  running   : Start of the primary slot of the image, mapped in memory, or
+*              NULL if it cannot be read
+*  offset    : Offset of the row in the slot
+*  data      : Row data
+*  length    : Row size
+*
+* Return:
+*  DFU_IMAGE_STATUS_OK, or the DFU_IMAGE_STATUS_xxx that rejects the image
+*
+*******************************************************************************/
+uint32_t dfu_image_check_row(uint32_t slot, uint32_t slot_size, const uint8_t *running, uint32_t offset,
+                             const uint8_t data[], uint32_t length)
+{
+    image_check_slot_t *check;
+
+    if (slot >= DFU_IMAGE_CHECK_SLOTS)
+    {
+        return DFU_IMAGE_STATUS_OK;
+    }
+    check = &image_check_slots[slot];
+
+    if (offset == 0U)
+    {
+        /* A new image for the slot, also when the host starts over */
+        memset(check, 0, sizeof(*check));
+        check->running = running;
+        check->status = (length >= MCUBOOT_IMAGE_HEADER_SIZE) ? image_check_header(check, slot_size, data) :
+                                                                DFU_IMAGE_STATUS_HEADER;
+        check->header_seen = true;
+    }
+    else if (check->header_seen && (check->status == DFU_IMAGE_STATUS_OK) && (!check->tlv_checked) &&
+             (offset < (check->tlv_offset + check->tlv_size)) && ((offset + length) > check->tlv_offset))
+    {
+        /* Copy the part of the row in the protected TLV area */
+        uint32_t start = (offset > check->tlv_offset) ? (offset - check->tlv_offset) : 0U;
+        uint32_t end = ((offset + length) - check->tlv_offset);
+
+        end = (end < check->tlv_size) ? end : check->tlv_size;
+        if (start <= check->tlv_filled)
+        {
+            memcpy(&check->tlv[start], &data[(check->tlv_offset + start) - offset], end - start);
+            check->tlv_filled = (end > check->tlv_filled) ? end : check->tlv_filled;
+        }
+        if (check->tlv_filled == check->tlv_size)
+        {
+            check->status = image_check_tlv(check);
+            check->tlv_checked = true;
+        }
+    }
+    else
+    {
+        /* Nothing to check in this row */
+    }
+
+    if (check->status != DFU_IMAGE_STATUS_OK)
+    {
+        DFU_TRACE3(ERR, IMAGE_REJECTED, check->status, slot, offset);
+    }
+
+    return check->status;
+}
+
+/*******************************************************************************
+* Function Name: image_check_header
+********************************************************************************
+* Summary:
+*  Checks the image header: the magic, that the image and its TLV areas fit
+*  in the slot, and that the version is not older than the one of the image
+*  running from the primary slot. Remembers where the protected TLV area is.
+*
+*******************************************************************************/
+static uint32_t image_check_header(image_check_slot_t *slot, uint32_t slot_size, const uint8_t data[])
+{
+    mcuboot_image_header_t header;
+    mcuboot_image_header_t running;
+    uint64_t end;
+
+    if (!mcuboot_image_parse_header(data, &header))
+    {
+        return DFU_IMAGE_STATUS_HEADER;
+    }
+
+    /* The unprotected TLV area holds at least its info and the image hash */
+    end = (uint64_t)header.hdr_size + header.img_size + header.protect_tlv_size + MCUBOOT_TLV_INFO_SIZE;
+    if (end > slot_size)
+    {
+        return DFU_IMAGE_STATUS_SLOT_FIT;
+    }
+
+#if !defined(DFU_IMAGE_CHECK_ALLOW_DOWNGRADE)
+    if ((slot->running != NULL) && mcuboot_image_parse_header(slot->running, &running))
+    {
+        uint64_t version = ((uint64_t)header.ver_major << 56U) | ((uint64_t)header.ver_minor << 48U) |
+                           ((uint64_t)header.ver_revision << 32U) | header.ver_build;
+        uint64_t running_version = ((uint64_t)running.ver_major << 56U) | ((uint64_t)running.ver_minor << 48U) |
+                                   ((uint64_t)running.ver_revision << 32U) | running.ver_build;
+
+        if (version < running_version)
+        {
+            return DFU_IMAGE_STATUS_ROLLBACK;
+        }
+    }
+#else
+    (void)running;
+#endif /* !defined(DFU_IMAGE_CHECK_ALLOW_DOWNGRADE) */
+
+    slot->tlv_offset = (uint32_t)header.hdr_size + header.img_size;
+    slot->tlv_size = header.protect_tlv_size;
+    if (slot->tlv_size > DFU_IMAGE_CHECK_MAX_TLV)
+    {
+        /* Too large to collect, left to the bootloader */
+        DFU_TRACE1(WRN, IMAGE_TLV_NOT_CHECKED, slot->tlv_size);
+        slot->tlv_checked = true;
+    }
+    else if (slot->tlv_size == 0U)
+    {
+        slot->tlv_checked = true;
+#if defined(DFU_IMAGE_CHECK_REQUIRE_PRODUCT)
+        return DFU_IMAGE_STATUS_PRODUCT;
+#endif /* defined(DFU_IMAGE_CHECK_REQUIRE_PRODUCT) */
+    }
+    else
+    {
+        /* Checked in dfu_image_check_row() once collected */
+    }
+
+    return DFU_IMAGE_STATUS_OK;
+}
+
+/*******************************************************************************
+* Function Name: image_check_tlv
+********************************************************************************
+* Summary:
+*  Checks the protected TLV area: its layout, that the security counter is
+*  not lower than the one of the running image, and that the product TLV, if
+*  any, is CY_DFU_PRODUCT.
+*
+*******************************************************************************/
+static uint32_t image_check_tlv(const image_check_slot_t *slot)
+{
+    uint32_t offset = MCUBOOT_TLV_INFO_SIZE;
+    uint32_t running_counter;
+    bool product_found = false;
+
+    if ((mcuboot_get_u16(&slot->tlv[0]) != MCUBOOT_TLV_PROT_INFO_MAGIC) ||
+        (mcuboot_get_u16(&slot->tlv[2]) != slot->tlv_size))
+    {
+        return DFU_IMAGE_STATUS_TLV;
+    }
+
+    while (offset < slot->tlv_size)
+    {
+        uint16_t type;
+        uint16_t length;
+
+        if ((offset + MCUBOOT_TLV_ENTRY_SIZE) > slot->tlv_size)
+        {
+            return DFU_IMAGE_STATUS_TLV;
+        }
+        type = mcuboot_get_u16(&slot->tlv[offset]);
+        length = mcuboot_get_u16(&slot->tlv[offset + 2U]);
+        offset += MCUBOOT_TLV_ENTRY_SIZE;
+        if ((offset + length) > slot->tlv_size)
+        {
+            return DFU_IMAGE_STATUS_TLV;
+        }
+
+        if ((type == MCUBOOT_TLV_SEC_CNT) && (length == 4U) &&
+            image_check_running_tlv(slot, MCUBOOT_TLV_SEC_CNT, &running_counter) &&
+            (mcuboot_get_u32(&slot->tlv[offset]) < running_counter))
+        {
+            return DFU_IMAGE_STATUS_ROLLBACK;
+        }
+        if (type == DFU_IMAGE_TLV_PRODUCT)
+        {
+            if ((length != 4U) || (mcuboot_get_u32(&slot->tlv[offset]) != (uint32_t)CY_DFU_PRODUCT))
+            {
+                return DFU_IMAGE_STATUS_PRODUCT;
+            }
+            product_found = true;
+        }
+        offset += length;
+    }
+
+#if defined(DFU_IMAGE_CHECK_REQUIRE_PRODUCT)
+    return product_found ? DFU_IMAGE_STATUS_OK : DFU_IMAGE_STATUS_PRODUCT;
+#else
+    (void)product_found;
+    return DFU_IMAGE_STATUS_OK;
+#endif /* defined(DFU_IMAGE_CHECK_REQUIRE_PRODUCT) */
+}
+
+/*******************************************************************************
+* Function Name: image_check_running_tlv
+********************************************************************************
+* Summary:
+*  Reads a 4-byte TLV of the image running from the primary slot.
+*
+*******************************************************************************/
+static bool image_check_running_tlv(const image_check_slot_t *slot, uint16_t type, uint32_t *value)
+{
+    mcuboot_image_header_t header;
+    uint16_t length = 0U;
+    const uint8_t *tlv = NULL;
+
+    if ((slot->running != NULL) && mcuboot_image_parse_header(slot->running, &header))
+    {
+        /* The primary slot is at least as large as the image in it */
+        tlv = mcuboot_image_find_tlv(slot->running, (uint32_t)header.hdr_size + header.img_size +
+                                     header.protect_tlv_size + MCUBOOT_TLV_INFO_SIZE, type, &length);
+    }
+    if ((tlv == NULL) || (length != 4U))
+    {
+        return false;
+    }
+    *value = mcuboot_get_u32(tlv);
+
+    return true;
+}
+
+#endif /* defined(DFU_IMAGE_CHECK) */
+
+/* [] END OF FILE */
@@ -0,0 +1,83 @@
+/*******************************************************************************
+* File Name        : dfu_image_check.h
+*
+* Description      : This file is the public interface of dfu_image_check.c,
+*                    the early check of the MCUboot image header and protected
+*                    TLVs of each update slot while the rows arrive. Enabled
+*                    with DEFINES+=DFU_IMAGE_CHECK in the Makefile.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef DFU_IMAGE_CHECK_H
+#define DFU_IMAGE_CHECK_H
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Response status of a Program Data command whose row belongs to an image
+ * that cannot boot. The DFU session fails with it at the first row that
+ * shows the problem, and so does every later row of the same slot. */
+#define DFU_IMAGE_STATUS_OK             (0x00U)
+#define DFU_IMAGE_STATUS_HEADER         (0x10U)     /* No MCUboot image header at the slot start */
+#define DFU_IMAGE_STATUS_SLOT_FIT       (0x11U)     /* Image and TLVs do not fit in the slot */
+#define DFU_IMAGE_STATUS_ROLLBACK       (0x12U)     /* Older version or security counter */
+#define DFU_IMAGE_STATUS_PRODUCT        (0x13U)     /* Built for another product */
+#define DFU_IMAGE_STATUS_TLV            (0x14U)     /* Malformed protected TLV area */
+
+/* Protected TLV with the 4-byte product ID (CY_DFU_PRODUCT) the image is
+ * built for, added at signing with imgtool --custom-tlv 0xA0 <id> */
+#ifndef DFU_IMAGE_TLV_PRODUCT
+    #define DFU_IMAGE_TLV_PRODUCT       (0xA0U)
+#endif /* DFU_IMAGE_TLV_PRODUCT */
+
+/* Number of update slots, see DFU_UPDATE_SLOTS in dfu_user.c */
+#ifndef DFU_IMAGE_CHECK_SLOTS
+    #define DFU_IMAGE_CHECK_SLOTS       (3U)
+#endif /* DFU_IMAGE_CHECK_SLOTS */
+
+/* Largest protected TLV area that is checked. A larger one is not checked. */
+#ifndef DFU_IMAGE_CHECK_MAX_TLV
+    #define DFU_IMAGE_CHECK_MAX_TLV     (128U)
+#endif /* DFU_IMAGE_CHECK_MAX_TLV */
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void dfu_image_check_reset(void);
+uint32_t dfu_image_check_row(uint32_t slot, uint32_t slot_size, const uint8_t *running, uint32_t offset,
+                             const uint8_t data[], uint32_t length);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* DFU_IMAGE_CHECK_H */
+
+/* [] END OF FILE */
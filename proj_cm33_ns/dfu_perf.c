@@ -0,0 +1,406 @@
+/*******************************************************************************
+* File Name        : dfu_perf.c
+*
+* Description      : This file provides per-phase performance counters for
+*                    the DFU session. Phases are timed with the DWT cycle
+*                    counter. For each phase, the number of samples, the total,
+*                    minimum and maximum duration and a log2 histogram are
+*                    kept in RAM and can be read by the host with a custom DFU
+*                    command. The latency of each DFU command ID, from packet
+*                    receipt to response written, is kept the same way.
+*                    Enabled with DEFINES+=DFU_PERF.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#if defined(DFU_PERF)
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <string.h>
+#include "cy_pdl.h"
+#include "dfu_clock.h"
+#include "dfu_perf.h"
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+    uint32_t histogram[DFU_PERF_HIST_BUCKETS];
+} dfu_perf_stats_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static dfu_perf_stats_t perf_stats[DFU_PERF_PHASE_COUNT];
+
+/* Per command latency, slots assigned in order of first receipt */
+static dfu_perf_stats_t perf_cmd_stats[DFU_PERF_CMD_SLOTS];
+static uint8_t perf_cmd_ids[DFU_PERF_CMD_SLOTS];
+static uint32_t perf_cmd_slots;
+
+/* Command waiting for its response */
+static bool perf_cmd_pending;
+static uint8_t perf_cmd_id;
+static uint32_t perf_cmd_start;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void put_u32(uint8_t dst[], uint32_t value);
+static void stats_add(dfu_perf_stats_t *stats, uint32_t cycles);
+static uint32_t stats_copy(const dfu_perf_stats_t *stats, uint32_t offset, uint8_t data[], uint32_t size);
+
+/*******************************************************************************
+* Function Name: put_u32
+********************************************************************************
+* Summary:
+*  Stores a 32-bit value in little endian byte order.
+*
+* Parameters:
+*  dst   : Destination, 4 bytes
+*  value : Value to store
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void put_u32(uint8_t dst[], uint32_t value)
+{
+    dst[0] = (uint8_t)value;
+    dst[1] = (uint8_t)(value >> 8U);
+    dst[2] = (uint8_t)(value >> 16U);
+    dst[3] = (uint8_t)(value >> 24U);
+}
+
+/*******************************************************************************
+* Function Name: stats_add
+********************************************************************************
+* Summary:
+*  Adds one sample to a set of statistics.
+*
+* Parameters:
+*  stats  : Statistics to update
+*  cycles : Duration of the sample in CPU cycles
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void stats_add(dfu_perf_stats_t *stats, uint32_t cycles)
+{
+    uint32_t us = cycles / dfu_clock_cycles_per_us();
+    uint32_t bucket = (us < 2U) ? 0U : (31U - __CLZ(us));
+
+    if (bucket >= DFU_PERF_HIST_BUCKETS)
+    {
+        bucket = DFU_PERF_HIST_BUCKETS - 1U;
+    }
+
+    stats->count++;
+    stats->total += cycles;
+    stats->min = (cycles < stats->min) ? cycles : stats->min;
+    stats->max = (cycles > stats->max) ? cycles : stats->max;
+    stats->histogram[bucket]++;
+}
+
+/*******************************************************************************
+* Function Name: stats_copy
+********************************************************************************
+* Summary:
+*  Serializes a set of statistics, see DFU_PERF_STATS_SIZE for the layout,
+*  and copies a part of them.
+*
+* Parameters:
+*  stats  : Statistics to serialize
+*  offset : Offset into the serialized statistics, below DFU_PERF_STATS_SIZE
+*  data   : Destination
+*  size   : Size of data in bytes
+*
+* Return:
+*  Number of bytes copied
+*
+*******************************************************************************/
+static uint32_t stats_copy(const dfu_perf_stats_t *stats, uint32_t offset, uint8_t data[], uint32_t size)
+{
+    uint8_t serialized[DFU_PERF_STATS_SIZE];
+    uint32_t length;
+
+    put_u32(&serialized[0], dfu_clock_cycles_per_us());
+    put_u32(&serialized[4], stats->count);
+    put_u32(&serialized[8], (stats->count == 0U) ? 0U : stats->min);
+    put_u32(&serialized[12], stats->max);
+    put_u32(&serialized[16], (uint32_t)stats->total);
+    put_u32(&serialized[20], (uint32_t)(stats->total >> 32U));
+    for (uint32_t bucket = 0U; bucket < DFU_PERF_HIST_BUCKETS; bucket++)
+    {
+        put_u32(&serialized[24U + (4U * bucket)], stats->histogram[bucket]);
+    }
+
+    length = DFU_PERF_STATS_SIZE - offset;
+    length = (length > size) ? size : length;
+    (void)memcpy(data, &serialized[offset], length);
+
+    return length;
+}
+
+/*******************************************************************************
+* Function Name: dfu_perf_init
+********************************************************************************
+* Summary:
+*  Starts the cycle counter, see dfu_clock_init(), and clears all statistics.
+*  Must be called after the CPU clock is set up.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void dfu_perf_init(void)
+{
+    dfu_clock_init();
+    dfu_perf_reset();
+}
+
+/*******************************************************************************
+* Function Name: dfu_perf_reset
+********************************************************************************
+* Summary:
+*  Clears all statistics.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void dfu_perf_reset(void)
+{
+    (void)memset(perf_stats, 0, sizeof(perf_stats));
+    for (uint32_t phase = 0U; phase < (uint32_t)DFU_PERF_PHASE_COUNT; phase++)
+    {
+        perf_stats[phase].min = UINT32_MAX;
+    }
+
+    (void)memset(perf_cmd_stats, 0, sizeof(perf_cmd_stats));
+    for (uint32_t slot = 0U; slot < DFU_PERF_CMD_SLOTS; slot++)
+    {
+        perf_cmd_stats[slot].min = UINT32_MAX;
+    }
+    perf_cmd_slots = 0U;
+    perf_cmd_pending = false;
+}
+
+/*******************************************************************************
+* Function Name: dfu_perf_now
+********************************************************************************
+* Summary:
+*  Returns the current value of the cycle counter.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  Timestamp in CPU cycles
+*
+*******************************************************************************/
+uint32_t dfu_perf_now(void)
+{
+    return DFU_CLOCK_CYCLES();
+}
+
+/*******************************************************************************
+* Function Name: dfu_perf_record
+********************************************************************************
+* Summary:
+*  Adds one sample to the statistics of a phase. The counter wraps after
+*  2^32 cycles, so a single phase must be shorter than that.
+*
+* Parameters:
+*  phase : Phase the sample belongs to
+*  start : Timestamp taken with dfu_perf_now() when the phase started
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void dfu_perf_record(dfu_perf_phase_t phase, uint32_t start)
+{
+    stats_add(&perf_stats[phase], dfu_perf_now() - start);
+}
+
+/*******************************************************************************
+* Function Name: dfu_perf_get_stats
+********************************************************************************
+* Summary:
+*  Serializes the statistics of a phase, see DFU_PERF_STATS_SIZE for the
+*  layout, and copies a part of them.
+*
+* Parameters:
+*  phase  : Phase to read
+*  offset : Offset into the serialized statistics
+*  data   : Destination
+*  size   : Size of data in bytes
+*
+* Return:
+*  Number of bytes copied, zero if phase or offset is out of range
+*
+*******************************************************************************/
+uint32_t dfu_perf_get_stats(uint32_t phase, uint32_t offset, uint8_t data[], uint32_t size)
+{
+    uint32_t length = 0U;
+
+    if ((phase < (uint32_t)DFU_PERF_PHASE_COUNT) && (offset < DFU_PERF_STATS_SIZE))
+    {
+        length = stats_copy(&perf_stats[phase], offset, data, size);
+    }
+
+    return length;
+}
+
+/*******************************************************************************
+* Function Name: dfu_perf_command_received
+********************************************************************************
+* Summary:
+*  Starts timing a command packet that was handed to the DFU middleware. A
+*  command that gets no response is not counted.
+*
+* Parameters:
+*  command : DFU command ID
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void dfu_perf_command_received(uint8_t command)
+{
+    perf_cmd_id = command;
+    perf_cmd_start = dfu_perf_now();
+    perf_cmd_pending = true;
+}
+
+/*******************************************************************************
+* Function Name: dfu_perf_response_sent
+********************************************************************************
+* Summary:
+*  Adds the latency of the pending command to the statistics of its ID.
+*  Commands received once all slots are taken are not counted.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void dfu_perf_response_sent(void)
+{
+    uint32_t slot = 0U;
+
+    if (perf_cmd_pending)
+    {
+        perf_cmd_pending = false;
+
+        while ((slot < perf_cmd_slots) && (perf_cmd_ids[slot] != perf_cmd_id))
+        {
+            slot++;
+        }
+
+        if ((slot == perf_cmd_slots) && (slot < DFU_PERF_CMD_SLOTS))
+        {
+            perf_cmd_ids[slot] = perf_cmd_id;
+            perf_cmd_slots++;
+        }
+
+        if (slot < perf_cmd_slots)
+        {
+            stats_add(&perf_cmd_stats[slot], dfu_perf_now() - perf_cmd_start);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: dfu_perf_get_cmd_slots
+********************************************************************************
+* Summary:
+*  Returns the number of command slots in use.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  Number of DFU command IDs with latency statistics
+*
+*******************************************************************************/
+uint32_t dfu_perf_get_cmd_slots(void)
+{
+    return perf_cmd_slots;
+}
+
+/*******************************************************************************
+* Function Name: dfu_perf_get_cmd_stats
+********************************************************************************
+* Summary:
+*  Serializes the latency statistics of one command slot, see
+*  DFU_PERF_CMD_STATS_SIZE for the layout, and copies a part of them.
+*
+* Parameters:
+*  slot   : Slot to read
+*  offset : Offset into the serialized statistics
+*  data   : Destination
+*  size   : Size of data in bytes
+*
+* Return:
+*  Number of bytes copied, zero if slot or offset is out of range
+*
+*******************************************************************************/
+uint32_t dfu_perf_get_cmd_stats(uint32_t slot, uint32_t offset, uint8_t data[], uint32_t size)
+{
+    uint8_t header[4];
+    uint32_t length = 0U;
+
+    if ((slot < perf_cmd_slots) && (offset < DFU_PERF_CMD_STATS_SIZE) && (size != 0U))
+    {
+        if (offset < sizeof(header))
+        {
+            put_u32(header, perf_cmd_ids[slot]);
+            length = sizeof(header) - offset;
+            length = (length > size) ? size : length;
+            (void)memcpy(data, &header[offset], length);
+            offset = sizeof(header);
+        }
+
+        length += stats_copy(&perf_cmd_stats[slot], offset - sizeof(header), &data[length], size - length);
+    }
+
+    return length;
+}
+
+#endif /* defined(DFU_PERF) */
+
+/* [] END OF FILE */
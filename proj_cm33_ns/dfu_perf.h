@@ -0,0 +1,138 @@
+/*******************************************************************************
+* File Name        : dfu_perf.h
+*
+* Description      : This file is the public interface of dfu_perf.c, the
+*                    per-phase DFU performance counters.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef DFU_PERF_H
+#define DFU_PERF_H
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Custom DFU command that reads the statistics of one phase.
+ * Request data: phase (1 byte), offset into the serialized statistics
+ * (2 bytes, little endian).
+ * Response data: number of phases (1 byte), size of the serialized
+ * statistics (2 bytes, little endian), then up to DFU_PERF_CHUNK_SIZE bytes
+ * starting at the requested offset. */
+#define DFU_PERF_CMD_GET_STATS      (0x50U)
+
+/* Custom DFU command that clears all statistics. No data. */
+#define DFU_PERF_CMD_RESET_STATS    (0x51U)
+
+/* Custom DFU command that reads the latency statistics of one DFU command ID.
+ * Request data: slot (1 byte), offset (2 bytes, little endian).
+ * Response data: number of slots in use (1 byte), size of the serialized
+ * statistics (2 bytes, little endian), then up to DFU_PERF_CHUNK_SIZE bytes
+ * starting at the requested offset. */
+#define DFU_PERF_CMD_GET_CMD_STATS  (0x52U)
+
+/* Number of DFU command IDs whose latency is tracked. Slots are assigned in
+ * the order the commands are first received in a session. */
+#define DFU_PERF_CMD_SLOTS          (8U)
+
+/* Largest number of statistics bytes in one response. Keeps every response
+ * within a 64-byte USB-HID report. */
+#define DFU_PERF_CHUNK_SIZE         (48U)
+
+/* Number of histogram buckets. Bucket n counts durations of 2^n to
+ * 2^(n+1) - 1 microseconds, bucket 0 also counts durations below 1 us and the
+ * last bucket everything longer. */
+#define DFU_PERF_HIST_BUCKETS       (20U)
+
+/* Size of the serialized statistics of one phase:
+ * cycles per microsecond, count, min, max (4 bytes each), total (8 bytes),
+ * histogram (4 bytes per bucket), all little endian. Min, max and total are
+ * in CPU cycles. */
+#define DFU_PERF_STATS_SIZE         (24U + (4U * DFU_PERF_HIST_BUCKETS))
+
+/* Size of the serialized latency statistics of one DFU command: the command
+ * ID (4 bytes) followed by the same layout as the phase statistics. The
+ * latency is measured from the end of the packet read to the end of the
+ * response write. */
+#define DFU_PERF_CMD_STATS_SIZE     (4U + DFU_PERF_STATS_SIZE)
+
+#if defined(DFU_PERF)
+    /* Starts timing a phase; declares the start timestamp variable */
+    #define DFU_PERF_BEGIN(start)           uint32_t start = dfu_perf_now()
+    /* Ends timing a phase started with DFU_PERF_BEGIN() */
+    #define DFU_PERF_END(phase, start)      dfu_perf_record((phase), (start))
+    /* Marks a command packet handed to the DFU middleware */
+    #define DFU_PERF_COMMAND_RECEIVED(cmd)  dfu_perf_command_received(cmd)
+    /* Marks the response to that command as sent */
+    #define DFU_PERF_RESPONSE_SENT()        dfu_perf_response_sent()
+#else
+    #define DFU_PERF_BEGIN(start)
+    #define DFU_PERF_END(phase, start)      ((void)0)
+    #define DFU_PERF_COMMAND_RECEIVED(cmd)  ((void)0)
+    #define DFU_PERF_RESPONSE_SENT()        ((void)0)
+#endif /* defined(DFU_PERF) */
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+
+/* Timed phases of a DFU session */
+typedef enum
+{
+    DFU_PERF_CONTINUE,          /* Cy_DFU_Continue() call that handled a command */
+    DFU_PERF_TRANSPORT_READ,    /* Wait for and read of a command packet */
+    DFU_PERF_TRANSPORT_WRITE,   /* Write of a response packet */
+    DFU_PERF_WRITE_DATA,        /* Cy_DFU_WriteData(), including erase and program */
+    DFU_PERF_FLASH_ERASE,       /* Serial memory erase in Ext_Flash_WriteRow() */
+    DFU_PERF_FLASH_PROGRAM,     /* Serial memory program in Ext_Flash_WriteRow() */
+    DFU_PERF_READ_DATA,         /* Cy_DFU_ReadData(), read or compare */
+    DFU_PERF_LOOP_DELAY,        /* Delay at the end of each main loop iteration */
+    DFU_PERF_PHASE_COUNT
+} dfu_perf_phase_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void dfu_perf_init(void);
+void dfu_perf_reset(void);
+uint32_t dfu_perf_now(void);
+void dfu_perf_record(dfu_perf_phase_t phase, uint32_t start);
+uint32_t dfu_perf_get_stats(uint32_t phase, uint32_t offset, uint8_t data[], uint32_t size);
+void dfu_perf_command_received(uint8_t command);
+void dfu_perf_response_sent(void);
+uint32_t dfu_perf_get_cmd_slots(void);
+uint32_t dfu_perf_get_cmd_stats(uint32_t slot, uint32_t offset, uint8_t data[], uint32_t size);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* DFU_PERF_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,317 @@
+/*******************************************************************************
+* File Name        : dfu_record.c
+*
+* Description      : This file provides the DFU session recorder. Every
+*                    packet read by Cy_DFU_TransportRead() and written by
+*                    Cy_DFU_TransportWrite() is stored with a microsecond
+*                    timestamp in a RAM buffer. An Enter DFU command starts
+*                    a new recording. dfu_record_dump() sends the recording
+*                    to the debug UART when the session ends, where
+*                    tools/dfu_capture saves it for replay with
+*                    tools/dfu_sim. Enabled with DEFINES+=DFU_RECORD.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#if defined(DFU_RECORD)
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <stdbool.h>
+#include <string.h>
+#include "cybsp.h"
+#include "cy_pdl.h"
+#include "dfu_clock.h"
+#include "dfu_record.h"
+#include "retarget_io_init.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#if ((DFU_RECORD_BUFFER_SIZE % 4U) != 0U)
+    #error "DFU_RECORD_BUFFER_SIZE must be a multiple of 4"
+#endif
+
+/* DFU packet fields, see dfu_user.c */
+#define RECORD_CMD_IDX          (0x01U)
+#define RECORD_CMD_ENTER        (0x38U)
+
+/* Largest piece handed to the debug UART at once */
+#define RECORD_WRITE_CHUNK      (32U)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static uint32_t record_buffer[DFU_RECORD_BUFFER_SIZE / 4U];
+static uint32_t record_used;            /* Bytes of record_buffer in use */
+static uint32_t record_entries;
+static uint32_t record_dropped;         /* Packets that did not fit */
+static bool record_pending;             /* Not dumped yet */
+
+static uint32_t record_last_cycles;
+static uint32_t record_time_us;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static uint32_t record_timestamp(void);
+static void record_write(const uint8_t data[], uint32_t size);
+static void record_send_frame(uint8_t type, const uint8_t header[], uint32_t header_size,
+                              const uint8_t payload[], uint32_t payload_size);
+
+/*******************************************************************************
+* Function Name: record_timestamp
+********************************************************************************
+* Summary:
+*  Returns the time since the recording started in microseconds. The DWT cycle
+*  counter is extended like in dfu_trace.c. Packets of a session are never
+*  further apart than the 5 second command timeout of main.c, well within one
+*  counter period.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  Timestamp in microseconds
+*
+*******************************************************************************/
+static uint32_t record_timestamp(void)
+{
+    uint32_t elapsed_us = (DFU_CLOCK_CYCLES() - record_last_cycles) / dfu_clock_cycles_per_us();
+
+    /* Keep the remainder, so no time is lost between calls */
+    record_last_cycles += elapsed_us * dfu_clock_cycles_per_us();
+    record_time_us += elapsed_us;
+
+    return record_time_us;
+}
+
+/*******************************************************************************
+* Function Name: record_write
+********************************************************************************
+* Summary:
+*  Sends bytes on the debug UART and waits for room in the TX FIFO or, with
+*  DEBUG_UART_ASYNC, in the retarget-io TX ring.
+*
+* Parameters:
+*  data : Bytes to send
+*  size : Number of bytes
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void record_write(const uint8_t data[], uint32_t size)
+{
+#if defined(DEBUG_UART_ASYNC)
+    while (size != 0U)
+    {
+        uint32_t chunk = (size < RECORD_WRITE_CHUNK) ? size : RECORD_WRITE_CHUNK;
+
+        if (retarget_io_write(data, chunk))
+        {
+            data += chunk;
+            size -= chunk;
+        }
+    }
+#else
+    if (size != 0U)
+    {
+        Cy_SCB_UART_PutArrayBlocking(CYBSP_DEBUG_UART_HW, (void *)data, size);
+    }
+#endif /* defined(DEBUG_UART_ASYNC) */
+}
+
+/*******************************************************************************
+* Function Name: record_send_frame
+********************************************************************************
+* Summary:
+*  Sends one frame whose payload is made of two parts, so that an entry can
+*  be sent straight from the buffer.
+*
+* Parameters:
+*  type         : DFU_RECORD_FRAME_xxx
+*  header       : First part of the payload
+*  header_size  : Size of the first part
+*  payload      : Second part of the payload
+*  payload_size : Size of the second part
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void record_send_frame(uint8_t type, const uint8_t header[], uint32_t header_size,
+                              const uint8_t payload[], uint32_t payload_size)
+{
+    uint32_t length = header_size + payload_size;
+    uint8_t frame[DFU_RECORD_FRAME_HEADER_SIZE] =
+    {
+        DFU_RECORD_SYNC0, DFU_RECORD_SYNC1, type, (uint8_t)length, (uint8_t)(length >> 8U)
+    };
+    uint8_t sum = (uint8_t)(type + frame[3] + frame[4]);
+
+    for (uint32_t i = 0U; i < header_size; i++)
+    {
+        sum += header[i];
+    }
+    for (uint32_t i = 0U; i < payload_size; i++)
+    {
+        sum += payload[i];
+    }
+
+    record_write(frame, DFU_RECORD_FRAME_HEADER_SIZE);
+    record_write(header, header_size);
+    record_write(payload, payload_size);
+    record_write(&sum, 1U);
+}
+
+/*******************************************************************************
+* Function Name: dfu_record_init
+********************************************************************************
+* Summary:
+*  Starts the cycle counter used for timestamps and empties the
+*  recording. Call it after init_retarget_io().
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void dfu_record_init(void)
+{
+    dfu_clock_init();
+
+    record_used = 0U;
+    record_entries = 0U;
+    record_dropped = 0U;
+    record_pending = false;
+}
+
+/*******************************************************************************
+* Function Name: dfu_record_packet
+********************************************************************************
+* Summary:
+*  Adds a packet to the recording. A received Enter DFU command starts a new
+*  recording, so the buffer holds the latest session from its start. Packets
+*  that do not fit are counted, not stored.
+*
+* Parameters:
+*  direction : DFU_RECORD_TO_DEVICE or DFU_RECORD_FROM_DEVICE
+*  transport : Interface the packet went through
+*  packet    : Packet bytes
+*  length    : Packet length
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void dfu_record_packet(uint32_t direction, uint32_t transport, const uint8_t packet[], uint32_t length)
+{
+    uint8_t *entry;
+    uint32_t timestamp;
+    uint32_t size = (DFU_RECORD_ENTRY_SIZE + length + 3U) & ~3U;
+
+    if ((direction == DFU_RECORD_TO_DEVICE) && (length > RECORD_CMD_IDX) &&
+        (packet[RECORD_CMD_IDX] == RECORD_CMD_ENTER))
+    {
+        record_last_cycles = DFU_CLOCK_CYCLES();
+        record_time_us = 0U;
+        record_used = 0U;
+        record_entries = 0U;
+        record_dropped = 0U;
+    }
+    timestamp = record_timestamp();
+    record_pending = true;
+
+    if ((length > UINT16_MAX) || (size > (DFU_RECORD_BUFFER_SIZE - record_used)))
+    {
+        record_dropped++;
+    }
+    else
+    {
+        entry = (uint8_t *)record_buffer + record_used;
+        entry[0] = (uint8_t)timestamp;
+        entry[1] = (uint8_t)(timestamp >> 8U);
+        entry[2] = (uint8_t)(timestamp >> 16U);
+        entry[3] = (uint8_t)(timestamp >> 24U);
+        entry[4] = (uint8_t)length;
+        entry[5] = (uint8_t)(length >> 8U);
+        entry[6] = (uint8_t)direction;
+        entry[7] = (uint8_t)transport;
+        (void)memcpy(&entry[DFU_RECORD_ENTRY_SIZE], packet, length);
+
+        record_used += size;
+        record_entries++;
+    }
+}
+
+/*******************************************************************************
+* Function Name: dfu_record_dump
+********************************************************************************
+* Summary:
+*  Sends the recording of the last session to the debug UART and waits until
+*  it has left the UART. Call it when a session ends, fails or times out,
+*  before a device reset. Does nothing if the recording was already sent.
+*  At 115200 bit/s a full 64 KB buffer takes about 6 seconds.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void dfu_record_dump(void)
+{
+    const uint8_t *buffer = (const uint8_t *)record_buffer;
+    uint8_t start[DFU_RECORD_START_SIZE];
+    uint32_t values[3] = { record_entries, record_dropped, record_used };
+
+    if (record_pending)
+    {
+        for (uint32_t i = 0U; i < 3U; i++)
+        {
+            start[(4U * i) + 0U] = (uint8_t)values[i];
+            start[(4U * i) + 1U] = (uint8_t)(values[i] >> 8U);
+            start[(4U * i) + 2U] = (uint8_t)(values[i] >> 16U);
+            start[(4U * i) + 3U] = (uint8_t)(values[i] >> 24U);
+        }
+        record_send_frame(DFU_RECORD_FRAME_START, start, DFU_RECORD_START_SIZE, NULL, 0U);
+
+        for (uint32_t offset = 0U; offset < record_used;)
+        {
+            uint32_t length = (uint32_t)buffer[offset + 4U] | ((uint32_t)buffer[offset + 5U] << 8U);
+
+            record_send_frame(DFU_RECORD_FRAME_ENTRY, &buffer[offset], DFU_RECORD_ENTRY_SIZE,
+                              &buffer[offset + DFU_RECORD_ENTRY_SIZE], length);
+            offset += (DFU_RECORD_ENTRY_SIZE + length + 3U) & ~3U;
+        }
+
+        record_send_frame(DFU_RECORD_FRAME_END, NULL, 0U, NULL, 0U);
+        retarget_io_flush();
+        record_pending = false;
+    }
+}
+
+#endif /* defined(DFU_RECORD) */
+
+/* [] END OF FILE */
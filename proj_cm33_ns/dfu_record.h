@@ -0,0 +1,107 @@
+/*******************************************************************************
+* File Name        : dfu_record.h
+*
+* Description      : This file is the public interface of dfu_record.c, the
+*                    DFU session recorder, and describes the recording
+*                    formats shared with the host tools in tools/.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef DFU_RECORD_H
+#define DFU_RECORD_H
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Size of the RAM buffer that holds the recording, a multiple of 4. A full
+ * Program Data packet takes about 540 bytes. */
+#ifndef DFU_RECORD_BUFFER_SIZE
+    #define DFU_RECORD_BUFFER_SIZE      (0x10000U)
+#endif /* DFU_RECORD_BUFFER_SIZE */
+
+/* Direction of a recorded packet */
+#define DFU_RECORD_TO_DEVICE            (0U)    /* Command from the host */
+#define DFU_RECORD_FROM_DEVICE          (1U)    /* Response of the device */
+
+/* Every recorded packet starts with an entry header of DFU_RECORD_ENTRY_SIZE
+ * bytes, all little endian: timestamp in microseconds since the Enter DFU
+ * command of the session (4 bytes), packet length (2 bytes), direction
+ * (1 byte) and cy_en_dfu_transport_t of the interface (1 byte). The packet
+ * follows. */
+#define DFU_RECORD_ENTRY_SIZE           (8U)
+
+/* The recording is sent on the debug UART in frames of DFU_RECORD_SYNC0,
+ * DFU_RECORD_SYNC1, the frame type, the payload length (2 bytes, little
+ * endian), the payload and the 8-bit sum of type, length and payload.
+ * A START frame carries the number of entries, the number of packets that
+ * did not fit in the buffer and the number of bytes recorded (4 bytes each),
+ * followed by one ENTRY frame per packet (entry header and packet) and an
+ * END frame without payload. */
+#define DFU_RECORD_SYNC0                (0xA5U)
+#define DFU_RECORD_SYNC1                (0xC3U)
+#define DFU_RECORD_FRAME_START          (0x01U)
+#define DFU_RECORD_FRAME_ENTRY          (0x02U)
+#define DFU_RECORD_FRAME_END            (0x03U)
+#define DFU_RECORD_FRAME_HEADER_SIZE    (5U)
+#define DFU_RECORD_START_SIZE           (12U)
+
+/* Capture file written by the host tools: a header of
+ * DFU_RECORD_FILE_HEADER_SIZE bytes, all little endian: DFU_RECORD_FILE_MAGIC
+ * (4 bytes), DFU_RECORD_FILE_VERSION (2 bytes), DFU_RECORD_SOURCE_xxx
+ * (2 bytes), number of entries and number of dropped packets (4 bytes each),
+ * then the entries back to back in the same layout as on the UART. */
+#define DFU_RECORD_FILE_MAGIC           (0x52554644U)   /* "DFUR" */
+#define DFU_RECORD_FILE_VERSION         (1U)
+#define DFU_RECORD_FILE_HEADER_SIZE     (16U)
+#define DFU_RECORD_SOURCE_DEVICE        (0U)    /* Recorded by the device */
+#define DFU_RECORD_SOURCE_HOST          (1U)    /* Recorded by the DFU host */
+
+#if defined(DFU_RECORD)
+    /* Records a packet that was received or sent */
+    #define DFU_RECORD_PACKET(direction, transport, packet, length) \
+        dfu_record_packet((direction), (uint32_t)(transport), (packet), (length))
+#else
+    #define DFU_RECORD_PACKET(direction, transport, packet, length)    ((void)0)
+#endif /* defined(DFU_RECORD) */
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void dfu_record_init(void);
+void dfu_record_packet(uint32_t direction, uint32_t transport, const uint8_t packet[], uint32_t length);
+void dfu_record_dump(void);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* DFU_RECORD_H */
+
+/* [] END OF FILE */
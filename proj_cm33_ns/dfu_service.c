@@ -0,0 +1,248 @@
+/*******************************************************************************
+* File Name        : dfu_service.c
+*
+* Description      : This file provides the CPU budget of the DFU engine when
+*                    it runs in the background of the application. main()
+*                    calls the engine once per pass of its loop, between
+*                    dfu_service_begin() and dfu_service_end(). The time of
+*                    the calls is charged to a window, and once the budget of
+*                    the window is used up the engine waits for the next one,
+*                    so the tasks of the application get the rest of the CPU.
+*                    Time is taken from the DWT cycle counter.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#if defined(DFU_BACKGROUND)
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <string.h>
+#include "cy_pdl.h"
+#include "dfu_clock.h"
+#include "dfu_service.h"
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Clock: microseconds and milliseconds since dfu_service_init() */
+static uint32_t service_last_cycles;
+static uint32_t service_cycles_rem;
+static uint64_t service_us;
+
+/* Budget */
+static uint64_t service_window_start;
+static uint32_t service_window_used;
+static uint64_t service_call_start;
+
+static dfu_service_stats_t service_stats;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static uint64_t service_clock(void);
+
+/*******************************************************************************
+* Function Name: dfu_service_init
+********************************************************************************
+* Summary:
+*  Starts the clock of the service, see dfu_clock_init(). Must be called after
+*  the CPU clock is set up.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void dfu_service_init(void)
+{
+    dfu_clock_init();
+    service_last_cycles = DFU_CLOCK_CYCLES();
+    service_cycles_rem = 0U;
+    service_us = 0U;
+    service_window_start = 0U;
+    service_window_used = 0U;
+
+    dfu_service_reset_stats();
+}
+
+/*******************************************************************************
+* Function Name: dfu_service_now_ms
+********************************************************************************
+* Summary:
+*  Returns the time since dfu_service_init(). The cycle counter wraps after
+*  2^32 cycles, about 21 seconds at 200 MHz, so call this or
+*  dfu_service_begin() more often than that.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  Time in milliseconds, wraps after 2^32 ms
+*
+*******************************************************************************/
+uint32_t dfu_service_now_ms(void)
+{
+    return (uint32_t)(service_clock() / 1000U);
+}
+
+/*******************************************************************************
+* Function Name: dfu_service_begin
+********************************************************************************
+* Summary:
+*  Starts a call of the DFU engine if the window has budget left. Starts a
+*  new window when the current one has ended.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  True to run the engine and call dfu_service_end() after it, false to skip
+*  it in this pass
+*
+*******************************************************************************/
+bool dfu_service_begin(void)
+{
+    uint64_t now = service_clock();
+
+    if ((now - service_window_start) >= DFU_SERVICE_WINDOW_US)
+    {
+        if (service_window_used > DFU_SERVICE_BUDGET_US)
+        {
+            service_stats.overruns++;
+        }
+        service_window_start = now;
+        service_window_used = 0U;
+    }
+
+    if (service_window_used >= DFU_SERVICE_BUDGET_US)
+    {
+        service_stats.deferred++;
+        return false;
+    }
+    service_call_start = now;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: dfu_service_end
+********************************************************************************
+* Summary:
+*  Charges the time since dfu_service_begin() to the window.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void dfu_service_end(void)
+{
+    uint32_t us = (uint32_t)(service_clock() - service_call_start);
+
+    service_window_used += us;
+    service_stats.calls++;
+    service_stats.busy_us += us;
+    service_stats.max_call_us = (us > service_stats.max_call_us) ? us : service_stats.max_call_us;
+}
+
+/*******************************************************************************
+* Function Name: dfu_service_get_stats
+********************************************************************************
+* Summary:
+*  Returns the statistics since the last dfu_service_reset_stats().
+*
+* Parameters:
+*  void
+*
+* Return:
+*  Statistics of the calls
+*
+*******************************************************************************/
+const dfu_service_stats_t *dfu_service_get_stats(void)
+{
+    return &service_stats;
+}
+
+/*******************************************************************************
+* Function Name: dfu_service_reset_stats
+********************************************************************************
+* Summary:
+*  Clears the statistics.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void dfu_service_reset_stats(void)
+{
+    (void)memset(&service_stats, 0, sizeof(service_stats));
+}
+
+/*******************************************************************************
+* Function Name: dfu_service_reset_allowed
+********************************************************************************
+* Summary:
+*  Asked before the reset that installs a finished update. Until it returns
+*  true, the update waits in the update slots and the application keeps
+*  running. The default allows the reset at once. Override it to reset at a
+*  time that suits the application.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  True to reset now
+*
+*******************************************************************************/
+__WEAK bool dfu_service_reset_allowed(void)
+{
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: service_clock
+********************************************************************************
+* Summary:
+*  Advances the clock by the cycles since the last call.
+*
+*******************************************************************************/
+static uint64_t service_clock(void)
+{
+    uint32_t cycles = DFU_CLOCK_CYCLES();
+
+    service_cycles_rem += cycles - service_last_cycles;
+    service_last_cycles = cycles;
+    service_us += service_cycles_rem / dfu_clock_cycles_per_us();
+    service_cycles_rem %= dfu_clock_cycles_per_us();
+
+    return service_us;
+}
+
+#endif /* defined(DFU_BACKGROUND) */
+
+/* [] END OF FILE */
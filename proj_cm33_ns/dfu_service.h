@@ -0,0 +1,95 @@
+/*******************************************************************************
+* File Name        : dfu_service.h
+*
+* Description      : This file is the public interface of dfu_service.c, the
+*                    CPU budget of the DFU engine when it runs in the
+*                    background of the application (DFU_BACKGROUND).
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef DFU_SERVICE_H
+#define DFU_SERVICE_H
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Longest wait for a command in one Cy_DFU_Continue() call, in milliseconds.
+ * Cy_DFU_TransportRead() shortens the read timeout of the middleware to this,
+ * responses keep the full timeout. */
+#ifndef DFU_SERVICE_POLL_MS
+    #define DFU_SERVICE_POLL_MS         (1U)
+#endif /* DFU_SERVICE_POLL_MS */
+
+/* The DFU engine may use DFU_SERVICE_BUDGET_US of CPU time in each window of
+ * DFU_SERVICE_WINDOW_US, 25 % by default. A call that starts with budget
+ * left runs to its end, so a window can overrun by one call. */
+#ifndef DFU_SERVICE_WINDOW_US
+    #define DFU_SERVICE_WINDOW_US       (20000U)
+#endif /* DFU_SERVICE_WINDOW_US */
+#ifndef DFU_SERVICE_BUDGET_US
+    #define DFU_SERVICE_BUDGET_US       (5000U)
+#endif /* DFU_SERVICE_BUDGET_US */
+
+/* Bytes of an update slot hashed in one call by SECURE_VERIFY */
+#ifndef DFU_SERVICE_VERIFY_STEP
+    #define DFU_SERVICE_VERIFY_STEP     (0x1000U)
+#endif /* DFU_SERVICE_VERIFY_STEP */
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t calls;             /* Calls that ran */
+    uint32_t deferred;          /* Calls skipped, the budget of the window was used up */
+    uint32_t max_call_us;       /* Longest call, the worst delay of the application */
+    uint32_t overruns;          /* Windows that used more than the budget */
+    uint64_t busy_us;           /* Time of all calls */
+} dfu_service_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void dfu_service_init(void);
+uint32_t dfu_service_now_ms(void);
+bool dfu_service_begin(void);
+void dfu_service_end(void);
+const dfu_service_stats_t *dfu_service_get_stats(void);
+void dfu_service_reset_stats(void);
+bool dfu_service_reset_allowed(void);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* DFU_SERVICE_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,324 @@
+/*******************************************************************************
+* File Name        : dfu_trace.c
+*
+* Description      : This file provides a deferred binary trace for the DFU
+*                    hot path. Events are stored as fixed-size records with a
+*                    microsecond timestamp, an event ID from dfu_trace_ids.h
+*                    and up to four arguments in a RAM ring. Any context,
+*                    including interrupts, can add records without locks.
+*                    dfu_trace_drain(), called from the main loop when it is
+*                    otherwise idle, sends whole records to the debug UART
+*                    without waiting for it. tools/dfu_trace turns the records
+*                    back into text. Enabled with DEFINES+=DFU_TRACE.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#if defined(DFU_TRACE)
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <string.h>
+#include "cybsp.h"
+#include "cy_pdl.h"
+#include "dfu_clock.h"
+#include "dfu_trace.h"
+#include "retarget_io_init.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define TRACE_RING_MASK     (DFU_TRACE_RING_SIZE - 1U)
+
+#if ((DFU_TRACE_RING_SIZE & TRACE_RING_MASK) != 0U)
+    #error "DFU_TRACE_RING_SIZE must be a power of two"
+#endif
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+
+/* One trace record, DFU_TRACE_RECORD_SIZE bytes */
+typedef struct
+{
+    uint32_t timestamp;                     /* Microseconds since dfu_trace_init() */
+    uint16_t id;                            /* dfu_trace_id_t */
+    uint8_t level;                          /* DFU_TRACE_LEVEL_xxx */
+    uint8_t argc;                           /* Number of valid arguments */
+    uint32_t args[DFU_TRACE_MAX_ARGS];
+} dfu_trace_record_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static dfu_trace_record_t trace_ring[DFU_TRACE_RING_SIZE];
+
+/* trace_commit[slot] is set to index + 1 once the record reserved at index is
+ * completely written, so the drain never sends a half-written record. */
+static volatile uint32_t trace_commit[DFU_TRACE_RING_SIZE];
+
+static volatile uint32_t trace_head;        /* Next index to reserve */
+static volatile uint32_t trace_tail;        /* Next index to send */
+static volatile uint32_t trace_dropped;     /* Records lost to a full ring */
+static uint32_t trace_dropped_reported;
+
+static uint32_t trace_last_cycles;
+static uint32_t trace_time_us;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static uint32_t trace_timestamp(void);
+static bool trace_send(void);
+
+/*******************************************************************************
+* Function Name: trace_timestamp
+********************************************************************************
+* Summary:
+*  Returns the time since dfu_trace_init() in microseconds. The DWT cycle
+*  counter is extended so that the timestamp wraps only after 71 minutes, as
+*  long as a record is added at least once per counter period.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  Timestamp in microseconds
+*
+*******************************************************************************/
+static uint32_t trace_timestamp(void)
+{
+    uint32_t intr_state = Cy_SysLib_EnterCriticalSection();
+    uint32_t cycles = DFU_CLOCK_CYCLES();
+    uint32_t elapsed_us = (cycles - trace_last_cycles) / dfu_clock_cycles_per_us();
+
+    /* Keep the remainder, so no time is lost between calls */
+    trace_last_cycles += elapsed_us * dfu_clock_cycles_per_us();
+    trace_time_us += elapsed_us;
+    elapsed_us = trace_time_us;
+    Cy_SysLib_ExitCriticalSection(intr_state);
+
+    return elapsed_us;
+}
+
+/*******************************************************************************
+* Function Name: trace_send
+********************************************************************************
+* Summary:
+*  Sends the oldest complete record if the debug UART has room for the whole
+*  frame, either in the TX FIFO or, with DEBUG_UART_ASYNC, in the retarget-io
+*  TX ring. Frames are never split, so printf() output in between does not
+*  corrupt them.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  True if a record was sent
+*
+*******************************************************************************/
+static bool trace_send(void)
+{
+    uint8_t frame[DFU_TRACE_FRAME_SIZE];
+    uint32_t index = trace_tail;
+    uint32_t slot = index & TRACE_RING_MASK;
+    uint8_t sum = 0U;
+    bool sent = false;
+
+    if ((index != trace_head) && (trace_commit[slot] == (index + 1U)))
+    {
+        frame[0] = DFU_TRACE_SYNC0;
+        frame[1] = DFU_TRACE_SYNC1;
+        (void)memcpy(&frame[2], &trace_ring[slot], DFU_TRACE_RECORD_SIZE);
+        for (uint32_t i = 2U; i < (DFU_TRACE_FRAME_SIZE - 1U); i++)
+        {
+            sum += frame[i];
+        }
+        frame[DFU_TRACE_FRAME_SIZE - 1U] = sum;
+
+#if defined(DEBUG_UART_ASYNC)
+        sent = retarget_io_write(frame, DFU_TRACE_FRAME_SIZE);
+#else
+        if ((Cy_SCB_GetFifoSize(CYBSP_DEBUG_UART_HW) - Cy_SCB_UART_GetNumInTxFifo(CYBSP_DEBUG_UART_HW)) >=
+            DFU_TRACE_FRAME_SIZE)
+        {
+            (void)Cy_SCB_UART_PutArray(CYBSP_DEBUG_UART_HW, frame, DFU_TRACE_FRAME_SIZE);
+            sent = true;
+        }
+#endif /* defined(DEBUG_UART_ASYNC) */
+
+        if (sent)
+        {
+            /* The slot may be reused from here on */
+            trace_tail = index + 1U;
+        }
+    }
+
+    return sent;
+}
+
+/*******************************************************************************
+* Function Name: dfu_trace_init
+********************************************************************************
+* Summary:
+*  Starts the cycle counter used for timestamps, empties the ring and
+*  records the TRACE_START event. Call it after init_retarget_io().
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void dfu_trace_init(void)
+{
+    dfu_clock_init();
+    trace_last_cycles = DFU_CLOCK_CYCLES();
+    trace_time_us = 0U;
+
+    trace_head = 0U;
+    trace_tail = 0U;
+    trace_dropped = 0U;
+    trace_dropped_reported = 0U;
+    (void)memset((void *)trace_commit, 0, sizeof(trace_commit));
+
+    dfu_trace_put(DFU_TRACE_ID_TRACE_START, DFU_TRACE_LEVEL_INF, 1U, SystemCoreClock, 0U, 0U, 0U);
+}
+
+/*******************************************************************************
+* Function Name: dfu_trace_put
+********************************************************************************
+* Summary:
+*  Adds a record to the ring. A slot is reserved with an exclusive
+*  load/store pair, so callers in different interrupt priorities never block
+*  each other. When the ring is full, the record is dropped and counted.
+*
+* Parameters:
+*  id    : Event ID
+*  level : DFU_TRACE_LEVEL_xxx
+*  argc  : Number of valid arguments
+*  arg0..arg3 : Arguments
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void dfu_trace_put(dfu_trace_id_t id, uint32_t level, uint32_t argc,
+                   uint32_t arg0, uint32_t arg1, uint32_t arg2, uint32_t arg3)
+{
+    dfu_trace_record_t *record;
+    uint32_t index;
+    uint32_t dropped;
+    bool full;
+
+    do
+    {
+        index = __LDREXW(&trace_head);
+        full = ((index - trace_tail) >= DFU_TRACE_RING_SIZE);
+        if (full)
+        {
+            __CLREX();
+            break;
+        }
+    } while (__STREXW(index + 1U, &trace_head) != 0U);
+
+    if (full)
+    {
+        do
+        {
+            dropped = __LDREXW(&trace_dropped);
+        } while (__STREXW(dropped + 1U, &trace_dropped) != 0U);
+    }
+    else
+    {
+        record = &trace_ring[index & TRACE_RING_MASK];
+        record->timestamp = trace_timestamp();
+        record->id = (uint16_t)id;
+        record->level = (uint8_t)level;
+        record->argc = (uint8_t)argc;
+        record->args[0] = arg0;
+        record->args[1] = arg1;
+        record->args[2] = arg2;
+        record->args[3] = arg3;
+
+        __DMB();
+        trace_commit[index & TRACE_RING_MASK] = index + 1U;
+    }
+}
+
+/*******************************************************************************
+* Function Name: dfu_trace_drain
+********************************************************************************
+* Summary:
+*  Sends as many records as fit in the debug UART TX FIFO and returns without
+*  waiting. Call it from the main loop. Dropped records are reported with a
+*  TRACE_OVERFLOW event.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void dfu_trace_drain(void)
+{
+    uint32_t dropped = trace_dropped;
+
+    if (dropped != trace_dropped_reported)
+    {
+        trace_dropped_reported = dropped;
+        dfu_trace_put(DFU_TRACE_ID_TRACE_OVERFLOW, DFU_TRACE_LEVEL_ERR, 1U, dropped, 0U, 0U, 0U);
+    }
+
+    while (trace_send())
+    {
+        /* Keep filling the TX FIFO */
+    }
+}
+
+/*******************************************************************************
+* Function Name: dfu_trace_flush
+********************************************************************************
+* Summary:
+*  Sends all records and waits until they have left the UART, for example
+*  before a device reset.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void dfu_trace_flush(void)
+{
+    do
+    {
+        dfu_trace_drain();
+    } while (trace_tail != trace_head);
+
+    retarget_io_flush();
+}
+
+#endif /* defined(DFU_TRACE) */
+
+/* [] END OF FILE */
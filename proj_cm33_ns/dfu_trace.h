@@ -0,0 +1,95 @@
+/*******************************************************************************
+* File Name        : dfu_trace.h
+*
+* Description      : This file is the public interface of dfu_trace.c, the
+*                    deferred binary trace for the DFU hot path.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef DFU_TRACE_H
+#define DFU_TRACE_H
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <stdint.h>
+#include "cy_dfu_logging.h"
+#include "dfu_trace_ids.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Number of records in the ring, a power of two */
+#ifndef DFU_TRACE_RING_SIZE
+    #define DFU_TRACE_RING_SIZE     (256U)
+#endif /* DFU_TRACE_RING_SIZE */
+
+/* DFU_TRACEn(level, event, args...) logs an event from dfu_trace_ids.h with n
+ * arguments at level ERR, WRN, INF or DBG. With DFU_TRACE defined, the event
+ * is stored in the trace ring, which takes well under a microsecond and is
+ * safe from interrupts. Otherwise it is printed with CY_DFU_LOG_<level>(). */
+#if defined(DFU_TRACE)
+    #define DFU_TRACE0(level, event) \
+        dfu_trace_put(DFU_TRACE_ID_##event, DFU_TRACE_LEVEL_##level, 0U, 0U, 0U, 0U, 0U)
+    #define DFU_TRACE1(level, event, a) \
+        dfu_trace_put(DFU_TRACE_ID_##event, DFU_TRACE_LEVEL_##level, 1U, (uint32_t)(a), 0U, 0U, 0U)
+    #define DFU_TRACE2(level, event, a, b) \
+        dfu_trace_put(DFU_TRACE_ID_##event, DFU_TRACE_LEVEL_##level, 2U, (uint32_t)(a), (uint32_t)(b), 0U, 0U)
+    #define DFU_TRACE3(level, event, a, b, c) \
+        dfu_trace_put(DFU_TRACE_ID_##event, DFU_TRACE_LEVEL_##level, 3U, (uint32_t)(a), (uint32_t)(b), \
+                      (uint32_t)(c), 0U)
+    #define DFU_TRACE4(level, event, a, b, c, d) \
+        dfu_trace_put(DFU_TRACE_ID_##event, DFU_TRACE_LEVEL_##level, 4U, (uint32_t)(a), (uint32_t)(b), \
+                      (uint32_t)(c), (uint32_t)(d))
+#else
+    #define DFU_TRACE0(level, event) \
+        CY_DFU_LOG_##level(DFU_TRACE_FMT_##event)
+    #define DFU_TRACE1(level, event, a) \
+        CY_DFU_LOG_##level(DFU_TRACE_FMT_##event, (unsigned int)(a))
+    #define DFU_TRACE2(level, event, a, b) \
+        CY_DFU_LOG_##level(DFU_TRACE_FMT_##event, (unsigned int)(a), (unsigned int)(b))
+    #define DFU_TRACE3(level, event, a, b, c) \
+        CY_DFU_LOG_##level(DFU_TRACE_FMT_##event, (unsigned int)(a), (unsigned int)(b), (unsigned int)(c))
+    #define DFU_TRACE4(level, event, a, b, c, d) \
+        CY_DFU_LOG_##level(DFU_TRACE_FMT_##event, (unsigned int)(a), (unsigned int)(b), (unsigned int)(c), \
+                           (unsigned int)(d))
+#endif /* defined(DFU_TRACE) */
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void dfu_trace_init(void);
+void dfu_trace_put(dfu_trace_id_t id, uint32_t level, uint32_t argc,
+                   uint32_t arg0, uint32_t arg1, uint32_t arg2, uint32_t arg3);
+void dfu_trace_drain(void);
+void dfu_trace_flush(void);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* DFU_TRACE_H */
+
+/* [] END OF FILE */
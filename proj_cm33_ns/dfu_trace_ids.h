@@ -0,0 +1,113 @@
+/*******************************************************************************
+* File Name        : dfu_trace_ids.h
+*
+* Description      : This file lists the DFU trace events and their message
+*                    formats. It is shared by the firmware, which stores only
+*                    the event ID and arguments, and by the host decoder in
+*                    tools/dfu_trace, which turns them back into text. Add new
+*                    events at the end so that older captures still decode.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef DFU_TRACE_IDS_H
+#define DFU_TRACE_IDS_H
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Message formats. Every argument is an unsigned 32-bit value. */
+#define DFU_TRACE_FMT_TRACE_START           "Trace started, CPU clock %u Hz"
+#define DFU_TRACE_FMT_TRACE_OVERFLOW        "Trace ring overflow, %u records dropped in total"
+#define DFU_TRACE_FMT_ADDRESS_NOT_CHECKED   "Address validation skipped"
+#define DFU_TRACE_FMT_EXT_WRITE_ROW         "Ext_Flash_WriteRow: address[0x%08X] extmemAddress[0x%08X] length[%u]"
+#define DFU_TRACE_FMT_EXT_NOT_ADDED         "Ext_Flash_WriteRow: External memory not added"
+#define DFU_TRACE_FMT_EXT_ALREADY_ERASED    "Ext_Flash_WriteRow: Memory is already erased"
+#define DFU_TRACE_FMT_EXT_ERASE             "Ext_Flash_WriteRow: Erase Operation - eraseBlockStart[0x%08X] eraseBlockSize[%u]"
+#define DFU_TRACE_FMT_EXT_ERASE_FAILED      "Ext_Flash_WriteRow: Erase failed[%u] - address[0x%08X] eraseBlockStart[0x%08X] eraseBlockSize[%u]"
+#define DFU_TRACE_FMT_EXT_PROGRAM_SIZE      "Ext_Flash_WriteRow: Invalid Program size"
+#define DFU_TRACE_FMT_EXT_WRITE_FAILED      "Ext_Flash_WriteRow: Write failed[%u] - address[0x%08X] length[%u]"
+#define DFU_TRACE_FMT_EXT_READ_FAILED       "Ext_Flash_ReadRow: Read failed[%u] - address[0x%08X] length[%u]"
+#define DFU_TRACE_FMT_NVM_PROGRAM_FAILED    "NVM program failed: module=0x%X code=0x%X"
+#define DFU_TRACE_FMT_NVM_ERASE_FAILED      "NVM erase failed: module=0x%X code=0x%X"
+#define DFU_TRACE_FMT_NVM_WRITE_FAILED      "NVM write failed: fstatus 0x%X "
+#define DFU_TRACE_FMT_WRITE_FAILED          "Write operation failed at address 0x%X"
+#define DFU_TRACE_FMT_RUNNING_SLOT          "Address 0x%08X is in a running slot (DFU_RUNNING_SLOT_GUARD)"
+#define DFU_TRACE_FMT_NOT_IN_UPDATE_SLOT    "Address 0x%08X is not in an update slot (DFU_SLOT_CHECK)"
+#define DFU_TRACE_FMT_IMAGE_REJECTED        "Image rejected with status 0x%02X: slot %u offset 0x%X (DFU_IMAGE_CHECK)"
+#define DFU_TRACE_FMT_IMAGE_TLV_NOT_CHECKED "Protected TLV area of %u bytes not checked (DFU_IMAGE_CHECK)"
+#define DFU_TRACE_FMT_DECRYPT_FAILED        "Decryption failed for image %u (SECURE_DECRYPT)"
+
+/* All events, in ID order. X(event) is expanded once per event. */
+#define DFU_TRACE_EVENTS(X)     \
+    X(TRACE_START)              \
+    X(TRACE_OVERFLOW)           \
+    X(ADDRESS_NOT_CHECKED)      \
+    X(EXT_WRITE_ROW)            \
+    X(EXT_NOT_ADDED)            \
+    X(EXT_ALREADY_ERASED)       \
+    X(EXT_ERASE)                \
+    X(EXT_ERASE_FAILED)         \
+    X(EXT_PROGRAM_SIZE)         \
+    X(EXT_WRITE_FAILED)         \
+    X(EXT_READ_FAILED)          \
+    X(NVM_PROGRAM_FAILED)       \
+    X(NVM_ERASE_FAILED)         \
+    X(NVM_WRITE_FAILED)         \
+    X(WRITE_FAILED)             \
+    X(RUNNING_SLOT)             \
+    X(NOT_IN_UPDATE_SLOT)       \
+    X(IMAGE_REJECTED)           \
+    X(IMAGE_TLV_NOT_CHECKED)    \
+    X(DECRYPT_FAILED)
+
+/* Severity stored with each record, named after CY_DFU_LOG_ERR() etc. */
+#define DFU_TRACE_LEVEL_ERR     (1U)
+#define DFU_TRACE_LEVEL_WRN     (2U)
+#define DFU_TRACE_LEVEL_INF     (3U)
+#define DFU_TRACE_LEVEL_DBG     (4U)
+
+/* Number of arguments in a record */
+#define DFU_TRACE_MAX_ARGS      (4U)
+
+/* Records are sent on the debug UART as DFU_TRACE_SYNC0, DFU_TRACE_SYNC1, the
+ * record in little endian byte order and the 8-bit sum of the record bytes.
+ * Anything between frames is plain text from printf(). */
+#define DFU_TRACE_SYNC0         (0xA5U)
+#define DFU_TRACE_SYNC1         (0x5AU)
+#define DFU_TRACE_RECORD_SIZE   (8U + (4U * DFU_TRACE_MAX_ARGS))
+#define DFU_TRACE_FRAME_SIZE    (2U + DFU_TRACE_RECORD_SIZE + 1U)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+#define DFU_TRACE_ENUM(event)   DFU_TRACE_ID_##event,
+
+typedef enum
+{
+    DFU_TRACE_EVENTS(DFU_TRACE_ENUM)
+    DFU_TRACE_ID_COUNT
+} dfu_trace_id_t;
+
+#undef DFU_TRACE_ENUM
+
+#endif /* DFU_TRACE_IDS_H */
+
+/* [] END OF FILE */
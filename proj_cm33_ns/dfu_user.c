@@ -46,6 +46,12 @@
 #include "cy_dfu.h"
 #include "cy_dfu_logging.h"
 #include "mtb_hal_system.h"
+#include "dfu_user_transport.h"
+#include "dfu_crc.h"
+#include "boot_time.h"
+#include "dfu_perf.h"
+#include "dfu_record.h"
+#include "dfu_trace.h"
 
 #if (CY_DFU_OPT_EXTERNAL_MEMORY == 0U)
     #include "mtb_hal_nvm.h"
@@ -63,6 +69,13 @@
     #include "transport_spi.h"
 #endif /* COMPONENT_DFU_SPI*/
 
+#ifdef COMPONENT_DFU_SPI_DMA
+    #if defined(COMPONENT_DFU_SPI)
+        #error "DFU_SPI and DFU_SPI_DMA components both serve CY_DFU_SPI, enable only one of them."
+    #endif /* defined(COMPONENT_DFU_SPI) */
+    #include "transport_spi_dma.h"
+#endif /* COMPONENT_DFU_SPI_DMA */
+
 #ifdef COMPONENT_DFU_USB_CDC
     #include "transport_usb_cdc.h"
 #endif /* COMPONENT_DFU_USB_CDC */
@@ -79,9 +92,16 @@
     #include "transport_canfd.h"
 #endif /* COMPONENT_DFU_CANFD */
 
+#ifdef COMPONENT_DFU_CANFD_ISOTP
+    #if defined(COMPONENT_DFU_CANFD)
+        #error "DFU_CANFD and DFU_CANFD_ISOTP components both serve CY_DFU_CANFD, enable only one of them."
+    #endif /* defined(COMPONENT_DFU_CANFD) */
+    #include "transport_canfd_isotp.h"
+#endif /* COMPONENT_DFU_CANFD_ISOTP */
+
 #if !defined(COMPONENT_DFU_I2C) && !defined(COMPONENT_DFU_UART) && !defined(COMPONENT_DFU_SPI) &&                \
     !defined(COMPONENT_DFU_USB_CDC) && !defined(COMPONENT_DFU_EMUSB_CDC) && !defined(COMPONENT_DFU_EMUSB_HID) && \
-    !defined(COMPONENT_DFU_CANFD)
+    !defined(COMPONENT_DFU_CANFD) && !defined(COMPONENT_DFU_SPI_DMA) && !defined(COMPONENT_DFU_CANFD_ISOTP)
     #warning "Select at least one of the DFU transports."
 #endif /* !defined(COMPONENT_DFU_I2C) ... !defined(COMPONENT_DFU_CANFD) */
 
@@ -96,7 +116,111 @@
     #endif /* CY_EXT_NVM1_BASE */
 #endif /* CY_DFU_OPT_EXTERNAL_MEMORY != 0U */
 
+#if defined(DFU_RUNNING_SLOT_GUARD)
+    /* Images the running application executes from, as {start, size}. DFU
+     * only refuses these; the host must send images built for the other
+     * slots, as rows are not moved to them. */
+    #ifndef DFU_GUARD_SLOTS
+        #include "cybsp.h"
+
+        #if defined(CYMEM_CM33_0_m33s_nvm_START)
+            #define DFU_GUARD_SLOT_S        { CYMEM_CM33_0_m33s_nvm_START, CYMEM_CM33_0_m33s_nvm_SIZE },
+        #else
+            #define DFU_GUARD_SLOT_S
+        #endif /* defined(CYMEM_CM33_0_m33s_nvm_START) */
+        #define DFU_GUARD_SLOTS                                             \
+            DFU_GUARD_SLOT_S                                                \
+            { CYMEM_CM33_0_m33_nvm_START, CYMEM_CM33_0_m33_nvm_SIZE },      \
+            { CYMEM_CM33_0_m55_nvm_START, CYMEM_CM33_0_m55_nvm_SIZE }
+    #endif /* DFU_GUARD_SLOTS */
+
+    /* Offset in the external memory, whichever XIP alias an address uses */
+    #define XIP_MEMORY_OFFSET(address)  ((uint32_t)(address) & (CY_EXT_NVM0_SIZE - 1U))
+#endif /* defined(DFU_RUNNING_SLOT_GUARD) */
+
+/* The options that need to know the update slot of a row */
+#if defined(DFU_SLOT_CHECK) || defined(DFU_IMAGE_CHECK) || defined(SECURE_VERIFY) || defined(SECURE_DECRYPT)
+    #define DFU_UPDATE_SLOT_TABLE
+#endif /* defined(DFU_SLOT_CHECK) || defined(DFU_IMAGE_CHECK) || defined(SECURE_VERIFY) || defined(SECURE_DECRYPT) */
+
+#if defined(DFU_UPDATE_SLOT_TABLE)
+    /* Update slots as {start, size}, indexed by MCUboot image ID: the
+     * secondary slots of proj_cm33_s, proj_cm33_ns and proj_cm55 that the
+     * Edge Protect Bootloader installs from. DFU only writes inside them. */
+    #ifndef DFU_UPDATE_SLOTS
+        #include "cybsp.h"
+
+        #define DFU_UPDATE_SLOTS                                                            \
+            { CYMEM_CM33_0_m33s_upgrade_slot_START, CYMEM_CM33_0_m33s_upgrade_slot_SIZE },  \
+            { CYMEM_CM33_0_m33_upgrade_slot_START, CYMEM_CM33_0_m33_upgrade_slot_SIZE },    \
+            { CYMEM_CM33_0_m55_upgrade_slot_START, CYMEM_CM33_0_m55_upgrade_slot_SIZE }
+    #endif /* DFU_UPDATE_SLOTS */
+
+    #ifndef XIP_MEMORY_OFFSET
+        #define XIP_MEMORY_OFFSET(address)  ((uint32_t)(address) & (CY_EXT_NVM0_SIZE - 1U))
+    #endif /* XIP_MEMORY_OFFSET */
+
+    /* Returned by FindUpdateSlot() for an address outside the update slots */
+    #define NO_UPDATE_SLOT                  (0xFFFFFFFFU)
+#endif /* defined(DFU_UPDATE_SLOT_TABLE) */
+
+#if defined(SECURE_DECRYPT)
+    #include "secure_decrypt.h"
+#endif /* defined(SECURE_DECRYPT) */
+
+#if defined(DFU_BACKGROUND)
+    #include "dfu_service.h"
+#endif /* defined(DFU_BACKGROUND) */
+
+#if (CY_DFU_OPT_EXTERNAL_MEMORY != 0U)
+    #if defined(DFU_XIP_QOS)
+        #include "dfu_xip_qos.h"
+
+        /* Erases and writes in short operations within the duty cycle limit,
+         * see dfu_xip_qos.h */
+        #define EXT_MEM_ERASE(obj, address, length)         dfu_xip_qos_erase((obj), (address), (length))
+        #define EXT_MEM_WRITE(obj, address, length, data)   dfu_xip_qos_write((obj), (address), (length), (data))
+    #else
+        #define EXT_MEM_ERASE(obj, address, length)         mtb_serial_memory_erase((obj), (address), (length))
+        #define EXT_MEM_WRITE(obj, address, length, data)   mtb_serial_memory_write((obj), (address), (length), (data))
+    #endif /* defined(DFU_XIP_QOS) */
+#endif /* (CY_DFU_OPT_EXTERNAL_MEMORY != 0U) */
+
+#if defined(DFU_IMAGE_CHECK)
+    #include "dfu_image_check.h"
+
+    /* Primary slots of the images, mapped in memory, in the order of
+     * DFU_UPDATE_SLOTS. The image in each is what an update must not roll
+     * back. The secure image cannot be read from here, so it is 0U. */
+    #ifndef DFU_RUNNING_IMAGES
+        #include "cybsp.h"
+
+        #define DFU_RUNNING_IMAGES          0U, CYMEM_CM33_0_m33_nvm_START, CYMEM_CM33_0_m55_nvm_START
+    #endif /* DFU_RUNNING_IMAGES */
+#endif /* defined(DFU_IMAGE_CHECK) */
+
 #define SECURE_REGION_MASK (0x10000000u)
+
+/* DFU packet layout, used to detect the Enter DFU command when several
+ * transports listen at once */
+#define PACKET_SOP              (0x01U)
+#define PACKET_EOP              (0x17U)
+#define PACKET_CMD_ENTER        (0x38U)
+#define PACKET_SOP_IDX          (0x00U)
+#define PACKET_CMD_IDX          (0x01U)
+#define PACKET_LENGTH_IDX       (0x02U)
+#define PACKET_DATA_IDX         (0x04U)
+#define PACKET_MIN_SIZE         (0x07U)
+
+/* DFU response status codes */
+#define PACKET_STATUS_SUCCESS   (0x00U)
+#define PACKET_STATUS_LENGTH    (0x03U)
+#define PACKET_STATUS_DATA      (0x04U)
+#define PACKET_STATUS_CHECKSUM  (0x08U)
+
+/* Time allowed to send the response to a statistics or boot timeline
+ * command */
+#define DFU_STATS_RESPONSE_TIMEOUT_MS   (20U)
 /* Global NVM object */
 #if (CY_DFU_OPT_EXTERNAL_MEMORY == 0U)
     #if !defined CY_IP_MXS40SSRSS || !defined COMPONENT_NON_SECURE_DEVICE
@@ -115,6 +239,24 @@ void Cy_DFU_AddExtMemory(mtb_serial_memory_t *serialMemObj)
 
     static cy_en_dfu_transport_t selectedInterface = CY_DFU_UART;
 
+/* Transports listened to concurrently, see Cy_DFU_TransportStartMulti().
+ * listenCount is zero when a single transport was started. */
+static cy_en_dfu_transport_t listenInterfaces[CY_DFU_MAX_LISTEN_TRANSPORTS];
+static uint32_t listenCount = 0U;
+static uint32_t listenNext = 0U;
+static bool sessionLocked = false;
+static bool selectPinned = false;
+
+#if defined(SECURE_VERIFY)
+/* Update slots written in this session, see Cy_DFU_GetUpdatedSlots() */
+static uint32_t updatedSlots = 0U;
+#endif /* defined(SECURE_VERIFY) */
+
+#if defined(SECURE_DECRYPT)
+/* Update slots whose rows are encrypted in this session, bit n for image ID n */
+static uint32_t decryptSlots = 0U;
+#endif /* defined(SECURE_DECRYPT) */
+
 #ifdef CY_IP_M7CPUSS
     static const mtb_hal_nvm_region_info_t *blocks_info;
     static uint8_t blocks_count;
@@ -138,11 +280,49 @@ static const uint32_t cy_dfu_metadata[CY_FLASH_SIZEOF_ROW / sizeof(uint32_t)] =
 
 static bool IsMultipleOf(uint32_t value, uint32_t multiple);
 static bool AddressValid(uint32_t address, cy_stc_dfu_params_t *params);
+#if defined(DFU_RUNNING_SLOT_GUARD)
+static bool InRunningSlot(uint32_t address);
+#endif /* defined(DFU_RUNNING_SLOT_GUARD) */
+#if defined(DFU_UPDATE_SLOT_TABLE)
+static uint32_t FindUpdateSlot(uint32_t address, uint32_t *offset, uint32_t *size);
+#endif /* defined(DFU_UPDATE_SLOT_TABLE) */
+#if defined(DFU_IMAGE_CHECK)
+static cy_en_dfu_status_t CheckImageRow(uint32_t address, uint32_t length, const uint8_t data[]);
+#endif /* defined(DFU_IMAGE_CHECK) */
 
 #if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
 static void GetStartEndAddress(uint32_t appId, uint32_t *startAddress, uint32_t *endAddress);
 #endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
 
+static bool IsValidPacket(const uint8_t buffer[], uint32_t count);
+static void SessionReset(void);
+#if defined(DFU_PERF) || defined(BOOT_TIME) || defined(SECURE_DECRYPT)
+static void SendResponse(cy_en_dfu_transport_t transport, uint8_t status, const uint8_t data[], uint32_t length);
+#endif /* defined(DFU_PERF) || defined(BOOT_TIME) || defined(SECURE_DECRYPT) */
+#if defined(DFU_PERF)
+static bool HandleStatsCommand(cy_en_dfu_transport_t transport, const uint8_t buffer[], uint32_t count);
+#else
+    #define HandleStatsCommand(transport, buffer, count)    (false)
+#endif /* defined(DFU_PERF) */
+#if defined(BOOT_TIME)
+static bool HandleBootTimeCommand(cy_en_dfu_transport_t transport, const uint8_t buffer[], uint32_t count);
+#else
+    #define HandleBootTimeCommand(transport, buffer, count) (false)
+#endif /* defined(BOOT_TIME) */
+#if defined(SECURE_DECRYPT)
+static bool HandleDecryptCommand(cy_en_dfu_transport_t transport, const uint8_t buffer[], uint32_t count);
+static cy_en_dfu_status_t DecryptRow(uint32_t address, uint32_t length, uint8_t data[]);
+#else
+    #define HandleDecryptCommand(transport, buffer, count)  (false)
+#endif /* defined(SECURE_DECRYPT) */
+static void TransportStart(cy_en_dfu_transport_t transport);
+static void TransportStop(cy_en_dfu_transport_t transport);
+static void TransportReset(cy_en_dfu_transport_t transport);
+static cy_en_dfu_status_t TransportRead(cy_en_dfu_transport_t transport, uint8_t buffer[], uint32_t size,
+                                        uint32_t *count, uint32_t timeout);
+static cy_en_dfu_status_t TransportWrite(cy_en_dfu_transport_t transport, uint8_t buffer[], uint32_t size,
+                                         uint32_t *count, uint32_t timeout);
+
 #if (CY_DFU_OPT_EXTERNAL_MEMORY != 0U)
 static cy_en_dfu_status_t Ext_Flash_WriteRow(uint32_t address, size_t length, cy_stc_dfu_params_t *params);
 static cy_en_dfu_status_t Ext_Flash_ReadRow(uint32_t address, size_t length, uint8_t *data);
@@ -166,6 +346,336 @@ static bool IsMultipleOf(uint32_t value, uint32_t multiple)
     return ((value % multiple) == 0U);
 }
 
+/*******************************************************************************
+ * Function Name: IsValidPacket
+ *******************************************************************************
+ *
+ * This internal function checks whether a received buffer holds a complete,
+ * well formed DFU command packet.
+ *
+ * \param buffer     The received data.
+ * \param count      The number of bytes received.
+ *
+ * \return True - the buffer holds a valid DFU packet
+ *
+ *******************************************************************************/
+static bool IsValidPacket(const uint8_t buffer[], uint32_t count)
+{
+    bool valid = false;
+    uint32_t length;
+
+    if (count >= PACKET_MIN_SIZE)
+    {
+        length = (uint32_t)buffer[PACKET_LENGTH_IDX] |
+                 ((uint32_t)buffer[PACKET_LENGTH_IDX + 1U] << 8U);
+
+        valid = (buffer[PACKET_SOP_IDX] == PACKET_SOP) &&
+                (count == (length + PACKET_MIN_SIZE)) &&
+                (buffer[count - 1U] == PACKET_EOP) &&
+                (dfu_packet_checksum(buffer, length + PACKET_DATA_IDX) ==
+                 (uint16_t)((uint16_t)buffer[count - 3U] | ((uint16_t)buffer[count - 2U] << 8U)));
+    }
+
+    return valid;
+}
+
+/*******************************************************************************
+ * Function Name: SessionReset
+ *******************************************************************************
+ *
+ * This internal function forgets the state of the previous DFU session. It is
+ * called on every valid Enter DFU command, whether a single transport was
+ * started or the command locked a listening transport.
+ *
+ *******************************************************************************/
+static void SessionReset(void)
+{
+#if defined(DFU_IMAGE_CHECK)
+    dfu_image_check_reset();
+#endif /* defined(DFU_IMAGE_CHECK) */
+#if defined(SECURE_VERIFY)
+    updatedSlots = 0U;
+#endif /* defined(SECURE_VERIFY) */
+#if defined(SECURE_DECRYPT)
+    decryptSlots = 0U;
+#endif /* defined(SECURE_DECRYPT) */
+}
+
+#if defined(DFU_PERF) || defined(BOOT_TIME) || defined(SECURE_DECRYPT)
+/*******************************************************************************
+ * Function Name: SendResponse
+ *******************************************************************************
+ *
+ * This internal function frames and sends a response to a command that is
+ * handled here instead of by the DFU middleware.
+ *
+ * \param transport  The transport the command came from.
+ * \param status     The response status code.
+ * \param data       The response data.
+ * \param length     The number of bytes in data.
+ *
+ *******************************************************************************/
+static void SendResponse(cy_en_dfu_transport_t transport, uint8_t status, const uint8_t data[], uint32_t length)
+{
+    static uint8_t response[PACKET_MIN_SIZE + 3U +
+                            ((DFU_PERF_CHUNK_SIZE > BOOT_TIME_CHUNK_SIZE) ? DFU_PERF_CHUNK_SIZE : BOOT_TIME_CHUNK_SIZE)];
+    uint16_t checksum;
+    uint32_t count;
+
+    response[PACKET_SOP_IDX] = PACKET_SOP;
+    response[PACKET_CMD_IDX] = status;
+    response[PACKET_LENGTH_IDX] = (uint8_t)length;
+    response[PACKET_LENGTH_IDX + 1U] = (uint8_t)(length >> 8U);
+    if (length != 0U)
+    {
+        (void)memcpy(&response[PACKET_DATA_IDX], data, length);
+    }
+    checksum = dfu_packet_checksum(response, PACKET_DATA_IDX + length);
+    response[PACKET_DATA_IDX + length] = (uint8_t)checksum;
+    response[PACKET_DATA_IDX + length + 1U] = (uint8_t)(checksum >> 8U);
+    response[PACKET_DATA_IDX + length + 2U] = PACKET_EOP;
+
+    (void)TransportWrite(transport, response, length + PACKET_MIN_SIZE, &count, DFU_STATS_RESPONSE_TIMEOUT_MS);
+}
+#endif /* defined(DFU_PERF) || defined(BOOT_TIME) || defined(SECURE_DECRYPT) */
+
+#if defined(DFU_PERF)
+/*******************************************************************************
+ * Function Name: HandleStatsCommand
+ *******************************************************************************
+ *
+ * This internal function answers the performance statistics commands, see
+ * dfu_perf.h. They are handled here so that they work in every DFU state,
+ * also before an Enter DFU command and after a session has ended. An Enter
+ * DFU command clears the statistics, so they cover one session.
+ *
+ * \param transport  The transport the packet came from.
+ * \param buffer     The received packet.
+ * \param count      The number of bytes received.
+ *
+ * \return True - the packet was a statistics command and has been answered
+ *
+ *******************************************************************************/
+static bool HandleStatsCommand(cy_en_dfu_transport_t transport, const uint8_t buffer[], uint32_t count)
+{
+    bool handled = false;
+    uint8_t data[3U + DFU_PERF_CHUNK_SIZE];
+    uint32_t length;
+    uint32_t offset;
+    uint32_t command = (count >= PACKET_MIN_SIZE) ? buffer[PACKET_CMD_IDX] : 0U;
+
+    if (command == PACKET_CMD_ENTER)
+    {
+        dfu_perf_reset();
+    }
+    else if ((command == DFU_PERF_CMD_GET_STATS) || (command == DFU_PERF_CMD_RESET_STATS) ||
+             (command == DFU_PERF_CMD_GET_CMD_STATS))
+    {
+        handled = true;
+
+        if (!IsValidPacket(buffer, count))
+        {
+            SendResponse(transport, PACKET_STATUS_CHECKSUM, NULL, 0U);
+        }
+        else if (command == DFU_PERF_CMD_RESET_STATS)
+        {
+            dfu_perf_reset();
+            SendResponse(transport, PACKET_STATUS_SUCCESS, NULL, 0U);
+        }
+        else if (count != (PACKET_MIN_SIZE + 3U))
+        {
+            SendResponse(transport, PACKET_STATUS_LENGTH, NULL, 0U);
+        }
+        else if (command == DFU_PERF_CMD_GET_CMD_STATS)
+        {
+            /* A slot past the ones in use returns only the header, which
+             * tells the host how many slots there are */
+            offset = (uint32_t)buffer[PACKET_DATA_IDX + 1U] | ((uint32_t)buffer[PACKET_DATA_IDX + 2U] << 8U);
+            length = dfu_perf_get_cmd_stats(buffer[PACKET_DATA_IDX], offset, &data[3], DFU_PERF_CHUNK_SIZE);
+            data[0] = (uint8_t)dfu_perf_get_cmd_slots();
+            data[1] = (uint8_t)DFU_PERF_CMD_STATS_SIZE;
+            data[2] = (uint8_t)(DFU_PERF_CMD_STATS_SIZE >> 8U);
+            SendResponse(transport, PACKET_STATUS_SUCCESS, data, length + 3U);
+        }
+        else
+        {
+            offset = (uint32_t)buffer[PACKET_DATA_IDX + 1U] | ((uint32_t)buffer[PACKET_DATA_IDX + 2U] << 8U);
+            length = dfu_perf_get_stats(buffer[PACKET_DATA_IDX], offset, &data[3], DFU_PERF_CHUNK_SIZE);
+            if (length != 0U)
+            {
+                data[0] = (uint8_t)DFU_PERF_PHASE_COUNT;
+                data[1] = (uint8_t)DFU_PERF_STATS_SIZE;
+                data[2] = (uint8_t)(DFU_PERF_STATS_SIZE >> 8U);
+                SendResponse(transport, PACKET_STATUS_SUCCESS, data, length + 3U);
+            }
+            else
+            {
+                SendResponse(transport, PACKET_STATUS_DATA, NULL, 0U);
+            }
+        }
+    }
+    else
+    {
+        /* Not a statistics command, the DFU middleware handles it */
+    }
+
+    return handled;
+}
+#endif /* defined(DFU_PERF) */
+
+#if defined(BOOT_TIME)
+/*******************************************************************************
+ * Function Name: HandleBootTimeCommand
+ *******************************************************************************
+ *
+ * This internal function answers the boot timeline command, see
+ * shared/include/boot_time.h. Like the statistics commands it works in every
+ * DFU state.
+ *
+ * \param transport  The transport the packet came from.
+ * \param buffer     The received packet.
+ * \param count      The number of bytes received.
+ *
+ * \return True - the packet was a boot timeline command and has been answered
+ *
+ *******************************************************************************/
+static bool HandleBootTimeCommand(cy_en_dfu_transport_t transport, const uint8_t buffer[], uint32_t count)
+{
+    bool handled = false;
+    uint8_t data[3U + BOOT_TIME_CHUNK_SIZE];
+    uint32_t length;
+    uint32_t offset;
+
+    if ((count >= PACKET_MIN_SIZE) && (buffer[PACKET_CMD_IDX] == BOOT_TIME_CMD_GET))
+    {
+        handled = true;
+
+        if (!IsValidPacket(buffer, count))
+        {
+            SendResponse(transport, PACKET_STATUS_CHECKSUM, NULL, 0U);
+        }
+        else if (count != (PACKET_MIN_SIZE + 3U))
+        {
+            SendResponse(transport, PACKET_STATUS_LENGTH, NULL, 0U);
+        }
+        else
+        {
+            offset = (uint32_t)buffer[PACKET_DATA_IDX + 1U] | ((uint32_t)buffer[PACKET_DATA_IDX + 2U] << 8U);
+            length = boot_time_get(offset, &data[3], BOOT_TIME_CHUNK_SIZE);
+            if (length != 0U)
+            {
+                data[0] = (uint8_t)BOOT_TIME_MARK_COUNT;
+                data[1] = (uint8_t)BOOT_TIME_RECORD_SIZE;
+                data[2] = (uint8_t)(BOOT_TIME_RECORD_SIZE >> 8U);
+                SendResponse(transport, PACKET_STATUS_SUCCESS, data, length + 3U);
+            }
+            else
+            {
+                SendResponse(transport, PACKET_STATUS_DATA, NULL, 0U);
+            }
+        }
+    }
+
+    return handled;
+}
+#endif /* defined(BOOT_TIME) */
+
+#if defined(SECURE_DECRYPT)
+/*******************************************************************************
+ * Function Name: HandleDecryptCommand
+ *******************************************************************************
+ *
+ * This internal function answers the command that starts the encrypted stream
+ * of an image, see shared/include/secure_decrypt.h. It is only handled in a
+ * DFU session, and the rows of the image are decrypted until the session
+ * ends.
+ *
+ * \param transport  The transport the packet came from.
+ * \param buffer     The received packet.
+ * \param count      The number of bytes received.
+ *
+ * \return True - the packet was the command and has been answered
+ *
+ *******************************************************************************/
+static bool HandleDecryptCommand(cy_en_dfu_transport_t transport, const uint8_t buffer[], uint32_t count)
+{
+    bool handled = false;
+    uint32_t imageId;
+    uint32_t nonce[2];
+
+    if ((count >= PACKET_MIN_SIZE) && (buffer[PACKET_CMD_IDX] == SECURE_DECRYPT_CMD_START))
+    {
+        handled = true;
+
+        if (!IsValidPacket(buffer, count))
+        {
+            SendResponse(transport, PACKET_STATUS_CHECKSUM, NULL, 0U);
+        }
+        else if (count != (PACKET_MIN_SIZE + 1U + SECURE_DECRYPT_NONCE_SIZE))
+        {
+            SendResponse(transport, PACKET_STATUS_LENGTH, NULL, 0U);
+        }
+        else
+        {
+            imageId = buffer[PACKET_DATA_IDX];
+            for (uint32_t word = 0U; word < 2U; word++)
+            {
+                const uint8_t *src = &buffer[PACKET_DATA_IDX + 1U + (4U * word)];
+
+                nonce[word] = (uint32_t)src[0] | ((uint32_t)src[1] << 8U) | ((uint32_t)src[2] << 16U) |
+                              ((uint32_t)src[3] << 24U);
+            }
+
+            if ((imageId < 32U) && (secure_decrypt_start(imageId, nonce[0], nonce[1]) == SECURE_DECRYPT_STATUS_OK))
+            {
+                decryptSlots |= 1UL << imageId;
+                SendResponse(transport, PACKET_STATUS_SUCCESS, NULL, 0U);
+            }
+            else
+            {
+                DFU_TRACE1(ERR, DECRYPT_FAILED, imageId);
+                SendResponse(transport, PACKET_STATUS_DATA, NULL, 0U);
+            }
+        }
+    }
+
+    return handled;
+}
+
+/*******************************************************************************
+ * Function Name: DecryptRow
+ *******************************************************************************
+ *
+ * This internal function decrypts a row in place with the secure image if its
+ * update slot has an encrypted stream in this session. Other rows are written
+ * as received.
+ *
+ * \param address    The address of the row, on port 0 of the XIP.
+ * \param length     The size of the row.
+ * \param data       The row data.
+ *
+ * \return CY_DFU_SUCCESS, or CY_DFU_ERROR_DATA if the row cannot be decrypted
+ *
+ *******************************************************************************/
+static cy_en_dfu_status_t DecryptRow(uint32_t address, uint32_t length, uint8_t data[])
+{
+    uint32_t offset = 0U;
+    uint32_t slot = FindUpdateSlot(address, &offset, NULL);
+
+    if ((slot == NO_UPDATE_SLOT) || ((decryptSlots & (1UL << slot)) == 0U))
+    {
+        return CY_DFU_SUCCESS;
+    }
+    if (secure_decrypt_row(slot, offset, data, length) != SECURE_DECRYPT_STATUS_OK)
+    {
+        DFU_TRACE1(ERR, DECRYPT_FAILED, slot);
+        return CY_DFU_ERROR_DATA;
+    }
+
+    return CY_DFU_SUCCESS;
+}
+#endif /* defined(SECURE_DECRYPT) */
+
 /*******************************************************************************
  * Function Name: AddressValid
  *******************************************************************************
@@ -192,6 +702,16 @@ static bool AddressValid(uint32_t address, cy_stc_dfu_params_t *params)
     #if (CY_DFU_OPT_EXTERNAL_MEMORY != 0U) /* External memory */
         addrValid = ((CY_EXT_NVM0_BASE <= address) && (address < (CY_EXT_NVM0_BASE + CY_EXT_NVM0_SIZE))) ||
                     ((CY_EXT_NVM1_BASE <= address) && (address < (CY_EXT_NVM1_BASE + CY_EXT_NVM1_SIZE)));
+        #if defined(DFU_RUNNING_SLOT_GUARD)
+            addrValid = addrValid && (!InRunningSlot(address));
+        #endif /* defined(DFU_RUNNING_SLOT_GUARD) */
+        #if defined(DFU_SLOT_CHECK)
+            if (addrValid && (FindUpdateSlot(address, NULL, NULL) == NO_UPDATE_SLOT))
+            {
+                DFU_TRACE1(ERR, NOT_IN_UPDATE_SLOT, address);
+                addrValid = false;
+            }
+        #endif /* defined(DFU_SLOT_CHECK) */
         CY_UNUSED_PARAMETER(params);
     #else                                  /* Internal memory */
         #ifdef CY_IP_M7CPUSS
@@ -211,7 +731,7 @@ static bool AddressValid(uint32_t address, cy_stc_dfu_params_t *params)
             #if defined CY_FLASH_BASE
                 addrValid = (CY_FLASH_BASE <= address) && (address < (CY_FLASH_BASE + CY_FLASH_SIZE));
             #else
-                CY_DFU_LOG_WRN("Address validation skipped");
+                DFU_TRACE0(WRN, ADDRESS_NOT_CHECKED);
                 CY_UNUSED_PARAMETER(address);
             #endif /* defined CY_FLASH_BASE */
             CY_UNUSED_PARAMETER(params);
@@ -222,6 +742,144 @@ static bool AddressValid(uint32_t address, cy_stc_dfu_params_t *params)
     return addrValid;
 }
 
+#if defined(DFU_RUNNING_SLOT_GUARD)
+/*******************************************************************************
+ * Function Name: InRunningSlot
+ *******************************************************************************
+ *
+ * This internal function checks whether an address of the external memory is
+ * in the slot of an image that is running, see DFU_GUARD_SLOTS.
+ *
+ * \param address    The address to check, on port 0 of the XIP.
+ *
+ * \return True - the address is in a running slot
+ *
+ *******************************************************************************/
+static bool InRunningSlot(uint32_t address)
+{
+    static const struct
+    {
+        uint32_t start;
+        uint32_t size;
+    } runningSlots[] = { DFU_GUARD_SLOTS };
+    bool running = false;
+
+    if ((CY_EXT_NVM0_BASE <= address) && (address < (CY_EXT_NVM0_BASE + CY_EXT_NVM0_SIZE)))
+    {
+        uint32_t offset = address - CY_EXT_NVM0_BASE;
+
+        for (uint32_t idx = 0U; (idx < (sizeof(runningSlots) / sizeof(runningSlots[0]))) && (!running); idx++)
+        {
+            uint32_t start = XIP_MEMORY_OFFSET(runningSlots[idx].start);
+
+            running = (start <= offset) && (offset < (start + runningSlots[idx].size));
+        }
+    }
+
+    if (running)
+    {
+        DFU_TRACE1(ERR, RUNNING_SLOT, address);
+    }
+
+    return running;
+}
+#endif /* defined(DFU_RUNNING_SLOT_GUARD) */
+
+#if defined(DFU_UPDATE_SLOT_TABLE)
+/*******************************************************************************
+ * Function Name: FindUpdateSlot
+ *******************************************************************************
+ *
+ * This internal function finds the update slot of one of the images, see
+ * DFU_UPDATE_SLOTS, that an address of the external memory is in. Slots start
+ * and end on a row boundary, so a row that starts in a slot ends in it.
+ *
+ * \param address    The address to find, on port 0 of the XIP.
+ * \param offset     The offset of the address in the slot, or NULL.
+ * \param size       The size of the slot, or NULL.
+ *
+ * \return The index of the slot, the MCUboot image ID, or NO_UPDATE_SLOT
+ *
+ *******************************************************************************/
+static uint32_t FindUpdateSlot(uint32_t address, uint32_t *offset, uint32_t *size)
+{
+    static const struct
+    {
+        uint32_t start;
+        uint32_t size;
+    } updateSlots[] = { DFU_UPDATE_SLOTS };
+    uint32_t slot = NO_UPDATE_SLOT;
+
+    if ((CY_EXT_NVM0_BASE <= address) && (address < (CY_EXT_NVM0_BASE + CY_EXT_NVM0_SIZE)))
+    {
+        uint32_t memOffset = address - CY_EXT_NVM0_BASE;
+
+        for (uint32_t idx = 0U; (idx < (sizeof(updateSlots) / sizeof(updateSlots[0]))) &&
+                                (slot == NO_UPDATE_SLOT); idx++)
+        {
+            uint32_t start = XIP_MEMORY_OFFSET(updateSlots[idx].start);
+
+            if ((start <= memOffset) && (memOffset < (start + updateSlots[idx].size)))
+            {
+                slot = idx;
+                if (offset != NULL)
+                {
+                    *offset = memOffset - start;
+                }
+                if (size != NULL)
+                {
+                    *size = updateSlots[idx].size;
+                }
+            }
+        }
+    }
+
+    return slot;
+}
+#endif /* defined(DFU_UPDATE_SLOT_TABLE) */
+
+#if defined(DFU_IMAGE_CHECK)
+/*******************************************************************************
+ * Function Name: CheckImageRow
+ *******************************************************************************
+ *
+ * This internal function runs the early image check of dfu_image_check.c on a
+ * row that is about to be written to an update slot. Rows outside the update
+ * slots are not checked.
+ *
+ * \param address    The address of the row, on port 0 of the XIP.
+ * \param length     The size of the row.
+ * \param data       The row data.
+ *
+ * \return CY_DFU_SUCCESS, or the DFU_IMAGE_STATUS_xxx that rejects the image
+ *
+ *******************************************************************************/
+static cy_en_dfu_status_t CheckImageRow(uint32_t address, uint32_t length, const uint8_t data[])
+{
+    static const uintptr_t runningImages[] = { DFU_RUNNING_IMAGES };
+    uint32_t offset = 0U;
+    uint32_t size = 0U;
+    uint32_t slot = FindUpdateSlot(address, &offset, &size);
+    const uint8_t *running = NULL;
+    uint32_t status;
+
+    if (slot == NO_UPDATE_SLOT)
+    {
+        return CY_DFU_SUCCESS;
+    }
+    if (slot < (sizeof(runningImages) / sizeof(runningImages[0])))
+    {
+        running = (const uint8_t *)runningImages[slot];
+    }
+
+    status = dfu_image_check_row(slot, size, running, offset, data, length);
+
+    /* The host gets the low byte, keep the middleware bits of the error codes */
+    return (status == DFU_IMAGE_STATUS_OK) ? CY_DFU_SUCCESS :
+           (cy_en_dfu_status_t)(((uint32_t)CY_DFU_ERROR_UNKNOWN & ~0xFFU) | status);
+}
+#endif /* defined(DFU_IMAGE_CHECK) */
+
 #if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
 /*******************************************************************************
  * Function Name: GetStartEndAddress
@@ -278,13 +936,12 @@ static cy_en_dfu_status_t Ext_Flash_WriteRow(uint32_t address, size_t length, cy
     static size_t lastErasedBlockEnd = 0;
     uint32_t extmemAddress = ((address) - (CY_EXT_NVM0_BASE));
 
-    CY_DFU_LOG_DBG("Ext_Flash_WriteRow: address[%p] extmemAddress[%p] length[%u]",
-                   (void *)address, (void *)extmemAddress, length);
+    DFU_TRACE3(DBG, EXT_WRITE_ROW, address, extmemAddress, length);
 
     if (serialMemObjPtr == NULL)
     {
         status = CY_DFU_ERROR_READ_EXT;
-        CY_DFU_LOG_ERR("Ext_Flash_WriteRow: External memory not added");
+        DFU_TRACE0(ERR, EXT_NOT_ADDED);
     }
     else
     {
@@ -296,7 +953,9 @@ static cy_en_dfu_status_t Ext_Flash_WriteRow(uint32_t address, size_t length, cy
             /* The address is expected to be valid and aligned with external memory
              * Erase command rules.
              */
-            cy_rslt_t extstatus = mtb_serial_memory_erase(serialMemObjPtr, extmemAddress, eraseBlockSize);
+            DFU_PERF_BEGIN(perfErase);
+            cy_rslt_t extstatus = EXT_MEM_ERASE(serialMemObjPtr, extmemAddress, eraseBlockSize);
+            DFU_PERF_END(DFU_PERF_FLASH_ERASE, perfErase);
             status = (extstatus == CY_RSLT_SUCCESS) ? CY_DFU_SUCCESS : CY_DFU_ERROR_WRITE_EXT;
         }
         else /* Write command */
@@ -306,7 +965,7 @@ static cy_en_dfu_status_t Ext_Flash_WriteRow(uint32_t address, size_t length, cy
             if ((lastErasedBlockStart <= extmemAddress) && ((extmemAddress + length) <= lastErasedBlockEnd))
             {
                 /* Required memory is already erased */
-                CY_DFU_LOG_DBG("Ext_Flash_WriteRow: Memory is already erased");
+                DFU_TRACE0(DBG, EXT_ALREADY_ERASED);
             }
             else
             {
@@ -315,12 +974,13 @@ static cy_en_dfu_status_t Ext_Flash_WriteRow(uint32_t address, size_t length, cy
                 /* The size of memory to erase:
                  * the last sector address - the first sector address + the last sector size */
                 eraseBlockSize = (size_t)mtb_serial_memory_get_sector_start_address(serialMemObjPtr, extmemAddress + (length - 1U)) -
-                                 extmemAddress + mtb_serial_memory_get_erase_size(serialMemObjPtr, extmemAddress + (length - 1U));
+                                 eraseBlockStart + mtb_serial_memory_get_erase_size(serialMemObjPtr, extmemAddress + (length - 1U));
 
-                CY_DFU_LOG_DBG("Ext_Flash_WriteRow: Erase Operation - eraseBlockStart[%p] eraseBlockSize[%u]",
-                               (void *)eraseBlockStart, eraseBlockSize);
+                DFU_TRACE2(DBG, EXT_ERASE, eraseBlockStart, eraseBlockSize);
 
-                cy_rslt_t extstatus = mtb_serial_memory_erase(serialMemObjPtr, eraseBlockStart, eraseBlockSize);
+                DFU_PERF_BEGIN(perfErase);
+                cy_rslt_t extstatus = EXT_MEM_ERASE(serialMemObjPtr, eraseBlockStart, eraseBlockSize);
+                DFU_PERF_END(DFU_PERF_FLASH_ERASE, perfErase);
                 if ((unsigned int)extstatus == CY_RSLT_SUCCESS)
                 {
                     status = CY_DFU_SUCCESS;
@@ -331,8 +991,7 @@ static cy_en_dfu_status_t Ext_Flash_WriteRow(uint32_t address, size_t length, cy
                 else
                 {
                     status = CY_DFU_ERROR_WRITE_EXT;
-                    CY_DFU_LOG_ERR("Ext_Flash_WriteRow: Erase failed[%u] - address[%p] eraseBlockStart[%p] eraseBlockSize[%u]",
-                                   (unsigned int)extstatus, (void *)address, (void *)eraseBlockStart, eraseBlockSize);
+                    DFU_TRACE4(ERR, EXT_ERASE_FAILED, extstatus, address, eraseBlockStart, eraseBlockSize);
                 }
             }
         #endif /* !define CY_DFU_DISABLE_EXTMEM_ERASE */
@@ -344,13 +1003,15 @@ static cy_en_dfu_status_t Ext_Flash_WriteRow(uint32_t address, size_t length, cy
                 if ((IsMultipleOf(length, progBlockSize) == 0))
                 {
                     status = CY_DFU_ERROR_LENGTH;
-                    CY_DFU_LOG_ERR("Ext_Flash_WriteRow: Invalid Program size");
+                    DFU_TRACE0(ERR, EXT_PROGRAM_SIZE);
                 }
             }
 
             if (status == CY_DFU_SUCCESS)
             {
-                cy_rslt_t extstatus = mtb_serial_memory_write(serialMemObjPtr, extmemAddress, length, params->dataBuffer);
+                DFU_PERF_BEGIN(perfProgram);
+                cy_rslt_t extstatus = EXT_MEM_WRITE(serialMemObjPtr, extmemAddress, length, params->dataBuffer);
+                DFU_PERF_END(DFU_PERF_FLASH_PROGRAM, perfProgram);
                 if ((unsigned int)extstatus == CY_RSLT_SUCCESS)
                 {
                     status = CY_DFU_SUCCESS;
@@ -358,8 +1019,7 @@ static cy_en_dfu_status_t Ext_Flash_WriteRow(uint32_t address, size_t length, cy
                 else
                 {
                     status = CY_DFU_ERROR_WRITE_EXT;
-                    CY_DFU_LOG_ERR("Ext_Flash_WriteRow: Write failed[%u] - address[%p] length[%u]",
-                                   (unsigned int)extstatus, (void *)address, length);
+                    DFU_TRACE3(ERR, EXT_WRITE_FAILED, extstatus, address, length);
                 }
             }
         }
@@ -387,6 +1047,7 @@ static cy_en_dfu_status_t Ext_Flash_ReadRow(uint32_t address, size_t length, uin
     if (serialMemObjPtr == NULL)
     {
         status = CY_DFU_ERROR_READ_EXT;
+        DFU_TRACE0(ERR, EXT_NOT_ADDED);
     }
     else
     {
@@ -398,8 +1059,7 @@ static cy_en_dfu_status_t Ext_Flash_ReadRow(uint32_t address, size_t length, uin
         else
         {
             status = CY_DFU_ERROR_READ_EXT;
-            CY_DFU_LOG_ERR("Ext_Flash_ReadRow: Read failed[%u] - address[%p] length[%u]",
-                           (unsigned int)extstatus, (void *)address, length);
+            DFU_TRACE3(ERR, EXT_READ_FAILED, extstatus, address, length);
         }
     }
 
@@ -419,6 +1079,7 @@ cy_en_dfu_status_t Cy_DFU_WriteData(uint32_t address, uint32_t length, uint32_t
                                     cy_stc_dfu_params_t *params)
 {
     cy_en_dfu_status_t status = CY_DFU_SUCCESS;
+    DFU_PERF_BEGIN(perfStart);
 
     /* Check if the address is inside the valid range */
     address &= ~(SECURE_REGION_MASK);
@@ -476,7 +1137,22 @@ cy_en_dfu_status_t Cy_DFU_WriteData(uint32_t address, uint32_t length, uint32_t
         {
             (void)memset(params->dataBuffer, 0, CY_NVM_SIZEOF_ROW);
         }
+    #if defined(SECURE_DECRYPT) || defined(DFU_IMAGE_CHECK)
+        else
+        {
+            /* The image check sees the decrypted row */
+        #if defined(SECURE_DECRYPT)
+            status = DecryptRow(address, length, params->dataBuffer);
+        #endif /* defined(SECURE_DECRYPT) */
+        #if defined(DFU_IMAGE_CHECK)
+            status = (status == CY_DFU_SUCCESS) ? CheckImageRow(address, length, params->dataBuffer) : status;
+        #endif /* defined(DFU_IMAGE_CHECK) */
+        }
+    #endif /* defined(SECURE_DECRYPT) || defined(DFU_IMAGE_CHECK) */
+    }
 
+    if (status == CY_DFU_SUCCESS)
+    {
     #if (CY_DFU_OPT_EXTERNAL_MEMORY != 0U)
         status = Ext_Flash_WriteRow(address, length, params);
     #else /* Internal flash */
@@ -495,17 +1171,13 @@ cy_en_dfu_status_t Cy_DFU_WriteData(uint32_t address, uint32_t length, uint32_t
                 if (fstatus != CY_RSLT_SUCCESS)
                 {
                     status = CY_DFU_ERROR_DATA;
-                    CY_DFU_LOG_ERR("NVM program failed: module=0x%X code=0x%X",
-                                (unsigned int)CY_RSLT_GET_MODULE(fstatus),
-                                (unsigned int)CY_RSLT_GET_CODE(fstatus));
+                    DFU_TRACE2(ERR, NVM_PROGRAM_FAILED, CY_RSLT_GET_MODULE(fstatus), CY_RSLT_GET_CODE(fstatus));
                 }
             }
             else
             {
                 status = CY_DFU_ERROR_DATA;
-                CY_DFU_LOG_ERR("NVM erase failed: module=0x%X code=0x%X",
-                            (unsigned int)CY_RSLT_GET_MODULE(fstatus),
-                            (unsigned int)CY_RSLT_GET_CODE(fstatus));
+                DFU_TRACE2(ERR, NVM_ERASE_FAILED, CY_RSLT_GET_MODULE(fstatus), CY_RSLT_GET_CODE(fstatus));
             }
             mtb_hal_system_critical_section_exit(int_status);
         #else
@@ -519,7 +1191,7 @@ cy_en_dfu_status_t Cy_DFU_WriteData(uint32_t address, uint32_t length, uint32_t
                 if (fstatus != CY_RSLT_SUCCESS)
                 {
                     status = CY_DFU_ERROR_DATA;
-                    CY_DFU_LOG_ERR("NVM write failed: fstatus 0x%X ", (unsigned int)fstatus);
+                    DFU_TRACE1(ERR, NVM_WRITE_FAILED, fstatus);
                 }
             #endif /* defined CY_IP_MXS40SSRSS && defined COMPONENT_NON_SECURE_DEVICE */
         #endif /* CY_IP_M7CPUSS */
@@ -528,12 +1200,36 @@ cy_en_dfu_status_t Cy_DFU_WriteData(uint32_t address, uint32_t length, uint32_t
 
     if (CY_DFU_SUCCESS != status)
     {
-        CY_DFU_LOG_ERR("Write operation failed at address 0x%X", (unsigned int)address);
+        DFU_TRACE1(ERR, WRITE_FAILED, address);
     }
+#if defined(SECURE_VERIFY)
+    else
+    {
+        uint32_t slot = FindUpdateSlot(address, NULL, NULL);
+
+        updatedSlots |= (slot != NO_UPDATE_SLOT) ? (1UL << slot) : 0U;
+    }
+#endif /* defined(SECURE_VERIFY) */
+
+    DFU_PERF_END(DFU_PERF_WRITE_DATA, perfStart);
 
     return (status);
 }
 
+#if defined(SECURE_VERIFY)
+/*******************************************************************************
+ * Function Name: Cy_DFU_GetUpdatedSlots
+ *******************************************************************************
+ *
+ * This function documentation is part of the dfu_user.h file.
+ *
+ *******************************************************************************/
+uint32_t Cy_DFU_GetUpdatedSlots(void)
+{
+    return updatedSlots;
+}
+#endif /* defined(SECURE_VERIFY) */
+
 /*******************************************************************************
  * Function Name: Cy_DFU_ReadData
  *******************************************************************************
@@ -546,6 +1242,7 @@ cy_en_dfu_status_t Cy_DFU_ReadData(uint32_t address, uint32_t length, uint32_t c
                                    cy_stc_dfu_params_t *params)
 {
     cy_en_dfu_status_t status = CY_DFU_SUCCESS;
+    DFU_PERF_BEGIN(perfStart);
 
     /* Check if the length is valid */
     if (IsMultipleOf(length, CY_NVM_SIZEOF_ROW) == false)
@@ -595,21 +1292,23 @@ cy_en_dfu_status_t Cy_DFU_ReadData(uint32_t address, uint32_t length, uint32_t c
         #endif /* (CY_DFU_OPT_EXTERNAL_MEMORY != 0U) */
         }
     }
+
+    DFU_PERF_END(DFU_PERF_READ_DATA, perfStart);
+
     return (status);
 }
 
 /*******************************************************************************
- * Function Name: Cy_DFU_TransportStart
+ * Function Name: TransportStart
  *******************************************************************************
  *
- * This function documentation is part of the DFU SDK API, see the
- * cy_dfu.h file or DFU SDK API Reference Manual for details.
+ * This internal function starts the given transport.
+ *
+ * \param transport  The transport to start.
  *
  *******************************************************************************/
-void Cy_DFU_TransportStart(cy_en_dfu_transport_t transport)
+static void TransportStart(cy_en_dfu_transport_t transport)
 {
-    selectedInterface = transport;
-
 #if (CY_DFU_OPT_EXTERNAL_MEMORY == 0U)
     /* Initialize NVM object */
     #if defined CY_IP_MXS40SSRSS && defined COMPONENT_NON_SECURE_DEVICE
@@ -646,6 +1345,11 @@ void Cy_DFU_TransportStart(cy_en_dfu_transport_t transport)
             SPI_SpiCyBtldrCommStart();
             break;
     #endif /* COMPONENT_DFU_SPI */
+    #ifdef COMPONENT_DFU_SPI_DMA
+        case CY_DFU_SPI:
+            SPI_DMA_CyBtldrCommStart();
+            break;
+    #endif /* COMPONENT_DFU_SPI_DMA */
     #ifdef COMPONENT_DFU_USB_CDC
         case CY_DFU_USB_CDC:
             USB_CDC_CyBtldrCommStart();
@@ -666,6 +1370,11 @@ void Cy_DFU_TransportStart(cy_en_dfu_transport_t transport)
             CANFD_CanfdCyBtldrCommStart();
             break;
     #endif /* COMPONENT_DFU_CANFD */
+    #ifdef COMPONENT_DFU_CANFD_ISOTP
+        case CY_DFU_CANFD:
+            CANFD_ISOTP_CyBtldrCommStart();
+            break;
+    #endif /* COMPONENT_DFU_CANFD_ISOTP */
 
         default:
             /* Selected interface in not applicable */
@@ -675,16 +1384,17 @@ void Cy_DFU_TransportStart(cy_en_dfu_transport_t transport)
 }
 
 /*******************************************************************************
- * Function Name: Cy_DFU_TransportStop
+ * Function Name: TransportStop
  *******************************************************************************
  *
- * This function documentation is part of the DFU SDK API, see the
- * cy_dfu.h file or DFU SDK API Reference Manual for details.
+ * This internal function stops the given transport.
+ *
+ * \param transport  The transport to stop.
  *
  *******************************************************************************/
-void Cy_DFU_TransportStop(void)
+static void TransportStop(cy_en_dfu_transport_t transport)
 {
-    switch (selectedInterface)
+    switch (transport)
     {
     #ifdef COMPONENT_DFU_I2C
         case CY_DFU_I2C:
@@ -702,6 +1412,11 @@ void Cy_DFU_TransportStop(void)
             SPI_SpiCyBtldrCommStop();
             break;
     #endif /* COMPONENT_DFU_SPI */
+    #ifdef COMPONENT_DFU_SPI_DMA
+        case CY_DFU_SPI:
+            SPI_DMA_CyBtldrCommStop();
+            break;
+    #endif /* COMPONENT_DFU_SPI_DMA */
     #ifdef COMPONENT_DFU_USB_CDC
         case CY_DFU_USB_CDC:
             USB_CDC_CyBtldrCommStop();
@@ -722,6 +1437,11 @@ void Cy_DFU_TransportStop(void)
             CANFD_CanfdCyBtldrCommStop();
             break;
     #endif /* COMPONENT_DFU_CANFD */
+    #ifdef COMPONENT_DFU_CANFD_ISOTP
+        case CY_DFU_CANFD:
+            CANFD_ISOTP_CyBtldrCommStop();
+            break;
+    #endif /* COMPONENT_DFU_CANFD_ISOTP */
 
         default:
             /* Selected interface in not applicable */
@@ -731,16 +1451,17 @@ void Cy_DFU_TransportStop(void)
 }
 
 /*******************************************************************************
- * Function Name: Cy_DFU_TransportReset
+ * Function Name: TransportReset
  *******************************************************************************
  *
- * This function documentation is part of the DFU SDK API, see the
- * cy_dfu.h file or DFU SDK API Reference Manual for details.
+ * This internal function resets the given transport.
+ *
+ * \param transport  The transport to reset.
  *
  *******************************************************************************/
-void Cy_DFU_TransportReset(void)
+static void TransportReset(cy_en_dfu_transport_t transport)
 {
-    switch (selectedInterface)
+    switch (transport)
     {
     #ifdef COMPONENT_DFU_I2C
         case CY_DFU_I2C:
@@ -758,6 +1479,11 @@ void Cy_DFU_TransportReset(void)
             SPI_SpiCyBtldrCommReset();
             break;
     #endif /* COMPONENT_DFU_SPI */
+    #ifdef COMPONENT_DFU_SPI_DMA
+        case CY_DFU_SPI:
+            SPI_DMA_CyBtldrCommReset();
+            break;
+    #endif /* COMPONENT_DFU_SPI_DMA */
     #ifdef COMPONENT_DFU_USB_CDC
         case CY_DFU_USB_CDC:
             USB_CDC_CyBtldrCommReset();
@@ -778,6 +1504,11 @@ void Cy_DFU_TransportReset(void)
             CANFD_CanfdCyBtldrCommReset();
             break;
     #endif /* COMPONENT_DFU_CANFD */
+    #ifdef COMPONENT_DFU_CANFD_ISOTP
+        case CY_DFU_CANFD:
+            CANFD_ISOTP_CyBtldrCommReset();
+            break;
+    #endif /* COMPONENT_DFU_CANFD_ISOTP */
 
         default:
             /* Selected interface in not applicable */
@@ -787,18 +1518,26 @@ void Cy_DFU_TransportReset(void)
 }
 
 /*******************************************************************************
- * Function Name: Cy_DFU_TransportRead
+ * Function Name: TransportRead
  *******************************************************************************
  *
- * This function documentation is part of the DFU SDK API, see the
- * cy_dfu.h file or DFU SDK API Reference Manual for details.
+ * This internal function reads a packet from the given transport.
+ *
+ * \param transport  The transport to read from.
+ * \param buffer     The buffer to store the packet.
+ * \param size       The size of the buffer.
+ * \param count      The number of bytes read.
+ * \param timeout    The read timeout in milliseconds.
+ *
+ * \return See \ref cy_en_dfu_status_t.
  *
  *******************************************************************************/
-cy_en_dfu_status_t Cy_DFU_TransportRead(uint8_t buffer[], uint32_t size, uint32_t *count, uint32_t timeout)
+static cy_en_dfu_status_t TransportRead(cy_en_dfu_transport_t transport, uint8_t buffer[], uint32_t size,
+                                        uint32_t *count, uint32_t timeout)
 {
     cy_en_dfu_status_t status = CY_DFU_ERROR_UNKNOWN;
 
-    switch (selectedInterface)
+    switch (transport)
     {
     #ifdef COMPONENT_DFU_I2C
         case CY_DFU_I2C:
@@ -816,6 +1555,11 @@ cy_en_dfu_status_t Cy_DFU_TransportRead(uint8_t buffer[], uint32_t size, uint32_
             status = SPI_SpiCyBtldrCommRead(buffer, size, count, timeout);
             break;
     #endif /* COMPONENT_DFU_SPI */
+    #ifdef COMPONENT_DFU_SPI_DMA
+        case CY_DFU_SPI:
+            status = SPI_DMA_CyBtldrCommRead(buffer, size, count, timeout);
+            break;
+    #endif /* COMPONENT_DFU_SPI_DMA */
     #ifdef COMPONENT_DFU_USB_CDC
         case CY_DFU_USB_CDC:
             status = USB_CDC_CyBtldrCommRead(buffer, size, count, timeout);
@@ -836,6 +1580,11 @@ cy_en_dfu_status_t Cy_DFU_TransportRead(uint8_t buffer[], uint32_t size, uint32_
             status = CANFD_CanfdCyBtldrCommRead(buffer, size, count, timeout);
             break;
     #endif /* COMPONENT_DFU_CANFD */
+    #ifdef COMPONENT_DFU_CANFD_ISOTP
+        case CY_DFU_CANFD:
+            status = CANFD_ISOTP_CyBtldrCommRead(buffer, size, count, timeout);
+            break;
+    #endif /* COMPONENT_DFU_CANFD_ISOTP */
 
         default:
             /* Selected interface in not applicable */
@@ -847,18 +1596,26 @@ cy_en_dfu_status_t Cy_DFU_TransportRead(uint8_t buffer[], uint32_t size, uint32_
 }
 
 /*******************************************************************************
- * Function Name: Cy_DFU_TransportWrite
+ * Function Name: TransportWrite
  *******************************************************************************
  *
- * This function documentation is part of the DFU SDK API, see the
- * cy_dfu.h file or DFU SDK API Reference Manual for details.
+ * This internal function writes a packet to the given transport.
+ *
+ * \param transport  The transport to write to.
+ * \param buffer     The packet to send.
+ * \param size       The size of the packet.
+ * \param count      The number of bytes written.
+ * \param timeout    The write timeout in milliseconds.
+ *
+ * \return See \ref cy_en_dfu_status_t.
  *
  *******************************************************************************/
-cy_en_dfu_status_t Cy_DFU_TransportWrite(uint8_t buffer[], uint32_t size, uint32_t *count, uint32_t timeout)
+static cy_en_dfu_status_t TransportWrite(cy_en_dfu_transport_t transport, uint8_t buffer[], uint32_t size,
+                                         uint32_t *count, uint32_t timeout)
 {
     cy_en_dfu_status_t status = CY_DFU_ERROR_UNKNOWN;
 
-    switch (selectedInterface)
+    switch (transport)
     {
     #ifdef COMPONENT_DFU_I2C
         case CY_DFU_I2C:
@@ -876,6 +1633,11 @@ cy_en_dfu_status_t Cy_DFU_TransportWrite(uint8_t buffer[], uint32_t size, uint32
             status = SPI_SpiCyBtldrCommWrite(buffer, size, count, timeout);
             break;
     #endif /* COMPONENT_DFU_SPI */
+    #ifdef COMPONENT_DFU_SPI_DMA
+        case CY_DFU_SPI:
+            status = SPI_DMA_CyBtldrCommWrite(buffer, size, count, timeout);
+            break;
+    #endif /* COMPONENT_DFU_SPI_DMA */
     #ifdef COMPONENT_DFU_USB_CDC
         case CY_DFU_USB_CDC:
             status = USB_CDC_CyBtldrCommWrite(buffer, size, count, timeout);
@@ -896,6 +1658,11 @@ cy_en_dfu_status_t Cy_DFU_TransportWrite(uint8_t buffer[], uint32_t size, uint32
             status = CANFD_CanfdCyBtldrCommWrite(buffer, size, count, timeout);
             break;
     #endif /* COMPONENT_DFU_CANFD */
+    #ifdef COMPONENT_DFU_CANFD_ISOTP
+        case CY_DFU_CANFD:
+            status = CANFD_ISOTP_CyBtldrCommWrite(buffer, size, count, timeout);
+            break;
+    #endif /* COMPONENT_DFU_CANFD_ISOTP */
 
         default:
             /* Selected interface in not applicable */
@@ -906,4 +1673,236 @@ cy_en_dfu_status_t Cy_DFU_TransportWrite(uint8_t buffer[], uint32_t size, uint32
     return status;
 }
 
+/*******************************************************************************
+ * Function Name: Cy_DFU_TransportStart
+ *******************************************************************************
+ *
+ * This function documentation is part of the DFU SDK API, see the
+ * cy_dfu.h file or DFU SDK API Reference Manual for details.
+ *
+ *******************************************************************************/
+void Cy_DFU_TransportStart(cy_en_dfu_transport_t transport)
+{
+    selectedInterface = transport;
+    listenCount = 0U;
+    sessionLocked = true;
+
+    TransportStart(transport);
+}
+
+/*******************************************************************************
+ * Function Name: Cy_DFU_TransportStartMulti
+ *******************************************************************************
+ *
+ * Starts several transports at once. All of them listen until one delivers a
+ * valid Enter DFU command; that transport then carries the whole session.
+ * \ref Cy_DFU_TransportReset makes all transports listen again.
+ *
+ * \param transports The transports to listen to.
+ * \param count      The number of transports, up to
+ *                   \ref CY_DFU_MAX_LISTEN_TRANSPORTS.
+ *
+ *******************************************************************************/
+void Cy_DFU_TransportStartMulti(const cy_en_dfu_transport_t transports[], uint32_t count)
+{
+    CY_ASSERT((count > 0U) && (count <= CY_DFU_MAX_LISTEN_TRANSPORTS));
+
+    listenCount = 0U;
+    for (uint32_t idx = 0U; (idx < count) && (idx < CY_DFU_MAX_LISTEN_TRANSPORTS); idx++)
+    {
+        listenInterfaces[idx] = transports[idx];
+        TransportStart(transports[idx]);
+        listenCount++;
+    }
+
+    selectedInterface = listenInterfaces[0];
+    listenNext = 0U;
+    sessionLocked = false;
+    selectPinned = false;
+}
+
+/*******************************************************************************
+ * Function Name: Cy_DFU_TransportSelect
+ *******************************************************************************
+ *
+ * Routes all DFU traffic to one of the transports started with
+ * \ref Cy_DFU_TransportStartMulti. The other transports stay started, so
+ * switching does not stop or re-initialize any hardware. The selection holds
+ * across \ref Cy_DFU_TransportReset until the next call.
+ *
+ * \param transport  The transport to use, must be one of the started ones.
+ *
+ *******************************************************************************/
+void Cy_DFU_TransportSelect(cy_en_dfu_transport_t transport)
+{
+    selectedInterface = transport;
+    sessionLocked = true;
+    selectPinned = true;
+}
+
+/*******************************************************************************
+ * Function Name: Cy_DFU_TransportGetActive
+ *******************************************************************************
+ *
+ * Returns the transport that carries the current DFU session.
+ *
+ * \param transport  The pointer to store the active transport.
+ *
+ * \return True - a transport owns the session, False - all transports
+ *         started with \ref Cy_DFU_TransportStartMulti are still listening.
+ *
+ *******************************************************************************/
+bool Cy_DFU_TransportGetActive(cy_en_dfu_transport_t *transport)
+{
+    *transport = selectedInterface;
+    return sessionLocked;
+}
+
+/*******************************************************************************
+ * Function Name: Cy_DFU_TransportStop
+ *******************************************************************************
+ *
+ * This function documentation is part of the DFU SDK API, see the
+ * cy_dfu.h file or DFU SDK API Reference Manual for details.
+ *
+ *******************************************************************************/
+void Cy_DFU_TransportStop(void)
+{
+    if (listenCount == 0U)
+    {
+        TransportStop(selectedInterface);
+    }
+    else
+    {
+        for (uint32_t idx = 0U; idx < listenCount; idx++)
+        {
+            TransportStop(listenInterfaces[idx]);
+        }
+        listenCount = 0U;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: Cy_DFU_TransportReset
+ *******************************************************************************
+ *
+ * This function documentation is part of the DFU SDK API, see the
+ * cy_dfu.h file or DFU SDK API Reference Manual for details.
+ *
+ *******************************************************************************/
+void Cy_DFU_TransportReset(void)
+{
+    if (listenCount == 0U)
+    {
+        TransportReset(selectedInterface);
+    }
+    else
+    {
+        /* End of session, every transport listens again unless one is selected */
+        for (uint32_t idx = 0U; idx < listenCount; idx++)
+        {
+            TransportReset(listenInterfaces[idx]);
+        }
+        sessionLocked = selectPinned;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: Cy_DFU_TransportRead
+ *******************************************************************************
+ *
+ * This function documentation is part of the DFU SDK API, see the
+ * cy_dfu.h file or DFU SDK API Reference Manual for details.
+ *
+ *******************************************************************************/
+cy_en_dfu_status_t Cy_DFU_TransportRead(uint8_t buffer[], uint32_t size, uint32_t *count, uint32_t timeout)
+{
+    cy_en_dfu_status_t status = CY_DFU_ERROR_TIMEOUT;
+    DFU_PERF_BEGIN(perfStart);
+
+#if defined(DFU_BACKGROUND)
+    /* Poll for a command instead of waiting, the application runs meanwhile */
+    timeout = (timeout < DFU_SERVICE_POLL_MS) ? timeout : DFU_SERVICE_POLL_MS;
+#endif /* defined(DFU_BACKGROUND) */
+
+    if (sessionLocked)
+    {
+        status = TransportRead(selectedInterface, buffer, size, count, timeout);
+        if ((status == CY_DFU_SUCCESS) && (HandleStatsCommand(selectedInterface, buffer, *count) ||
+                                           HandleBootTimeCommand(selectedInterface, buffer, *count) ||
+                                           HandleDecryptCommand(selectedInterface, buffer, *count)))
+        {
+            *count = 0U;
+            status = CY_DFU_ERROR_TIMEOUT;
+        }
+    }
+    else
+    {
+        /* Poll the listening transports in turn, sharing the timeout. Anything
+         * other than a valid Enter DFU command is dropped. */
+        uint32_t slice = timeout / listenCount;
+        slice = (slice == 0U) ? 1U : slice;
+
+        for (uint32_t idx = 0U; (idx < listenCount) && (!sessionLocked); idx++)
+        {
+            cy_en_dfu_transport_t transport = listenInterfaces[listenNext];
+            listenNext = (listenNext + 1U) % listenCount;
+
+            if ((TransportRead(transport, buffer, size, count, slice) == CY_DFU_SUCCESS) &&
+                (!HandleStatsCommand(transport, buffer, *count)) &&
+                (!HandleBootTimeCommand(transport, buffer, *count)))
+            {
+                if ((buffer[PACKET_CMD_IDX] == PACKET_CMD_ENTER) && IsValidPacket(buffer, *count))
+                {
+                    selectedInterface = transport;
+                    sessionLocked = true;
+                    status = CY_DFU_SUCCESS;
+                }
+                else
+                {
+                    TransportReset(transport);
+                }
+            }
+        }
+    }
+
+    if (status == CY_DFU_SUCCESS)
+    {
+        if ((buffer[PACKET_CMD_IDX] == PACKET_CMD_ENTER) && IsValidPacket(buffer, *count))
+        {
+            SessionReset();
+        }
+        DFU_PERF_END(DFU_PERF_TRANSPORT_READ, perfStart);
+        DFU_PERF_COMMAND_RECEIVED(buffer[PACKET_CMD_IDX]);
+        DFU_RECORD_PACKET(DFU_RECORD_TO_DEVICE, selectedInterface, buffer, *count);
+    }
+
+    return status;
+}
+
+/*******************************************************************************
+ * Function Name: Cy_DFU_TransportWrite
+ *******************************************************************************
+ *
+ * This function documentation is part of the DFU SDK API, see the
+ * cy_dfu.h file or DFU SDK API Reference Manual for details.
+ *
+ *******************************************************************************/
+cy_en_dfu_status_t Cy_DFU_TransportWrite(uint8_t buffer[], uint32_t size, uint32_t *count, uint32_t timeout)
+{
+    cy_en_dfu_status_t status;
+    DFU_PERF_BEGIN(perfStart);
+
+    status = TransportWrite(selectedInterface, buffer, size, count, timeout);
+
+    DFU_PERF_END(DFU_PERF_TRANSPORT_WRITE, perfStart);
+    DFU_PERF_RESPONSE_SENT();
+    if (status == CY_DFU_SUCCESS)
+    {
+        DFU_RECORD_PACKET(DFU_RECORD_FROM_DEVICE, selectedInterface, buffer, size);
+    }
+
+    return status;
+}
+
 /* [] END OF FILE */
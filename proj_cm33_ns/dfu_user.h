@@ -219,6 +219,25 @@ void Cy_DFU_AddExtMemory(mtb_serial_memory_t *serialMemObj);
 /** \} group_dfu_functions */
 #endif /* #if ((CY_DFU_OPT_EXTERNAL_MEMORY != 0U) && !defined (USE_SMIF_PDL_INIT)) || defined(CY_DOXYGEN) */
 
+#if defined(SECURE_VERIFY) || defined(CY_DOXYGEN)
+/**
+* \addtogroup group_dfu_functions
+* \{
+*/
+/*******************************************************************************
+* Function Name: Cy_DFU_GetUpdatedSlots
+****************************************************************************//**
+*
+* This function returns the update slots written since the last Enter DFU
+* command, see DFU_UPDATE_SLOTS in dfu_user.c.
+*
+* \return Bit n set for the update slot of MCUboot image ID n
+*
+*******************************************************************************/
+uint32_t Cy_DFU_GetUpdatedSlots(void);
+/** \} group_dfu_functions */
+#endif /* defined(SECURE_VERIFY) || defined(CY_DOXYGEN) */
+
 /** \cond INTERNAL */
 /* Basic bootloader flow specific constants. Do not update this section */
 #if (CY_DFU_FLOW == CY_DFU_BASIC_FLOW) || defined(CY_DOXYGEN)
@@ -0,0 +1,61 @@
+/*******************************************************************************
+* File Name        : dfu_user_transport.h
+*
+* Description      : This file declares the transport extensions implemented in
+*                    dfu_user.c on top of the DFU SDK transport API.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef DFU_USER_TRANSPORT_H
+#define DFU_USER_TRANSPORT_H
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <stdbool.h>
+#include "cy_dfu.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Maximum number of transports that can listen at the same time */
+#ifndef CY_DFU_MAX_LISTEN_TRANSPORTS
+    #define CY_DFU_MAX_LISTEN_TRANSPORTS    (6U)
+#endif /* CY_DFU_MAX_LISTEN_TRANSPORTS */
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void Cy_DFU_TransportStartMulti(const cy_en_dfu_transport_t transports[], uint32_t count);
+void Cy_DFU_TransportSelect(cy_en_dfu_transport_t transport);
+bool Cy_DFU_TransportGetActive(cy_en_dfu_transport_t *transport);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* DFU_USER_TRANSPORT_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,487 @@
+/*******************************************************************************
+* File Name        : dfu_xip_qos.c
+*
+* Description      : This file shares the external flash between the code that
+*                    runs from it and the erases and writes of DFU. While the
+*                    flash erases or programs, XIP fetches of the CM33 and the
+*                    CM55 from CY_XIP_PORT0 stall. The operations are split
+*                    into short ones: pages for a write, and sectors for an
+*                    erase, suspended after DFU_QOS_ERASE_SLICE_US when the
+*                    flash supports it. Each operation is charged to a credit
+*                    that fills at DFU_QOS_BUSY_US per DFU_QOS_WINDOW_US, and
+*                    the next one waits, with the flash free, while the credit
+*                    is used up. Time is taken from the DWT cycle counter.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#if defined(DFU_XIP_QOS)
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <string.h>
+#include "cy_pdl.h"
+#include "dfu_clock.h"
+#include "dfu_xip_qos.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* The credit is kept in microseconds times DFU_QOS_WINDOW_US, so that it
+ * fills by DFU_QOS_BUSY_US per elapsed microsecond without rounding */
+#define QOS_CREDIT_MAX                  ((int64_t)DFU_QOS_BUSY_US * (int64_t)DFU_QOS_WINDOW_US)
+
+/* Longest single Cy_SysLib_DelayUs() of a wait */
+#define QOS_WAIT_STEP_US                (1000U)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef enum
+{
+    QOS_ERASE_DONE,             /* Sector erased */
+    QOS_ERASE_SUSPENDED,        /* Slice over, the erase is suspended */
+    QOS_ERASE_NOT_STARTED       /* No erase-suspend driver */
+} qos_erase_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static uint32_t qos_slice_cycles;
+
+static int64_t qos_credit;
+static uint32_t qos_last_cycles;
+static uint32_t qos_cycles_rem;
+
+static dfu_xip_qos_stats_t qos_stats;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void qos_refill(void);
+static void qos_wait(void);
+static void qos_charge(uint32_t cycles);
+static qos_erase_t qos_erase_slice(mtb_serial_memory_t *obj, uint32_t address, bool resume, uint32_t *cycles);
+
+/*******************************************************************************
+* Function Name: dfu_xip_qos_init
+********************************************************************************
+* Summary:
+*  Starts the cycle counter, see dfu_clock_init(), and fills the credit. Must
+*  be called after the CPU clock is set up.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void dfu_xip_qos_init(void)
+{
+    dfu_clock_init();
+    qos_slice_cycles = DFU_QOS_ERASE_SLICE_US * dfu_clock_cycles_per_us();
+    qos_credit = QOS_CREDIT_MAX;
+    qos_last_cycles = DFU_CLOCK_CYCLES();
+    qos_cycles_rem = 0U;
+
+    dfu_xip_qos_reset_stats();
+}
+
+/*******************************************************************************
+* Function Name: dfu_xip_qos_erase
+********************************************************************************
+* Summary:
+*  Erases the sectors that hold an area, one sector at a time. With the
+*  erase-suspend driver, the erase of a sector runs in slices of at most
+*  DFU_QOS_ERASE_SLICE_US with interrupts disabled, and is suspended in
+*  between while the credit fills. Without it, each sector is erased in one
+*  go by mtb_serial_memory_erase(). An area without a sector size fails
+*  instead of being erased.
+*
+* Parameters:
+*  obj     : Serial memory object
+*  address : Start of the area in the memory, at a sector start
+*  length  : Size of the area
+*
+* Return:
+*  CY_RSLT_SUCCESS, DFU_QOS_RSLT_ERR_ERASE_SIZE, or the error of
+*  mtb_serial_memory_erase()
+*
+*******************************************************************************/
+cy_rslt_t dfu_xip_qos_erase(mtb_serial_memory_t *obj, uint32_t address, size_t length)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+
+    while ((length > 0U) && (result == CY_RSLT_SUCCESS))
+    {
+        size_t sector = mtb_serial_memory_get_erase_size(obj, address);
+        qos_erase_t erase;
+        uint32_t cycles;
+        uint32_t intr_state;
+
+        if (sector == 0U)
+        {
+            /* No sector at this address, the loop would never end */
+            result = DFU_QOS_RSLT_ERR_ERASE_SIZE;
+            break;
+        }
+
+        qos_wait();
+        intr_state = Cy_SysLib_EnterCriticalSection();
+        erase = qos_erase_slice(obj, address, false, &cycles);
+        Cy_SysLib_ExitCriticalSection(intr_state);
+
+        if (erase == QOS_ERASE_NOT_STARTED)
+        {
+            cycles = DFU_CLOCK_CYCLES();
+            result = mtb_serial_memory_erase(obj, address, sector);
+            cycles = DFU_CLOCK_CYCLES() - cycles;
+        }
+        qos_charge(cycles);
+
+        while (erase == QOS_ERASE_SUSPENDED)
+        {
+            /* Pending interrupts and XIP fetches run here */
+            qos_stats.suspends++;
+            qos_wait();
+            intr_state = Cy_SysLib_EnterCriticalSection();
+            erase = qos_erase_slice(obj, address, true, &cycles);
+            Cy_SysLib_ExitCriticalSection(intr_state);
+            qos_charge(cycles);
+        }
+
+        qos_stats.erases++;
+        address += (uint32_t)sector;
+        length -= (length > sector) ? sector : length;
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: dfu_xip_qos_write
+********************************************************************************
+* Summary:
+*  Writes data to erased memory, DFU_QOS_PROGRAM_CHUNK bytes at a time.
+*
+* Parameters:
+*  obj     : Serial memory object
+*  address : Address in the memory, aligned to the program size
+*  length  : Size of the data, a multiple of the program size
+*  data    : Data
+*
+* Return:
+*  CY_RSLT_SUCCESS, or the error of mtb_serial_memory_write()
+*
+*******************************************************************************/
+cy_rslt_t dfu_xip_qos_write(mtb_serial_memory_t *obj, uint32_t address, size_t length, const uint8_t *data)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    size_t prog = mtb_serial_memory_get_prog_size(obj, address);
+    size_t chunk;
+
+    prog = (prog == 0U) ? 1U : prog;
+    chunk = DFU_QOS_PROGRAM_CHUNK - (DFU_QOS_PROGRAM_CHUNK % prog);
+    chunk = (chunk == 0U) ? prog : chunk;
+
+    while ((length > 0U) && (result == CY_RSLT_SUCCESS))
+    {
+        size_t size = (length > chunk) ? chunk : length;
+        uint32_t cycles;
+
+        qos_wait();
+        cycles = DFU_CLOCK_CYCLES();
+        result = mtb_serial_memory_write(obj, address, size, data);
+        qos_charge(DFU_CLOCK_CYCLES() - cycles);
+
+        qos_stats.programs++;
+        address += (uint32_t)size;
+        data = &data[size];
+        length -= size;
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: dfu_xip_qos_ready
+********************************************************************************
+* Summary:
+*  Tells whether a flash operation would start at once. Lets a caller that
+*  can do other work, such as the main loop with DFU_BACKGROUND, hold back a
+*  DFU command instead of waiting in it.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  True if credit is left
+*
+*******************************************************************************/
+bool dfu_xip_qos_ready(void)
+{
+    qos_refill();
+
+    return (qos_credit > 0);
+}
+
+/*******************************************************************************
+* Function Name: dfu_xip_qos_get_stats
+********************************************************************************
+* Summary:
+*  Returns the statistics since the last dfu_xip_qos_reset_stats().
+*
+* Parameters:
+*  void
+*
+* Return:
+*  Statistics of the flash operations
+*
+*******************************************************************************/
+const dfu_xip_qos_stats_t *dfu_xip_qos_get_stats(void)
+{
+    return &qos_stats;
+}
+
+/*******************************************************************************
+* Function Name: dfu_xip_qos_reset_stats
+********************************************************************************
+* Summary:
+*  Clears the statistics.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void dfu_xip_qos_reset_stats(void)
+{
+    (void)memset(&qos_stats, 0, sizeof(qos_stats));
+}
+
+/*******************************************************************************
+* Function Name: dfu_xip_qos_erase_start
+********************************************************************************
+* Summary:
+*  Starts the erase of a sector and returns while the flash erases. Override
+*  it with the erase-suspend driver of the flash. The default has no driver.
+*
+* Parameters:
+*  obj     : Serial memory object
+*  address : Start of the sector in the memory
+*
+* Return:
+*  True if the erase started, false to erase with mtb_serial_memory_erase()
+*
+*******************************************************************************/
+CY_RAMFUNC_BEGIN
+__WEAK bool dfu_xip_qos_erase_start(mtb_serial_memory_t *obj, uint32_t address)
+{
+    (void)obj;
+    (void)address;
+
+    return false;
+}
+CY_RAMFUNC_END
+
+/*******************************************************************************
+* Function Name: dfu_xip_qos_erase_busy
+********************************************************************************
+* Summary:
+*  Tells whether the erase started by dfu_xip_qos_erase_start() or resumed by
+*  dfu_xip_qos_erase_resume() is still running, from the status register of
+*  the flash.
+*
+* Parameters:
+*  obj : Serial memory object
+*
+* Return:
+*  True while the flash erases
+*
+*******************************************************************************/
+CY_RAMFUNC_BEGIN
+__WEAK bool dfu_xip_qos_erase_busy(mtb_serial_memory_t *obj)
+{
+    (void)obj;
+
+    return false;
+}
+CY_RAMFUNC_END
+
+/*******************************************************************************
+* Function Name: dfu_xip_qos_erase_suspend
+********************************************************************************
+* Summary:
+*  Suspends the running erase, and returns once the flash can be read.
+*
+* Parameters:
+*  obj : Serial memory object
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+CY_RAMFUNC_BEGIN
+__WEAK void dfu_xip_qos_erase_suspend(mtb_serial_memory_t *obj)
+{
+    (void)obj;
+}
+CY_RAMFUNC_END
+
+/*******************************************************************************
+* Function Name: dfu_xip_qos_erase_resume
+********************************************************************************
+* Summary:
+*  Resumes the suspended erase.
+*
+* Parameters:
+*  obj : Serial memory object
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+CY_RAMFUNC_BEGIN
+__WEAK void dfu_xip_qos_erase_resume(mtb_serial_memory_t *obj)
+{
+    (void)obj;
+}
+CY_RAMFUNC_END
+
+/*******************************************************************************
+* Function Name: qos_refill
+********************************************************************************
+* Summary:
+*  Adds the credit of the time since the last call. The cycle counter wraps
+*  after 2^32 cycles, so a longer gap adds less, which only delays the next
+*  operation by up to one window.
+*
+*******************************************************************************/
+static void qos_refill(void)
+{
+    uint32_t cycles = DFU_CLOCK_CYCLES();
+    uint32_t us;
+
+    qos_cycles_rem += cycles - qos_last_cycles;
+    qos_last_cycles = cycles;
+    us = qos_cycles_rem / dfu_clock_cycles_per_us();
+    qos_cycles_rem %= dfu_clock_cycles_per_us();
+
+    qos_credit += (int64_t)us * (int64_t)DFU_QOS_BUSY_US;
+    qos_credit = (qos_credit > QOS_CREDIT_MAX) ? QOS_CREDIT_MAX : qos_credit;
+}
+
+/*******************************************************************************
+* Function Name: qos_wait
+********************************************************************************
+* Summary:
+*  Waits, with the flash free for XIP, until credit is left.
+*
+*******************************************************************************/
+static void qos_wait(void)
+{
+    uint32_t start;
+
+    qos_refill();
+    if (qos_credit > 0)
+    {
+        return;
+    }
+
+    qos_stats.throttles++;
+    start = DFU_CLOCK_CYCLES();
+    while (qos_credit <= 0)
+    {
+        /* Time until the credit is positive again */
+        int64_t us = ((-qos_credit) / (int64_t)DFU_QOS_BUSY_US) + 1;
+
+        Cy_SysLib_DelayUs((uint16_t)((us > (int64_t)QOS_WAIT_STEP_US) ? QOS_WAIT_STEP_US : (uint32_t)us));
+        qos_refill();
+    }
+    qos_stats.throttle_us += (DFU_CLOCK_CYCLES() - start) / dfu_clock_cycles_per_us();
+}
+
+/*******************************************************************************
+* Function Name: qos_charge
+********************************************************************************
+* Summary:
+*  Charges the busy time of an operation to the credit and the statistics.
+*
+*******************************************************************************/
+static void qos_charge(uint32_t cycles)
+{
+    uint32_t us = cycles / dfu_clock_cycles_per_us();
+
+    qos_refill();
+    qos_credit -= (int64_t)us * (int64_t)DFU_QOS_WINDOW_US;
+
+    qos_stats.busy_us += us;
+    qos_stats.max_busy_us = (us > qos_stats.max_busy_us) ? us : qos_stats.max_busy_us;
+}
+
+/*******************************************************************************
+* Function Name: qos_erase_slice
+********************************************************************************
+* Summary:
+*  Starts or resumes the erase of a sector and lets it run until it is done
+*  or the slice is over, then suspends it. Runs from RAM with interrupts
+*  disabled, as nothing can be fetched from the flash meanwhile.
+*
+*******************************************************************************/
+CY_RAMFUNC_BEGIN
+static qos_erase_t qos_erase_slice(mtb_serial_memory_t *obj, uint32_t address, bool resume, uint32_t *cycles)
+{
+    uint32_t start = DFU_CLOCK_CYCLES();
+    qos_erase_t erase = QOS_ERASE_DONE;
+
+    if (resume)
+    {
+        dfu_xip_qos_erase_resume(obj);
+    }
+    else if (!dfu_xip_qos_erase_start(obj, address))
+    {
+        erase = QOS_ERASE_NOT_STARTED;
+    }
+    else
+    {
+        /* Erase running */
+    }
+
+    while ((erase == QOS_ERASE_DONE) && dfu_xip_qos_erase_busy(obj))
+    {
+        if ((DFU_CLOCK_CYCLES() - start) >= qos_slice_cycles)
+        {
+            dfu_xip_qos_erase_suspend(obj);
+            erase = QOS_ERASE_SUSPENDED;
+        }
+    }
+    *cycles = DFU_CLOCK_CYCLES() - start;
+
+    return erase;
+}
+CY_RAMFUNC_END
+
+#endif /* defined(DFU_XIP_QOS) */
+
+/* [] END OF FILE */
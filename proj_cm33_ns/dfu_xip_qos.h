@@ -0,0 +1,117 @@
+/*******************************************************************************
+* File Name        : dfu_xip_qos.h
+*
+* Description      : This file is the public interface of dfu_xip_qos.c, which
+*                    shares the external flash between the code that runs from
+*                    it (XIP) and the erases and writes of DFU (DFU_XIP_QOS).
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef DFU_XIP_QOS_H
+#define DFU_XIP_QOS_H
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "mtb_serial_memory.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Flash operations may keep the flash busy for DFU_QOS_BUSY_US of each
+ * DFU_QOS_WINDOW_US, 25 % by default. Unused time carries over up to one
+ * window. An operation that starts within the limit runs to its end, so keep
+ * the operations short with the two settings below. */
+#ifndef DFU_QOS_WINDOW_US
+    #define DFU_QOS_WINDOW_US           (10000U)
+#endif /* DFU_QOS_WINDOW_US */
+#ifndef DFU_QOS_BUSY_US
+    #define DFU_QOS_BUSY_US             (2500U)
+#endif /* DFU_QOS_BUSY_US */
+
+/* Bytes written by one program operation, rounded down to a multiple of the
+ * program size of the flash. One page of most serial NOR flashes. */
+#ifndef DFU_QOS_PROGRAM_CHUNK
+    #define DFU_QOS_PROGRAM_CHUNK       (256U)
+#endif /* DFU_QOS_PROGRAM_CHUNK */
+
+/* Longest run of an erase before it is suspended, when the erase-suspend
+ * hooks below are provided */
+#ifndef DFU_QOS_ERASE_SLICE_US
+    #define DFU_QOS_ERASE_SLICE_US      (1000U)
+#endif /* DFU_QOS_ERASE_SLICE_US */
+
+/* Result of dfu_xip_qos_erase() for an area without a sector size */
+#define DFU_QOS_RSLT_ERR_ERASE_SIZE     \
+    (CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_MIDDLEWARE_BASE, 0U))
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+
+/* Flash busy time is measured, not the stalls of the XIP fetches: a fetch only
+ * stalls if it misses the cache while the flash is busy. */
+typedef struct
+{
+    uint32_t erases;            /* Sectors erased */
+    uint32_t programs;          /* Program operations */
+    uint32_t suspends;          /* Erases suspended to let XIP run */
+    uint32_t throttles;         /* Waits for the duty cycle limit */
+    uint32_t max_busy_us;       /* Longest time the flash was busy in one go */
+    uint64_t busy_us;           /* Time the flash was busy */
+    uint64_t throttle_us;       /* Time waited for the duty cycle limit */
+} dfu_xip_qos_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void dfu_xip_qos_init(void);
+cy_rslt_t dfu_xip_qos_erase(mtb_serial_memory_t *obj, uint32_t address, size_t length);
+cy_rslt_t dfu_xip_qos_write(mtb_serial_memory_t *obj, uint32_t address, size_t length, const uint8_t *data);
+bool dfu_xip_qos_ready(void);
+const dfu_xip_qos_stats_t *dfu_xip_qos_get_stats(void);
+void dfu_xip_qos_reset_stats(void);
+
+/* Erase-suspend driver of the flash, weak. mtb_serial_memory erases block
+ * until done and has no suspend, and the commands differ between flash parts,
+ * so the board port provides them. The defaults report no support and each
+ * sector is erased with mtb_serial_memory_erase(). The hooks are called with
+ * interrupts disabled while the flash cannot be read, so they must run from
+ * RAM (CY_RAMFUNC_BEGIN) and must not wait for the erase to end.
+ * dfu_xip_qos_erase_suspend() returns once the flash can be read again. */
+bool dfu_xip_qos_erase_start(mtb_serial_memory_t *obj, uint32_t address);
+bool dfu_xip_qos_erase_busy(mtb_serial_memory_t *obj);
+void dfu_xip_qos_erase_suspend(mtb_serial_memory_t *obj);
+void dfu_xip_qos_erase_resume(mtb_serial_memory_t *obj);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* DFU_XIP_QOS_H */
+
+/* [] END OF FILE */
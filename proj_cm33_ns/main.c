@@ -43,6 +43,26 @@
 #include "USB.h"
 #include "USB_HID.h"
 #include "cy_dfu_logging.h"
+#include "dfu_user_transport.h"
+#include "boot_time.h"
+#include "dfu_perf.h"
+#include "dfu_record.h"
+#include "dfu_trace.h"
+#if defined(SECURE_VERIFY)
+#include "secure_verify.h"
+#endif /* defined(SECURE_VERIFY) */
+#if defined(DFU_BACKGROUND)
+#include "dfu_service.h"
+#endif /* defined(DFU_BACKGROUND) */
+#if defined(DFU_XIP_QOS)
+#include "dfu_xip_qos.h"
+#endif /* defined(DFU_XIP_QOS) */
+#if defined(COMPONENT_DFU_SPI_DMA)
+#include "transport_spi_dma.h"
+#endif /* defined(COMPONENT_DFU_SPI_DMA) */
+#if defined(COMPONENT_DFU_CANFD_ISOTP)
+#include "transport_canfd_isotp.h"
+#endif /* defined(COMPONENT_DFU_CANFD_ISOTP) */
 #if defined(_MTB_HAL_DRIVER_AVAILABLE_IRQ) && (_MTB_HAL_DRIVER_AVAILABLE_IRQ)
 #include "mtb_hal_irq_impl.h"
 #endif /* defined(_MTB_HAL_DRIVER_AVAILABLE_IRQ) && (_MTB_HAL_DRIVER_AVAILABLE_IRQ) */
@@ -59,11 +79,46 @@
 #define CM55_BOOT_WAIT_TIME_USEC (10U)
 
 /* Number of DFU transports supported */
-#define MAX_DFU_TRANSPORT (3)
+#define MAX_DFU_TRANSPORT \
+    (sizeof(dfu_transport_supported) / sizeof(dfu_transport_supported[0]))
 
 /* Default DFU transport */
 #define DEFAULT_DFU_TRANSPORT (CY_DFU_I2C)
 
+#if defined(DFU_MULTI_TRANSPORT) && !defined(DFU_USB_COMPOSITE)
+/* USB-CDC and USB-HID share the USB device, so listening on both at once
+ * needs the composite device */
+#define DFU_USB_COMPOSITE
+#endif /* defined(DFU_MULTI_TRANSPORT) && !defined(DFU_USB_COMPOSITE) */
+
+#if defined(DFU_USB_COMPOSITE)
+/* USB classes of the composite DFU device */
+#define DFU_USB_CLASS_CDC (1u << 0u)
+#define DFU_USB_CLASS_HID (1u << 1u)
+#define DFU_USB_CLASS_ALL (DFU_USB_CLASS_CDC | DFU_USB_CLASS_HID)
+#endif /* defined(DFU_USB_COMPOSITE) */
+
+#if defined(COMPONENT_DFU_CANFD_ISOTP)
+/* CAN FD channel of the DFU transport (CYBSP_CAN_FD_CH_0) */
+#ifndef DFU_CANFD_HW
+#define DFU_CANFD_HW CANFD0
+#define DFU_CANFD_CHANNEL (0U)
+#define DFU_CANFD_IRQ canfd_0_interrupts0_0_IRQn
+#define DFU_CANFD_MRAM_ADDR CY_CAN0MRAM_BASE
+#define DFU_CANFD_MRAM_SIZE (4096U)
+#endif /* DFU_CANFD_HW */
+
+/* 11-bit CAN IDs of the frames sent by the DFU host and by this device */
+#ifndef DFU_CANFD_RX_ID
+#define DFU_CANFD_RX_ID (0x6F0U)
+#define DFU_CANFD_TX_ID (0x6F8U)
+#endif /* DFU_CANFD_RX_ID */
+#endif /* defined(COMPONENT_DFU_CANFD_ISOTP) */
+
+/* Number of DFU transports listening in multi-transport mode */
+#define DFU_LISTEN_TRANSPORT_COUNT \
+    (sizeof(dfu_transport_listen) / sizeof(dfu_transport_listen[0]))
+
 /* Timeout for Cy_DFU_Continue(), in milliseconds */
 #define DFU_SESSION_TIMEOUT_MS (20u)
 
@@ -98,16 +153,112 @@ static mtb_serial_memory_t smif0_obj;
 static cy_stc_smif_mem_context_t smif0_mem_cxt;
 static cy_stc_smif_mem_info_t smif0_mem_info;
 
+/* Start up work deferred until the DFU transport is up, in the order it runs.
+ * See startup_continue(). */
+typedef enum
+{
+    STARTUP_SERIAL_MEMORY,      /* SFDP discovery of the external flash */
+    STARTUP_CM55,               /* Boot of the CM55 application */
+    STARTUP_BANNER,             /* Banner on the debug UART */
+    STARTUP_DONE
+} startup_stage_t;
+
+static startup_stage_t startup_stage = STARTUP_SERIAL_MEMORY;
+
+#if defined(SECURE_VERIFY)
+/* Result of update_verify_step() */
+typedef enum
+{
+    UPDATE_VERIFY_BUSY,         /* Call again */
+    UPDATE_VERIFY_VALID,        /* All images are valid */
+    UPDATE_VERIFY_INVALID
+} update_verify_result_t;
+
+/* Update slots left to verify, and the status of the current one */
+static uint32_t verify_slots = 0u;
+static uint32_t verify_image_id = 0u;
+static uint32_t verify_status = SECURE_VERIFY_STATUS_OK;
+#endif /* defined(SECURE_VERIFY) */
+
+#if defined(DFU_BACKGROUND)
+/* Steps of the DFU task, see dfu_background_task() */
+typedef enum
+{
+    DFU_TASK_RUN,               /* Cy_DFU_Continue() */
+    DFU_TASK_VERIFY,            /* Verification of the finished session */
+    DFU_TASK_RESET,             /* Waiting for dfu_service_reset_allowed() */
+    DFU_TASK_RESTART            /* Waiting for the error response to go out */
+} dfu_task_step_t;
+
+static dfu_task_step_t dfu_task_step = DFU_TASK_RUN;
+#endif /* defined(DFU_BACKGROUND) */
+
+#if defined(DFU_MULTI_TRANSPORT)
+/* Transports armed together in multi-transport mode. USB-CDC and USB-HID
+ * share the composite USB device. */
+static const cy_en_dfu_transport_t dfu_transport_listen[] =
+    {CY_DFU_I2C, CY_DFU_USB_CDC, CY_DFU_USB_HID,
+#if defined(COMPONENT_DFU_SPI_DMA)
+     CY_DFU_SPI,
+#endif /* defined(COMPONENT_DFU_SPI_DMA) */
+#if defined(COMPONENT_DFU_CANFD_ISOTP)
+     CY_DFU_CANFD,
+#endif /* defined(COMPONENT_DFU_CANFD_ISOTP) */
+    };
+#else
 /* For DFU Transport switching */
 static cy_en_dfu_transport_t dfu_transport = DEFAULT_DFU_TRANSPORT;
 static cy_en_dfu_transport_t new_dfu_transport = DEFAULT_DFU_TRANSPORT;
-const static cy_en_dfu_transport_t dfu_transport_supported[MAX_DFU_TRANSPORT] = 
-    {CY_DFU_I2C, CY_DFU_USB_CDC, CY_DFU_USB_HID};
+const static cy_en_dfu_transport_t dfu_transport_supported[] =
+    {CY_DFU_I2C, CY_DFU_USB_CDC, CY_DFU_USB_HID,
+#if defined(COMPONENT_DFU_SPI_DMA)
+     CY_DFU_SPI,
+#endif /* defined(COMPONENT_DFU_SPI_DMA) */
+#if defined(COMPONENT_DFU_CANFD_ISOTP)
+     CY_DFU_CANFD,
+#endif /* defined(COMPONENT_DFU_CANFD_ISOTP) */
+    };
+#endif /* defined(DFU_MULTI_TRANSPORT) */
 
 /* I2C transport HAL object  */
 static mtb_hal_i2c_t             dfuI2cHalObj;
 static cy_stc_scb_i2c_context_t  dfuI2cContext;
 
+#if defined(COMPONENT_DFU_SPI_DMA)
+/* SPI transport context */
+static cy_stc_scb_spi_context_t  dfuSpiContext;
+#endif /* defined(COMPONENT_DFU_SPI_DMA) */
+
+#if defined(COMPONENT_DFU_CANFD_ISOTP)
+/* CAN FD transport context */
+static cy_stc_canfd_context_t    dfuCanfdContext;
+#endif /* defined(COMPONENT_DFU_CANFD_ISOTP) */
+
+#if defined(DFU_USB_COMPOSITE)
+/* Data structure for the emUSB composite CDC + HID device */
+static const USB_DEVICE_INFO USB_DeviceInfo_Composite =
+{
+    .VendorId = 0x058B,
+    .ProductId = 0xF21D,
+    .sVendorName = "Infineon",
+    .sProductName = "PSOC-DFU-USB",
+    .sSerialNumber = "0132456789"
+};
+
+/* USB classes added to and enabled on the composite device */
+static uint32_t usb_classes_added = 0u;
+static uint32_t usb_classes_enabled = 0u;
+static bool usb_started = false;
+
+/* Composite device actions, shared by the USB-CDC and USB-HID callbacks */
+typedef enum
+{
+    DFU_USB_CLASS_ADD,
+    DFU_USB_CLASS_ENABLE,
+    DFU_USB_CLASS_DISABLE,
+    DFU_USB_CLASS_REMOVE,
+} dfu_usb_class_action_t;
+#else
 /* Data structure for emUSB-CDC-Device */
 static const USB_DEVICE_INFO USB_DeviceInfo_CDC =
 {
@@ -127,6 +278,7 @@ static const USB_DEVICE_INFO USB_DeviceInfo_HID =
     .sProductName = "PSOC-DFU-USB-HID",
     .sSerialNumber = "9876543210"
 };
+#endif /* defined(DFU_USB_COMPOSITE) */
 
 /*******************************************************************************
  * Function Prototypes
@@ -134,15 +286,44 @@ static const USB_DEVICE_INFO USB_DeviceInfo_HID =
 
 static char *dfu_status_in_str(cy_en_dfu_status_t dfu_status);
 static void dfu_transport_check(void);
+static void startup_continue(void);
+static void dfu_finish(void);
+static void dfu_restart(uint32_t *dfu_state, cy_stc_dfu_params_t *dfu_params);
+#if defined(DFU_BACKGROUND)
+static void dfu_background_task(uint32_t *dfu_state, cy_stc_dfu_params_t *dfu_params);
+static void app_task(void);
+#endif /* defined(DFU_BACKGROUND) */
+#if defined(SECURE_VERIFY)
+#if !defined(DFU_BACKGROUND)
+static bool update_verify(uint32_t slots);
+#endif /* !defined(DFU_BACKGROUND) */
+static void update_verify_start(uint32_t slots);
+static update_verify_result_t update_verify_step(uint32_t max_bytes);
+#endif /* defined(SECURE_VERIFY) */
+#if !defined(DFU_MULTI_TRANSPORT)
 static void user_btn1_isr(void);
+#endif /* !defined(DFU_MULTI_TRANSPORT) */
 static void dfuI2cIsr(void);
 static void dfuI2cTransportCallback(cy_en_dfu_transport_i2c_action_t action);
 static void dfuUsbCdcTransportCallback(cy_en_dfu_transport_usb_cdc_action_t action);
 static void dfuUsbHidTransportCallback(cy_en_dfu_transport_usb_hid_action_t action);
 static void dfu_transport_init(cy_en_dfu_transport_t transport);
+static const char *dfu_transport_name(cy_en_dfu_transport_t transport);
+#if defined(DFU_USB_COMPOSITE)
+static void dfu_usb_composite_update(uint32_t usb_class, dfu_usb_class_action_t action);
+static void dfu_usb_composite_start(void);
+#endif /* defined(DFU_USB_COMPOSITE) */
 static void dfu_usb_hid_transport_init(void);
 static void dfu_usb_cdc_transport_init(void);
 static void dfu_i2c_transport_init(void);
+#if defined(COMPONENT_DFU_SPI_DMA)
+static void dfuSpiDmaTransportCallback(cy_en_dfu_transport_spi_dma_action_t action);
+static void dfu_spi_transport_init(void);
+#endif /* defined(COMPONENT_DFU_SPI_DMA) */
+#if defined(COMPONENT_DFU_CANFD_ISOTP)
+static void dfuCanfdIsotpTransportCallback(cy_en_dfu_transport_canfd_isotp_action_t action);
+static void dfu_canfd_transport_init(void);
+#endif /* defined(COMPONENT_DFU_CANFD_ISOTP) */
 
 /*******************************************************************************
  * Function Name: main
@@ -160,7 +341,9 @@ static void dfu_i2c_transport_init(void);
  *******************************************************************************/
 int main(void)
 {
+#if !defined(DFU_BACKGROUND)
     uint32_t count = 0;
+#endif /* !defined(DFU_BACKGROUND) */
     cy_rslt_t result;
     cy_en_dfu_status_t dfu_status = CY_DFU_ERROR_UNKNOWN;
     uint32_t dfu_state = CY_DFU_STATE_NONE;
@@ -180,12 +363,16 @@ int main(void)
         .packetBuffer = &dfu_packet[0],
     };
 
+#if !defined(DFU_MULTI_TRANSPORT)
     /* Interrupt config structure */
     cy_stc_sysint_t intrCfg =
     {
         .intrSrc = CYBSP_USER_BTN_IRQ,
         .intrPriority = GPIO_INTERRUPT_PRIORITY
     };
+#endif /* !defined(DFU_MULTI_TRANSPORT) */
+
+    BOOT_TIME_MARK(NS_MAIN);
 
     /* Initialize the device and board peripherals */
     result = cybsp_init();
@@ -199,43 +386,47 @@ int main(void)
     /* Enable global interrupts */
     __enable_irq();
 
+    BOOT_TIME_MARK(NS_BSP);
+
     /* Initialize retarget-io middleware */
     init_retarget_io();
 
-    /* Register interrupt callback for USER_BTN1 */
-    Cy_SysInt_Init(&intrCfg, &user_btn1_isr);
-
-    /* Enable the interrupt in the NVIC */
-    Cy_GPIO_ClearInterrupt(CYBSP_USER_BTN1_PORT, CYBSP_USER_BTN1_PIN);
-    NVIC_ClearPendingIRQ(CYBSP_USER_BTN1_IRQ);
-    NVIC_EnableIRQ(intrCfg.intrSrc);
+    BOOT_TIME_MARK(NS_RETARGET_IO);
 
-    printf("\r\n\n***************** PSOC Edge MCU: DFU Code Example *****************\r\n\n");
+#if defined(DFU_PERF)
+    /* Start the cycle counter for the DFU performance counters */
+    dfu_perf_init();
+#endif /* defined(DFU_PERF) */
 
-    printf("For more projects, visit our code examples repositories:\r\n\n");
+#if defined(DFU_TRACE)
+    /* Start the deferred binary trace on the debug UART */
+    dfu_trace_init();
+#endif /* defined(DFU_TRACE) */
 
-    printf("https://github.com/Infineon/Code-Examples-for-ModusToolbox-Software\r\n\n");
+#if defined(DFU_RECORD)
+    /* Record the packets of each DFU session for replay on the host */
+    dfu_record_init();
+#endif /* defined(DFU_RECORD) */
 
-    printf("\n====================================================================\n");
-    printf("\r [DFU APP] Version: %s | CPU: CM33\r", APP_VERSION);
-    printf("\n====================================================================\n");
+#if defined(DFU_BACKGROUND)
+    /* Clock and CPU budget of the DFU task */
+    dfu_service_init();
+#endif /* defined(DFU_BACKGROUND) */
 
-    /* Initialize serial memory middleware */
-    result = mtb_serial_memory_setup(&smif0_obj, MTB_SERIAL_MEMORY_CHIP_SELECT_1,
-                                     CYBSP_SMIF_CORE_0_XSPI_FLASH_hal_config.base,
-                                     CYBSP_SMIF_CORE_0_XSPI_FLASH_hal_config.clock,
-                                     &smif0_mem_cxt, &smif0_mem_info, &smif0BlockConfig);
-    if (result != CY_RSLT_SUCCESS)
-    {
-        printf("Serial memory setup failed\r\n");
-        CY_ASSERT(0);
-    }
+#if defined(DFU_XIP_QOS)
+    /* Duty cycle limit of the flash operations of DFU */
+    dfu_xip_qos_init();
+#endif /* defined(DFU_XIP_QOS) */
 
-    /* Enable CM55 */
-    Cy_SysEnableCM55(MXCM55, CM55_APP_BOOT_ADDR, CM55_BOOT_WAIT_TIME_USEC);
+#if !defined(DFU_MULTI_TRANSPORT)
+    /* Register interrupt callback for USER_BTN1 */
+    Cy_SysInt_Init(&intrCfg, &user_btn1_isr);
 
-    /* Add External memory to DFU middleware */
-    Cy_DFU_AddExtMemory(&smif0_obj);
+    /* Enable the interrupt in the NVIC */
+    Cy_GPIO_ClearInterrupt(CYBSP_USER_BTN1_PORT, CYBSP_USER_BTN1_PIN);
+    NVIC_ClearPendingIRQ(CYBSP_USER_BTN1_IRQ);
+    NVIC_EnableIRQ(intrCfg.intrSrc);
+#endif /* !defined(DFU_MULTI_TRANSPORT) */
 
     /* Initialize DFU Structure. */
     dfu_status = Cy_DFU_Init(&dfu_state, &dfu_params);
@@ -245,22 +436,73 @@ int main(void)
         CY_ASSERT(0);
     }
 
+    BOOT_TIME_MARK(NS_DFU_INIT);
+
+#if defined(DFU_MULTI_TRANSPORT)
+    /* Arm all transports, the first valid Enter DFU command selects one */
+    for (uint32_t idx = 0u; idx < DFU_LISTEN_TRANSPORT_COUNT; idx++)
+    {
+        printf("\r\n STARTING DFU Transport ");
+        dfu_transport_init(dfu_transport_listen[idx]);
+    }
+    Cy_DFU_TransportStartMulti(dfu_transport_listen, DFU_LISTEN_TRANSPORT_COUNT);
+    dfu_usb_composite_start();
+#elif defined(DFU_USB_COMPOSITE)
+    /* Start every transport once, switching only changes the selected one */
+    for (uint32_t idx = 0u; idx < MAX_DFU_TRANSPORT; idx++)
+    {
+        printf("\r\n STARTING DFU Transport ");
+        dfu_transport_init(dfu_transport_supported[idx]);
+    }
+    Cy_DFU_TransportStartMulti(dfu_transport_supported, MAX_DFU_TRANSPORT);
+    dfu_usb_composite_start();
+    Cy_DFU_TransportSelect(dfu_transport);
+    printf("\r\n SELECTED DFU Transport %s\r\n", dfu_transport_name(dfu_transport));
+#else
     printf("\r\n STARTING DFU Transport ");
     /* Initialize DFU communication. */
     dfu_transport_init(dfu_transport);
     Cy_DFU_TransportStart(dfu_transport);
+#endif /* defined(DFU_MULTI_TRANSPORT) */
+
+    BOOT_TIME_MARK(NS_READY);
 
     for (;;)
     {
+        /* The rest of the start up, one stage per pass. The serial memory is
+         * set up in the first pass, before any DFU command is handled, and
+         * blocks that pass. */
+        if (startup_stage != STARTUP_DONE)
+        {
+            startup_continue();
+        }
+
+#if defined(DFU_BACKGROUND)
+        /* DFU runs as one task of the application, within its CPU budget */
+        dfu_background_task(&dfu_state, &dfu_params);
+        app_task();
+#else
+        DFU_PERF_BEGIN(perf_continue);
         dfu_status = Cy_DFU_Continue(&dfu_state, &dfu_params);
+        if (dfu_status != CY_DFU_ERROR_TIMEOUT)
+        {
+            DFU_PERF_END(DFU_PERF_CONTINUE, perf_continue);
+        }
         count++;
+#if defined(SECURE_VERIFY)
+        if ((CY_DFU_STATE_FINISHED == dfu_state) && (!update_verify(Cy_DFU_GetUpdatedSlots())))
+        {
+            /* The bootloader would refuse the update, stay in DFU instead of
+             * a reset that only boots the current images again */
+            dfu_state = CY_DFU_STATE_FAILED;
+            dfu_status = CY_DFU_ERROR_VERIFY;
+        }
+#endif /* defined(SECURE_VERIFY) */
         if (CY_DFU_STATE_FINISHED == dfu_state)
         {
             printf("\r\n DFU_STATE_FINISHED - %s \r\n Launching Bootloader\r", dfu_status_in_str(dfu_status));
             Cy_SysLib_Delay(1000);
-
-            /* All went well, Restarting the device to complete the upgrade */
-            NVIC_SystemReset();
+            dfu_finish();
         }
         else if (CY_DFU_STATE_FAILED == dfu_state)
         {
@@ -269,8 +511,7 @@ int main(void)
             /* An error occurred. Handle it here.
              * This code just restarts the DFU */
             count = 0u;
-            Cy_DFU_Init(&dfu_state, &dfu_params);
-            dfu_transport_check();
+            dfu_restart(&dfu_state, &dfu_params);
         }
         else if (dfu_state == CY_DFU_STATE_UPDATING)
         {
@@ -284,8 +525,7 @@ int main(void)
                 {
                     /* No command has been received since last 5 seconds. Restart DFU */
                     count = 0u;
-                    Cy_DFU_Init(&dfu_state, &dfu_params);
-                    dfu_transport_check();
+                    dfu_restart(&dfu_state, &dfu_params);
                 }
             }
             else
@@ -319,10 +559,456 @@ int main(void)
             Cy_GPIO_Inv(DFU_LED_PORT, DFU_LED_PIN);
         }
 
+#if defined(DFU_TRACE)
+        /* Send queued trace records without waiting for the UART */
+        dfu_trace_drain();
+#endif /* defined(DFU_TRACE) */
+
+        DFU_PERF_BEGIN(perf_delay);
         Cy_SysLib_Delay(1);
+        DFU_PERF_END(DFU_PERF_LOOP_DELAY, perf_delay);
+#endif /* defined(DFU_BACKGROUND) */
     }
 }
 
+/*******************************************************************************
+ * Function Name: dfu_finish
+ ********************************************************************************
+ * Summary:
+ *  Resets the device to let the bootloader install the images of a finished
+ *  DFU session. Prints the flash busy time of the session and sends what is left
+ *  of the trace and the recording first.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void dfu_finish(void)
+{
+#if defined(DFU_XIP_QOS)
+    const dfu_xip_qos_stats_t *qos = dfu_xip_qos_get_stats();
+
+    printf("\r Flash busy: longest %lu us, total %lu us, %lu suspends, %lu us throttled \r\n",
+           (unsigned long)qos->max_busy_us, (unsigned long)qos->busy_us, (unsigned long)qos->suspends,
+           (unsigned long)qos->throttle_us);
+#endif /* defined(DFU_XIP_QOS) */
+#if defined(DFU_TRACE)
+    dfu_trace_flush();
+#endif /* defined(DFU_TRACE) */
+#if defined(DFU_RECORD)
+    /* The recording is lost with the reset */
+    dfu_record_dump();
+#endif /* defined(DFU_RECORD) */
+    retarget_io_flush();
+
+    /* All went well, Restarting the device to complete the upgrade */
+    NVIC_SystemReset();
+}
+
+/*******************************************************************************
+ * Function Name: dfu_restart
+ ********************************************************************************
+ * Summary:
+ *  Starts DFU again after a failed or timed out session.
+ *
+ * Parameters:
+ *  dfu_state  : DFU state
+ *  dfu_params : DFU parameters
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void dfu_restart(uint32_t *dfu_state, cy_stc_dfu_params_t *dfu_params)
+{
+#if defined(DFU_RECORD)
+    dfu_record_dump();
+#endif /* defined(DFU_RECORD) */
+    Cy_DFU_Init(dfu_state, dfu_params);
+    dfu_transport_check();
+}
+
+#if defined(DFU_BACKGROUND)
+/*******************************************************************************
+ * Function Name: dfu_background_task
+ ********************************************************************************
+ * Summary:
+ *  Runs one bounded step of DFU: one Cy_DFU_Continue() call, which handles at
+ *  most one command and waits at most DFU_SERVICE_POLL_MS for it, or one step
+ *  of the verification of a finished session. Nothing here waits with
+ *  Cy_SysLib_Delay(), the timeouts of the session are measured with the
+ *  clock of the service. The step is skipped when the DFU budget of the
+ *  current window is used up, see dfu_service.h.
+ *
+ * Parameters:
+ *  dfu_state  : DFU state
+ *  dfu_params : DFU parameters
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void dfu_background_task(uint32_t *dfu_state, cy_stc_dfu_params_t *dfu_params)
+{
+    static uint32_t last_command_ms = 0u;
+    static uint32_t restart_ms = 0u;
+    cy_en_dfu_status_t dfu_status = CY_DFU_ERROR_TIMEOUT;
+    uint32_t now;
+
+    if (!dfu_service_begin())
+    {
+        return;
+    }
+    now = dfu_service_now_ms();
+
+    switch (dfu_task_step)
+    {
+        case DFU_TASK_RUN:
+        {
+        #if defined(DFU_XIP_QOS)
+            /* A row write would wait for the flash duty cycle limit, let the
+             * application run meanwhile */
+            if (!dfu_xip_qos_ready())
+            {
+                break;
+            }
+        #endif /* defined(DFU_XIP_QOS) */
+            DFU_PERF_BEGIN(perf_continue);
+            dfu_status = Cy_DFU_Continue(dfu_state, dfu_params);
+            if (dfu_status != CY_DFU_ERROR_TIMEOUT)
+            {
+                DFU_PERF_END(DFU_PERF_CONTINUE, perf_continue);
+            }
+            break;
+        }
+
+    #if defined(SECURE_VERIFY)
+        case DFU_TASK_VERIFY:
+            switch (update_verify_step(DFU_SERVICE_VERIFY_STEP))
+            {
+                case UPDATE_VERIFY_BUSY:
+                    break;
+
+                case UPDATE_VERIFY_VALID:
+                    dfu_task_step = DFU_TASK_RESET;
+                    break;
+
+                default:
+                    /* The bootloader would refuse the update, stay in DFU
+                     * instead of a reset that only boots the current images */
+                    *dfu_state = CY_DFU_STATE_FAILED;
+                    dfu_status = CY_DFU_ERROR_VERIFY;
+                    dfu_task_step = DFU_TASK_RUN;
+                    break;
+            }
+            break;
+    #endif /* defined(SECURE_VERIFY) */
+
+        case DFU_TASK_RESET:
+            if (dfu_service_reset_allowed())
+            {
+                dfu_finish();
+            }
+            break;
+
+        case DFU_TASK_RESTART:
+            /* The transport may still be sending the error response */
+            if ((now - restart_ms) >= DFU_SESSION_TIMEOUT_MS)
+            {
+                dfu_transport_check();
+                last_command_ms = now;
+                dfu_task_step = DFU_TASK_RUN;
+            }
+            break;
+
+        default:
+            dfu_task_step = DFU_TASK_RUN;
+            break;
+    }
+
+    if (dfu_task_step == DFU_TASK_RUN)
+    {
+        if (CY_DFU_STATE_FINISHED == *dfu_state)
+        {
+            const dfu_service_stats_t *stats = dfu_service_get_stats();
+
+            printf("\r\n DFU_STATE_FINISHED - %s \r\n", dfu_status_in_str(dfu_status));
+            printf("\r DFU task: %lu calls, longest %lu us, %lu deferred \r\n", (unsigned long)stats->calls,
+                   (unsigned long)stats->max_call_us, (unsigned long)stats->deferred);
+        #if defined(SECURE_VERIFY)
+            update_verify_start(Cy_DFU_GetUpdatedSlots());
+            dfu_task_step = DFU_TASK_VERIFY;
+        #else
+            dfu_task_step = DFU_TASK_RESET;
+        #endif /* defined(SECURE_VERIFY) */
+        }
+        else if (CY_DFU_STATE_FAILED == *dfu_state)
+        {
+            printf("\r DFU_STATE_FAILED - %s \r", dfu_status_in_str(dfu_status));
+            dfu_restart(dfu_state, dfu_params);
+            last_command_ms = now;
+        }
+        else if (*dfu_state == CY_DFU_STATE_UPDATING)
+        {
+            if (dfu_status == CY_DFU_SUCCESS)
+            {
+                last_command_ms = now;
+            }
+            else if (dfu_status == CY_DFU_ERROR_TIMEOUT)
+            {
+                if ((now - last_command_ms) >= DFU_COMMAND_TIMEOUT_MS)
+                {
+                    /* No command has been received since last 5 seconds. Restart DFU */
+                    dfu_restart(dfu_state, dfu_params);
+                    last_command_ms = now;
+                }
+            }
+            else
+            {
+                /* Restart DFU once the error response is sent */
+                restart_ms = now;
+                dfu_task_step = DFU_TASK_RESTART;
+            }
+        }
+        else
+        {
+            /* dfu_state == CY_DFU_STATE_NONE */
+            last_command_ms = now;
+            dfu_transport_check();
+        }
+    }
+
+    dfu_service_end();
+}
+
+/*******************************************************************************
+ * Function Name: app_task
+ ********************************************************************************
+ * Summary:
+ *  Stands in for the work of the application, which runs in every pass of the
+ *  main loop while DFU runs in the background. It blinks the LED and sends
+ *  the queued trace records.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void app_task(void)
+{
+    static uint32_t blink_ms = 0u;
+    uint32_t now = dfu_service_now_ms();
+
+    if ((now - blink_ms) >= LED_TOGGLE_INTERVAL_MS)
+    {
+        blink_ms = now;
+        Cy_GPIO_Inv(DFU_LED_PORT, DFU_LED_PIN);
+    }
+
+#if defined(DFU_TRACE)
+    /* Send queued trace records without waiting for the UART */
+    dfu_trace_drain();
+#endif /* defined(DFU_TRACE) */
+}
+#endif /* defined(DFU_BACKGROUND) */
+
+/*******************************************************************************
+ * Function Name: startup_continue
+ ********************************************************************************
+ * Summary:
+ *  Runs the next stage of the start up work that main() defers until the DFU
+ *  transport is started, so that the host can connect, and USB can enumerate,
+ *  while the rest of the device comes up:
+ *  - The serial memory is set up first. mtb_serial_memory_setup() reads the
+ *    SFDP tables in one blocking call, so this pass runs before the first
+ *    Cy_DFU_Continue() and DFU commands wait in the transport until it
+ *    returns. Cy_DFU_AddExtMemory() is only called if the setup succeeds.
+ *    Otherwise the flash reads and writes of the DFU middleware fail with
+ *    CY_DFU_ERROR_READ_EXT, which the host gets as the status of its command,
+ *    instead of touching an unconfigured memory.
+ *  - The CM55 boot and the banner are not needed for DFU and run in later
+ *    passes of the main loop, after the first DFU command has had a chance to
+ *    be handled.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void startup_continue(void)
+{
+    cy_rslt_t result;
+
+    switch (startup_stage)
+    {
+        case STARTUP_SERIAL_MEMORY:
+            /* Initialize serial memory middleware */
+            result = mtb_serial_memory_setup(&smif0_obj, MTB_SERIAL_MEMORY_CHIP_SELECT_1,
+                                             CYBSP_SMIF_CORE_0_XSPI_FLASH_hal_config.base,
+                                             CYBSP_SMIF_CORE_0_XSPI_FLASH_hal_config.clock,
+                                             &smif0_mem_cxt, &smif0_mem_info, &smif0BlockConfig);
+            if (result != CY_RSLT_SUCCESS)
+            {
+                /* The transport is already up, so keep running: without the
+                 * memory each row fails with CY_DFU_ERROR_READ_EXT, which the
+                 * host sees as the status of its command */
+                printf("Serial memory setup failed: 0x%08lx\r\n", (unsigned long)result);
+            }
+            else
+            {
+                /* Add External memory to DFU middleware */
+                Cy_DFU_AddExtMemory(&smif0_obj);
+            }
+            BOOT_TIME_MARK(NS_SERIAL_MEMORY);
+            break;
+
+        case STARTUP_CM55:
+            /* Enable CM55 */
+            Cy_SysEnableCM55(MXCM55, CM55_APP_BOOT_ADDR, CM55_BOOT_WAIT_TIME_USEC);
+            BOOT_TIME_MARK(NS_CM55);
+            break;
+
+        case STARTUP_BANNER:
+            printf("\r\n\n***************** PSOC Edge MCU: DFU Code Example *****************\r\n\n");
+
+            printf("For more projects, visit our code examples repositories:\r\n\n");
+
+            printf("https://github.com/Infineon/Code-Examples-for-ModusToolbox-Software\r\n\n");
+
+            printf("\n====================================================================\n");
+            printf("\r [DFU APP] Version: %s | CPU: CM33\r", APP_VERSION);
+            printf("\n====================================================================\n");
+#if defined(DFU_RUNNING_SLOT_GUARD)
+            printf("\r [DFU APP] Running slot guard, running from 0x%08lx\r\n", (unsigned long)CYMEM_CM33_0_m33_nvm_START);
+#endif /* defined(DFU_RUNNING_SLOT_GUARD) */
+            BOOT_TIME_MARK(NS_BANNER);
+
+#if defined(BOOT_TIME)
+            /* Print the time of each start up phase */
+            boot_time_print();
+#endif /* defined(BOOT_TIME) */
+            break;
+
+        default:
+            /* Start up is complete */
+            break;
+    }
+
+    if (startup_stage != STARTUP_DONE)
+    {
+        startup_stage = (startup_stage_t)((uint32_t)startup_stage + 1u);
+    }
+}
+
+#if defined(SECURE_VERIFY)
+#if !defined(DFU_BACKGROUND)
+/*******************************************************************************
+ * Function Name: update_verify
+ ********************************************************************************
+ * Summary:
+ *  Verifies the images in the update slots that the DFU session wrote with the
+ *  verification service of the secure image, as the bootloader will at the
+ *  next reset.
+ *
+ * Parameters:
+ *  slots : Bit n set for the update slot of MCUboot image ID n
+ *
+ * Return:
+ *  True if all images are valid
+ *
+ *******************************************************************************/
+static bool update_verify(uint32_t slots)
+{
+    update_verify_result_t result;
+
+    update_verify_start(slots);
+    do
+    {
+        result = update_verify_step(SECURE_VERIFY_MAX_STEP);
+    } while (result == UPDATE_VERIFY_BUSY);
+
+    return (result == UPDATE_VERIFY_VALID);
+}
+#endif /* !defined(DFU_BACKGROUND) */
+
+/*******************************************************************************
+ * Function Name: update_verify_start
+ ********************************************************************************
+ * Summary:
+ *  Starts the verification of update slots, see update_verify_step().
+ *
+ * Parameters:
+ *  slots : Bit n set for the update slot of MCUboot image ID n
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void update_verify_start(uint32_t slots)
+{
+    verify_slots = slots;
+    verify_status = SECURE_VERIFY_STATUS_OK;
+}
+
+/*******************************************************************************
+ * Function Name: update_verify_step
+ ********************************************************************************
+ * Summary:
+ *  Runs one call of the verification service: the start of the next slot,
+ *  the hash of up to max_bytes of the current one, or its check.
+ *
+ * Parameters:
+ *  max_bytes : Bytes hashed by this call at most
+ *
+ * Return:
+ *  UPDATE_VERIFY_BUSY until all slots are verified or one is not valid
+ *
+ *******************************************************************************/
+static update_verify_result_t update_verify_step(uint32_t max_bytes)
+{
+    if (verify_status == SECURE_VERIFY_STATUS_IN_PROGRESS)
+    {
+        verify_status = secure_verify_update(max_bytes);
+    }
+    else if (verify_status == SECURE_VERIFY_STATUS_HASHED)
+    {
+        verify_status = secure_verify_finish();
+    }
+    else if (verify_slots != 0u)
+    {
+        verify_image_id = 0u;
+        while ((verify_slots & (1uL << verify_image_id)) == 0u)
+        {
+            verify_image_id++;
+        }
+        verify_slots &= ~(1uL << verify_image_id);
+        verify_status = secure_verify_begin(verify_image_id);
+    }
+    else
+    {
+        return UPDATE_VERIFY_VALID;
+    }
+
+    if ((verify_status != SECURE_VERIFY_STATUS_OK) && (verify_status != SECURE_VERIFY_STATUS_IN_PROGRESS) &&
+        (verify_status != SECURE_VERIFY_STATUS_HASHED))
+    {
+        printf("\r\n Image %lu is not valid, status 0x%02lx \r\n", (unsigned long)verify_image_id,
+               (unsigned long)verify_status);
+        verify_slots = 0u;
+        return UPDATE_VERIFY_INVALID;
+    }
+
+    return UPDATE_VERIFY_BUSY;
+}
+#endif /* defined(SECURE_VERIFY) */
+
 /*******************************************************************************
  * Function Name: dfu_status_in_str
  ********************************************************************************
@@ -380,7 +1066,8 @@ static char *dfu_status_in_str(cy_en_dfu_status_t dfu_status)
  ********************************************************************************
  * Summary:
  * This is the function to check for pending transport switch request. It switches
- * DFU transport dynamically on GPIO interrupt request.
+ * DFU transport dynamically on GPIO interrupt request. In multi-transport mode
+ * it only resets the transports so that all of them listen again.
  *
  * Parameters:
  *  void
@@ -391,9 +1078,18 @@ static char *dfu_status_in_str(cy_en_dfu_status_t dfu_status)
  *******************************************************************************/
 static void dfu_transport_check(void)
 {
+#if defined(DFU_MULTI_TRANSPORT)
+    Cy_DFU_TransportReset();
+#else
     /* Check of DFU transport switch is requested*/
     if (new_dfu_transport != dfu_transport)
     {
+#if defined(DFU_USB_COMPOSITE)
+        /* All transports are running, route DFU traffic to the new one */
+        Cy_DFU_TransportReset();
+        Cy_DFU_TransportSelect(new_dfu_transport);
+        printf("\r\n SWITCHING DFU Transport to %s\r\n", dfu_transport_name(new_dfu_transport));
+#else
         /* Stop the current DFU transport */
         Cy_DFU_TransportReset();
         Cy_DFU_TransportStop();
@@ -402,6 +1098,7 @@ static void dfu_transport_check(void)
         printf("\r\n SWITCHING DFU Transport to ");
         dfu_transport_init(new_dfu_transport);
         Cy_DFU_TransportStart(new_dfu_transport);
+#endif /* defined(DFU_USB_COMPOSITE) */
 
         /* Conclude the switch */
         dfu_transport = new_dfu_transport;
@@ -411,8 +1108,10 @@ static void dfu_transport_check(void)
         /* DFU transport switch is not requested, reset the transport */
         Cy_DFU_TransportReset();
     }
+#endif /* defined(DFU_MULTI_TRANSPORT) */
 }
 
+#if !defined(DFU_MULTI_TRANSPORT)
 /*******************************************************************************
  * Function Name: user_btn1_isr
  ********************************************************************************
@@ -448,6 +1147,7 @@ static void user_btn1_isr(void)
         /* Previous switch request is not processed yet, ignore the new request*/
     }
 }
+#endif /* !defined(DFU_MULTI_TRANSPORT) */
 
 /*******************************************************************************
  * Function Name: dfuI2cIsr
@@ -509,6 +1209,20 @@ static void dfuUsbCdcTransportCallback(cy_en_dfu_transport_usb_cdc_action_t acti
 {
     switch (action)
     {
+#if defined(DFU_USB_COMPOSITE)
+        case CY_DFU_TRANSPORT_USB_CDC_INIT:
+            dfu_usb_composite_update(DFU_USB_CLASS_CDC, DFU_USB_CLASS_ADD);
+            break;
+        case CY_DFU_TRANSPORT_USB_CDC_ENABLE:
+            dfu_usb_composite_update(DFU_USB_CLASS_CDC, DFU_USB_CLASS_ENABLE);
+            break;
+        case CY_DFU_TRANSPORT_USB_CDC_DEINIT:
+            dfu_usb_composite_update(DFU_USB_CLASS_CDC, DFU_USB_CLASS_REMOVE);
+            break;
+        case CY_DFU_TRANSPORT_USB_CDC_DISABLE:
+            dfu_usb_composite_update(DFU_USB_CLASS_CDC, DFU_USB_CLASS_DISABLE);
+            break;
+#else
         case CY_DFU_TRANSPORT_USB_CDC_INIT:
             USBD_Init();
             break;
@@ -522,6 +1236,7 @@ static void dfuUsbCdcTransportCallback(cy_en_dfu_transport_usb_cdc_action_t acti
         case CY_DFU_TRANSPORT_USB_CDC_DISABLE:
             USBD_Stop();
             break;
+#endif /* defined(DFU_USB_COMPOSITE) */
         default:
             CY_ASSERT(0);
             break;
@@ -545,6 +1260,20 @@ static void dfuUsbHidTransportCallback(cy_en_dfu_transport_usb_hid_action_t acti
 {
     switch (action)
     {
+#if defined(DFU_USB_COMPOSITE)
+        case CY_DFU_TRANSPORT_USB_HID_INIT:
+            dfu_usb_composite_update(DFU_USB_CLASS_HID, DFU_USB_CLASS_ADD);
+            break;
+        case CY_DFU_TRANSPORT_USB_HID_ENABLE:
+            dfu_usb_composite_update(DFU_USB_CLASS_HID, DFU_USB_CLASS_ENABLE);
+            break;
+        case CY_DFU_TRANSPORT_USB_HID_DEINIT:
+            dfu_usb_composite_update(DFU_USB_CLASS_HID, DFU_USB_CLASS_REMOVE);
+            break;
+        case CY_DFU_TRANSPORT_USB_HID_DISABLE:
+            dfu_usb_composite_update(DFU_USB_CLASS_HID, DFU_USB_CLASS_DISABLE);
+            break;
+#else
         case CY_DFU_TRANSPORT_USB_HID_INIT:
             USBD_Init();
             break;
@@ -558,12 +1287,96 @@ static void dfuUsbHidTransportCallback(cy_en_dfu_transport_usb_hid_action_t acti
         case CY_DFU_TRANSPORT_USB_HID_DISABLE:
             USBD_Stop();
             break;
+#endif /* defined(DFU_USB_COMPOSITE) */
         default:
             CY_ASSERT(0);
             break;
     }
 }
 
+#if defined(DFU_USB_COMPOSITE)
+/*******************************************************************************
+ * Function Name: dfu_usb_composite_update
+ ********************************************************************************
+ * Summary:
+ *  Tracks the USB-CDC and USB-HID classes of the composite device. The USB stack
+ *  is initialized by the first class added. The device is not started here but
+ *  by dfu_usb_composite_start(), so the start of one USB transport never
+ *  depends on the other. The stack is stopped when the first class is disabled
+ *  and de-initialized when the last class goes away.
+ *
+ * Parameters:
+ *  usb_class : DFU_USB_CLASS_CDC or DFU_USB_CLASS_HID
+ *  action    : Transport callback action
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void dfu_usb_composite_update(uint32_t usb_class, dfu_usb_class_action_t action)
+{
+    switch (action)
+    {
+        case DFU_USB_CLASS_ADD:
+            if (usb_classes_added == 0u)
+            {
+                USBD_Init();
+                USBD_EnableIAD();
+            }
+            usb_classes_added |= usb_class;
+            break;
+        case DFU_USB_CLASS_ENABLE:
+            usb_classes_enabled |= usb_class;
+            break;
+        case DFU_USB_CLASS_DISABLE:
+            if (usb_started)
+            {
+                USBD_Stop();
+                usb_started = false;
+            }
+            usb_classes_enabled &= ~usb_class;
+            break;
+        case DFU_USB_CLASS_REMOVE:
+            usb_classes_added &= ~usb_class;
+            if (usb_classes_added == 0u)
+            {
+                USBD_DeInit();
+            }
+            break;
+        default:
+            CY_ASSERT(0);
+            break;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: dfu_usb_composite_start
+ ********************************************************************************
+ * Summary:
+ *  Starts the composite USB device once, after the DFU transports are started
+ *  and both USB classes are added, so the host enumerates it once with both
+ *  DFU interfaces. emUSB-Device does not accept classes after USBD_Start().
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void dfu_usb_composite_start(void)
+{
+    CY_ASSERT(usb_classes_enabled == DFU_USB_CLASS_ALL);
+
+    if (!usb_started)
+    {
+        USBD_SetDeviceInfo(&USB_DeviceInfo_Composite);
+        USBD_Start();
+        usb_started = true;
+    }
+}
+#endif /* defined(DFU_USB_COMPOSITE) */
+
 /*******************************************************************************
  * Function Name: dfu_transport_init
  ********************************************************************************
@@ -583,19 +1396,64 @@ static void dfu_transport_init(cy_en_dfu_transport_t transport)
     {
         case CY_DFU_I2C:
             dfu_i2c_transport_init();
-            printf("I2C\r\n");
             break;
         case CY_DFU_USB_CDC:
             dfu_usb_cdc_transport_init();
-            printf("USB-CDC\r\n");
             break;
         case CY_DFU_USB_HID:
             dfu_usb_hid_transport_init();
-            printf("USB-HID\r\n");
             break;
+#if defined(COMPONENT_DFU_SPI_DMA)
+        case CY_DFU_SPI:
+            dfu_spi_transport_init();
+            break;
+#endif /* defined(COMPONENT_DFU_SPI_DMA) */
+#if defined(COMPONENT_DFU_CANFD_ISOTP)
+        case CY_DFU_CANFD:
+            dfu_canfd_transport_init();
+            break;
+#endif /* defined(COMPONENT_DFU_CANFD_ISOTP) */
         default:
             break;
     }
+    printf("%s\r\n", dfu_transport_name(transport));
+}
+
+/*******************************************************************************
+ * Function Name: dfu_transport_name
+ ********************************************************************************
+ * Summary:
+ *  Returns the name of a DFU transport for the terminal messages
+ *
+ * Parameters:
+ *  transport : DFU transport
+ *
+ * Return:
+ *  string pointer
+ *
+ *******************************************************************************/
+static const char *dfu_transport_name(cy_en_dfu_transport_t transport)
+{
+    switch (transport)
+    {
+        case CY_DFU_I2C:
+            return "I2C";
+
+        case CY_DFU_USB_CDC:
+            return "USB-CDC";
+
+        case CY_DFU_USB_HID:
+            return "USB-HID";
+
+        case CY_DFU_SPI:
+            return "SPI";
+
+        case CY_DFU_CANFD:
+            return "CAN FD";
+
+        default:
+            return "Unknown";
+    }
 }
 
 /*******************************************************************************
@@ -702,4 +1560,135 @@ static void dfu_i2c_transport_init()
     Cy_DFU_TransportI2cConfig(&i2cTransportCfg);
 }
 
+#if defined(COMPONENT_DFU_SPI_DMA)
+/*******************************************************************************
+ * Function Name: dfuSpiDmaTransportCallback
+ ********************************************************************************
+ * Summary:
+ *  Callback to enable or disable DFU SPI transport
+ *
+ * Parameters:
+ *  action : Callback trigger
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void dfuSpiDmaTransportCallback(cy_en_dfu_transport_spi_dma_action_t action)
+{
+    if (action == CY_DFU_TRANSPORT_SPI_DMA_INIT)
+    {
+        Cy_SCB_SPI_Enable(DFU_SPI_HW);
+    }
+    else if (action == CY_DFU_TRANSPORT_SPI_DMA_DEINIT)
+    {
+        Cy_SCB_SPI_Disable(DFU_SPI_HW, &dfuSpiContext);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: dfu_spi_transport_init
+ ********************************************************************************
+ * Summary:
+ *  Configure DFU SPI transport to receive data from DFU Host Tool. The SCB
+ *  (DFU_SPI), the two DMA channels (DFU_SPI_RX_DMA, DFU_SPI_TX_DMA) with their
+ *  SCB trigger connections, and the ready/busy pin (DFU_SPI_READY) come from
+ *  the Device Configurator.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void dfu_spi_transport_init(void)
+{
+    cy_en_scb_spi_status_t pdlSpiStatus;
+
+    static const cy_stc_dfu_transport_spi_dma_cfg_t spiTransportCfg =
+    {
+        .base      = DFU_SPI_HW,
+        .context   = &dfuSpiContext,
+        .rxDma     = { DFU_SPI_RX_DMA_HW, DFU_SPI_RX_DMA_CHANNEL, DFU_SPI_RX_DMA_IRQ },
+        .txDma     = { DFU_SPI_TX_DMA_HW, DFU_SPI_TX_DMA_CHANNEL, DFU_SPI_TX_DMA_IRQ },
+        .readyPort = DFU_SPI_READY_PORT,
+        .readyPin  = DFU_SPI_READY_PIN,
+        .callback  = dfuSpiDmaTransportCallback,
+    };
+
+    pdlSpiStatus = Cy_SCB_SPI_Init(DFU_SPI_HW, &DFU_SPI_config, &dfuSpiContext);
+    if (CY_SCB_SPI_SUCCESS != pdlSpiStatus)
+    {
+        CY_DFU_LOG_ERR("Error during SPI PDL initialization. Status: %X", (unsigned int)pdlSpiStatus);
+    }
+    else
+    {
+        CY_DFU_LOG_INF("SPI transport is initialized");
+    }
+
+    Cy_DFU_TransportSpiDmaConfig(&spiTransportCfg);
+}
+#endif /* defined(COMPONENT_DFU_SPI_DMA) */
+
+#if defined(COMPONENT_DFU_CANFD_ISOTP)
+/*******************************************************************************
+ * Function Name: dfuCanfdIsotpTransportCallback
+ ********************************************************************************
+ * Summary:
+ *  Callback to enable or disable DFU CAN FD transport
+ *
+ * Parameters:
+ *  action : Callback trigger
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void dfuCanfdIsotpTransportCallback(cy_en_dfu_transport_canfd_isotp_action_t action)
+{
+    if (action == CY_DFU_TRANSPORT_CANFD_ISOTP_INIT)
+    {
+        Cy_CANFD_Enable(DFU_CANFD_HW, 1UL << DFU_CANFD_CHANNEL);
+    }
+    else if (action == CY_DFU_TRANSPORT_CANFD_ISOTP_DEINIT)
+    {
+        Cy_CANFD_Disable(DFU_CANFD_HW, 1UL << DFU_CANFD_CHANNEL);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: dfu_canfd_transport_init
+ ********************************************************************************
+ * Summary:
+ *  Configure DFU CAN FD transport to receive data from the DFU host. The
+ *  transport programs the channel bit timing, message RAM and filters itself;
+ *  the CAN FD clock and pins come from the Device Configurator.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void dfu_canfd_transport_init(void)
+{
+    static const cy_stc_dfu_transport_canfd_isotp_cfg_t canfdTransportCfg =
+    {
+        .base              = DFU_CANFD_HW,
+        .channel           = DFU_CANFD_CHANNEL,
+        .irq               = DFU_CANFD_IRQ,
+        .context           = &dfuCanfdContext,
+        .messageRamAddress = DFU_CANFD_MRAM_ADDR,
+        .messageRamSize    = DFU_CANFD_MRAM_SIZE,
+        .rxId              = DFU_CANFD_RX_ID,
+        .txId              = DFU_CANFD_TX_ID,
+        .callback          = dfuCanfdIsotpTransportCallback,
+    };
+
+    Cy_DFU_TransportCanfdIsotpConfig(&canfdTransportCfg);
+}
+#endif /* defined(COMPONENT_DFU_CANFD_ISOTP) */
+
 /* [] END OF FILE */
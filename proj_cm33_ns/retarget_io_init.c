@@ -41,6 +41,29 @@
 *******************************************************************************/
 #include "retarget_io_init.h"
 
+#if defined(DEBUG_UART_ASYNC)
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* The asynchronous mode replaces the GCC _write() of retarget-io */
+#if !defined(__GNUC__) || defined(__ARMCC_VERSION)
+    #error "DEBUG_UART_ASYNC is supported with the GCC_ARM toolchain only"
+#endif
+
+#define TX_RING_MASK            (DEBUG_UART_TX_RING_SIZE - 1U)
+
+#if ((DEBUG_UART_TX_RING_SIZE & TX_RING_MASK) != 0U)
+    #error "DEBUG_UART_TX_RING_SIZE must be a power of two"
+#endif
+
+/* Largest X loop count of a DataWire descriptor */
+#define TX_DMA_MAX_XCOUNT       (256U)
+
+/* _write() splits the output into pieces of at most this size, so a piece
+ * always fits into an empty ring */
+#define TX_WRITE_MAX            (DEBUG_UART_TX_RING_SIZE / 2U)
+#endif /* defined(DEBUG_UART_ASYNC) */
+
 /*******************************************************************************
 * Global Variables
 *******************************************************************************/
@@ -48,6 +71,54 @@
 static cy_stc_scb_uart_context_t    DEBUG_UART_context;  
 static mtb_hal_uart_t               DEBUG_UART_hal_obj;  
 
+#if defined(DEBUG_UART_ASYNC)
+/* TX ring drained by the DEBUG_UART_TX_DMA channel. The DMA reads from
+ * tx_tail and advances it when a chunk has been moved into the TX FIFO. */
+static uint8_t tx_ring[DEBUG_UART_TX_RING_SIZE];
+static volatile uint32_t tx_head;           /* Next index to write */
+static volatile uint32_t tx_tail;           /* Next index the DMA reads */
+static volatile uint32_t tx_dma_count;      /* Bytes in flight, 0 when idle */
+static volatile uint32_t tx_dropped;        /* Bytes lost to a full ring */
+
+static cy_stc_dma_descriptor_t tx_descriptor;
+
+/* Memory to TX FIFO, one byte per trigger */
+static const cy_stc_dma_descriptor_config_t tx_descriptor_config =
+{
+    .retrigger       = CY_DMA_RETRIG_IM,
+    .interruptType   = CY_DMA_DESCR,
+    .triggerOutType  = CY_DMA_1ELEMENT,
+    .channelState    = CY_DMA_CHANNEL_DISABLED,
+    .triggerInType   = CY_DMA_1ELEMENT,
+    .dataSize        = CY_DMA_BYTE,
+    .srcTransferSize = CY_DMA_TRANSFER_SIZE_DATA,
+    .dstTransferSize = CY_DMA_TRANSFER_SIZE_WORD,
+    .descriptorType  = CY_DMA_1D_TRANSFER,
+    .srcAddress      = NULL,
+    .dstAddress      = NULL,
+    .srcXincrement   = 1,
+    .dstXincrement   = 0,
+    .xCount          = 1U,
+    .srcYincrement   = 0,
+    .dstYincrement   = 0,
+    .yCount          = 1U,
+    .nextDescriptor  = NULL
+};
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void tx_dma_init(void);
+static void tx_dma_start(void);
+static void tx_dma_isr(void);
+static void tx_ring_put(const uint8_t data[], uint32_t length);
+static void tx_write(const uint8_t data[], uint32_t length);
+#if (CY_CFG_PWR_SYS_IDLE_MODE == CY_CFG_PWR_MODE_DEEPSLEEP)
+static cy_en_syspm_status_t tx_ring_syspm_callback(cy_stc_syspm_callback_params_t *callbackParams,
+                                                   cy_en_syspm_callback_mode_t mode);
+#endif /* (CY_CFG_PWR_SYS_IDLE_MODE == CY_CFG_PWR_MODE_DEEPSLEEP) */
+#endif /* defined(DEBUG_UART_ASYNC) */
+
 /* Retarget-io deepsleep callback parameters  */
 #if (CY_CFG_PWR_SYS_IDLE_MODE == CY_CFG_PWR_MODE_DEEPSLEEP)
 
@@ -88,8 +159,353 @@ static cy_stc_syspm_callback_t retarget_io_syspm_cb =
     .nextItm            = NULL,
     .order              = SYSPM_CALLBACK_ORDER
 };
+
+#if defined(DEBUG_UART_ASYNC)
+/* SysPm callback parameter structure for the TX ring */
+static cy_stc_syspm_callback_params_t tx_ring_syspm_cb_params =
+{
+    .context            = NULL,
+    .base               = CYBSP_DEBUG_UART_HW
+};
+
+/* SysPm callback structure for the TX ring, called before the UART one */
+static cy_stc_syspm_callback_t tx_ring_syspm_cb =
+{
+    .callback           = &tx_ring_syspm_callback,
+    .skipMode           = SYSPM_SKIP_MODE,
+    .type               = CY_SYSPM_DEEPSLEEP,
+    .callbackParams     = &tx_ring_syspm_cb_params,
+    .prevItm            = NULL,
+    .nextItm            = NULL,
+    .order              = SYSPM_ASYNC_CALLBACK_ORDER
+};
+#endif /* defined(DEBUG_UART_ASYNC) */
+#endif /* (CY_CFG_PWR_SYS_IDLE_MODE == CY_CFG_PWR_MODE_DEEPSLEEP) */
+
+#if defined(DEBUG_UART_ASYNC)
+/*******************************************************************************
+* Function Name: tx_dma_init
+********************************************************************************
+* Summary:
+*  Initializes the DEBUG_UART_TX_DMA channel that moves the TX ring into the
+*  debug UART TX FIFO and hooks up its completion interrupt. The channel is
+*  triggered by the TX FIFO level of the debug UART.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void tx_dma_init(void)
+{
+    cy_stc_dma_channel_config_t channel_config =
+    {
+        .descriptor  = &tx_descriptor,
+        .preemptable = false,
+        .priority    = 3U,
+        .enable      = false,
+        .bufferable  = false
+    };
+    cy_stc_sysint_t dma_isr_cfg =
+    {
+        .intrSrc      = DEBUG_UART_TX_DMA_IRQ,
+        .intrPriority = DEBUG_UART_TX_DMA_INTR_PRIORITY
+    };
+
+    /* The TX FIFO requests data while it has room */
+    Cy_SCB_SetTxFifoLevel(CYBSP_DEBUG_UART_HW, Cy_SCB_GetFifoSize(CYBSP_DEBUG_UART_HW) - 1U);
+
+    (void)Cy_DMA_Descriptor_Init(&tx_descriptor, &tx_descriptor_config);
+    Cy_DMA_Descriptor_SetDstAddress(&tx_descriptor, (void *)&SCB_TX_FIFO_WR(CYBSP_DEBUG_UART_HW));
+    (void)Cy_DMA_Channel_Init(DEBUG_UART_TX_DMA_HW, DEBUG_UART_TX_DMA_CHANNEL, &channel_config);
+    Cy_DMA_Channel_SetInterruptMask(DEBUG_UART_TX_DMA_HW, DEBUG_UART_TX_DMA_CHANNEL, CY_DMA_INTR_MASK);
+    Cy_DMA_Enable(DEBUG_UART_TX_DMA_HW);
+
+    (void)Cy_SysInt_Init(&dma_isr_cfg, &tx_dma_isr);
+    NVIC_ClearPendingIRQ(DEBUG_UART_TX_DMA_IRQ);
+    NVIC_EnableIRQ(DEBUG_UART_TX_DMA_IRQ);
+}
+
+/*******************************************************************************
+* Function Name: tx_dma_start
+********************************************************************************
+* Summary:
+*  Starts the DMA on the oldest contiguous part of the TX ring if the channel
+*  is idle. Must be called with interrupts disabled.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void tx_dma_start(void)
+{
+    uint32_t tail = tx_tail;
+    uint32_t count = tx_head - tail;
+    uint32_t contiguous = DEBUG_UART_TX_RING_SIZE - (tail & TX_RING_MASK);
+
+    if ((tx_dma_count == 0U) && (count != 0U))
+    {
+        count = (count > contiguous) ? contiguous : count;
+        count = (count > TX_DMA_MAX_XCOUNT) ? TX_DMA_MAX_XCOUNT : count;
+        tx_dma_count = count;
+
+        Cy_DMA_Descriptor_SetSrcAddress(&tx_descriptor, &tx_ring[tail & TX_RING_MASK]);
+        Cy_DMA_Descriptor_SetXloopDataCount(&tx_descriptor, count);
+        Cy_DMA_Channel_SetDescriptor(DEBUG_UART_TX_DMA_HW, DEBUG_UART_TX_DMA_CHANNEL, &tx_descriptor);
+        Cy_DMA_Channel_Enable(DEBUG_UART_TX_DMA_HW, DEBUG_UART_TX_DMA_CHANNEL);
+    }
+}
+
+/*******************************************************************************
+* Function Name: tx_dma_isr
+********************************************************************************
+* Summary:
+*  TX channel completion interrupt. Releases the chunk that has been moved
+*  into the TX FIFO and continues with the rest of the ring.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void tx_dma_isr(void)
+{
+    Cy_DMA_Channel_ClearInterrupt(DEBUG_UART_TX_DMA_HW, DEBUG_UART_TX_DMA_CHANNEL);
+
+    tx_tail += tx_dma_count;
+    tx_dma_count = 0U;
+    tx_dma_start();
+}
+
+/*******************************************************************************
+* Function Name: tx_ring_put
+********************************************************************************
+* Summary:
+*  Copies data into the TX ring. The caller checks that there is room and
+*  holds interrupts disabled.
+*
+* Parameters:
+*  data   : Data to add
+*  length : Number of bytes
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void tx_ring_put(const uint8_t data[], uint32_t length)
+{
+    uint32_t head = tx_head;
+
+    for (uint32_t i = 0U; i < length; i++)
+    {
+        tx_ring[(head + i) & TX_RING_MASK] = data[i];
+    }
+    tx_head = head + length;
+}
+
+/*******************************************************************************
+* Function Name: tx_write
+********************************************************************************
+* Summary:
+*  Adds data of at most TX_WRITE_MAX bytes to the TX ring according to the
+*  overflow policy. With DEBUG_UART_TX_BLOCK the call waits for the DMA to make
+*  room, otherwise data that does not fit is dropped and counted. The call
+*  never waits when interrupts are disabled, as the DMA interrupt could not
+*  run.
+*
+* Parameters:
+*  data   : Data to add
+*  length : Number of bytes
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void tx_write(const uint8_t data[], uint32_t length)
+{
+    uint32_t intr_state;
+    bool done = false;
+
+    while (!done)
+    {
+        intr_state = Cy_SysLib_EnterCriticalSection();
+
+        if ((DEBUG_UART_TX_RING_SIZE - (tx_head - tx_tail)) >= length)
+        {
+            tx_ring_put(data, length);
+            tx_dma_start();
+            done = true;
+        }
+        else if ((DEBUG_UART_TX_BLOCK == 0) || (intr_state != 0U))
+        {
+            tx_dropped += length;
+            done = true;
+        }
+        else
+        {
+            /* Wait for the DMA with interrupts enabled */
+        }
+
+        Cy_SysLib_ExitCriticalSection(intr_state);
+    }
+}
+
+#if (CY_CFG_PWR_SYS_IDLE_MODE == CY_CFG_PWR_MODE_DEEPSLEEP)
+/*******************************************************************************
+* Function Name: tx_ring_syspm_callback
+********************************************************************************
+* Summary:
+*  Deep Sleep callback of the TX ring. Deep Sleep is refused while output is
+*  still queued, so the UART callback that follows only sees an idle ring. The
+*  DMA channel is set up again after wake-up.
+*
+* Parameters:
+*  callbackParams : Callback parameters, unused
+*  mode           : SysPm callback mode
+*
+* Return:
+*  CY_SYSPM_FAIL if the ring is not empty, otherwise CY_SYSPM_SUCCESS
+*
+*******************************************************************************/
+static cy_en_syspm_status_t tx_ring_syspm_callback(cy_stc_syspm_callback_params_t *callbackParams,
+                                                   cy_en_syspm_callback_mode_t mode)
+{
+    cy_en_syspm_status_t status = CY_SYSPM_SUCCESS;
+
+    (void)callbackParams;
+
+    if ((CY_SYSPM_CHECK_READY == mode) && (tx_head != tx_tail))
+    {
+        status = CY_SYSPM_FAIL;
+    }
+    else if (CY_SYSPM_AFTER_TRANSITION == mode)
+    {
+        tx_dma_init();
+    }
+    else
+    {
+        /* Nothing to do */
+    }
+
+    return status;
+}
 #endif /* (CY_CFG_PWR_SYS_IDLE_MODE == CY_CFG_PWR_MODE_DEEPSLEEP) */
 
+/*******************************************************************************
+* Function Name: _write
+********************************************************************************
+* Summary:
+*  Replaces the weak GCC _write() of retarget-io, so printf() only copies its
+*  output into the TX ring instead of waiting for the UART. Line feeds are
+*  converted to CR LF when CY_RETARGET_IO_CONVERT_LF_TO_CRLF is defined.
+*
+* Parameters:
+*  fd  : File descriptor, unused
+*  ptr : Data to write
+*  len : Number of bytes
+*
+* Return:
+*  Number of bytes consumed, dropped bytes included
+*
+*******************************************************************************/
+int _write(int fd, const char *ptr, int len)
+{
+    static const uint8_t crlf[] = { (uint8_t)'\r', (uint8_t)'\n' };
+    const uint8_t *data = (const uint8_t *)ptr;
+    uint32_t length = ((ptr != NULL) && (len > 0)) ? (uint32_t)len : 0U;
+    uint32_t start = 0U;
+    uint32_t end;
+
+    (void)fd;
+
+    while (start < length)
+    {
+        end = start;
+        while ((end < length) && (data[end] != (uint8_t)'\n') && ((end - start) < TX_WRITE_MAX))
+        {
+            end++;
+        }
+
+        if (end > start)
+        {
+            tx_write(&data[start], end - start);
+        }
+
+        if ((end < length) && (data[end] == (uint8_t)'\n'))
+        {
+#if defined(CY_RETARGET_IO_CONVERT_LF_TO_CRLF)
+            tx_write(crlf, sizeof(crlf));
+#else
+            tx_write(&crlf[1], 1U);
+#endif /* defined(CY_RETARGET_IO_CONVERT_LF_TO_CRLF) */
+            end++;
+        }
+
+        start = end;
+    }
+
+    return (int)length;
+}
+
+/*******************************************************************************
+* Function Name: retarget_io_write
+********************************************************************************
+* Summary:
+*  Adds data to the TX ring only if all of it fits, independent of the
+*  overflow policy. Used by writers that must not be split, such as the binary
+*  trace frames, and that retry later themselves.
+*
+* Parameters:
+*  data   : Data to add
+*  length : Number of bytes
+*
+* Return:
+*  True if the data was added
+*
+*******************************************************************************/
+bool retarget_io_write(const uint8_t data[], uint32_t length)
+{
+    uint32_t intr_state = Cy_SysLib_EnterCriticalSection();
+    bool written = false;
+
+    if ((DEBUG_UART_TX_RING_SIZE - (tx_head - tx_tail)) >= length)
+    {
+        tx_ring_put(data, length);
+        tx_dma_start();
+        written = true;
+    }
+
+    Cy_SysLib_ExitCriticalSection(intr_state);
+
+    return written;
+}
+
+/*******************************************************************************
+* Function Name: retarget_io_get_dropped
+********************************************************************************
+* Summary:
+*  Returns the number of printf() bytes dropped because the TX ring was full.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  Number of dropped bytes
+*
+*******************************************************************************/
+uint32_t retarget_io_get_dropped(void)
+{
+    return tx_dropped;
+}
+#endif /* defined(DEBUG_UART_ASYNC) */
+
 /*******************************************************************************
 * Function Name: init_retarget_io
 ********************************************************************************
@@ -144,6 +560,48 @@ void init_retarget_io(void)
     /* UART SysPm callback registration for retarget-io */
     Cy_SysPm_RegisterCallback(&retarget_io_syspm_cb);
 #endif /* (CY_CFG_PWR_SYS_IDLE_MODE == CY_CFG_PWR_MODE_DEEPSLEEP) */
+
+#if defined(DEBUG_UART_ASYNC)
+    tx_dma_init();
+
+#if (CY_CFG_PWR_SYS_IDLE_MODE == CY_CFG_PWR_MODE_DEEPSLEEP)
+    /* TX ring SysPm callback registration */
+    Cy_SysPm_RegisterCallback(&tx_ring_syspm_cb);
+#endif /* (CY_CFG_PWR_SYS_IDLE_MODE == CY_CFG_PWR_MODE_DEEPSLEEP) */
+#endif /* defined(DEBUG_UART_ASYNC) */
+}
+
+/*******************************************************************************
+* Function Name: retarget_io_flush
+********************************************************************************
+* Summary:
+*  Waits until all queued debug output has left the UART, for example before
+*  a device reset. With interrupts disabled the DMA completion is polled.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void retarget_io_flush(void)
+{
+#if defined(DEBUG_UART_ASYNC)
+    while (tx_head != tx_tail)
+    {
+        if ((__get_PRIMASK() != 0U) &&
+            (Cy_DMA_Channel_GetInterruptStatus(DEBUG_UART_TX_DMA_HW, DEBUG_UART_TX_DMA_CHANNEL) != 0U))
+        {
+            tx_dma_isr();
+        }
+    }
+#endif /* defined(DEBUG_UART_ASYNC) */
+
+    while (!Cy_SCB_UART_IsTxComplete(CYBSP_DEBUG_UART_HW))
+    {
+        /* Wait for the last byte to leave the shifter */
+    }
 }
 
 /* [] END OF FILE */
\ No newline at end of file
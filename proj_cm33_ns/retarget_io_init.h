@@ -59,11 +59,37 @@
 #define SYSPM_SKIP_MODE         (0U)
 #define SYSPM_CALLBACK_ORDER    (1U)
 
+#if defined(DEBUG_UART_ASYNC)
+/* Size of the debug UART TX ring buffer, must be a power of two */
+#ifndef DEBUG_UART_TX_RING_SIZE
+    #define DEBUG_UART_TX_RING_SIZE         (2048U)
+#endif /* DEBUG_UART_TX_RING_SIZE */
+
+/* Set to 1 to make printf() wait for room in a full ring. By default the
+ * output that does not fit is dropped and counted. */
+#ifndef DEBUG_UART_TX_BLOCK
+    #define DEBUG_UART_TX_BLOCK             (0)
+#endif /* DEBUG_UART_TX_BLOCK */
+
+/* Interrupt priority of the TX DMA channel. Keep it above (numerically
+ * below) any interrupt that calls printf() in blocking mode. */
+#ifndef DEBUG_UART_TX_DMA_INTR_PRIORITY
+    #define DEBUG_UART_TX_DMA_INTR_PRIORITY (6U)
+#endif /* DEBUG_UART_TX_DMA_INTR_PRIORITY */
+
+/* The TX ring must be idle before the one of the UART is called */
+#define SYSPM_ASYNC_CALLBACK_ORDER  (0U)
+#endif /* defined(DEBUG_UART_ASYNC) */
 
 /*******************************************************************************
 * Function prototypes
 *******************************************************************************/
 void init_retarget_io(void);
+void retarget_io_flush(void);
+#if defined(DEBUG_UART_ASYNC)
+bool retarget_io_write(const uint8_t data[], uint32_t length);
+uint32_t retarget_io_get_dropped(void);
+#endif /* defined(DEBUG_UART_ASYNC) */
 
 /*******************************************************************************
 * Function Name: handle_app_error
@@ -0,0 +1,916 @@
+/*******************************************************************************
+* File Name        : transport_canfd_isotp.c
+*
+* Description      : This file provides a CAN FD transport for the DFU
+*                    middleware. DFU packets are carried in 64-byte CAN FD
+*                    frames with bit rate switching and are segmented as in
+*                    ISO 15765-2 (ISO-TP): a single frame for short packets,
+*                    otherwise a first frame followed by consecutive frames
+*                    paced by flow control frames from the receiver. Only
+*                    frames with the configured host ID pass the hardware
+*                    filter into RX FIFO 0.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#if defined(COMPONENT_DFU_CANFD_ISOTP)
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <string.h>
+#include "transport_canfd_isotp.h"
+#include "cy_dfu_logging.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* CAN FD frame payload */
+#define FRAME_SIZE                  (64U)
+#define FRAME_PADDING               (0xCCU)
+
+/* ISO-TP protocol control information, upper nibble of the first byte */
+#define PCI_SINGLE_FRAME            (0x0U)
+#define PCI_FIRST_FRAME             (0x1U)
+#define PCI_CONSECUTIVE_FRAME       (0x2U)
+#define PCI_FLOW_CONTROL            (0x3U)
+
+/* Flow status of a flow control frame */
+#define FLOW_CONTINUE               (0x0U)
+#define FLOW_WAIT                   (0x1U)
+#define FLOW_OVERFLOW               (0x2U)
+
+/* Payload bytes per frame type. Single frames longer than a classic CAN frame
+ * use the escape form with the length in the second byte. */
+#define SF_CLASSIC_MAX              (7U)
+#define SF_MAX                      (FRAME_SIZE - 2U)
+#define FF_PAYLOAD                  (FRAME_SIZE - 2U)
+#define CF_PAYLOAD                  (FRAME_SIZE - 1U)
+
+/* Message RAM layout. The last TX buffer is reserved for flow control frames
+ * sent from the receive interrupt, the others queue consecutive frames. */
+#define RX_FIFO_ELEMENTS            (16U)
+#define TX_BUFFERS                  (4U)
+#define TX_BUFFER_FLOW_CONTROL      (TX_BUFFERS - 1U)
+
+/* Granularity of the Read/Write timeout polling */
+#define POLL_INTERVAL_US            (10U)
+
+/* Longest single Cy_SysLib_DelayUs() of a wait */
+#define DELAY_STEP_US               (1000U)
+
+/* Bit timing for an 80 MHz CAN FD clock. Arbitration phase: 500 kbit/s,
+ * 20 time quanta, sample point 80 %. Data phase: 10 or 16 time quanta at
+ * 80 MHz, sample point 80 %. The transceiver delay compensation offset is the
+ * data phase sample point in clock cycles. */
+#define NOMINAL_PRESCALER           (7U)
+#define NOMINAL_TSEG1               (14U)
+#define NOMINAL_TSEG2               (3U)
+#define NOMINAL_SJW                 (3U)
+
+#if (CY_DFU_CANFD_ISOTP_DATA_RATE_MBPS == 5U)
+    #define FAST_PRESCALER          (0U)
+    #define FAST_TSEG1              (11U)
+    #define FAST_TSEG2              (2U)
+    #define FAST_SJW                (2U)
+    #define FAST_TDC_OFFSET         (13U)
+#elif (CY_DFU_CANFD_ISOTP_DATA_RATE_MBPS == 8U)
+    #define FAST_PRESCALER          (0U)
+    #define FAST_TSEG1              (6U)
+    #define FAST_TSEG2              (1U)
+    #define FAST_SJW                (1U)
+    #define FAST_TDC_OFFSET         (8U)
+#else
+    #error "CY_DFU_CANFD_ISOTP_DATA_RATE_MBPS must be 5 or 8"
+#endif /* (CY_DFU_CANFD_ISOTP_DATA_RATE_MBPS == 5U) */
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static const cy_stc_dfu_transport_canfd_isotp_cfg_t *isotpCfg = NULL;
+
+/* Packet being reassembled. rxLength is non-zero while a complete packet waits
+ * to be consumed by CANFD_ISOTP_CyBtldrCommRead(). */
+CY_ALIGN(4) static uint8_t rxBuffer[CY_DFU_CANFD_ISOTP_BUFFER_SIZE];
+static volatile uint32_t rxLength;
+static volatile bool rxActive;
+static uint32_t rxExpected;
+static uint32_t rxReceived;
+static uint8_t rxSequence;
+
+/* Last flow control frame received from the host */
+static volatile bool fcReceived;
+static volatile uint8_t fcStatus;
+static volatile uint8_t fcBlockSize;
+static volatile uint8_t fcStmin;
+
+/* Next TX buffer for consecutive frames */
+static uint32_t txIndex;
+
+/* Segmentation errors seen on the bus, for debugging */
+static volatile uint32_t rxSequenceErrors;
+
+/* DLC to payload length */
+static const uint8_t dlcLength[16] = {0U, 1U, 2U, 3U, 4U, 5U, 6U, 7U, 8U, 12U, 16U, 20U, 24U, 32U, 48U, 64U};
+
+static const cy_stc_canfd_bitrate_t nominalBitrate =
+{
+    .prescaler      = NOMINAL_PRESCALER,
+    .timeSegment1   = NOMINAL_TSEG1,
+    .timeSegment2   = NOMINAL_TSEG2,
+    .syncJumpWidth  = NOMINAL_SJW
+};
+
+static const cy_stc_canfd_bitrate_t fastBitrate =
+{
+    .prescaler      = FAST_PRESCALER,
+    .timeSegment1   = FAST_TSEG1,
+    .timeSegment2   = FAST_TSEG2,
+    .syncJumpWidth  = FAST_SJW
+};
+
+static const cy_stc_canfd_transceiver_delay_compensation_t tdcConfig =
+{
+    .tdcEnabled         = true,
+    .tdcOffset          = FAST_TDC_OFFSET,
+    .tdcFilterWindow    = 0U
+};
+
+/* Single classic filter for the host ID, filled in from the configuration */
+static cy_stc_id_filter_t sidFilter;
+
+static const cy_stc_canfd_sid_filter_config_t sidFilterConfig =
+{
+    .numberOfSIDFilters = 1U,
+    .sidFilter          = &sidFilter
+};
+
+static const cy_stc_canfd_extid_filter_config_t extidFilterConfig =
+{
+    .numberOfEXTIDFilters   = 0U,
+    .extidFilter            = NULL,
+    .extIDANDMask           = 0x1FFFFFFFUL
+};
+
+static const cy_stc_canfd_global_filter_config_t globalFilterConfig =
+{
+    .nonMatchingFramesStandard  = CY_CANFD_REJECT_NON_MATCHING,
+    .nonMatchingFramesExtended  = CY_CANFD_REJECT_NON_MATCHING,
+    .rejectRemoteFramesStandard = true,
+    .rejectRemoteFramesExtended = true
+};
+
+static const cy_en_canfd_fifo_config_t rxFifo0Config =
+{
+    .mode                   = CY_CANFD_FIFO_MODE_BLOCKING,
+    .watermark              = 0U,
+    .numberOfFIFOElements   = RX_FIFO_ELEMENTS,
+    .topPointerLogicEnabled = false
+};
+
+static const cy_en_canfd_fifo_config_t rxFifo1Config =
+{
+    .mode                   = CY_CANFD_FIFO_MODE_BLOCKING,
+    .watermark              = 0U,
+    .numberOfFIFOElements   = 0U,
+    .topPointerLogicEnabled = false
+};
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void CanfdIsr(void);
+static void RxCallback(bool rxFIFOMsg, uint8_t msgBufOrRxFIFONum, cy_stc_canfd_rx_buffer_t *basemsg);
+static void ProcessFrame(const uint8_t frame[], uint32_t length);
+static cy_en_canfd_status_t QueueFrame(uint32_t index, const uint8_t data[], uint32_t length);
+static void SendFlowControl(uint8_t flowStatus);
+static bool WaitTxBuffer(uint32_t index, uint32_t *timeoutUs);
+static bool WaitFlowControl(uint32_t *timeoutUs);
+static uint32_t StminToUs(uint8_t stmin);
+static void DelayUs(uint32_t delayUs, uint32_t *timeoutUs);
+static cy_en_dfu_status_t SendPacket(const uint8_t pData[], uint32_t size, uint32_t timeout);
+
+/*******************************************************************************
+* Function Name: CanfdIsr
+********************************************************************************
+* Summary:
+*  CAN FD channel interrupt, dispatches received frames to RxCallback().
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void CanfdIsr(void)
+{
+    Cy_CANFD_IrqHandler(isotpCfg->base, isotpCfg->channel, isotpCfg->context);
+}
+
+/*******************************************************************************
+* Function Name: RxCallback
+********************************************************************************
+* Summary:
+*  Called by the CAN FD driver for every frame read from RX FIFO 0.
+*
+* Parameters:
+*  rxFIFOMsg         : True if the frame comes from an RX FIFO
+*  msgBufOrRxFIFONum : RX FIFO number
+*  basemsg           : Received frame
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void RxCallback(bool rxFIFOMsg, uint8_t msgBufOrRxFIFONum, cy_stc_canfd_rx_buffer_t *basemsg)
+{
+    uint32_t length = dlcLength[basemsg->r1_f->dlc & 0x0FU];
+
+    (void)rxFIFOMsg;
+    (void)msgBufOrRxFIFONum;
+
+    if (length != 0U)
+    {
+        ProcessFrame((const uint8_t *)basemsg->data_area_f, length);
+    }
+}
+
+/*******************************************************************************
+* Function Name: ProcessFrame
+********************************************************************************
+* Summary:
+*  Reassembles packets from single, first and consecutive frames and records
+*  flow control frames for SendPacket(). A first frame is answered with a
+*  clear-to-send flow control frame without a block limit, so the host can
+*  stream the remaining consecutive frames back to back.
+*
+* Parameters:
+*  frame  : Frame payload
+*  length : Payload length in bytes
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void ProcessFrame(const uint8_t frame[], uint32_t length)
+{
+    uint32_t chunk;
+    uint32_t offset;
+
+    switch (frame[0] >> 4U)
+    {
+        case PCI_SINGLE_FRAME:
+            offset = ((frame[0] & 0x0FU) != 0U) ? 1U : 2U;
+            chunk = (offset == 1U) ? (frame[0] & 0x0FU) : frame[1];
+            if ((rxLength == 0U) && (chunk != 0U) && ((chunk + offset) <= length) &&
+                (chunk <= CY_DFU_CANFD_ISOTP_BUFFER_SIZE))
+            {
+                (void)memcpy(rxBuffer, &frame[offset], chunk);
+                rxActive = false;
+                rxLength = chunk;
+            }
+            break;
+
+        case PCI_FIRST_FRAME:
+            rxExpected = (((uint32_t)frame[0] & 0x0FU) << 8U) | frame[1];
+            if ((length < FRAME_SIZE) || (rxExpected <= SF_MAX))
+            {
+                /* Not a valid CAN FD first frame */
+                rxActive = false;
+            }
+            else if (rxExpected > CY_DFU_CANFD_ISOTP_BUFFER_SIZE)
+            {
+                rxActive = false;
+                SendFlowControl(FLOW_OVERFLOW);
+            }
+            else if (rxLength == 0U)
+            {
+                (void)memcpy(rxBuffer, &frame[2], FF_PAYLOAD);
+                rxReceived = FF_PAYLOAD;
+                rxSequence = 1U;
+                rxActive = true;
+                SendFlowControl(FLOW_CONTINUE);
+            }
+            else
+            {
+                /* Previous packet not consumed yet, the host will time out */
+            }
+            break;
+
+        case PCI_CONSECUTIVE_FRAME:
+            if (rxActive && ((frame[0] & 0x0FU) == rxSequence))
+            {
+                chunk = rxExpected - rxReceived;
+                chunk = (chunk > CF_PAYLOAD) ? CF_PAYLOAD : chunk;
+                chunk = ((chunk + 1U) > length) ? (length - 1U) : chunk;
+
+                (void)memcpy(&rxBuffer[rxReceived], &frame[1], chunk);
+                rxReceived += chunk;
+                rxSequence = (rxSequence + 1U) & 0x0FU;
+
+                if (rxReceived == rxExpected)
+                {
+                    rxActive = false;
+                    rxLength = rxExpected;
+                }
+            }
+            else if (rxActive)
+            {
+                rxSequenceErrors++;
+                rxActive = false;
+            }
+            else
+            {
+                /* Not part of a packet in progress */
+            }
+            break;
+
+        case PCI_FLOW_CONTROL:
+            if (length >= 3U)
+            {
+                fcStatus = frame[0] & 0x0FU;
+                fcBlockSize = frame[1];
+                fcStmin = frame[2];
+                fcReceived = true;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/*******************************************************************************
+* Function Name: QueueFrame
+********************************************************************************
+* Summary:
+*  Writes a frame into a TX buffer and requests its transmission with bit rate
+*  switching. The payload is padded to the next valid CAN FD length.
+*
+* Parameters:
+*  index  : TX buffer, must not be pending
+*  data   : Frame payload
+*  length : Payload length, up to FRAME_SIZE
+*
+* Return:
+*  Status of the CAN FD driver
+*
+*******************************************************************************/
+static cy_en_canfd_status_t QueueFrame(uint32_t index, const uint8_t data[], uint32_t length)
+{
+    uint32_t words[FRAME_SIZE / 4U];
+    uint32_t dlc = 0U;
+
+    while (dlcLength[dlc] < length)
+    {
+        dlc++;
+    }
+
+    (void)memset(words, FRAME_PADDING, sizeof(words));
+    (void)memcpy(words, data, length);
+
+    cy_stc_canfd_t0_t t0 =
+    {
+        .id     = isotpCfg->txId,
+        .rtr    = CY_CANFD_RTR_DATA_FRAME,
+        .xtd    = CY_CANFD_XTD_STANDARD_ID,
+        .esi    = CY_CANFD_ESI_ERROR_ACTIVE
+    };
+    cy_stc_canfd_t1_t t1 =
+    {
+        .dlc    = dlc,
+        .brs    = true,
+        .fdf    = CY_CANFD_FDF_CAN_FD_FRAME,
+        .efc    = false,
+        .mm     = 0U
+    };
+    cy_stc_canfd_tx_buffer_t txBuffer =
+    {
+        .t0_f           = &t0,
+        .t1_f           = &t1,
+        .data_area_f    = words
+    };
+
+    return Cy_CANFD_UpdateAndTransmitMsgBuffer(isotpCfg->base, isotpCfg->channel, &txBuffer,
+                                               (uint8_t)index, isotpCfg->context);
+}
+
+/*******************************************************************************
+* Function Name: SendFlowControl
+********************************************************************************
+* Summary:
+*  Sends a flow control frame from the receive interrupt through the reserved
+*  TX buffer.
+*
+* Parameters:
+*  flowStatus : FLOW_CONTINUE, FLOW_WAIT or FLOW_OVERFLOW
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void SendFlowControl(uint8_t flowStatus)
+{
+    const uint8_t frame[3] =
+    {
+        (uint8_t)((PCI_FLOW_CONTROL << 4U) | flowStatus),
+        0U,                             /* No block size limit */
+        CY_DFU_CANFD_ISOTP_STMIN
+    };
+
+    (void)QueueFrame(TX_BUFFER_FLOW_CONTROL, frame, sizeof(frame));
+}
+
+/*******************************************************************************
+* Function Name: WaitTxBuffer
+********************************************************************************
+* Summary:
+*  Waits until a TX buffer is free to take the next frame. The controller
+*  sends pending buffers with equal IDs in buffer order, so the higher data
+*  buffers, which still hold earlier frames, must be sent as well. Filling the
+*  first buffer again therefore waits for the whole queue to drain.
+*
+* Parameters:
+*  index     : TX buffer
+*  timeoutUs : Remaining time budget, updated
+*
+* Return:
+*  True if the buffer is free
+*
+*******************************************************************************/
+static bool WaitTxBuffer(uint32_t index, uint32_t *timeoutUs)
+{
+    uint32_t pending = index;
+
+    while ((pending < TX_BUFFER_FLOW_CONTROL) && (*timeoutUs > 0U))
+    {
+        if (Cy_CANFD_GetTxBufferStatus(isotpCfg->base, isotpCfg->channel, (uint8_t)pending) ==
+            CY_CANFD_TX_BUFFER_PENDING)
+        {
+            DelayUs(POLL_INTERVAL_US, timeoutUs);
+        }
+        else
+        {
+            pending++;
+        }
+    }
+
+    return (pending == TX_BUFFER_FLOW_CONTROL);
+}
+
+/*******************************************************************************
+* Function Name: WaitFlowControl
+********************************************************************************
+* Summary:
+*  Waits for a flow control frame from the host. Wait frames restart the wait.
+*
+* Parameters:
+*  timeoutUs : Remaining time budget, updated
+*
+* Return:
+*  True if the host is ready for more consecutive frames
+*
+*******************************************************************************/
+static bool WaitFlowControl(uint32_t *timeoutUs)
+{
+    bool ready = false;
+    bool done = false;
+
+    while ((!done) && (*timeoutUs > 0U))
+    {
+        if (fcReceived)
+        {
+            fcReceived = false;
+            ready = (fcStatus == FLOW_CONTINUE);
+            done = (fcStatus != FLOW_WAIT);
+        }
+        else
+        {
+            DelayUs(POLL_INTERVAL_US, timeoutUs);
+        }
+    }
+
+    return ready;
+}
+
+/*******************************************************************************
+* Function Name: StminToUs
+********************************************************************************
+* Summary:
+*  Converts an ISO 15765-2 separation time to microseconds.
+*
+* Parameters:
+*  stmin : Separation time as received in a flow control frame
+*
+* Return:
+*  Separation time in microseconds
+*
+*******************************************************************************/
+static uint32_t StminToUs(uint8_t stmin)
+{
+    uint32_t delayUs;
+
+    if (stmin <= 0x7FU)
+    {
+        delayUs = (uint32_t)stmin * 1000U;
+    }
+    else if ((stmin >= 0xF1U) && (stmin <= 0xF9U))
+    {
+        delayUs = ((uint32_t)stmin - 0xF0U) * 100U;
+    }
+    else
+    {
+        /* Reserved values are handled as the longest separation time */
+        delayUs = 0x7FU * 1000U;
+    }
+
+    return delayUs;
+}
+
+/*******************************************************************************
+* Function Name: DelayUs
+********************************************************************************
+* Summary:
+*  Waits and charges the wait to a time budget.
+*
+* Parameters:
+*  delayUs   : Time to wait
+*  timeoutUs : Remaining time budget, updated
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void DelayUs(uint32_t delayUs, uint32_t *timeoutUs)
+{
+    uint32_t wait = (delayUs > *timeoutUs) ? *timeoutUs : delayUs;
+    uint32_t step;
+
+    *timeoutUs -= wait;
+
+    /* Separation times reach 127 ms, beyond the range of Cy_SysLib_DelayUs() */
+    while (wait > 0U)
+    {
+        step = (wait > DELAY_STEP_US) ? DELAY_STEP_US : wait;
+        Cy_SysLib_DelayUs((uint16_t)step);
+        wait -= step;
+    }
+}
+
+/*******************************************************************************
+* Function Name: SendPacket
+********************************************************************************
+* Summary:
+*  Sends a packet as a single frame, or as a first frame followed by
+*  consecutive frames. Consecutive frames are queued in all data TX buffers, in
+*  buffer order, so the bus stays busy while the host permits it, honoring the
+*  block size and separation time of its flow control frames.
+*
+* Parameters:
+*  pData   : Packet to send
+*  size    : Packet size, non-zero and within the buffer size
+*  timeout : Time to send the whole packet, in milliseconds
+*
+* Return:
+*  CY_DFU_SUCCESS or CY_DFU_ERROR_TIMEOUT
+*
+*******************************************************************************/
+static cy_en_dfu_status_t SendPacket(const uint8_t pData[], uint32_t size, uint32_t timeout)
+{
+    cy_en_dfu_status_t status = CY_DFU_ERROR_TIMEOUT;
+    uint32_t timeoutUs = timeout * 1000U;
+    uint8_t frame[FRAME_SIZE];
+    uint32_t sent;
+    uint32_t chunk;
+    uint32_t blockCount = 0U;
+    uint32_t stminUs = 0U;
+    uint8_t sequence = 1U;
+    bool ready = true;
+
+    if (size <= SF_MAX)
+    {
+        if (size <= SF_CLASSIC_MAX)
+        {
+            frame[0] = (uint8_t)((PCI_SINGLE_FRAME << 4U) | size);
+            (void)memcpy(&frame[1], pData, size);
+            chunk = size + 1U;
+        }
+        else
+        {
+            frame[0] = (uint8_t)(PCI_SINGLE_FRAME << 4U);
+            frame[1] = (uint8_t)size;
+            (void)memcpy(&frame[2], pData, size);
+            chunk = size + 2U;
+        }
+
+        if (WaitTxBuffer(txIndex, &timeoutUs) && (QueueFrame(txIndex, frame, chunk) == CY_CANFD_SUCCESS))
+        {
+            status = CY_DFU_SUCCESS;
+        }
+        txIndex = (txIndex + 1U) % TX_BUFFER_FLOW_CONTROL;
+    }
+    else
+    {
+        fcReceived = false;
+
+        frame[0] = (uint8_t)((PCI_FIRST_FRAME << 4U) | (size >> 8U));
+        frame[1] = (uint8_t)size;
+        (void)memcpy(&frame[2], pData, FF_PAYLOAD);
+        sent = FF_PAYLOAD;
+
+        ready = WaitTxBuffer(txIndex, &timeoutUs) && (QueueFrame(txIndex, frame, FRAME_SIZE) == CY_CANFD_SUCCESS);
+        txIndex = (txIndex + 1U) % TX_BUFFER_FLOW_CONTROL;
+
+        while (ready && (sent < size))
+        {
+            if (blockCount == 0U)
+            {
+                /* Wait for permission to send the next block */
+                ready = WaitFlowControl(&timeoutUs);
+                blockCount = (fcBlockSize == 0U) ? UINT32_MAX : fcBlockSize;
+                stminUs = StminToUs(fcStmin);
+            }
+            else if (stminUs != 0U)
+            {
+                DelayUs(stminUs, &timeoutUs);
+            }
+            else
+            {
+                /* Back to back */
+            }
+
+            if (ready)
+            {
+                chunk = ((size - sent) > CF_PAYLOAD) ? CF_PAYLOAD : (size - sent);
+                frame[0] = (uint8_t)((PCI_CONSECUTIVE_FRAME << 4U) | sequence);
+                (void)memcpy(&frame[1], &pData[sent], chunk);
+
+                ready = WaitTxBuffer(txIndex, &timeoutUs) &&
+                        (QueueFrame(txIndex, frame, chunk + 1U) == CY_CANFD_SUCCESS);
+                txIndex = (txIndex + 1U) % TX_BUFFER_FLOW_CONTROL;
+
+                sent += chunk;
+                sequence = (sequence + 1U) & 0x0FU;
+                blockCount--;
+            }
+        }
+
+        if (ready && (sent == size))
+        {
+            status = CY_DFU_SUCCESS;
+        }
+    }
+
+    return status;
+}
+
+/*******************************************************************************
+* Function Name: Cy_DFU_TransportCanfdIsotpConfig
+********************************************************************************
+* Summary:
+*  Stores the CAN FD ISO-TP transport configuration. Must be called before
+*  CANFD_ISOTP_CyBtldrCommStart().
+*
+* Parameters:
+*  config : Transport configuration, must stay valid while the transport is used
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void Cy_DFU_TransportCanfdIsotpConfig(const cy_stc_dfu_transport_canfd_isotp_cfg_t *config)
+{
+    CY_ASSERT(NULL != config);
+    isotpCfg = config;
+}
+
+/*******************************************************************************
+* Function Name: CANFD_ISOTP_CyBtldrCommStart
+********************************************************************************
+* Summary:
+*  Starts the CAN FD ISO-TP transport: configures the channel for CAN FD with
+*  bit rate switching, 64-byte RX FIFO 0 elements and a single filter that
+*  accepts only the host ID, then enables the channel interrupt.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void CANFD_ISOTP_CyBtldrCommStart(void)
+{
+    cy_en_canfd_status_t canfdStatus;
+    const cy_stc_canfd_config_t canfdConfig =
+    {
+        .txCallback         = NULL,
+        .rxCallback         = RxCallback,
+        .errorCallback      = NULL,
+        .canFDMode          = true,
+        .bitrate            = &nominalBitrate,
+        .fastBitrate        = &fastBitrate,
+        .tdcConfig          = &tdcConfig,
+        .sidFilterConfig    = &sidFilterConfig,
+        .extidFilterConfig  = &extidFilterConfig,
+        .globalFilterConfig = &globalFilterConfig,
+        .rxBufferDataSize   = CY_CANFD_BUFFER_DATA_SIZE_64,
+        .rxFIFO1DataSize    = CY_CANFD_BUFFER_DATA_SIZE_64,
+        .rxFIFO0DataSize    = CY_CANFD_BUFFER_DATA_SIZE_64,
+        .txBufferDataSize   = CY_CANFD_BUFFER_DATA_SIZE_64,
+        .rxFIFO0Config      = &rxFifo0Config,
+        .rxFIFO1Config      = &rxFifo1Config,
+        .noOfRxBuffers      = 0U,
+        .noOfTxBuffers      = TX_BUFFERS,
+        .messageRAMaddress  = isotpCfg->messageRamAddress,
+        .messageRAMsize     = isotpCfg->messageRamSize
+    };
+    cy_stc_sysint_t canfdIsrCfg =
+    {
+        .intrSrc      = isotpCfg->irq,
+        .intrPriority = CY_DFU_CANFD_ISOTP_INTR_PRIORITY
+    };
+
+    CY_ASSERT(NULL != isotpCfg);
+
+    if (isotpCfg->callback != NULL)
+    {
+        isotpCfg->callback(CY_DFU_TRANSPORT_CANFD_ISOTP_INIT);
+    }
+
+    sidFilter.sfid2 = 0x7FFU;
+    sidFilter.sfid1 = isotpCfg->rxId;
+    sidFilter.sfec  = CY_CANFD_SFEC_STORE_RX_FIFO_0;
+    sidFilter.sft   = CY_CANFD_SFT_CLASSIC_FILTER;
+
+    canfdStatus = Cy_CANFD_Init(isotpCfg->base, isotpCfg->channel, &canfdConfig, isotpCfg->context);
+    if (CY_CANFD_SUCCESS != canfdStatus)
+    {
+        CY_DFU_LOG_ERR("Error during CAN FD initialization. Status: %X", (unsigned int)canfdStatus);
+    }
+    else
+    {
+        (void)Cy_SysInt_Init(&canfdIsrCfg, &CanfdIsr);
+        NVIC_ClearPendingIRQ(isotpCfg->irq);
+        NVIC_EnableIRQ(isotpCfg->irq);
+        CY_DFU_LOG_INF("CAN FD transport is initialized");
+    }
+
+    txIndex = 0U;
+    CANFD_ISOTP_CyBtldrCommReset();
+}
+
+/*******************************************************************************
+* Function Name: CANFD_ISOTP_CyBtldrCommStop
+********************************************************************************
+* Summary:
+*  Stops the CAN FD ISO-TP transport.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void CANFD_ISOTP_CyBtldrCommStop(void)
+{
+    NVIC_DisableIRQ(isotpCfg->irq);
+    (void)Cy_CANFD_DeInit(isotpCfg->base, isotpCfg->channel, isotpCfg->context);
+
+    if (isotpCfg->callback != NULL)
+    {
+        isotpCfg->callback(CY_DFU_TRANSPORT_CANFD_ISOTP_DEINIT);
+    }
+}
+
+/*******************************************************************************
+* Function Name: CANFD_ISOTP_CyBtldrCommReset
+********************************************************************************
+* Summary:
+*  Drops any partially received or pending packet.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void CANFD_ISOTP_CyBtldrCommReset(void)
+{
+    uint32_t intrState = Cy_SysLib_EnterCriticalSection();
+
+    rxActive = false;
+    rxLength = 0U;
+    fcReceived = false;
+
+    Cy_SysLib_ExitCriticalSection(intrState);
+}
+
+/*******************************************************************************
+* Function Name: CANFD_ISOTP_CyBtldrCommRead
+********************************************************************************
+* Summary:
+*  Waits for a complete packet from the host and copies it to pData.
+*
+* Parameters:
+*  pData   : Buffer to store the packet
+*  size    : Size of pData in bytes
+*  count   : Number of bytes copied
+*  timeout : Time to wait for a packet, in milliseconds
+*
+* Return:
+*  CY_DFU_SUCCESS, CY_DFU_ERROR_TIMEOUT or CY_DFU_ERROR_LENGTH
+*
+*******************************************************************************/
+cy_en_dfu_status_t CANFD_ISOTP_CyBtldrCommRead(uint8_t pData[], uint32_t size, uint32_t *count, uint32_t timeout)
+{
+    cy_en_dfu_status_t status = CY_DFU_ERROR_TIMEOUT;
+    uint32_t timeoutUs = timeout * 1000U;
+    uint32_t length;
+
+    *count = 0U;
+
+    while ((rxLength == 0U) && (timeoutUs > 0U))
+    {
+        DelayUs(POLL_INTERVAL_US, &timeoutUs);
+    }
+
+    length = rxLength;
+    if (length != 0U)
+    {
+        if (length <= size)
+        {
+            (void)memcpy(pData, rxBuffer, length);
+            *count = length;
+            status = CY_DFU_SUCCESS;
+        }
+        else
+        {
+            status = CY_DFU_ERROR_LENGTH;
+        }
+
+        /* Release the buffer for the next packet */
+        rxLength = 0U;
+    }
+
+    return status;
+}
+
+/*******************************************************************************
+* Function Name: CANFD_ISOTP_CyBtldrCommWrite
+********************************************************************************
+* Summary:
+*  Sends a response packet to the host.
+*
+* Parameters:
+*  pData   : Response to send
+*  size    : Number of bytes to send
+*  count   : Number of bytes sent
+*  timeout : Time to send the response, in milliseconds
+*
+* Return:
+*  CY_DFU_SUCCESS, CY_DFU_ERROR_TIMEOUT or CY_DFU_ERROR_LENGTH
+*
+*******************************************************************************/
+cy_en_dfu_status_t CANFD_ISOTP_CyBtldrCommWrite(const uint8_t pData[], uint32_t size, uint32_t *count, uint32_t timeout)
+{
+    cy_en_dfu_status_t status;
+
+    *count = 0U;
+
+    if ((size == 0U) || (size > CY_DFU_CANFD_ISOTP_BUFFER_SIZE))
+    {
+        status = CY_DFU_ERROR_LENGTH;
+    }
+    else
+    {
+        status = SendPacket(pData, size, timeout);
+        *count = (status == CY_DFU_SUCCESS) ? size : 0U;
+    }
+
+    return status;
+}
+
+#endif /* defined(COMPONENT_DFU_CANFD_ISOTP) */
+
+/* [] END OF FILE */
@@ -0,0 +1,111 @@
+/*******************************************************************************
+* File Name        : transport_canfd_isotp.h
+*
+* Description      : This file is the public interface of
+*                    transport_canfd_isotp.c, a CAN FD transport for the DFU
+*                    middleware that segments packets like ISO 15765-2.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef TRANSPORT_CANFD_ISOTP_H
+#define TRANSPORT_CANFD_ISOTP_H
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include "cy_pdl.h"
+#include "cy_dfu.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Size of the receive and transmit packet buffers */
+#ifndef CY_DFU_CANFD_ISOTP_BUFFER_SIZE
+    #define CY_DFU_CANFD_ISOTP_BUFFER_SIZE      (CY_DFU_SIZEOF_CMD_BUFFER)
+#endif /* CY_DFU_CANFD_ISOTP_BUFFER_SIZE */
+
+/* Interrupt priority of the CAN FD channel */
+#ifndef CY_DFU_CANFD_ISOTP_INTR_PRIORITY
+    #define CY_DFU_CANFD_ISOTP_INTR_PRIORITY    (3U)
+#endif /* CY_DFU_CANFD_ISOTP_INTR_PRIORITY */
+
+/* Separation time the device asks the host to leave between consecutive
+ * frames, in ISO 15765-2 STmin encoding. Zero lets the host send back to back. */
+#ifndef CY_DFU_CANFD_ISOTP_STMIN
+    #define CY_DFU_CANFD_ISOTP_STMIN            (0U)
+#endif /* CY_DFU_CANFD_ISOTP_STMIN */
+
+/* Data phase bit rate in Mbit/s, 5 or 8. The bit timing below assumes an
+ * 80 MHz CAN FD clock and a 500 kbit/s arbitration phase. */
+#ifndef CY_DFU_CANFD_ISOTP_DATA_RATE_MBPS
+    #define CY_DFU_CANFD_ISOTP_DATA_RATE_MBPS   (8U)
+#endif /* CY_DFU_CANFD_ISOTP_DATA_RATE_MBPS */
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+
+/* Actions passed to the transport callback */
+typedef enum
+{
+    CY_DFU_TRANSPORT_CANFD_ISOTP_INIT,      /* Transport is started */
+    CY_DFU_TRANSPORT_CANFD_ISOTP_DEINIT,    /* Transport is stopped */
+} cy_en_dfu_transport_canfd_isotp_action_t;
+
+/* Callback to enable or disable the transceiver and the CAN FD clock */
+typedef void (*Cy_DFU_TransportCanfdIsotpCallback)(cy_en_dfu_transport_canfd_isotp_action_t action);
+
+/* CAN FD ISO-TP transport configuration */
+typedef struct
+{
+    CANFD_Type                          *base;              /* CAN FD block */
+    uint32_t                            channel;            /* Channel number */
+    IRQn_Type                           irq;                /* Channel interrupt line 0 */
+    cy_stc_canfd_context_t              *context;           /* CAN FD driver context */
+    uint32_t                            messageRamAddress;  /* Channel message RAM */
+    uint32_t                            messageRamSize;
+    uint32_t                            rxId;               /* 11-bit ID of host frames */
+    uint32_t                            txId;               /* 11-bit ID of device frames */
+    Cy_DFU_TransportCanfdIsotpCallback  callback;
+} cy_stc_dfu_transport_canfd_isotp_cfg_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void Cy_DFU_TransportCanfdIsotpConfig(const cy_stc_dfu_transport_canfd_isotp_cfg_t *config);
+
+void CANFD_ISOTP_CyBtldrCommStart(void);
+void CANFD_ISOTP_CyBtldrCommStop(void);
+void CANFD_ISOTP_CyBtldrCommReset(void);
+cy_en_dfu_status_t CANFD_ISOTP_CyBtldrCommRead(uint8_t pData[], uint32_t size, uint32_t *count, uint32_t timeout);
+cy_en_dfu_status_t CANFD_ISOTP_CyBtldrCommWrite(const uint8_t pData[], uint32_t size, uint32_t *count, uint32_t timeout);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* TRANSPORT_CANFD_ISOTP_H */
+
+/* [] END OF FILE */
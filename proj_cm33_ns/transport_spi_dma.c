@@ -0,0 +1,682 @@
+/*******************************************************************************
+* File Name        : transport_spi_dma.c
+*
+* Description      : This file provides a SPI slave transport for the DFU
+*                    middleware. Packets are moved between the SCB FIFOs and
+*                    RAM by two DataWire channels, so the CPU is not involved
+*                    per byte. A ready/busy GPIO tells the host master when
+*                    the device can accept the next transaction.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#if defined(COMPONENT_DFU_SPI_DMA)
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <string.h>
+#include "transport_spi_dma.h"
+#include "cy_dfu_logging.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* DFU packet framing */
+#define PACKET_SOP                  (0x01U)
+#define PACKET_HEADER_SIZE          (4U)    /* SOP, command, 16-bit length */
+#define PACKET_FOOTER_SIZE          (3U)    /* 16-bit checksum, EOP */
+
+/* Maximum number of elements in one DataWire X loop */
+#define DMA_MAX_XCOUNT              (256U)
+
+/* Granularity of the Read/Write timeout polling */
+#define POLL_INTERVAL_US            (10U)
+
+/* Ready/busy handshake levels */
+#define READY_LEVEL                 (1U)
+#define BUSY_LEVEL                  (0U)
+
+/* Stages of the RX channel */
+#define RX_STAGE_IDLE               (0U)    /* Packet waits to be read */
+#define RX_STAGE_DISCARD            (1U)    /* Bytes clocked in with a response */
+#define RX_STAGE_HEADER             (2U)
+#define RX_STAGE_BODY               (3U)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static const cy_stc_dfu_transport_spi_dma_cfg_t *spiDmaCfg = NULL;
+
+/* Receive buffer. rxLength is non-zero while a complete packet waits to be
+ * consumed by SPI_DMA_CyBtldrCommRead(). DFU is strictly command and
+ * response, so the host never sends a packet before the previous one is
+ * answered and one buffer is enough. */
+CY_ALIGN(4) static uint8_t rxBuffer[CY_DFU_SPI_DMA_BUFFER_SIZE];
+static volatile uint32_t rxLength;
+static volatile uint32_t rxStage;
+static uint32_t rxExpected;
+static uint32_t rxReceived;
+
+/* The bytes the host shifts in while it reads a response are received here
+ * and dropped */
+static uint8_t rxDiscardBuffer[DMA_MAX_XCOUNT];
+static uint32_t rxDiscard;
+
+CY_ALIGN(4) static uint8_t txBuffer[CY_DFU_SPI_DMA_BUFFER_SIZE];
+static volatile uint32_t txRemaining;
+static uint32_t txOffset;
+
+static cy_stc_dma_descriptor_t rxDescriptor;
+static cy_stc_dma_descriptor_t txDescriptor;
+
+/* Framing errors seen on the bus, for debugging */
+static volatile uint32_t rxFramingErrors;
+
+static const cy_stc_dma_descriptor_config_t rxDescriptorConfig =
+{
+    .retrigger       = CY_DMA_RETRIG_IM,
+    .interruptType   = CY_DMA_DESCR,
+    .triggerOutType  = CY_DMA_1ELEMENT,
+    .channelState    = CY_DMA_CHANNEL_DISABLED,
+    .triggerInType   = CY_DMA_1ELEMENT,
+    .dataSize        = CY_DMA_BYTE,
+    .srcTransferSize = CY_DMA_TRANSFER_SIZE_WORD,
+    .dstTransferSize = CY_DMA_TRANSFER_SIZE_DATA,
+    .descriptorType  = CY_DMA_1D_TRANSFER,
+    .srcAddress      = NULL,
+    .dstAddress      = NULL,
+    .srcXincrement   = 0,
+    .dstXincrement   = 1,
+    .xCount          = PACKET_HEADER_SIZE,
+    .srcYincrement   = 0,
+    .dstYincrement   = 0,
+    .yCount          = 1U,
+    .nextDescriptor  = NULL
+};
+
+static const cy_stc_dma_descriptor_config_t txDescriptorConfig =
+{
+    .retrigger       = CY_DMA_RETRIG_IM,
+    .interruptType   = CY_DMA_DESCR,
+    .triggerOutType  = CY_DMA_1ELEMENT,
+    .channelState    = CY_DMA_CHANNEL_DISABLED,
+    .triggerInType   = CY_DMA_1ELEMENT,
+    .dataSize        = CY_DMA_BYTE,
+    .srcTransferSize = CY_DMA_TRANSFER_SIZE_DATA,
+    .dstTransferSize = CY_DMA_TRANSFER_SIZE_WORD,
+    .descriptorType  = CY_DMA_1D_TRANSFER,
+    .srcAddress      = NULL,
+    .dstAddress      = NULL,
+    .srcXincrement   = 1,
+    .dstXincrement   = 0,
+    .xCount          = 1U,
+    .srcYincrement   = 0,
+    .dstYincrement   = 0,
+    .yCount          = 1U,
+    .nextDescriptor  = NULL
+};
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void SetReady(uint32_t level);
+static void DmaChannelInit(const cy_stc_dfu_transport_spi_dma_chan_t *chan,
+                           cy_stc_dma_descriptor_t *descriptor,
+                           const cy_stc_dma_descriptor_config_t *descriptorConfig,
+                           cy_israddress isr);
+static void RxArm(uint8_t *dst, uint32_t count);
+static void RxArmHeader(void);
+static void RxArmDiscard(uint32_t count);
+static void RxDmaIsr(void);
+static void TxArmChunk(void);
+static void TxDmaIsr(void);
+static cy_en_dfu_status_t SendResponse(const uint8_t pData[], uint32_t size, uint32_t timeout);
+
+/*******************************************************************************
+* Function Name: SetReady
+********************************************************************************
+* Summary:
+*  Drives the ready/busy handshake line towards the host master.
+*
+* Parameters:
+*  level : READY_LEVEL or BUSY_LEVEL
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void SetReady(uint32_t level)
+{
+    Cy_GPIO_Write(spiDmaCfg->readyPort, spiDmaCfg->readyPin, level);
+}
+
+/*******************************************************************************
+* Function Name: DmaChannelInit
+********************************************************************************
+* Summary:
+*  Initializes a DataWire channel with a single descriptor and hooks up its
+*  completion interrupt.
+*
+* Parameters:
+*  chan             : DMA channel to initialize
+*  descriptor       : Descriptor owned by the channel
+*  descriptorConfig : Initial descriptor configuration
+*  isr              : Completion interrupt handler
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void DmaChannelInit(const cy_stc_dfu_transport_spi_dma_chan_t *chan,
+                           cy_stc_dma_descriptor_t *descriptor,
+                           const cy_stc_dma_descriptor_config_t *descriptorConfig,
+                           cy_israddress isr)
+{
+    cy_stc_dma_channel_config_t channelConfig =
+    {
+        .descriptor  = descriptor,
+        .preemptable = false,
+        .priority    = 0U,
+        .enable      = false,
+        .bufferable  = false
+    };
+    cy_stc_sysint_t dmaIsrCfg =
+    {
+        .intrSrc      = chan->irq,
+        .intrPriority = CY_DFU_SPI_DMA_INTR_PRIORITY
+    };
+
+    (void)Cy_DMA_Descriptor_Init(descriptor, descriptorConfig);
+    (void)Cy_DMA_Channel_Init(chan->base, chan->channel, &channelConfig);
+    Cy_DMA_Channel_SetInterruptMask(chan->base, chan->channel, CY_DMA_INTR_MASK);
+    Cy_DMA_Enable(chan->base);
+
+    (void)Cy_SysInt_Init(&dmaIsrCfg, isr);
+    NVIC_ClearPendingIRQ(chan->irq);
+    NVIC_EnableIRQ(chan->irq);
+}
+
+/*******************************************************************************
+* Function Name: RxArm
+********************************************************************************
+* Summary:
+*  Points the RX channel at the given destination and enables it.
+*
+* Parameters:
+*  dst   : Destination in the receive buffer
+*  count : Number of bytes to move, at most DMA_MAX_XCOUNT
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void RxArm(uint8_t *dst, uint32_t count)
+{
+    Cy_DMA_Descriptor_SetDstAddress(&rxDescriptor, dst);
+    Cy_DMA_Descriptor_SetXloopDataCount(&rxDescriptor, count);
+    Cy_DMA_Channel_SetDescriptor(spiDmaCfg->rxDma.base, spiDmaCfg->rxDma.channel, &rxDescriptor);
+    Cy_DMA_Channel_Enable(spiDmaCfg->rxDma.base, spiDmaCfg->rxDma.channel);
+}
+
+/*******************************************************************************
+* Function Name: RxArmHeader
+********************************************************************************
+* Summary:
+*  Starts reception of the next packet header.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void RxArmHeader(void)
+{
+    rxStage = RX_STAGE_HEADER;
+    rxReceived = 0U;
+    RxArm(rxBuffer, PACKET_HEADER_SIZE);
+}
+
+/*******************************************************************************
+* Function Name: RxArmDiscard
+********************************************************************************
+* Summary:
+*  Starts reception of the bytes the host shifts in while it reads a response
+*  of count bytes. They are dropped, and reception of the next packet header
+*  follows without a gap.
+*
+* Parameters:
+*  count : Size of the response, non-zero
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void RxArmDiscard(uint32_t count)
+{
+    rxStage = RX_STAGE_DISCARD;
+    rxDiscard = count;
+    RxArm(rxDiscardBuffer, (count > DMA_MAX_XCOUNT) ? DMA_MAX_XCOUNT : count);
+}
+
+/*******************************************************************************
+* Function Name: RxDmaIsr
+********************************************************************************
+* Summary:
+*  RX channel completion interrupt. After a response, the bytes the host
+*  shifted in to read it are dropped. Then the header is received to learn
+*  the packet length, and the body in chunks of up to DMA_MAX_XCOUNT bytes.
+*  When the packet is complete the handshake goes busy, and reception stays
+*  off until the response is queued.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void RxDmaIsr(void)
+{
+    uint32_t chunk;
+
+    Cy_DMA_Channel_ClearInterrupt(spiDmaCfg->rxDma.base, spiDmaCfg->rxDma.channel);
+
+    if (rxStage == RX_STAGE_DISCARD)
+    {
+        rxDiscard -= Cy_DMA_Descriptor_GetXloopDataCount(&rxDescriptor);
+        if (rxDiscard != 0U)
+        {
+            RxArm(rxDiscardBuffer, (rxDiscard > DMA_MAX_XCOUNT) ? DMA_MAX_XCOUNT : rxDiscard);
+        }
+        else
+        {
+            RxArmHeader();
+        }
+        return;
+    }
+
+    if (rxStage == RX_STAGE_HEADER)
+    {
+        rxExpected = PACKET_HEADER_SIZE + PACKET_FOOTER_SIZE +
+                     ((uint32_t)rxBuffer[2] | ((uint32_t)rxBuffer[3] << 8U));
+        rxStage = RX_STAGE_BODY;
+        rxReceived = PACKET_HEADER_SIZE;
+    }
+    else
+    {
+        rxReceived += Cy_DMA_Descriptor_GetXloopDataCount(&rxDescriptor);
+    }
+
+    if ((rxBuffer[0] != PACKET_SOP) || (rxExpected > CY_DFU_SPI_DMA_BUFFER_SIZE))
+    {
+        /* Not a packet start, drop what is in the FIFO and resync */
+        rxFramingErrors++;
+        Cy_SCB_SPI_ClearRxFifo(spiDmaCfg->base);
+        RxArmHeader();
+    }
+    else if (rxReceived < rxExpected)
+    {
+        chunk = rxExpected - rxReceived;
+        RxArm(&rxBuffer[rxReceived], (chunk > DMA_MAX_XCOUNT) ? DMA_MAX_XCOUNT : chunk);
+    }
+    else
+    {
+        /* Packet complete: hold the host off until the response is ready */
+        SetReady(BUSY_LEVEL);
+        rxStage = RX_STAGE_IDLE;
+        rxLength = rxExpected;
+    }
+}
+
+/*******************************************************************************
+* Function Name: TxArmChunk
+********************************************************************************
+* Summary:
+*  Loads the next chunk of the response into the TX channel.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void TxArmChunk(void)
+{
+    uint32_t chunk = (txRemaining > DMA_MAX_XCOUNT) ? DMA_MAX_XCOUNT : txRemaining;
+
+    Cy_DMA_Descriptor_SetSrcAddress(&txDescriptor, &txBuffer[txOffset]);
+    Cy_DMA_Descriptor_SetXloopDataCount(&txDescriptor, chunk);
+    Cy_DMA_Channel_SetDescriptor(spiDmaCfg->txDma.base, spiDmaCfg->txDma.channel, &txDescriptor);
+    Cy_DMA_Channel_Enable(spiDmaCfg->txDma.base, spiDmaCfg->txDma.channel);
+}
+
+/*******************************************************************************
+* Function Name: TxDmaIsr
+********************************************************************************
+* Summary:
+*  TX channel completion interrupt. Continues with the next chunk until the
+*  whole response has been pushed into the TX FIFO.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void TxDmaIsr(void)
+{
+    uint32_t chunk = Cy_DMA_Descriptor_GetXloopDataCount(&txDescriptor);
+
+    Cy_DMA_Channel_ClearInterrupt(spiDmaCfg->txDma.base, spiDmaCfg->txDma.channel);
+
+    txOffset += chunk;
+    txRemaining -= chunk;
+
+    if (txRemaining != 0U)
+    {
+        TxArmChunk();
+    }
+}
+
+/*******************************************************************************
+* Function Name: Cy_DFU_TransportSpiDmaConfig
+********************************************************************************
+* Summary:
+*  Stores the SPI DMA transport configuration. Must be called before
+*  SPI_DMA_CyBtldrCommStart().
+*
+* Parameters:
+*  config : Transport configuration, must stay valid while the transport is used
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void Cy_DFU_TransportSpiDmaConfig(const cy_stc_dfu_transport_spi_dma_cfg_t *config)
+{
+    CY_ASSERT(NULL != config);
+    spiDmaCfg = config;
+}
+
+/*******************************************************************************
+* Function Name: SPI_DMA_CyBtldrCommStart
+********************************************************************************
+* Summary:
+*  Starts the SPI DMA transport: enables the SCB, sets up both DataWire
+*  channels and signals ready to the host.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void SPI_DMA_CyBtldrCommStart(void)
+{
+    CY_ASSERT(NULL != spiDmaCfg);
+
+    if (spiDmaCfg->callback != NULL)
+    {
+        spiDmaCfg->callback(CY_DFU_TRANSPORT_SPI_DMA_INIT);
+    }
+
+    /* Request an RX transfer as soon as one byte is in the FIFO and a TX
+     * transfer as soon as there is room for one byte. */
+    Cy_SCB_SetRxFifoLevel(spiDmaCfg->base, 0U);
+    Cy_SCB_SetTxFifoLevel(spiDmaCfg->base, Cy_SCB_GetFifoSize(spiDmaCfg->base) - 1U);
+
+    DmaChannelInit(&spiDmaCfg->rxDma, &rxDescriptor, &rxDescriptorConfig, &RxDmaIsr);
+    DmaChannelInit(&spiDmaCfg->txDma, &txDescriptor, &txDescriptorConfig, &TxDmaIsr);
+
+    CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.6', 'FIFO register address is used as DMA endpoint');
+    Cy_DMA_Descriptor_SetSrcAddress(&rxDescriptor, (void *)&SCB_RX_FIFO_RD(spiDmaCfg->base));
+    CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.6', 'FIFO register address is used as DMA endpoint');
+    Cy_DMA_Descriptor_SetDstAddress(&txDescriptor, (void *)&SCB_TX_FIFO_WR(spiDmaCfg->base));
+
+    SPI_DMA_CyBtldrCommReset();
+}
+
+/*******************************************************************************
+* Function Name: SPI_DMA_CyBtldrCommStop
+********************************************************************************
+* Summary:
+*  Stops the SPI DMA transport and leaves the handshake in the busy state.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void SPI_DMA_CyBtldrCommStop(void)
+{
+    SetReady(BUSY_LEVEL);
+
+    Cy_DMA_Channel_Disable(spiDmaCfg->rxDma.base, spiDmaCfg->rxDma.channel);
+    Cy_DMA_Channel_Disable(spiDmaCfg->txDma.base, spiDmaCfg->txDma.channel);
+    NVIC_DisableIRQ(spiDmaCfg->rxDma.irq);
+    NVIC_DisableIRQ(spiDmaCfg->txDma.irq);
+
+    if (spiDmaCfg->callback != NULL)
+    {
+        spiDmaCfg->callback(CY_DFU_TRANSPORT_SPI_DMA_DEINIT);
+    }
+}
+
+/*******************************************************************************
+* Function Name: SPI_DMA_CyBtldrCommReset
+********************************************************************************
+* Summary:
+*  Drops any partially received or pending packet and re-arms reception.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void SPI_DMA_CyBtldrCommReset(void)
+{
+    Cy_DMA_Channel_Disable(spiDmaCfg->rxDma.base, spiDmaCfg->rxDma.channel);
+    Cy_DMA_Channel_Disable(spiDmaCfg->txDma.base, spiDmaCfg->txDma.channel);
+
+    Cy_SCB_SPI_ClearRxFifo(spiDmaCfg->base);
+    Cy_SCB_SPI_ClearTxFifo(spiDmaCfg->base);
+
+    rxLength = 0U;
+    txRemaining = 0U;
+
+    RxArmHeader();
+    SetReady(READY_LEVEL);
+}
+
+/*******************************************************************************
+* Function Name: SPI_DMA_CyBtldrCommRead
+********************************************************************************
+* Summary:
+*  Waits for a complete packet from the host and copies it to pData.
+*
+* Parameters:
+*  pData   : Buffer to store the packet
+*  size    : Size of pData in bytes
+*  count   : Number of bytes copied
+*  timeout : Time to wait for a packet, in milliseconds
+*
+* Return:
+*  CY_DFU_SUCCESS, CY_DFU_ERROR_TIMEOUT or CY_DFU_ERROR_LENGTH
+*
+*******************************************************************************/
+cy_en_dfu_status_t SPI_DMA_CyBtldrCommRead(uint8_t pData[], uint32_t size, uint32_t *count, uint32_t timeout)
+{
+    cy_en_dfu_status_t status = CY_DFU_ERROR_TIMEOUT;
+    uint32_t timeoutUs = timeout * 1000U;
+    uint32_t length;
+
+    *count = 0U;
+
+    while ((rxLength == 0U) && (timeoutUs > 0U))
+    {
+        Cy_SysLib_DelayUs(POLL_INTERVAL_US);
+        timeoutUs = (timeoutUs > POLL_INTERVAL_US) ? (timeoutUs - POLL_INTERVAL_US) : 0U;
+    }
+
+    length = rxLength;
+    if (length != 0U)
+    {
+        if (length <= size)
+        {
+            (void)memcpy(pData, rxBuffer, length);
+            *count = length;
+            status = CY_DFU_SUCCESS;
+        }
+        else
+        {
+            status = CY_DFU_ERROR_LENGTH;
+        }
+
+        /* Release the buffer. Reception resumes when the response is
+         * queued, see SendResponse(), or at once for a packet that is not
+         * answered. */
+        rxLength = 0U;
+        if (status != CY_DFU_SUCCESS)
+        {
+            RxArmHeader();
+            SetReady(READY_LEVEL);
+        }
+    }
+
+    return status;
+}
+
+/*******************************************************************************
+* Function Name: SPI_DMA_CyBtldrCommWrite
+********************************************************************************
+* Summary:
+*  Queues a response for the host, signals ready and waits until the host has
+*  clocked the whole response out. The dummy bytes the host shifts in
+*  meanwhile are dropped, so they are not mistaken for a packet.
+*
+* Parameters:
+*  pData   : Response to send
+*  size    : Number of bytes to send
+*  count   : Number of bytes sent
+*  timeout : Time to wait for the host to read the response, in milliseconds
+*
+* Return:
+*  CY_DFU_SUCCESS, CY_DFU_ERROR_TIMEOUT or CY_DFU_ERROR_LENGTH
+*
+*******************************************************************************/
+cy_en_dfu_status_t SPI_DMA_CyBtldrCommWrite(const uint8_t pData[], uint32_t size, uint32_t *count, uint32_t timeout)
+{
+    cy_en_dfu_status_t status;
+
+    *count = 0U;
+
+    if ((size == 0U) || (size > CY_DFU_SPI_DMA_BUFFER_SIZE))
+    {
+        status = CY_DFU_ERROR_LENGTH;
+    }
+    else
+    {
+        status = SendResponse(pData, size, timeout);
+        *count = (status == CY_DFU_SUCCESS) ? size : 0U;
+    }
+
+    return status;
+}
+
+/*******************************************************************************
+* Function Name: SendResponse
+********************************************************************************
+* Summary:
+*  Hands the response to the TX channel and waits for the host to read it.
+*  Reception is armed before the handshake goes ready: it first drops the
+*  size bytes that the host shifts in while it reads the response, then
+*  receives the next command. So the host may send that command as soon as
+*  it has read the response.
+*
+* Parameters:
+*  pData   : Response to send
+*  size    : Number of bytes to send, non-zero and within the buffer size
+*  timeout : Time to wait for the host to read the response, in milliseconds
+*
+* Return:
+*  CY_DFU_SUCCESS once the last byte has left the shifter, or
+*  CY_DFU_ERROR_TIMEOUT
+*
+*******************************************************************************/
+static cy_en_dfu_status_t SendResponse(const uint8_t pData[], uint32_t size, uint32_t timeout)
+{
+    cy_en_dfu_status_t status = CY_DFU_ERROR_TIMEOUT;
+    uint32_t timeoutUs = timeout * 1000U;
+
+    Cy_DMA_Channel_Disable(spiDmaCfg->rxDma.base, spiDmaCfg->rxDma.channel);
+
+    (void)memcpy(txBuffer, pData, size);
+    txOffset = 0U;
+    txRemaining = size;
+    Cy_SCB_SPI_ClearTxFifo(spiDmaCfg->base);
+    TxArmChunk();
+
+    /* The host does not clock while the handshake is busy, so the RX FIFO
+     * holds nothing of the next command yet */
+    Cy_SCB_SPI_ClearRxFifo(spiDmaCfg->base);
+    RxArmDiscard(size);
+
+    SetReady(READY_LEVEL);
+
+    while (((txRemaining != 0U) || (!Cy_SCB_SPI_IsTxComplete(spiDmaCfg->base))) && (timeoutUs > 0U))
+    {
+        Cy_SysLib_DelayUs(POLL_INTERVAL_US);
+        timeoutUs = (timeoutUs > POLL_INTERVAL_US) ? (timeoutUs - POLL_INTERVAL_US) : 0U;
+    }
+
+    if ((txRemaining == 0U) && Cy_SCB_SPI_IsTxComplete(spiDmaCfg->base))
+    {
+        status = CY_DFU_SUCCESS;
+    }
+    else
+    {
+        /* Drop the response and wait for a new command */
+        SetReady(BUSY_LEVEL);
+        Cy_DMA_Channel_Disable(spiDmaCfg->txDma.base, spiDmaCfg->txDma.channel);
+        Cy_DMA_Channel_Disable(spiDmaCfg->rxDma.base, spiDmaCfg->rxDma.channel);
+        Cy_SCB_SPI_ClearTxFifo(spiDmaCfg->base);
+        Cy_SCB_SPI_ClearRxFifo(spiDmaCfg->base);
+        txRemaining = 0U;
+        RxArmHeader();
+        SetReady(READY_LEVEL);
+        CY_DFU_LOG_ERR("SPI DMA: host did not read the response");
+    }
+
+    return status;
+}
+
+#endif /* defined(COMPONENT_DFU_SPI_DMA) */
+
+/* [] END OF FILE */
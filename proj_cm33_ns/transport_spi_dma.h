@@ -0,0 +1,105 @@
+/*******************************************************************************
+* File Name        : transport_spi_dma.h
+*
+* Description      : This file is the public interface of transport_spi_dma.c,
+*                    a DMA driven SPI slave transport for the DFU middleware.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef TRANSPORT_SPI_DMA_H
+#define TRANSPORT_SPI_DMA_H
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include "cy_pdl.h"
+#include "cy_dfu.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Size of the receive buffer and of the transmit buffer. A packet may carry
+ * more than one NVM row as long as it fits in this size. */
+#ifndef CY_DFU_SPI_DMA_BUFFER_SIZE
+    #define CY_DFU_SPI_DMA_BUFFER_SIZE      (CY_DFU_SIZEOF_CMD_BUFFER)
+#endif /* CY_DFU_SPI_DMA_BUFFER_SIZE */
+
+/* Interrupt priority of the RX and TX DMA channels */
+#ifndef CY_DFU_SPI_DMA_INTR_PRIORITY
+    #define CY_DFU_SPI_DMA_INTR_PRIORITY    (3U)
+#endif /* CY_DFU_SPI_DMA_INTR_PRIORITY */
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+
+/* Actions passed to the transport callback */
+typedef enum
+{
+    CY_DFU_TRANSPORT_SPI_DMA_INIT,      /* Transport is started */
+    CY_DFU_TRANSPORT_SPI_DMA_DEINIT,    /* Transport is stopped */
+} cy_en_dfu_transport_spi_dma_action_t;
+
+/* Callback to enable or disable the SCB and DMA hardware */
+typedef void (*Cy_DFU_TransportSpiDmaCallback)(cy_en_dfu_transport_spi_dma_action_t action);
+
+/* DMA channel used by the transport */
+typedef struct
+{
+    DW_Type                         *base;      /* DataWire instance */
+    uint32_t                        channel;    /* Channel number */
+    IRQn_Type                       irq;        /* Channel interrupt */
+} cy_stc_dfu_transport_spi_dma_chan_t;
+
+/* SPI DMA transport configuration */
+typedef struct
+{
+    CySCB_Type                          *base;          /* SCB configured as SPI slave */
+    cy_stc_scb_spi_context_t            *context;       /* SCB SPI context */
+    cy_stc_dfu_transport_spi_dma_chan_t rxDma;          /* RX FIFO to memory channel */
+    cy_stc_dfu_transport_spi_dma_chan_t txDma;          /* Memory to TX FIFO channel */
+    GPIO_PRT_Type                       *readyPort;     /* Ready/busy handshake output */
+    uint32_t                            readyPin;
+    Cy_DFU_TransportSpiDmaCallback      callback;
+} cy_stc_dfu_transport_spi_dma_cfg_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void Cy_DFU_TransportSpiDmaConfig(const cy_stc_dfu_transport_spi_dma_cfg_t *config);
+
+void SPI_DMA_CyBtldrCommStart(void);
+void SPI_DMA_CyBtldrCommStop(void);
+void SPI_DMA_CyBtldrCommReset(void);
+cy_en_dfu_status_t SPI_DMA_CyBtldrCommRead(uint8_t pData[], uint32_t size, uint32_t *count, uint32_t timeout);
+cy_en_dfu_status_t SPI_DMA_CyBtldrCommWrite(const uint8_t pData[], uint32_t size, uint32_t *count, uint32_t timeout);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* TRANSPORT_SPI_DMA_H */
+
+/* [] END OF FILE */
@@ -42,6 +42,7 @@
 
 #include "cy_pdl.h"
 #include "cybsp.h"
+#include "boot_time.h"
 
 /*****************************************************************************
 * Macros
@@ -66,6 +67,9 @@ int main(void)
     cy_cmse_funcptr NonSecure_ResetHandler;
     cy_rslt_t result;
 
+    /* Start of the boot timeline */
+    BOOT_TIME_START();
+
     /* Set up internal routing, pins, and clock-to-peripheral connections */
     result = cybsp_init();
 
@@ -85,11 +89,15 @@ int main(void)
     /* Enable global interrupts */
     __enable_irq();
 
+    BOOT_TIME_MARK(SECURE_BSP);
+
     ns_stack = (uint32_t)(*((uint32_t*)CM33_NS_APP_BOOT_ADDR));
     __TZ_set_MSP_NS(ns_stack);
     
     NonSecure_ResetHandler = (cy_cmse_funcptr)(*((uint32_t*)(CM33_NS_APP_BOOT_ADDR + 4)));
 
+    BOOT_TIME_HANDOFF();
+
     /* Start non-secure application */
     NonSecure_ResetHandler();
 
@@ -0,0 +1,240 @@
+/*******************************************************************************
+* File Name        : secure_decrypt.c
+*
+* Description      : This file provides the decryption of encrypted update
+*                    rows that the non-secure image calls through non-secure
+*                    callable veneers, see secure_decrypt.h. The transport key
+*                    is kept wrapped in the image and is unwrapped into secure
+*                    RAM on first use. Each row is decrypted in place in the
+*                    row buffer of the non-secure image, and hashed for the
+*                    cross-check of secure_verify.c in the same pass.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#if defined(SECURE_DECRYPT)
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <arm_cmse.h>
+#include <stdbool.h>
+#include <string.h>
+#include "cy_pdl.h"
+#include "mbedtls/aes.h"
+#include "mbedtls/nist_kw.h"
+#include "secure_decrypt.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Number of update slots, see SECURE_VERIFY_SLOTS */
+#ifndef SECURE_DECRYPT_SLOTS
+    #define SECURE_DECRYPT_SLOTS        (3U)
+#endif /* SECURE_DECRYPT_SLOTS */
+
+/* Transport key wrapped with the key encryption key, as the list of
+ * SECURE_DECRYPT_WRAPPED_KEY_SIZE bytes that "dfu_crypt -w" prints. Set it in
+ * common.mk. */
+#ifndef SECURE_DECRYPT_WRAPPED_KEY
+    #error "Define SECURE_DECRYPT_WRAPPED_KEY, see docs/design_and_implementation.md"
+#endif /* SECURE_DECRYPT_WRAPPED_KEY */
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static const uint8_t secure_decrypt_wrapped_key[SECURE_DECRYPT_WRAPPED_KEY_SIZE] = { SECURE_DECRYPT_WRAPPED_KEY };
+
+static bool secure_decrypt_key_ready = false;
+static mbedtls_aes_context secure_decrypt_aes;
+
+/* Nonce of each image, valid after secure_decrypt_start() */
+static uint8_t secure_decrypt_nonces[SECURE_DECRYPT_SLOTS][SECURE_DECRYPT_NONCE_SIZE];
+static bool secure_decrypt_started[SECURE_DECRYPT_SLOTS];
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static bool secure_decrypt_unwrap_key(void);
+
+/*******************************************************************************
+* Function Name: secure_decrypt_kek
+********************************************************************************
+* Summary:
+*  Provides the key encryption key that the transport key is wrapped with.
+*  A key built into the image would let the image files alone reveal the
+*  transport key, so there is no default key: this default fails, and every
+*  encrypted update is rejected with SECURE_DECRYPT_STATUS_KEY. Override this
+*  function to take the key from a key store that only the secure image can
+*  read.
+*
+* Parameters:
+*  kek : SECURE_DECRYPT_KEY_SIZE bytes of result
+*
+* Return:
+*  True if the key is available
+*
+*******************************************************************************/
+__WEAK bool secure_decrypt_kek(uint8_t kek[])
+{
+    (void)kek;
+
+    return false;
+}
+
+/*******************************************************************************
+* Function Name: secure_decrypt_start
+********************************************************************************
+* Summary:
+*  Starts the encrypted stream of an image. Its rows are then decrypted by
+*  secure_decrypt_row().
+*
+* Parameters:
+*  image_id   : MCUboot image ID
+*  nonce_low  : Bytes 0 to 3 of the nonce, little endian
+*  nonce_high : Bytes 4 to 7 of the nonce, little endian
+*
+* Return:
+*  SECURE_DECRYPT_STATUS_OK, or the error
+*
+*******************************************************************************/
+SECURE_VERIFY_ENTRY uint32_t secure_decrypt_start(uint32_t image_id, uint32_t nonce_low, uint32_t nonce_high)
+{
+    if (image_id >= SECURE_DECRYPT_SLOTS)
+    {
+        return SECURE_DECRYPT_STATUS_IMAGE_ID;
+    }
+    if ((!secure_decrypt_key_ready) && (!secure_decrypt_unwrap_key()))
+    {
+        return SECURE_DECRYPT_STATUS_KEY;
+    }
+
+    for (uint32_t i = 0U; i < 4U; i++)
+    {
+        secure_decrypt_nonces[image_id][i] = (uint8_t)(nonce_low >> (8U * i));
+        secure_decrypt_nonces[image_id][4U + i] = (uint8_t)(nonce_high >> (8U * i));
+    }
+    secure_decrypt_started[image_id] = true;
+
+    return SECURE_DECRYPT_STATUS_OK;
+}
+
+/*******************************************************************************
+* Function Name: secure_decrypt_row
+********************************************************************************
+* Summary:
+*  Decrypts a row of an image in place, see secure_decrypt.h for the counter
+*  blocks. With SECURE_VERIFY the plain row is also hashed for the
+*  verification of the slot.
+*
+* Parameters:
+*  image_id : MCUboot image ID
+*  offset   : Offset of the row in the update slot, a multiple of
+*             SECURE_DECRYPT_BLOCK_SIZE
+*  row      : Row, in non-secure memory
+*  length   : Row size
+*
+* Return:
+*  SECURE_DECRYPT_STATUS_OK, or the error
+*
+*******************************************************************************/
+SECURE_VERIFY_ENTRY uint32_t secure_decrypt_row(uint32_t image_id, uint32_t offset, uint8_t row[],
+                                                uint32_t length)
+{
+    uint8_t counter[SECURE_DECRYPT_BLOCK_SIZE];
+    uint8_t stream[SECURE_DECRYPT_BLOCK_SIZE];
+    size_t stream_offset = 0U;
+    uint32_t block = offset / SECURE_DECRYPT_BLOCK_SIZE;
+    uint32_t status = SECURE_DECRYPT_STATUS_OK;
+
+    if (image_id >= SECURE_DECRYPT_SLOTS)
+    {
+        return SECURE_DECRYPT_STATUS_IMAGE_ID;
+    }
+    if (!secure_decrypt_started[image_id])
+    {
+        return SECURE_DECRYPT_STATUS_STATE;
+    }
+    /* The row is written here, so it must be non-secure memory that the
+     * caller may write */
+    if (((offset % SECURE_DECRYPT_BLOCK_SIZE) != 0U) ||
+        (cmse_check_address_range(row, length, CMSE_NONSECURE | CMSE_MPU_READWRITE) == NULL))
+    {
+        return SECURE_DECRYPT_STATUS_BUFFER;
+    }
+
+    memcpy(counter, secure_decrypt_nonces[image_id], SECURE_DECRYPT_NONCE_SIZE);
+    for (uint32_t i = 0U; i < 4U; i++)
+    {
+        counter[SECURE_DECRYPT_CTR_IMAGE_IDX + i] = (uint8_t)(image_id >> (24U - (8U * i)));
+        counter[SECURE_DECRYPT_CTR_BLOCK_IDX + i] = (uint8_t)(block >> (24U - (8U * i)));
+    }
+    if (mbedtls_aes_crypt_ctr(&secure_decrypt_aes, length, &stream_offset, counter, stream, row, row) != 0)
+    {
+        status = SECURE_DECRYPT_STATUS_CRYPTO;
+    }
+#if defined(SECURE_VERIFY)
+    else
+    {
+        secure_verify_feed(image_id, offset, row, length);
+    }
+#endif /* defined(SECURE_VERIFY) */
+    memset(stream, 0, sizeof(stream));
+
+    return status;
+}
+
+/*******************************************************************************
+* Function Name: secure_decrypt_unwrap_key
+********************************************************************************
+* Summary:
+*  Unwraps the transport key into the AES context. The plain key only exists
+*  on the stack of this function.
+*
+*******************************************************************************/
+static bool secure_decrypt_unwrap_key(void)
+{
+    uint8_t kek[SECURE_DECRYPT_KEY_SIZE];
+    uint8_t key[SECURE_DECRYPT_KEY_SIZE];
+    size_t key_length = 0U;
+    mbedtls_nist_kw_context kw;
+
+    mbedtls_nist_kw_init(&kw);
+    secure_decrypt_key_ready = secure_decrypt_kek(kek) &&
+        (mbedtls_nist_kw_setkey(&kw, MBEDTLS_CIPHER_ID_AES, kek, 8U * SECURE_DECRYPT_KEY_SIZE, 0) == 0) &&
+        (mbedtls_nist_kw_unwrap(&kw, MBEDTLS_KW_MODE_KW, secure_decrypt_wrapped_key,
+                                SECURE_DECRYPT_WRAPPED_KEY_SIZE, key, &key_length, sizeof(key)) == 0) &&
+        (key_length == SECURE_DECRYPT_KEY_SIZE);
+    mbedtls_nist_kw_free(&kw);
+
+    if (secure_decrypt_key_ready)
+    {
+        mbedtls_aes_init(&secure_decrypt_aes);
+        secure_decrypt_key_ready = (mbedtls_aes_setkey_enc(&secure_decrypt_aes, key, 8U * SECURE_DECRYPT_KEY_SIZE) == 0);
+    }
+    memset(kek, 0, sizeof(kek));
+    memset(key, 0, sizeof(key));
+
+    return secure_decrypt_key_ready;
+}
+
+#endif /* defined(SECURE_DECRYPT) */
+
+/* [] END OF FILE */
@@ -0,0 +1,409 @@
+/*******************************************************************************
+* File Name        : secure_verify.c
+*
+* Description      : This file provides the image verification service that
+*                    the non-secure image calls through non-secure callable
+*                    veneers, see secure_verify.h. It checks an update slot the
+*                    way the bootloader does at the next reset: the image hash
+*                    TLV over the header, the image and the protected TLVs, the
+*                    key hash TLV, and the ECDSA P-256 signature with the
+*                    public key of the bootloader. Rows that the secure image
+*                    decrypts, see secure_decrypt.c, are hashed in the same
+*                    pass, and such a slot is not read again.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#if defined(SECURE_VERIFY)
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <stdbool.h>
+#include <string.h>
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "mbedtls/pk.h"
+#include "mbedtls/sha256.h"
+#include "mcuboot_image.h"
+#include "secure_verify.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Update slots as {start, size}, indexed by MCUboot image ID, as
+ * DFU_UPDATE_SLOTS of proj_cm33_ns */
+#ifndef SECURE_VERIFY_SLOTS
+    #define SECURE_VERIFY_SLOTS                                                         \
+        { CYMEM_CM33_0_m33s_upgrade_slot_START, CYMEM_CM33_0_m33s_upgrade_slot_SIZE },  \
+        { CYMEM_CM33_0_m33_upgrade_slot_START, CYMEM_CM33_0_m33_upgrade_slot_SIZE },    \
+        { CYMEM_CM33_0_m55_upgrade_slot_START, CYMEM_CM33_0_m55_upgrade_slot_SIZE }
+#endif /* SECURE_VERIFY_SLOTS */
+
+/* Public key of the bootloader, the SubjectPublicKeyInfo in DER that
+ * "imgtool getpub -k <signing key>" writes as a C file. Add that file to the
+ * SOURCES of this project. */
+#ifndef SECURE_VERIFY_KEY
+    #define SECURE_VERIFY_KEY               ecdsa_pub_key
+    #define SECURE_VERIFY_KEY_LEN           ecdsa_pub_key_len
+#endif /* SECURE_VERIFY_KEY */
+
+/* The update slots are non-secure, the secure image reads them through the
+ * non-secure alias */
+#define SECURE_VERIFY_SECURE_ALIAS          (0x10000000UL)
+
+#define SECURE_VERIFY_HASH_SIZE             (32U)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef enum
+{
+    SECURE_VERIFY_IDLE,
+    SECURE_VERIFY_HASHING,
+    SECURE_VERIFY_DONE
+} secure_verify_state_t;
+
+/* Hash of the rows of a slot fed in order from its start */
+typedef struct
+{
+    bool active;
+    uint32_t signed_size;                       /* Header, image and protected TLVs */
+    uint32_t fed;                               /* Bytes fed from the slot start */
+    mbedtls_sha256_context sha;
+} secure_verify_stream_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+extern const unsigned char SECURE_VERIFY_KEY[];
+extern const unsigned int SECURE_VERIFY_KEY_LEN;
+
+static const struct
+{
+    uint32_t start;
+    uint32_t size;
+} secure_verify_slots[] = { SECURE_VERIFY_SLOTS };
+
+static secure_verify_state_t secure_verify_state = SECURE_VERIFY_IDLE;
+static const uint8_t *secure_verify_slot;
+static uint32_t secure_verify_slot_size;
+static uint32_t secure_verify_signed_size;     /* Header, image and protected TLVs */
+static uint32_t secure_verify_hashed;
+static mbedtls_sha256_context secure_verify_sha;
+static secure_verify_stream_t *secure_verify_cross_check;  /* Complete stream of the slot, or NULL */
+static secure_verify_stream_t secure_verify_streams[sizeof(secure_verify_slots) / sizeof(secure_verify_slots[0])];
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static uint32_t secure_verify_check(const uint8_t hash[]);
+
+/*******************************************************************************
+* Function Name: secure_verify_begin
+********************************************************************************
+* Summary:
+*  Starts the verification of the image in the update slot of an image ID.
+*  Any verification in progress is dropped. The slot is always hashed from
+*  the memory, so the result covers what the bootloader will boot. If the
+*  whole signed part of the image was fed with secure_verify_feed(), that
+*  hash must match too.
+*
+* Parameters:
+*  image_id : MCUboot image ID, 0 for proj_cm33_s, 1 for proj_cm33_ns and 2
+*             for proj_cm55
+*
+* Return:
+*  SECURE_VERIFY_STATUS_IN_PROGRESS, or the error
+*
+*******************************************************************************/
+SECURE_VERIFY_ENTRY uint32_t secure_verify_begin(uint32_t image_id)
+{
+    mcuboot_image_header_t header;
+    uint64_t end;
+
+    if (secure_verify_state != SECURE_VERIFY_IDLE)
+    {
+        mbedtls_sha256_free(&secure_verify_sha);
+        secure_verify_state = SECURE_VERIFY_IDLE;
+    }
+
+    if (image_id >= (sizeof(secure_verify_slots) / sizeof(secure_verify_slots[0])))
+    {
+        return SECURE_VERIFY_STATUS_IMAGE_ID;
+    }
+    secure_verify_slot = (const uint8_t *)(secure_verify_slots[image_id].start & ~SECURE_VERIFY_SECURE_ALIAS);
+    secure_verify_slot_size = secure_verify_slots[image_id].size;
+
+    if (!mcuboot_image_parse_header(secure_verify_slot, &header))
+    {
+        return SECURE_VERIFY_STATUS_HEADER;
+    }
+    end = (uint64_t)header.hdr_size + header.img_size + header.protect_tlv_size + MCUBOOT_TLV_INFO_SIZE;
+    if (end > secure_verify_slot_size)
+    {
+        return SECURE_VERIFY_STATUS_HEADER;
+    }
+    secure_verify_signed_size = (uint32_t)header.hdr_size + header.img_size + header.protect_tlv_size;
+    secure_verify_hashed = 0U;
+
+    /* The rows hashed as they were written must be what the slot holds */
+    secure_verify_cross_check = NULL;
+    if ((secure_verify_streams[image_id].active) &&
+        (secure_verify_streams[image_id].fed == secure_verify_streams[image_id].signed_size))
+    {
+        secure_verify_cross_check = &secure_verify_streams[image_id];
+    }
+
+    mbedtls_sha256_init(&secure_verify_sha);
+    if (mbedtls_sha256_starts(&secure_verify_sha, 0) != 0)
+    {
+        mbedtls_sha256_free(&secure_verify_sha);
+        return SECURE_VERIFY_STATUS_CRYPTO;
+    }
+    secure_verify_state = SECURE_VERIFY_HASHING;
+
+    return SECURE_VERIFY_STATUS_IN_PROGRESS;
+}
+
+/*******************************************************************************
+* Function Name: secure_verify_feed
+********************************************************************************
+* Summary:
+*  Hashes a row of an update slot as it is written, for a cross-check with
+*  the slot read back by the verification. The row at offset 0 starts the
+*  hash of the slot, and the rows must follow in order. A row out of order
+*  stops the hash, and the verification then only reads the slot.
+*
+* Parameters:
+*  image_id : MCUboot image ID of the slot
+*  offset   : Offset of the row in the slot
+*  data     : Row as written
+*  length   : Row size
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void secure_verify_feed(uint32_t image_id, uint32_t offset, const uint8_t data[], uint32_t length)
+{
+    secure_verify_stream_t *stream;
+    mcuboot_image_header_t header;
+    uint32_t size;
+
+    if (image_id >= (sizeof(secure_verify_streams) / sizeof(secure_verify_streams[0])))
+    {
+        return;
+    }
+    stream = &secure_verify_streams[image_id];
+
+    if (offset == 0U)
+    {
+        if (stream->active)
+        {
+            mbedtls_sha256_free(&stream->sha);
+        }
+        stream->active = (length >= MCUBOOT_IMAGE_HEADER_SIZE) && mcuboot_image_parse_header(data, &header);
+        if (!stream->active)
+        {
+            return;
+        }
+        stream->signed_size = (uint32_t)header.hdr_size + header.img_size + header.protect_tlv_size;
+        stream->fed = 0U;
+        mbedtls_sha256_init(&stream->sha);
+        stream->active = (mbedtls_sha256_starts(&stream->sha, 0) == 0);
+    }
+
+    if ((stream->active) && (offset == stream->fed) && (stream->fed < stream->signed_size))
+    {
+        size = stream->signed_size - stream->fed;
+        size = (size < length) ? size : length;
+        stream->active = (mbedtls_sha256_update(&stream->sha, data, size) == 0);
+        stream->fed += size;
+    }
+    else if (stream->active && (offset < stream->signed_size))
+    {
+        /* Out of order, nothing to cross-check */
+        mbedtls_sha256_free(&stream->sha);
+        stream->active = false;
+    }
+    else
+    {
+        /* Past the signed part of the image */
+    }
+}
+
+/*******************************************************************************
+* Function Name: secure_verify_update
+********************************************************************************
+* Summary:
+*  Hashes the next part of the slot.
+*
+* Parameters:
+*  max_bytes : Most bytes to hash in this call, at most SECURE_VERIFY_MAX_STEP
+*
+* Return:
+*  SECURE_VERIFY_STATUS_IN_PROGRESS while there is more to hash,
+*  SECURE_VERIFY_STATUS_HASHED once done, or the error
+*
+*******************************************************************************/
+SECURE_VERIFY_ENTRY uint32_t secure_verify_update(uint32_t max_bytes)
+{
+    uint32_t length = secure_verify_signed_size - secure_verify_hashed;
+
+    if (secure_verify_state == SECURE_VERIFY_DONE)
+    {
+        return SECURE_VERIFY_STATUS_HASHED;
+    }
+    if (secure_verify_state != SECURE_VERIFY_HASHING)
+    {
+        return SECURE_VERIFY_STATUS_STATE;
+    }
+
+    max_bytes = (max_bytes < SECURE_VERIFY_MAX_STEP) ? max_bytes : SECURE_VERIFY_MAX_STEP;
+    length = (length < max_bytes) ? length : max_bytes;
+    if (mbedtls_sha256_update(&secure_verify_sha, &secure_verify_slot[secure_verify_hashed], length) != 0)
+    {
+        mbedtls_sha256_free(&secure_verify_sha);
+        secure_verify_state = SECURE_VERIFY_IDLE;
+        return SECURE_VERIFY_STATUS_CRYPTO;
+    }
+    secure_verify_hashed += length;
+
+    if (secure_verify_hashed < secure_verify_signed_size)
+    {
+        return SECURE_VERIFY_STATUS_IN_PROGRESS;
+    }
+    secure_verify_state = SECURE_VERIFY_DONE;
+
+    return SECURE_VERIFY_STATUS_HASHED;
+}
+
+/*******************************************************************************
+* Function Name: secure_verify_finish
+********************************************************************************
+* Summary:
+*  Ends the verification once the slot is hashed and checks the image hash,
+*  the key hash and the signature TLVs. The hash of the rows fed as they
+*  were written, if complete, must equal the hash of the slot.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  SECURE_VERIFY_STATUS_OK if the bootloader would accept the image, or the
+*  error
+*
+*******************************************************************************/
+SECURE_VERIFY_ENTRY uint32_t secure_verify_finish(void)
+{
+    uint8_t hash[SECURE_VERIFY_HASH_SIZE];
+    uint32_t status;
+
+    if (secure_verify_state != SECURE_VERIFY_DONE)
+    {
+        return SECURE_VERIFY_STATUS_STATE;
+    }
+
+    status = (mbedtls_sha256_finish(&secure_verify_sha, hash) == 0) ? secure_verify_check(hash) :
+                                                                     SECURE_VERIFY_STATUS_CRYPTO;
+    mbedtls_sha256_free(&secure_verify_sha);
+
+    if (secure_verify_cross_check != NULL)
+    {
+        uint8_t fed_hash[SECURE_VERIFY_HASH_SIZE];
+
+        /* The slot does not hold the rows as they were written */
+        if ((status == SECURE_VERIFY_STATUS_OK) &&
+            ((secure_verify_cross_check->signed_size != secure_verify_signed_size) ||
+             (mbedtls_sha256_finish(&secure_verify_cross_check->sha, fed_hash) != 0) ||
+             (memcmp(fed_hash, hash, SECURE_VERIFY_HASH_SIZE) != 0)))
+        {
+            status = SECURE_VERIFY_STATUS_HASH;
+        }
+        mbedtls_sha256_free(&secure_verify_cross_check->sha);
+        secure_verify_cross_check->active = false;
+        secure_verify_cross_check = NULL;
+        memset(fed_hash, 0, sizeof(fed_hash));
+    }
+    memset(hash, 0, sizeof(hash));
+    secure_verify_state = SECURE_VERIFY_IDLE;
+
+    return status;
+}
+
+/*******************************************************************************
+* Function Name: secure_verify_check
+********************************************************************************
+* Summary:
+*  Checks the TLVs of the slot against the hash of the signed part of the
+*  image, as MCUboot does.
+*
+*******************************************************************************/
+static uint32_t secure_verify_check(const uint8_t hash[])
+{
+    uint8_t key_hash[SECURE_VERIFY_HASH_SIZE];
+    const uint8_t *tlv;
+    uint16_t length = 0U;
+    mbedtls_pk_context key;
+    uint32_t status = SECURE_VERIFY_STATUS_OK;
+
+    tlv = mcuboot_image_find_tlv(secure_verify_slot, secure_verify_slot_size, MCUBOOT_TLV_SHA256, &length);
+    if ((tlv == NULL) || (length != SECURE_VERIFY_HASH_SIZE) || (memcmp(tlv, hash, SECURE_VERIFY_HASH_SIZE) != 0))
+    {
+        return SECURE_VERIFY_STATUS_HASH;
+    }
+
+    /* MCUboot selects the key by the hash of the key in the image */
+    tlv = mcuboot_image_find_tlv(secure_verify_slot, secure_verify_slot_size, MCUBOOT_TLV_KEYHASH, &length);
+    if ((tlv == NULL) || (length != SECURE_VERIFY_HASH_SIZE) ||
+        (mbedtls_sha256(SECURE_VERIFY_KEY, SECURE_VERIFY_KEY_LEN, key_hash, 0) != 0) ||
+        (memcmp(tlv, key_hash, SECURE_VERIFY_HASH_SIZE) != 0))
+    {
+        return SECURE_VERIFY_STATUS_KEY;
+    }
+
+    tlv = mcuboot_image_find_tlv(secure_verify_slot, secure_verify_slot_size, MCUBOOT_TLV_ECDSA_SIG, &length);
+    if (tlv == NULL)
+    {
+        return SECURE_VERIFY_STATUS_SIGNATURE;
+    }
+
+    mbedtls_pk_init(&key);
+    if (mbedtls_pk_parse_public_key(&key, SECURE_VERIFY_KEY, SECURE_VERIFY_KEY_LEN) != 0)
+    {
+        status = SECURE_VERIFY_STATUS_CRYPTO;
+    }
+    else if (mbedtls_pk_verify(&key, MBEDTLS_MD_SHA256, hash, SECURE_VERIFY_HASH_SIZE, tlv, length) != 0)
+    {
+        status = SECURE_VERIFY_STATUS_SIGNATURE;
+    }
+    else
+    {
+        /* Valid */
+    }
+    mbedtls_pk_free(&key);
+
+    return status;
+}
+
+#endif /* defined(SECURE_VERIFY) */
+
+/* [] END OF FILE */
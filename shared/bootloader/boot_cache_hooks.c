@@ -0,0 +1,289 @@
+/*******************************************************************************
+* File Name        : boot_cache_hooks.c
+*
+* Description      : MCUboot image access hooks of the validated-image cache,
+*                    see shared/include/boot_cache.h. Add this file to the
+*                    SOURCES of proj_bootloader, define
+*                    MCUBOOT_IMAGE_ACCESS_HOOKS and BOOT_CACHE_HOOKS, and call
+*                    boot_cache_boot_done() once boot_go() has succeeded.
+*                    boot_image_check_hook() skips the signature check of a
+*                    primary slot whose digest matches the record; any other
+*                    slot is validated by MCUboot as usual.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#if defined(BOOT_CACHE_HOOKS)
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "bootutil/boot_hooks.h"
+#include "bootutil/bootutil_public.h"
+#include "bootutil/fault_injection_hardening.h"
+#include "bootutil/image.h"
+#include "boot_cache.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Primary slots as {start, size}, indexed by MCUboot image ID, as
+ * SECURE_VERIFY_SLOTS of proj_cm33_s. The slots are read through the XIP. */
+#ifndef BOOT_CACHE_PRIMARY_SLOTS
+    #define BOOT_CACHE_PRIMARY_SLOTS                                        \
+        { CYMEM_CM33_0_m33s_nvm_START, CYMEM_CM33_0_m33s_nvm_SIZE },        \
+        { CYMEM_CM33_0_m33_nvm_START, CYMEM_CM33_0_m33_nvm_SIZE },          \
+        { CYMEM_CM33_0_m55_nvm_START, CYMEM_CM33_0_m55_nvm_SIZE }
+#endif /* BOOT_CACHE_PRIMARY_SLOTS */
+
+/* Slot argument of the hooks for the primary slot */
+#define BOOT_CACHE_PRIMARY_SLOT     (0)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t start;
+    uint32_t size;
+} boot_cache_slot_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static const boot_cache_slot_t boot_cache_slots[] = { BOOT_CACHE_PRIMARY_SLOTS };
+
+static boot_cache_record_t boot_cache_record;
+static bool boot_cache_started = false;
+
+/* Images validated in full by MCUboot in this boot, one bit per image ID */
+static uint32_t boot_cache_pending = 0U;
+
+/*******************************************************************************
+* Function Name: boot_cache_read
+********************************************************************************
+* Summary:
+*  Reads the record from storage that only the bootloader can write, such as
+*  a bootloader-owned RRAM area. Override it together with boot_cache_write()
+*  for the storage of the device. The default has no storage, so every boot
+*  validates all slots in full.
+*
+* Parameters:
+*  record : The record
+*
+* Return:
+*  True if the record was read
+*
+*******************************************************************************/
+__WEAK bool boot_cache_read(boot_cache_record_t *record)
+{
+    (void)record;
+
+    return false;
+}
+
+/*******************************************************************************
+* Function Name: boot_cache_write
+********************************************************************************
+* Summary:
+*  Writes the record back to its storage, see boot_cache_read().
+*
+* Parameters:
+*  record : The record
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+__WEAK void boot_cache_write(const boot_cache_record_t *record)
+{
+    (void)record;
+}
+
+/*******************************************************************************
+* Function Name: boot_cache_start
+********************************************************************************
+* Summary:
+*  Reads the record and starts the boot, on the first hook call of a boot.
+*
+*******************************************************************************/
+static void boot_cache_start(void)
+{
+    if (!boot_cache_started)
+    {
+        memset(&boot_cache_record, 0, sizeof(boot_cache_record));
+        (void)boot_cache_read(&boot_cache_record);
+        if (boot_cache_begin(&boot_cache_record))
+        {
+            boot_cache_write(&boot_cache_record);
+        }
+        boot_cache_started = true;
+    }
+}
+
+/*******************************************************************************
+* Function Name: boot_image_check_hook
+********************************************************************************
+* Summary:
+*  Called by MCUboot before it validates a slot. A primary slot whose digest
+*  matches the record is reported valid without the signature check. Any
+*  other slot is validated by MCUboot, and boot_cache_boot_done() records the
+*  primary slots among them.
+*
+* Parameters:
+*  img_index : MCUboot image ID
+*  slot      : Slot of the image, 0 for the primary slot
+*
+* Return:
+*  FIH_SUCCESS to skip the validation, FIH_BOOT_HOOK_REGULAR to run it
+*
+*******************************************************************************/
+fih_ret boot_image_check_hook(int img_index, int slot)
+{
+    const boot_cache_slot_t *entry;
+
+    if ((slot != BOOT_CACHE_PRIMARY_SLOT) || (img_index < 0) ||
+        ((uint32_t)img_index >= (sizeof(boot_cache_slots) / sizeof(boot_cache_slots[0]))) ||
+        ((uint32_t)img_index >= BOOT_CACHE_SLOTS))
+    {
+        FIH_RET(FIH_BOOT_HOOK_REGULAR);
+    }
+
+    boot_cache_start();
+    entry = &boot_cache_slots[img_index];
+    if (boot_cache_hit(&boot_cache_record, entry->start, (const uint8_t *)(uintptr_t)entry->start, entry->size))
+    {
+        FIH_RET(FIH_SUCCESS);
+    }
+
+    boot_cache_pending |= (1UL << (uint32_t)img_index);
+    FIH_RET(FIH_BOOT_HOOK_REGULAR);
+}
+
+/*******************************************************************************
+* Function Name: boot_cache_boot_done
+********************************************************************************
+* Summary:
+*  Call it once boot_go() has validated all images, before the first image is
+*  launched. Records the digest of each primary slot that MCUboot validated in
+*  full in this boot, such as a slot an update was just installed into, and
+*  writes the record back.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+void boot_cache_boot_done(void)
+{
+    bool changed = false;
+
+    if (!boot_cache_started)
+    {
+        return;
+    }
+
+    for (uint32_t idx = 0U; idx < (sizeof(boot_cache_slots) / sizeof(boot_cache_slots[0])); idx++)
+    {
+        const boot_cache_slot_t *entry = &boot_cache_slots[idx];
+
+        if ((boot_cache_pending & (1UL << idx)) != 0U)
+        {
+            changed = boot_cache_store(&boot_cache_record, entry->start, (const uint8_t *)(uintptr_t)entry->start,
+                                       entry->size, true) || changed;
+        }
+    }
+    changed = boot_cache_end(&boot_cache_record) || changed;
+    boot_cache_pending = 0U;
+
+    if (changed)
+    {
+        boot_cache_write(&boot_cache_record);
+    }
+}
+
+#if !defined(BOOT_CACHE_CHECK_HOOK_ONLY)
+/* The other image access hooks keep the regular behavior. A bootloader that
+ * has its own hooks defines BOOT_CACHE_CHECK_HOOK_ONLY and keeps them. */
+
+int boot_read_image_header_hook(int img_index, int slot, struct image_header *img_head)
+{
+    (void)img_index;
+    (void)slot;
+    (void)img_head;
+
+    return BOOT_HOOK_REGULAR;
+}
+
+int boot_perform_update_hook(int img_index, struct image_header *img_head, const struct flash_area *area)
+{
+    (void)img_index;
+    (void)img_head;
+    (void)area;
+
+    return BOOT_HOOK_REGULAR;
+}
+
+int boot_copy_region_post_hook(int img_index, const struct flash_area *area, size_t size)
+{
+    (void)img_index;
+    (void)area;
+    (void)size;
+
+    return 0;
+}
+
+int boot_read_swap_state_primary_slot_hook(int image_index, struct boot_swap_state *state)
+{
+    (void)image_index;
+    (void)state;
+
+    return BOOT_HOOK_REGULAR;
+}
+
+int boot_serial_uploaded_hook(int img_index, const struct flash_area *area, size_t size)
+{
+    (void)img_index;
+    (void)area;
+    (void)size;
+
+    return 0;
+}
+
+int boot_img_install_stat_hook(int image_index, int slot, int *img_install_stat)
+{
+    (void)image_index;
+    (void)slot;
+    (void)img_install_stat;
+
+    return BOOT_HOOK_REGULAR;
+}
+#endif /* !defined(BOOT_CACHE_CHECK_HOOK_ONLY) */
+
+#endif /* defined(BOOT_CACHE_HOOKS) */
+
+/* [] END OF FILE */
@@ -0,0 +1,394 @@
+/*******************************************************************************
+* File Name        : boot_cache.h
+*
+* Description      : Validated-image cache for the bootloader. Records a
+*                    digest of each slot that passed a full validation,
+*                    computed by the bootloader over the image as it is in
+*                    the slot. A later boot hashes the slot again and skips
+*                    the signature check if the digest still matches. A full
+*                    validation is forced every BOOT_CACHE_FULL_EVERY boots.
+*                    The record is kept by the bootloader in storage that the
+*                    applications cannot write and is protected by the keyed
+*                    MAC BOOT_CACHE_MAC(). See boot_cache_hooks.c for the
+*                    MCUboot hooks that use it.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef BOOT_CACHE_H
+#define BOOT_CACHE_H
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "mcuboot_image.h"
+#if !defined(BOOT_CACHE_MAC) && defined(BOOT_CACHE_KEY)
+    #include "mbedtls/md.h"
+#endif /* !defined(BOOT_CACHE_MAC) && defined(BOOT_CACHE_KEY) */
+#if !defined(BOOT_CACHE_DIGEST)
+    #include "mbedtls/sha256.h"
+#endif /* !defined(BOOT_CACHE_DIGEST) */
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* "VCAC" */
+#define BOOT_CACHE_MAGIC            (0x43414356UL)
+#define BOOT_CACHE_VERSION          (2U)
+
+/* Number of slots in the record: the primary slots of proj_cm33_s,
+ * proj_cm33_ns and proj_cm55 */
+#ifndef BOOT_CACHE_SLOTS
+    #define BOOT_CACHE_SLOTS        (3U)
+#endif /* BOOT_CACHE_SLOTS */
+
+/* Policy: validate every slot in full on every Nth boot, whether it changed or
+ * not. 1 validates in full on every boot, which disables the cache, 0 only
+ * when a slot changes. */
+#ifndef BOOT_CACHE_FULL_EVERY
+    #define BOOT_CACHE_FULL_EVERY   (16U)
+#endif /* BOOT_CACHE_FULL_EVERY */
+
+#define BOOT_CACHE_DIGEST_SIZE      (32U)
+#define BOOT_CACHE_MAC_SIZE         (32U)
+
+/* Digest of the slots: BOOT_CACHE_DIGEST(data, size, digest) computes
+ * BOOT_CACHE_DIGEST_SIZE bytes over size bytes of data and evaluates to 0 on
+ * success. The default is SHA-256 of Mbed TLS, which uses the crypto
+ * accelerator of the device. */
+#ifndef BOOT_CACHE_DIGEST
+    #define BOOT_CACHE_DIGEST(data, size, digest)   mbedtls_sha256((data), (size), (digest), 0)
+#endif /* BOOT_CACHE_DIGEST */
+
+/* Protection of the record: BOOT_CACHE_MAC(data, size, mac) computes a keyed
+ * MAC of BOOT_CACHE_MAC_SIZE bytes over size bytes of data and evaluates to 0
+ * on success. A record that can be forged lets a changed image skip its
+ * validation, so there is no unkeyed default. Either define BOOT_CACHE_MAC, or
+ * define BOOT_CACHE_KEY as an expression that points to the device key, which
+ * only the bootloader can read, and BOOT_CACHE_KEY_SIZE as its size in bytes
+ * to use HMAC-SHA256 of Mbed TLS. */
+#ifndef BOOT_CACHE_MAC
+    #if defined(BOOT_CACHE_KEY) && defined(BOOT_CACHE_KEY_SIZE)
+        #define BOOT_CACHE_HMAC_SHA256
+        #define BOOT_CACHE_MAC(data, size, mac)     boot_cache_hmac_sha256((data), (size), (mac))
+    #else
+        #error "boot_cache.h needs a keyed MAC: define BOOT_CACHE_MAC, or BOOT_CACHE_KEY and BOOT_CACHE_KEY_SIZE"
+    #endif /* defined(BOOT_CACHE_KEY) && defined(BOOT_CACHE_KEY_SIZE) */
+#endif /* BOOT_CACHE_MAC */
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t slot;                                  /* Slot address, 0 if unused */
+    uint8_t digest[BOOT_CACHE_DIGEST_SIZE];         /* boot_cache_digest() at the last validation */
+} boot_cache_entry_t;
+
+typedef struct
+{
+    uint32_t magic;                                 /* BOOT_CACHE_MAGIC */
+    uint32_t version;                               /* BOOT_CACHE_VERSION */
+    uint32_t boots_since_full;                      /* Boots since the last full validation */
+    uint32_t full;                                  /* Non-zero while a full validation is due */
+    boot_cache_entry_t entries[BOOT_CACHE_SLOTS];
+    uint8_t mac[BOOT_CACHE_MAC_SIZE];               /* BOOT_CACHE_MAC() of all fields above */
+} boot_cache_record_t;
+
+#if defined(BOOT_CACHE_HMAC_SHA256)
+/*******************************************************************************
+* Function Name: boot_cache_hmac_sha256
+********************************************************************************
+* Summary:
+*  Default BOOT_CACHE_MAC() when BOOT_CACHE_KEY is defined: HMAC-SHA256 of the
+*  data with the device key.
+*
+* Parameters:
+*  data : Data
+*  size : Size of data in bytes
+*  mac  : BOOT_CACHE_MAC_SIZE bytes of result
+*
+* Return:
+*  0 on success
+*
+*******************************************************************************/
+static inline int boot_cache_hmac_sha256(const uint8_t data[], uint32_t size, uint8_t mac[])
+{
+    return mbedtls_md_hmac(mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), (const uint8_t *)(BOOT_CACHE_KEY),
+                           (size_t)(BOOT_CACHE_KEY_SIZE), data, size, mac);
+}
+#endif /* defined(BOOT_CACHE_HMAC_SHA256) */
+
+/*******************************************************************************
+* Function Name: boot_cache_seal
+********************************************************************************
+* Summary:
+*  Updates the MAC of the record. Call it before the record is written back to
+*  its storage.
+*
+* Parameters:
+*  record : The record
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static inline void boot_cache_seal(boot_cache_record_t *record)
+{
+    if (BOOT_CACHE_MAC((const uint8_t *)record, (uint32_t)offsetof(boot_cache_record_t, mac), record->mac) != 0)
+    {
+        /* Fails the check at the next boot, so all slots are validated in full */
+        memset(record->mac, 0, BOOT_CACHE_MAC_SIZE);
+    }
+}
+
+/*******************************************************************************
+* Function Name: boot_cache_begin
+********************************************************************************
+* Summary:
+*  Starts a boot. A record whose magic, version or MAC does not match is
+*  cleared, so every slot is validated in full. Otherwise a full validation is
+*  forced if BOOT_CACHE_FULL_EVERY boots have passed since the last one. A
+*  record whose MAC cannot be computed is cleared as well. Call
+*  it once per boot before the first boot_cache_hit().
+*
+* Parameters:
+*  record : The record, read from its storage
+*
+* Return:
+*  True if the record was changed and must be written back
+*
+*******************************************************************************/
+static inline bool boot_cache_begin(boot_cache_record_t *record)
+{
+    uint8_t mac[BOOT_CACHE_MAC_SIZE];
+
+    if ((BOOT_CACHE_MAC((const uint8_t *)record, (uint32_t)offsetof(boot_cache_record_t, mac), mac) != 0) ||
+        (record->magic != BOOT_CACHE_MAGIC) || (record->version != BOOT_CACHE_VERSION) ||
+        (memcmp(mac, record->mac, BOOT_CACHE_MAC_SIZE) != 0))
+    {
+        memset(record, 0, sizeof(*record));
+        record->magic = BOOT_CACHE_MAGIC;
+        record->version = BOOT_CACHE_VERSION;
+        record->full = 1U;
+    }
+    else if (record->full == 0U)
+    {
+        record->boots_since_full++;
+        if ((BOOT_CACHE_FULL_EVERY != 0U) && (record->boots_since_full >= BOOT_CACHE_FULL_EVERY))
+        {
+            record->full = 1U;
+        }
+    }
+    else
+    {
+        /* A full validation is still due, nothing to write */
+        return false;
+    }
+
+    boot_cache_seal(record);
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: boot_cache_find
+********************************************************************************
+* Summary:
+*  Returns the entry of a slot, NULL if there is none.
+*
+*******************************************************************************/
+static inline boot_cache_entry_t *boot_cache_find(boot_cache_record_t *record, uint32_t slot)
+{
+    for (uint32_t i = 0U; i < BOOT_CACHE_SLOTS; i++)
+    {
+        if (record->entries[i].slot == slot)
+        {
+            return &record->entries[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+* Function Name: boot_cache_digest
+********************************************************************************
+* Summary:
+*  Computes the digest of the image in a slot over the bytes that MCUboot
+*  hashes for its signature check: the header, the image, and the protected
+*  TLV area. A change to any of these bytes changes the digest.
+*
+* Parameters:
+*  image     : Start of the slot, mapped in memory
+*  slot_size : Size of the slot, nothing past it is read
+*  digest    : BOOT_CACHE_DIGEST_SIZE bytes of result
+*
+* Return:
+*  True if the slot holds an image and its digest was computed
+*
+*******************************************************************************/
+static inline bool boot_cache_digest(const uint8_t image[], uint32_t slot_size, uint8_t digest[])
+{
+    mcuboot_image_header_t header;
+    uint64_t size;
+
+    if ((slot_size < MCUBOOT_IMAGE_HEADER_SIZE) || (!mcuboot_image_parse_header(image, &header)))
+    {
+        return false;
+    }
+    size = (uint64_t)header.hdr_size + header.img_size + header.protect_tlv_size;
+
+    return (size <= slot_size) && (BOOT_CACHE_DIGEST(image, (size_t)size, digest) == 0);
+}
+
+/*******************************************************************************
+* Function Name: boot_cache_hit
+********************************************************************************
+* Summary:
+*  Checks whether a slot may skip the signature check: no full validation is
+*  due and the digest of the slot is the one recorded at its last full
+*  validation. The whole image is hashed, so an image that changed in any
+*  hashed byte is validated in full.
+*
+* Parameters:
+*  record    : The record, after boot_cache_begin()
+*  slot      : Slot address, the key of the entry
+*  image     : Start of the slot, mapped in memory
+*  slot_size : Size of the slot
+*
+* Return:
+*  True if the slot may skip the full validation
+*
+*******************************************************************************/
+static inline bool boot_cache_hit(boot_cache_record_t *record, uint32_t slot, const uint8_t image[],
+                                  uint32_t slot_size)
+{
+    const boot_cache_entry_t *entry = boot_cache_find(record, slot);
+    uint8_t digest[BOOT_CACHE_DIGEST_SIZE];
+
+    if ((record->full != 0U) || (entry == NULL) || (slot == 0U) ||
+        (!boot_cache_digest(image, slot_size, digest)))
+    {
+        return false;
+    }
+
+    return (memcmp(entry->digest, digest, BOOT_CACHE_DIGEST_SIZE) == 0);
+}
+
+/*******************************************************************************
+* Function Name: boot_cache_store
+********************************************************************************
+* Summary:
+*  Stores the result of the full validation of a slot. For a slot that passed,
+*  the digest of the slot is computed now and recorded, a slot that failed is
+*  removed. Call it in the boot that validated the slot, before the slot can
+*  be written by anything but the bootloader.
+*
+* Parameters:
+*  record    : The record, after boot_cache_begin()
+*  slot      : Slot address, the key of the entry
+*  image     : Start of the slot, mapped in memory
+*  slot_size : Size of the slot
+*  valid     : Result of the full validation
+*
+* Return:
+*  True if the record was changed and must be written back
+*
+*******************************************************************************/
+static inline bool boot_cache_store(boot_cache_record_t *record, uint32_t slot, const uint8_t image[],
+                                    uint32_t slot_size, bool valid)
+{
+    boot_cache_entry_t *entry = boot_cache_find(record, slot);
+    uint8_t digest[BOOT_CACHE_DIGEST_SIZE];
+
+    if ((!valid) || (slot == 0U) || (!boot_cache_digest(image, slot_size, digest)))
+    {
+        if (entry == NULL)
+        {
+            return false;
+        }
+        memset(entry, 0, sizeof(*entry));
+    }
+    else
+    {
+        entry = (entry != NULL) ? entry : boot_cache_find(record, 0U);
+        if (entry == NULL)
+        {
+            return false;
+        }
+        entry->slot = slot;
+        memcpy(entry->digest, digest, BOOT_CACHE_DIGEST_SIZE);
+    }
+    boot_cache_seal(record);
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: boot_cache_end
+********************************************************************************
+* Summary:
+*  Ends a boot in which every slot was validated, in full or from the cache.
+*  Restarts the count of boots after a full validation.
+*
+* Parameters:
+*  record : The record
+*
+* Return:
+*  True if the record was changed and must be written back
+*
+*******************************************************************************/
+static inline bool boot_cache_end(boot_cache_record_t *record)
+{
+    if (record->full == 0U)
+    {
+        return false;
+    }
+    record->full = 0U;
+    record->boots_since_full = 0U;
+    boot_cache_seal(record);
+
+    return true;
+}
+
+#if defined(BOOT_CACHE_HOOKS)
+/* shared/bootloader/boot_cache_hooks.c. The storage of the record is weak,
+ * override it for the device. */
+bool boot_cache_read(boot_cache_record_t *record);
+void boot_cache_write(const boot_cache_record_t *record);
+void boot_cache_boot_done(void);
+#endif /* defined(BOOT_CACHE_HOOKS) */
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* BOOT_CACHE_H */
+
+/* [] END OF FILE */
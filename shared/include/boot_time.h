@@ -0,0 +1,238 @@
+/*******************************************************************************
+* File Name        : boot_time.h
+*
+* Description      : Boot timeline shared by proj_cm33_s, proj_cm33_ns and the
+*                    host tools. Both images mark the end of their start up
+*                    phases with the DWT cycle counter, which starts at the
+*                    first line of the secure main(), in a record in shared
+*                    SRAM. Enabled with DEFINES+=BOOT_TIME in common.mk.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef BOOT_TIME_H
+#define BOOT_TIME_H
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <stdint.h>
+#if defined(BOOT_TIME)
+#include "cy_pdl.h"
+#include "cybsp.h"
+#endif /* defined(BOOT_TIME) */
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* All marks in time order. X(mark, name) is expanded once per mark. A mark
+ * is taken at the end of the phase it names, so the time of a phase is the
+ * time from the previous mark. SECURE_MAIN is the start of the timeline. */
+#define BOOT_TIME_MARKS(X)                                              \
+    X(SECURE_MAIN,          "Secure main()")                            \
+    X(SECURE_BSP,           "Secure cybsp_init()")                      \
+    X(SECURE_HANDOFF,       "Secure handoff to NonSecure_ResetHandler") \
+    X(NS_MAIN,              "Non-secure start up code")                 \
+    X(NS_BSP,               "cybsp_init()")                             \
+    X(NS_RETARGET_IO,       "init_retarget_io()")                       \
+    X(NS_DFU_INIT,          "Debug set up and Cy_DFU_Init()")           \
+    X(NS_READY,             "DFU transport start")                      \
+    X(NS_SERIAL_MEMORY,     "mtb_serial_memory_setup()")                \
+    X(NS_CM55,              "Main loop pass and Cy_SysEnableCM55()")    \
+    X(NS_BANNER,            "Main loop pass and banner")
+
+/* "BOOT" */
+#define BOOT_TIME_MAGIC             (0x544F4F42U)
+
+/* Custom DFU command that reads the boot timeline record.
+ * Request data: ignored (1 byte), offset into the record (2 bytes, little
+ * endian). Response data: number of marks (1 byte), size of the record
+ * (2 bytes, little endian), then up to BOOT_TIME_CHUNK_SIZE bytes starting at
+ * the requested offset. The record is boot_time_record_t, all little
+ * endian. */
+#define BOOT_TIME_CMD_GET           (0x53U)
+
+/* Largest number of record bytes in one response, as for the DFU_PERF
+ * statistics commands */
+#define BOOT_TIME_CHUNK_SIZE        (48U)
+
+/* Size of boot_time_record_t */
+#define BOOT_TIME_RECORD_SIZE       (16U + (8U * BOOT_TIME_MARK_COUNT))
+
+/* Address of the record: the CM33 shared SRAM region of design.modus, which
+ * neither start up code clears, so the record survives warm resets. Once
+ * cybsp_init() has made the region non-secure the secure image can only reach
+ * it through the non-secure alias, so both images use that alias. */
+#ifndef BOOT_TIME_RECORD_ADDR
+    #define BOOT_TIME_RECORD_ADDR   (CYMEM_CM33_0_m33_allocatable_shared_START)
+#endif /* BOOT_TIME_RECORD_ADDR */
+
+/* Address bit that selects the secure alias */
+#define BOOT_TIME_SECURE_ALIAS      (0x10000000UL)
+
+#define BOOT_TIME_RECORD            ((volatile boot_time_record_t *)((uint32_t)(BOOT_TIME_RECORD_ADDR) & \
+                                                                     ~BOOT_TIME_SECURE_ALIAS))
+
+#if defined(BOOT_TIME)
+    /* Marks the end of a start up phase */
+    #define BOOT_TIME_MARK(mark)    boot_time_mark(BOOT_TIME_##mark)
+    /* Secure image only: start of the timeline and handoff to the
+     * non-secure image */
+    #define BOOT_TIME_START()       boot_time_start()
+    #define BOOT_TIME_HANDOFF()     boot_time_handoff()
+#else
+    #define BOOT_TIME_MARK(mark)    ((void)0)
+    #define BOOT_TIME_START()       ((void)0)
+    #define BOOT_TIME_HANDOFF()     ((void)0)
+#endif /* defined(BOOT_TIME) */
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+#define BOOT_TIME_ENUM(mark, name)  BOOT_TIME_##mark,
+
+typedef enum
+{
+    BOOT_TIME_MARKS(BOOT_TIME_ENUM)
+    BOOT_TIME_MARK_COUNT
+} boot_time_mark_t;
+
+#undef BOOT_TIME_ENUM
+
+typedef struct
+{
+    uint32_t magic;                         /* BOOT_TIME_MAGIC once started */
+    uint32_t boot_count;                    /* Boots since the last cold boot */
+    uint32_t reset_reason;                  /* Cy_SysLib_GetResetReason() */
+    uint32_t marks;                         /* Bit n set once mark n is taken */
+    uint32_t cycles[BOOT_TIME_MARK_COUNT];  /* DWT cycle counter at each mark */
+    uint32_t clock_hz[BOOT_TIME_MARK_COUNT];/* SystemCoreClock at each mark */
+} boot_time_record_t;
+
+#if defined(BOOT_TIME)
+
+#if defined(__ARM_FEATURE_CMSE) && (__ARM_FEATURE_CMSE == 3U)
+/* The secure image marks into its own RAM and copies the marks to the shared
+ * record in boot_time_handoff(), when the non-secure alias is usable */
+static boot_time_record_t boot_time_secure_record;
+#define BOOT_TIME_MARK_RECORD       (&boot_time_secure_record)
+#else
+#define BOOT_TIME_MARK_RECORD       (BOOT_TIME_RECORD)
+#endif /* defined(__ARM_FEATURE_CMSE) && (__ARM_FEATURE_CMSE == 3U) */
+
+/*******************************************************************************
+* Function Name: boot_time_mark
+********************************************************************************
+* Summary:
+*  Stores the cycle counter and the CPU clock at a mark.
+*
+* Parameters:
+*  mark : The phase that ends here
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static inline void boot_time_mark(boot_time_mark_t mark)
+{
+    BOOT_TIME_MARK_RECORD->cycles[mark] = DWT->CYCCNT;
+    BOOT_TIME_MARK_RECORD->clock_hz[mark] = SystemCoreClock;
+    BOOT_TIME_MARK_RECORD->marks |= 1UL << mark;
+}
+
+#if defined(__ARM_FEATURE_CMSE) && (__ARM_FEATURE_CMSE == 3U)
+/*******************************************************************************
+* Function Name: boot_time_start
+********************************************************************************
+* Summary:
+*  Starts the DWT cycle counter from 0 and takes the SECURE_MAIN mark. Call it
+*  first thing in the secure main().
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static inline void boot_time_start(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0U;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    boot_time_secure_record.reset_reason = Cy_SysLib_GetResetReason();
+    boot_time_mark(BOOT_TIME_SECURE_MAIN);
+}
+
+/*******************************************************************************
+* Function Name: boot_time_handoff
+********************************************************************************
+* Summary:
+*  Takes the SECURE_HANDOFF mark and copies the secure marks to the shared
+*  record. The boot count carries over from the record of the previous boot.
+*  Call it right before the jump to the non-secure image.
+*
+* Parameters:
+*  void
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static inline void boot_time_handoff(void)
+{
+    volatile boot_time_record_t *record = BOOT_TIME_RECORD;
+
+    boot_time_mark(BOOT_TIME_SECURE_HANDOFF);
+
+    boot_time_secure_record.boot_count = (record->magic == BOOT_TIME_MAGIC) ? (record->boot_count + 1U) : 1U;
+    record->magic = 0U;
+    record->boot_count = boot_time_secure_record.boot_count;
+    record->reset_reason = boot_time_secure_record.reset_reason;
+    record->marks = boot_time_secure_record.marks;
+    for (uint32_t i = 0U; i < (uint32_t)BOOT_TIME_MARK_COUNT; i++)
+    {
+        record->cycles[i] = boot_time_secure_record.cycles[i];
+        record->clock_hz[i] = boot_time_secure_record.clock_hz[i];
+    }
+    record->magic = BOOT_TIME_MAGIC;
+}
+#else
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void boot_time_print(void);
+uint32_t boot_time_get(uint32_t offset, uint8_t data[], uint32_t size);
+#endif /* defined(__ARM_FEATURE_CMSE) && (__ARM_FEATURE_CMSE == 3U) */
+
+#endif /* defined(BOOT_TIME) */
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* BOOT_TIME_H */
+
+/* [] END OF FILE */
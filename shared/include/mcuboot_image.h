@@ -0,0 +1,221 @@
+/*******************************************************************************
+* File Name        : mcuboot_image.h
+*
+* Description      : Layout of an MCUboot image as the Edge Protect Bootloader
+*                    expects it in a slot: the image header, the image, and
+*                    the protected and unprotected TLV areas. Shared by the
+*                    images and the host tools, all values are little endian.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef MCUBOOT_IMAGE_H
+#define MCUBOOT_IMAGE_H
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define MCUBOOT_IMAGE_MAGIC             (0x96F3B83DUL)
+#define MCUBOOT_IMAGE_HEADER_SIZE       (32U)
+
+/* ih_flags */
+#define MCUBOOT_IMAGE_F_ENCRYPTED_AES128 (0x00000004UL)
+#define MCUBOOT_IMAGE_F_ENCRYPTED_AES256 (0x00000008UL)
+#define MCUBOOT_IMAGE_F_RAM_LOAD        (0x00000020UL)
+
+/* Start of the protected and of the unprotected TLV area */
+#define MCUBOOT_TLV_PROT_INFO_MAGIC     (0x6908U)
+#define MCUBOOT_TLV_INFO_MAGIC          (0x6907U)
+#define MCUBOOT_TLV_INFO_SIZE           (4U)
+#define MCUBOOT_TLV_ENTRY_SIZE          (4U)
+
+/* TLV types */
+#define MCUBOOT_TLV_KEYHASH             (0x01U)
+#define MCUBOOT_TLV_SHA256              (0x10U)
+#define MCUBOOT_TLV_SHA384              (0x11U)
+#define MCUBOOT_TLV_ECDSA_SIG           (0x22U)
+#define MCUBOOT_TLV_ENC_KW              (0x31U)
+#define MCUBOOT_TLV_DEPENDENCY          (0x40U)
+#define MCUBOOT_TLV_SEC_CNT             (0x50U)
+#define MCUBOOT_TLV_BOOT_RECORD         (0x60U)
+
+/* Byte offsets of the image header fields */
+#define MCUBOOT_HDR_MAGIC_IDX           (0U)
+#define MCUBOOT_HDR_LOAD_ADDR_IDX       (4U)
+#define MCUBOOT_HDR_HDR_SIZE_IDX        (8U)
+#define MCUBOOT_HDR_PROT_TLV_SIZE_IDX   (10U)
+#define MCUBOOT_HDR_IMG_SIZE_IDX        (12U)
+#define MCUBOOT_HDR_FLAGS_IDX           (16U)
+#define MCUBOOT_HDR_VER_MAJOR_IDX       (20U)
+#define MCUBOOT_HDR_VER_MINOR_IDX       (21U)
+#define MCUBOOT_HDR_VER_REVISION_IDX    (22U)
+#define MCUBOOT_HDR_VER_BUILD_IDX       (24U)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t magic;                         /* MCUBOOT_IMAGE_MAGIC */
+    uint32_t load_addr;
+    uint16_t hdr_size;                      /* Offset of the image in the slot */
+    uint16_t protect_tlv_size;              /* Size of the protected TLV area */
+    uint32_t img_size;                      /* Size of the image without header */
+    uint32_t flags;
+    uint8_t  ver_major;
+    uint8_t  ver_minor;
+    uint16_t ver_revision;
+    uint32_t ver_build;
+} mcuboot_image_header_t;
+
+/*******************************************************************************
+* Function Name: mcuboot_get_u16
+*******************************************************************************/
+static inline uint16_t mcuboot_get_u16(const uint8_t src[])
+{
+    return (uint16_t)((uint32_t)src[0] | ((uint32_t)src[1] << 8U));
+}
+
+/*******************************************************************************
+* Function Name: mcuboot_get_u32
+*******************************************************************************/
+static inline uint32_t mcuboot_get_u32(const uint8_t src[])
+{
+    return (uint32_t)mcuboot_get_u16(&src[0]) | ((uint32_t)mcuboot_get_u16(&src[2]) << 16U);
+}
+
+/*******************************************************************************
+* Function Name: mcuboot_image_parse_header
+********************************************************************************
+* Summary:
+*  Decodes the first MCUBOOT_IMAGE_HEADER_SIZE bytes of a slot.
+*
+* Parameters:
+*  data   : Start of the slot
+*  header : Decoded header
+*
+* Return:
+*  True if data starts with an image header
+*
+*******************************************************************************/
+static inline bool mcuboot_image_parse_header(const uint8_t data[], mcuboot_image_header_t *header)
+{
+    header->magic = mcuboot_get_u32(&data[MCUBOOT_HDR_MAGIC_IDX]);
+    header->load_addr = mcuboot_get_u32(&data[MCUBOOT_HDR_LOAD_ADDR_IDX]);
+    header->hdr_size = mcuboot_get_u16(&data[MCUBOOT_HDR_HDR_SIZE_IDX]);
+    header->protect_tlv_size = mcuboot_get_u16(&data[MCUBOOT_HDR_PROT_TLV_SIZE_IDX]);
+    header->img_size = mcuboot_get_u32(&data[MCUBOOT_HDR_IMG_SIZE_IDX]);
+    header->flags = mcuboot_get_u32(&data[MCUBOOT_HDR_FLAGS_IDX]);
+    header->ver_major = data[MCUBOOT_HDR_VER_MAJOR_IDX];
+    header->ver_minor = data[MCUBOOT_HDR_VER_MINOR_IDX];
+    header->ver_revision = mcuboot_get_u16(&data[MCUBOOT_HDR_VER_REVISION_IDX]);
+    header->ver_build = mcuboot_get_u32(&data[MCUBOOT_HDR_VER_BUILD_IDX]);
+
+    return (header->magic == MCUBOOT_IMAGE_MAGIC) && (header->hdr_size >= MCUBOOT_IMAGE_HEADER_SIZE);
+}
+
+/*******************************************************************************
+* Function Name: mcuboot_image_find_tlv
+********************************************************************************
+* Summary:
+*  Finds the first TLV of a type in the protected or the unprotected TLV area
+*  of an image that is mapped in memory, such as a slot in the external flash
+*  read through the XIP.
+*
+* Parameters:
+*  slot      : Start of the slot
+*  slot_size : Size of the slot, nothing past it is read
+*  type      : TLV type to find
+*  length    : Length of the TLV value if found
+*
+* Return:
+*  The TLV value, NULL if the slot holds no image or the image has no TLV of
+*  this type
+*
+*******************************************************************************/
+static inline const uint8_t *mcuboot_image_find_tlv(const uint8_t slot[], uint32_t slot_size, uint16_t type,
+                                                    uint16_t *length)
+{
+    mcuboot_image_header_t header;
+    uint32_t offset;
+    uint32_t end;
+
+    if ((slot_size < MCUBOOT_IMAGE_HEADER_SIZE) || (!mcuboot_image_parse_header(slot, &header)) ||
+        (((uint64_t)header.hdr_size + header.img_size + MCUBOOT_TLV_INFO_SIZE) > slot_size))
+    {
+        return NULL;
+    }
+
+    /* The protected area, if any, comes first, then the unprotected one.
+     * Each starts with an info of its magic and its size with the info. */
+    offset = (uint32_t)header.hdr_size + header.img_size;
+    for (uint32_t area = 0U; area < 2U; area++)
+    {
+        uint16_t magic = (area == 0U) ? MCUBOOT_TLV_PROT_INFO_MAGIC : MCUBOOT_TLV_INFO_MAGIC;
+
+        if (((offset + MCUBOOT_TLV_INFO_SIZE) > slot_size) || (mcuboot_get_u16(&slot[offset]) != magic))
+        {
+            if (area == 0U)
+            {
+                continue;
+            }
+            return NULL;
+        }
+        end = offset + mcuboot_get_u16(&slot[offset + 2U]);
+        end = (end < slot_size) ? end : slot_size;
+
+        for (offset += MCUBOOT_TLV_INFO_SIZE; (offset + MCUBOOT_TLV_ENTRY_SIZE) <= end;)
+        {
+            uint16_t entry_length = mcuboot_get_u16(&slot[offset + 2U]);
+
+            if ((offset + MCUBOOT_TLV_ENTRY_SIZE + entry_length) > end)
+            {
+                break;
+            }
+            if (mcuboot_get_u16(&slot[offset]) == type)
+            {
+                *length = entry_length;
+                return &slot[offset + MCUBOOT_TLV_ENTRY_SIZE];
+            }
+            offset += MCUBOOT_TLV_ENTRY_SIZE + entry_length;
+        }
+        offset = end;
+    }
+
+    return NULL;
+}
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* MCUBOOT_IMAGE_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,97 @@
+/*******************************************************************************
+* File Name        : secure_decrypt.h
+*
+* Description      : Decryption of encrypted update rows by proj_cm33_s,
+*                    called by proj_cm33_ns through non-secure callable
+*                    veneers, and the stream format shared with the host
+*                    tools. The rows of an image are encrypted with AES-128 in
+*                    CTR mode under a transport key that only the secure image
+*                    holds, wrapped with a key encryption key. Enabled with
+*                    DEFINES+=SECURE_DECRYPT in common.mk.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef SECURE_DECRYPT_H
+#define SECURE_DECRYPT_H
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "secure_verify.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Custom DFU command that starts the encrypted stream of an image. Send it
+ * after Enter DFU and before the first row of the image.
+ * Request data: image ID (1 byte), nonce (SECURE_DECRYPT_NONCE_SIZE bytes).
+ * Response data: none. The rows of the image are then decrypted before they
+ * are written. The rows of an image without this command are written as
+ * received, for example an image that imgtool encrypted for the bootloader. */
+#define SECURE_DECRYPT_CMD_START        (0x54U)
+
+#define SECURE_DECRYPT_KEY_SIZE         (16U)       /* AES-128 */
+#define SECURE_DECRYPT_WRAPPED_KEY_SIZE (24U)       /* AES key wrap, RFC 3394 */
+#define SECURE_DECRYPT_NONCE_SIZE       (8U)
+#define SECURE_DECRYPT_BLOCK_SIZE       (16U)
+
+/* Counter block of the 16 bytes at offset o of the update slot of image i:
+ * the nonce, then i and o / 16 as 32-bit big endian values. A new nonce for
+ * every encrypted image keeps the key stream from repeating. */
+#define SECURE_DECRYPT_CTR_IMAGE_IDX    (8U)
+#define SECURE_DECRYPT_CTR_BLOCK_IDX    (12U)
+
+/* Result of the service calls, as secure_verify.h */
+#define SECURE_DECRYPT_STATUS_OK        (SECURE_VERIFY_STATUS_OK)
+#define SECURE_DECRYPT_STATUS_STATE     (SECURE_VERIFY_STATUS_STATE)       /* Image not started */
+#define SECURE_DECRYPT_STATUS_IMAGE_ID  (SECURE_VERIFY_STATUS_IMAGE_ID)
+#define SECURE_DECRYPT_STATUS_CRYPTO    (SECURE_VERIFY_STATUS_CRYPTO)
+#define SECURE_DECRYPT_STATUS_KEY       (SECURE_VERIFY_STATUS_KEY)         /* Wrapped key does not unwrap */
+#define SECURE_DECRYPT_STATUS_BUFFER    (0x17U)     /* Row not in non-secure memory or not aligned */
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+
+/* Same rules as secure_verify.h: not reentrant, call from one context */
+SECURE_VERIFY_ENTRY uint32_t secure_decrypt_start(uint32_t image_id, uint32_t nonce_low, uint32_t nonce_high);
+SECURE_VERIFY_ENTRY uint32_t secure_decrypt_row(uint32_t image_id, uint32_t offset, uint8_t row[],
+                                                uint32_t length);
+
+#if defined(__ARM_FEATURE_CMSE) && (__ARM_FEATURE_CMSE == 3U)
+/* Secure image only: key encryption key of the transport key. The weak
+ * default fails, override it to read the secure key store. */
+bool secure_decrypt_kek(uint8_t kek[]);
+#endif /* defined(__ARM_FEATURE_CMSE) && (__ARM_FEATURE_CMSE == 3U) */
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* SECURE_DECRYPT_H */
+
+/* [] END OF FILE */
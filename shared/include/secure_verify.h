@@ -0,0 +1,95 @@
+/*******************************************************************************
+* File Name        : secure_verify.h
+*
+* Description      : Image verification service of proj_cm33_s, called by
+*                    proj_cm33_ns through non-secure callable veneers. The
+*                    secure image hashes an update slot in steps, compares the
+*                    hash with the image hash TLV and checks the signature with
+*                    the public key of the bootloader, which stays in the
+*                    secure image. Enabled with DEFINES+=SECURE_VERIFY in
+*                    common.mk.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef SECURE_VERIFY_H
+#define SECURE_VERIFY_H
+
+/*******************************************************************************
+* Header Files
+*******************************************************************************/
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Result of the service calls */
+#define SECURE_VERIFY_STATUS_OK             (0x00U)     /* Image is valid */
+#define SECURE_VERIFY_STATUS_IN_PROGRESS    (0x01U)     /* More of the slot to hash */
+#define SECURE_VERIFY_STATUS_HASHED         (0x02U)     /* Slot hashed, call secure_verify_finish() */
+#define SECURE_VERIFY_STATUS_STATE          (0x10U)     /* Call out of order */
+#define SECURE_VERIFY_STATUS_IMAGE_ID       (0x11U)     /* No update slot for the image ID */
+#define SECURE_VERIFY_STATUS_HEADER         (0x12U)     /* No image, or it does not fit in the slot */
+#define SECURE_VERIFY_STATUS_HASH           (0x13U)     /* Image hash TLV missing or different */
+#define SECURE_VERIFY_STATUS_KEY            (0x14U)     /* Signed with another key */
+#define SECURE_VERIFY_STATUS_SIGNATURE      (0x15U)     /* Signature TLV missing or wrong */
+#define SECURE_VERIFY_STATUS_CRYPTO         (0x16U)     /* Crypto library error */
+
+/* Most bytes of the slot hashed by one secure_verify_update() call, so that
+ * the non-secure image gets the CPU back in bounded time */
+#ifndef SECURE_VERIFY_MAX_STEP
+    #define SECURE_VERIFY_MAX_STEP          (0x4000U)
+#endif /* SECURE_VERIFY_MAX_STEP */
+
+/* Entry points of the secure image */
+#if defined(__ARM_FEATURE_CMSE) && (__ARM_FEATURE_CMSE == 3U)
+    #define SECURE_VERIFY_ENTRY             __attribute__((cmse_nonsecure_entry))
+#else
+    #define SECURE_VERIFY_ENTRY
+#endif /* defined(__ARM_FEATURE_CMSE) && (__ARM_FEATURE_CMSE == 3U) */
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+
+/* The calls are not reentrant. Call them from one context of the non-secure
+ * image only, for example its main loop. No pointers cross the boundary, the
+ * secure image reads the slot itself. */
+SECURE_VERIFY_ENTRY uint32_t secure_verify_begin(uint32_t image_id);
+SECURE_VERIFY_ENTRY uint32_t secure_verify_update(uint32_t max_bytes);
+SECURE_VERIFY_ENTRY uint32_t secure_verify_finish(void);
+
+#if defined(__ARM_FEATURE_CMSE) && (__ARM_FEATURE_CMSE == 3U)
+/* Secure image only: hashes the rows of an update slot as they are written.
+ * secure_verify_finish() checks that the slot read back has the same hash. */
+void secure_verify_feed(uint32_t image_id, uint32_t offset, const uint8_t data[], uint32_t length);
+#endif /* defined(__ARM_FEATURE_CMSE) && (__ARM_FEATURE_CMSE == 3U) */
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* SECURE_VERIFY_H */
+
+/* [] END OF FILE */
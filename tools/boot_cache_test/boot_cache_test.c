@@ -0,0 +1,275 @@
+/*******************************************************************************
+* File Name        : boot_cache_test.c
+*
+* Description      : Host test of the validated-image cache
+*                    (shared/include/boot_cache.h). Boots an image in a
+*                    simulated slot several times against a record kept in
+*                    simulated storage, and checks that the cache only skips
+*                    the validation of a slot whose hashed bytes did not
+*                    change: a changed image body, header, or record is
+*                    validated in full. Run it with "make -C tools test".
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "dfu_sha256.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Device key of the test, the bootloader port reads it from its key store */
+static uint8_t test_key[32] = "boot_cache_test device key 0001";
+
+#define BOOT_CACHE_MAC(data, size, mac)         dfu_hmac_sha256(test_key, sizeof(test_key), (data), (size), (mac))
+#define BOOT_CACHE_DIGEST(data, size, digest)   dfu_sha256((data), (size), (digest))
+#define BOOT_CACHE_FULL_EVERY                   (4U)
+
+#include "boot_cache.h"
+
+#define TEST_SLOT                   (0x60100000UL)
+#define TEST_SLOT_SIZE              (0x2000U)
+#define TEST_HDR_SIZE               (0x400U)
+#define TEST_IMG_SIZE               (0x1000U)
+#define TEST_PROT_TLV_SIZE          (0x10U)
+
+#define CHECK(condition)            check((condition), #condition, __LINE__)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static uint8_t slot[TEST_SLOT_SIZE];
+
+/* The record as kept in the storage of the bootloader between boots */
+static boot_cache_record_t storage;
+
+static unsigned int checks = 0U;
+static unsigned int failures = 0U;
+
+/*******************************************************************************
+* Function Name: check
+*******************************************************************************/
+static void check(bool condition, const char *text, int line)
+{
+    checks++;
+    if (!condition)
+    {
+        failures++;
+        fprintf(stderr, "boot_cache_test.c:%d: check failed: %s\n", line, text);
+    }
+}
+
+/*******************************************************************************
+* Function Name: put_u16
+*******************************************************************************/
+static void put_u16(uint8_t dst[], uint32_t value)
+{
+    dst[0] = (uint8_t)value;
+    dst[1] = (uint8_t)(value >> 8U);
+}
+
+/*******************************************************************************
+* Function Name: put_u32
+*******************************************************************************/
+static void put_u32(uint8_t dst[], uint32_t value)
+{
+    put_u16(&dst[0], value);
+    put_u16(&dst[2], value >> 16U);
+}
+
+/*******************************************************************************
+* Function Name: make_image
+********************************************************************************
+* Summary:
+*  Writes an image to the slot: header, body, a protected TLV area with a
+*  security counter, and an unprotected TLV area that stands in for the hash
+*  and the signature.
+*
+*******************************************************************************/
+static void make_image(void)
+{
+    uint32_t offset = TEST_HDR_SIZE + TEST_IMG_SIZE;
+
+    memset(slot, 0xFF, sizeof(slot));
+    memset(slot, 0, TEST_HDR_SIZE);
+    put_u32(&slot[MCUBOOT_HDR_MAGIC_IDX], MCUBOOT_IMAGE_MAGIC);
+    put_u16(&slot[MCUBOOT_HDR_HDR_SIZE_IDX], TEST_HDR_SIZE);
+    put_u16(&slot[MCUBOOT_HDR_PROT_TLV_SIZE_IDX], TEST_PROT_TLV_SIZE);
+    put_u32(&slot[MCUBOOT_HDR_IMG_SIZE_IDX], TEST_IMG_SIZE);
+    slot[MCUBOOT_HDR_VER_MAJOR_IDX] = 1U;
+
+    for (uint32_t i = 0U; i < TEST_IMG_SIZE; i++)
+    {
+        slot[TEST_HDR_SIZE + i] = (uint8_t)((i * 7U) + (i >> 8U));
+    }
+
+    put_u16(&slot[offset], MCUBOOT_TLV_PROT_INFO_MAGIC);
+    put_u16(&slot[offset + 2U], TEST_PROT_TLV_SIZE);
+    put_u16(&slot[offset + 4U], MCUBOOT_TLV_SEC_CNT);
+    put_u16(&slot[offset + 6U], 8U);
+    put_u32(&slot[offset + 8U], 1U);
+    offset += TEST_PROT_TLV_SIZE;
+
+    put_u16(&slot[offset], MCUBOOT_TLV_INFO_MAGIC);
+    put_u16(&slot[offset + 2U], MCUBOOT_TLV_INFO_SIZE + MCUBOOT_TLV_ENTRY_SIZE + BOOT_CACHE_DIGEST_SIZE);
+    put_u16(&slot[offset + 4U], MCUBOOT_TLV_SHA256);
+    put_u16(&slot[offset + 6U], BOOT_CACHE_DIGEST_SIZE);
+    (void)dfu_sha256(slot, TEST_HDR_SIZE + TEST_IMG_SIZE + TEST_PROT_TLV_SIZE, &slot[offset + 8U]);
+}
+
+/*******************************************************************************
+* Function Name: boot
+********************************************************************************
+* Summary:
+*  One boot of the bootloader with the cache, as boot_cache_hooks.c runs it.
+*  The full validation is stood in for by valid.
+*
+* Return:
+*  True if the slot skipped the full validation
+*
+*******************************************************************************/
+static bool boot(bool valid)
+{
+    boot_cache_record_t record = storage;
+    bool hit;
+
+    if (boot_cache_begin(&record))
+    {
+        storage = record;
+    }
+    hit = boot_cache_hit(&record, TEST_SLOT, slot, TEST_SLOT_SIZE);
+    if ((!hit) && boot_cache_store(&record, TEST_SLOT, slot, TEST_SLOT_SIZE, valid))
+    {
+        storage = record;
+    }
+    if ((hit || valid) && boot_cache_end(&record))
+    {
+        storage = record;
+    }
+
+    return hit;
+}
+
+/*******************************************************************************
+* Function Name: test_sha256
+********************************************************************************
+* Summary:
+*  Known answers of FIPS 180-4 and RFC 4231 test case 2.
+*
+*******************************************************************************/
+static void test_sha256(void)
+{
+    static const uint8_t abc[DFU_SHA256_SIZE] =
+    {
+        0xBAU, 0x78U, 0x16U, 0xBFU, 0x8FU, 0x01U, 0xCFU, 0xEAU, 0x41U, 0x41U, 0x40U, 0xDEU, 0x5DU, 0xAEU, 0x22U, 0x23U,
+        0xB0U, 0x03U, 0x61U, 0xA3U, 0x96U, 0x17U, 0x7AU, 0x9CU, 0xB4U, 0x10U, 0xFFU, 0x61U, 0xF2U, 0x00U, 0x15U, 0xADU
+    };
+    static const uint8_t hmac[DFU_SHA256_SIZE] =
+    {
+        0x5BU, 0xDCU, 0xC1U, 0x46U, 0xBFU, 0x60U, 0x75U, 0x4EU, 0x6AU, 0x04U, 0x24U, 0x26U, 0x08U, 0x95U, 0x75U, 0xC7U,
+        0x5AU, 0x00U, 0x3FU, 0x08U, 0x9DU, 0x27U, 0x39U, 0x83U, 0x9DU, 0xECU, 0x58U, 0xB9U, 0x64U, 0xECU, 0x38U, 0x43U
+    };
+    const char *data = "what do ya want for nothing?";
+    uint8_t digest[DFU_SHA256_SIZE];
+
+    (void)dfu_sha256((const uint8_t *)"abc", 3U, digest);
+    CHECK(memcmp(digest, abc, sizeof(abc)) == 0);
+    (void)dfu_hmac_sha256((const uint8_t *)"Jefe", 4U, (const uint8_t *)data, strlen(data), digest);
+    CHECK(memcmp(digest, hmac, sizeof(hmac)) == 0);
+}
+
+/*******************************************************************************
+* Function Name: test_cache
+*******************************************************************************/
+static void test_cache(void)
+{
+    uint8_t saved;
+
+    make_image();
+    memset(&storage, 0, sizeof(storage));
+
+    /* No record yet: validated in full and recorded */
+    CHECK(!boot(true));
+    CHECK(boot(true));
+
+    /* A changed byte of the body is validated in full, even with the header
+     * and the hash TLV unchanged */
+    saved = slot[TEST_HDR_SIZE + 0x123U];
+    slot[TEST_HDR_SIZE + 0x123U] ^= 0x01U;
+    CHECK(!boot(false));
+    CHECK(!boot(false));
+    slot[TEST_HDR_SIZE + 0x123U] = saved;
+
+    /* The failed validation removed the entry */
+    CHECK(!boot(true));
+    CHECK(boot(true));
+
+    /* A changed header or protected TLV is validated in full */
+    slot[MCUBOOT_HDR_VER_MINOR_IDX] = 1U;
+    CHECK(!boot(false));
+    slot[MCUBOOT_HDR_VER_MINOR_IDX] = 0U;
+    CHECK(!boot(true));
+    slot[TEST_HDR_SIZE + TEST_IMG_SIZE + 8U] = 2U;
+    CHECK(!boot(false));
+    slot[TEST_HDR_SIZE + TEST_IMG_SIZE + 8U] = 1U;
+    CHECK(!boot(true));
+
+    /* The unprotected TLV area is not part of the signed bytes */
+    slot[TEST_HDR_SIZE + TEST_IMG_SIZE + TEST_PROT_TLV_SIZE + 8U] ^= 0x01U;
+    CHECK(boot(true));
+    slot[TEST_HDR_SIZE + TEST_IMG_SIZE + TEST_PROT_TLV_SIZE + 8U] ^= 0x01U;
+
+    /* A record forged to match a changed body fails its MAC and is cleared */
+    slot[TEST_HDR_SIZE] ^= 0x01U;
+    (void)boot_cache_digest(slot, TEST_SLOT_SIZE, storage.entries[0].digest);
+    CHECK(!boot(false));
+    slot[TEST_HDR_SIZE] ^= 0x01U;
+    CHECK(!boot(true));
+
+    /* A record sealed with another key is cleared */
+    test_key[0] ^= 0x01U;
+    CHECK(!boot(true));
+
+    /* Policy: a full validation every BOOT_CACHE_FULL_EVERY boots */
+    for (uint32_t i = 1U; i < BOOT_CACHE_FULL_EVERY; i++)
+    {
+        CHECK(boot(true));
+    }
+    CHECK(!boot(true));
+    CHECK(boot(true));
+}
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(void)
+{
+    test_sha256();
+    test_cache();
+
+    printf("boot_cache_test: %u checks, %u failed\n", checks, failures);
+
+    return (failures == 0U) ? 0 : 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,251 @@
+/*******************************************************************************
+* File Name        : dfu_aes.c
+*
+* Description      : AES-128 encryption for the host tools, see dfu_aes.h.
+*                    Only the forward cipher is needed: CTR mode decrypts with
+*                    it, and the tools only wrap keys. Not hardened against
+*                    timing attacks, the device side uses mbedtls.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "dfu_aes.h"
+#include "secure_decrypt.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define AES_ROUNDS                  (10U)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static const uint8_t aes_sbox[256] =
+{
+    0x63U, 0x7CU, 0x77U, 0x7BU, 0xF2U, 0x6BU, 0x6FU, 0xC5U, 0x30U, 0x01U, 0x67U, 0x2BU, 0xFEU, 0xD7U, 0xABU, 0x76U,
+    0xCAU, 0x82U, 0xC9U, 0x7DU, 0xFAU, 0x59U, 0x47U, 0xF0U, 0xADU, 0xD4U, 0xA2U, 0xAFU, 0x9CU, 0xA4U, 0x72U, 0xC0U,
+    0xB7U, 0xFDU, 0x93U, 0x26U, 0x36U, 0x3FU, 0xF7U, 0xCCU, 0x34U, 0xA5U, 0xE5U, 0xF1U, 0x71U, 0xD8U, 0x31U, 0x15U,
+    0x04U, 0xC7U, 0x23U, 0xC3U, 0x18U, 0x96U, 0x05U, 0x9AU, 0x07U, 0x12U, 0x80U, 0xE2U, 0xEBU, 0x27U, 0xB2U, 0x75U,
+    0x09U, 0x83U, 0x2CU, 0x1AU, 0x1BU, 0x6EU, 0x5AU, 0xA0U, 0x52U, 0x3BU, 0xD6U, 0xB3U, 0x29U, 0xE3U, 0x2FU, 0x84U,
+    0x53U, 0xD1U, 0x00U, 0xEDU, 0x20U, 0xFCU, 0xB1U, 0x5BU, 0x6AU, 0xCBU, 0xBEU, 0x39U, 0x4AU, 0x4CU, 0x58U, 0xCFU,
+    0xD0U, 0xEFU, 0xAAU, 0xFBU, 0x43U, 0x4DU, 0x33U, 0x85U, 0x45U, 0xF9U, 0x02U, 0x7FU, 0x50U, 0x3CU, 0x9FU, 0xA8U,
+    0x51U, 0xA3U, 0x40U, 0x8FU, 0x92U, 0x9DU, 0x38U, 0xF5U, 0xBCU, 0xB6U, 0xDAU, 0x21U, 0x10U, 0xFFU, 0xF3U, 0xD2U,
+    0xCDU, 0x0CU, 0x13U, 0xECU, 0x5FU, 0x97U, 0x44U, 0x17U, 0xC4U, 0xA7U, 0x7EU, 0x3DU, 0x64U, 0x5DU, 0x19U, 0x73U,
+    0x60U, 0x81U, 0x4FU, 0xDCU, 0x22U, 0x2AU, 0x90U, 0x88U, 0x46U, 0xEEU, 0xB8U, 0x14U, 0xDEU, 0x5EU, 0x0BU, 0xDBU,
+    0xE0U, 0x32U, 0x3AU, 0x0AU, 0x49U, 0x06U, 0x24U, 0x5CU, 0xC2U, 0xD3U, 0xACU, 0x62U, 0x91U, 0x95U, 0xE4U, 0x79U,
+    0xE7U, 0xC8U, 0x37U, 0x6DU, 0x8DU, 0xD5U, 0x4EU, 0xA9U, 0x6CU, 0x56U, 0xF4U, 0xEAU, 0x65U, 0x7AU, 0xAEU, 0x08U,
+    0xBAU, 0x78U, 0x25U, 0x2EU, 0x1CU, 0xA6U, 0xB4U, 0xC6U, 0xE8U, 0xDDU, 0x74U, 0x1FU, 0x4BU, 0xBDU, 0x8BU, 0x8AU,
+    0x70U, 0x3EU, 0xB5U, 0x66U, 0x48U, 0x03U, 0xF6U, 0x0EU, 0x61U, 0x35U, 0x57U, 0xB9U, 0x86U, 0xC1U, 0x1DU, 0x9EU,
+    0xE1U, 0xF8U, 0x98U, 0x11U, 0x69U, 0xD9U, 0x8EU, 0x94U, 0x9BU, 0x1EU, 0x87U, 0xE9U, 0xCEU, 0x55U, 0x28U, 0xDFU,
+    0x8CU, 0xA1U, 0x89U, 0x0DU, 0xBFU, 0xE6U, 0x42U, 0x68U, 0x41U, 0x99U, 0x2DU, 0x0FU, 0xB0U, 0x54U, 0xBBU, 0x16U
+};
+
+/*******************************************************************************
+* Function Name: aes_xtime
+*******************************************************************************/
+static uint8_t aes_xtime(uint8_t value)
+{
+    return (uint8_t)((value << 1U) ^ (((value & 0x80U) != 0U) ? 0x1BU : 0x00U));
+}
+
+/*******************************************************************************
+* Function Name: dfu_aes_init
+********************************************************************************
+* Summary:
+*  Expands an AES-128 key.
+*
+*******************************************************************************/
+void dfu_aes_init(dfu_aes_t *aes, const uint8_t key[])
+{
+    uint8_t *w = aes->round_keys;
+    uint8_t rcon = 0x01U;
+
+    memcpy(w, key, DFU_AES_KEY_SIZE);
+    for (uint32_t i = DFU_AES_KEY_SIZE; i < DFU_AES_ROUND_KEYS_SIZE; i += 4U)
+    {
+        uint8_t t[4] = { w[i - 4U], w[i - 3U], w[i - 2U], w[i - 1U] };
+
+        if ((i % DFU_AES_KEY_SIZE) == 0U)
+        {
+            uint8_t first = t[0];
+
+            t[0] = (uint8_t)(aes_sbox[t[1]] ^ rcon);
+            t[1] = aes_sbox[t[2]];
+            t[2] = aes_sbox[t[3]];
+            t[3] = aes_sbox[first];
+            rcon = aes_xtime(rcon);
+        }
+        for (uint32_t j = 0U; j < 4U; j++)
+        {
+            w[i + j] = (uint8_t)(w[(i + j) - DFU_AES_KEY_SIZE] ^ t[j]);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: dfu_aes_encrypt
+********************************************************************************
+* Summary:
+*  Encrypts one block. in and out may be the same.
+*
+*******************************************************************************/
+void dfu_aes_encrypt(const dfu_aes_t *aes, const uint8_t in[], uint8_t out[])
+{
+    uint8_t s[DFU_AES_BLOCK_SIZE];
+
+    for (uint32_t i = 0U; i < DFU_AES_BLOCK_SIZE; i++)
+    {
+        s[i] = (uint8_t)(in[i] ^ aes->round_keys[i]);
+    }
+
+    for (uint32_t round = 1U; round <= AES_ROUNDS; round++)
+    {
+        uint8_t t[DFU_AES_BLOCK_SIZE];
+
+        /* SubBytes and ShiftRows, the state is in column order */
+        for (uint32_t c = 0U; c < 4U; c++)
+        {
+            for (uint32_t r = 0U; r < 4U; r++)
+            {
+                t[(4U * c) + r] = aes_sbox[s[(4U * ((c + r) % 4U)) + r]];
+            }
+        }
+        /* MixColumns, except in the last round */
+        if (round != AES_ROUNDS)
+        {
+            for (uint32_t c = 0U; c < 4U; c++)
+            {
+                uint8_t *col = &t[4U * c];
+                uint8_t all = (uint8_t)(col[0] ^ col[1] ^ col[2] ^ col[3]);
+                uint8_t first = col[0];
+
+                col[0] = (uint8_t)(col[0] ^ all ^ aes_xtime((uint8_t)(col[0] ^ col[1])));
+                col[1] = (uint8_t)(col[1] ^ all ^ aes_xtime((uint8_t)(col[1] ^ col[2])));
+                col[2] = (uint8_t)(col[2] ^ all ^ aes_xtime((uint8_t)(col[2] ^ col[3])));
+                col[3] = (uint8_t)(col[3] ^ all ^ aes_xtime((uint8_t)(col[3] ^ first)));
+            }
+        }
+        for (uint32_t i = 0U; i < DFU_AES_BLOCK_SIZE; i++)
+        {
+            s[i] = (uint8_t)(t[i] ^ aes->round_keys[(DFU_AES_BLOCK_SIZE * round) + i]);
+        }
+    }
+
+    memcpy(out, s, DFU_AES_BLOCK_SIZE);
+}
+
+/*******************************************************************************
+* Function Name: dfu_aes_ctr
+********************************************************************************
+* Summary:
+*  XORs data with the key stream of the update slot of image_id from offset,
+*  which encrypts and decrypts alike.
+*
+*******************************************************************************/
+void dfu_aes_ctr(const dfu_aes_t *aes, const uint8_t nonce[], uint32_t image_id, uint32_t offset,
+                 uint8_t data[], size_t length)
+{
+    uint8_t counter[DFU_AES_BLOCK_SIZE];
+    uint8_t stream[DFU_AES_BLOCK_SIZE];
+    uint32_t block = offset / DFU_AES_BLOCK_SIZE;
+
+    memcpy(counter, nonce, SECURE_DECRYPT_NONCE_SIZE);
+    for (size_t done = 0U; done < length; done += DFU_AES_BLOCK_SIZE)
+    {
+        for (uint32_t i = 0U; i < 4U; i++)
+        {
+            counter[SECURE_DECRYPT_CTR_IMAGE_IDX + i] = (uint8_t)(image_id >> (24U - (8U * i)));
+            counter[SECURE_DECRYPT_CTR_BLOCK_IDX + i] = (uint8_t)(block >> (24U - (8U * i)));
+        }
+        dfu_aes_encrypt(aes, counter, stream);
+        for (size_t i = 0U; (i < DFU_AES_BLOCK_SIZE) && ((done + i) < length); i++)
+        {
+            data[done + i] ^= stream[i];
+        }
+        block++;
+    }
+}
+
+/*******************************************************************************
+* Function Name: dfu_aes_parse
+********************************************************************************
+* Return:
+*  0 on success, -1 if text is not 2 * length hex digits
+*
+*******************************************************************************/
+int dfu_aes_parse(const char *text, uint8_t data[], size_t length)
+{
+    unsigned int value;
+
+    if (strlen(text) != (2U * length))
+    {
+        return -1;
+    }
+    for (size_t i = 0U; i < length; i++)
+    {
+        if ((strchr("0123456789abcdefABCDEF", text[2U * i]) == NULL) ||
+            (strchr("0123456789abcdefABCDEF", text[(2U * i) + 1U]) == NULL) ||
+            (sscanf(&text[2U * i], "%2x", &value) != 1))
+        {
+            return -1;
+        }
+        data[i] = (uint8_t)value;
+    }
+
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: dfu_aes_wrap
+********************************************************************************
+* Summary:
+*  Wraps key with kek, RFC 3394 with the default initial value.
+*
+*******************************************************************************/
+void dfu_aes_wrap(const uint8_t kek[], const uint8_t key[], uint8_t wrapped[])
+{
+    dfu_aes_t aes;
+    uint8_t b[DFU_AES_BLOCK_SIZE];
+    uint8_t *r = &wrapped[8];
+    const uint32_t n = DFU_AES_KEY_SIZE / 8U;
+
+    dfu_aes_init(&aes, kek);
+    memset(wrapped, 0xA6, 8U);
+    memcpy(r, key, DFU_AES_KEY_SIZE);
+
+    for (uint32_t j = 0U; j < 6U; j++)
+    {
+        for (uint32_t i = 0U; i < n; i++)
+        {
+            uint32_t t = (n * j) + i + 1U;
+
+            memcpy(b, wrapped, 8U);
+            memcpy(&b[8], &r[8U * i], 8U);
+            dfu_aes_encrypt(&aes, b, b);
+            memcpy(wrapped, b, 8U);
+            wrapped[7] ^= (uint8_t)t;
+            memcpy(&r[8U * i], &b[8], 8U);
+        }
+    }
+    memset(&aes, 0, sizeof(aes));
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,67 @@
+/*******************************************************************************
+* File Name        : dfu_aes.h
+*
+* Description      : AES-128 for the host tools: the CTR key stream of
+*                    encrypted updates (shared/include/secure_decrypt.h) and
+*                    the AES key wrap of the transport key.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef DFU_AES_H
+#define DFU_AES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define DFU_AES_KEY_SIZE            (16U)
+#define DFU_AES_BLOCK_SIZE          (16U)
+#define DFU_AES_ROUND_KEYS_SIZE     (176U)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    uint8_t round_keys[DFU_AES_ROUND_KEYS_SIZE];
+} dfu_aes_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void dfu_aes_init(dfu_aes_t *aes, const uint8_t key[]);
+void dfu_aes_encrypt(const dfu_aes_t *aes, const uint8_t in[], uint8_t out[]);
+
+/* Encrypts or decrypts data at offset of the update slot of image_id, see
+ * secure_decrypt.h. offset is a multiple of DFU_AES_BLOCK_SIZE. */
+void dfu_aes_ctr(const dfu_aes_t *aes, const uint8_t nonce[], uint32_t image_id, uint32_t offset,
+                 uint8_t data[], size_t length);
+
+/* Parses a key or nonce of length bytes given as 2 * length hex digits */
+int dfu_aes_parse(const char *text, uint8_t data[], size_t length);
+
+/* RFC 3394 key wrap of a DFU_AES_KEY_SIZE key into DFU_AES_KEY_SIZE + 8 bytes */
+void dfu_aes_wrap(const uint8_t kek[], const uint8_t key[], uint8_t wrapped[]);
+
+#endif /* DFU_AES_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,1571 @@
+/*******************************************************************************
+* File Name        : dfu_host.c
+*
+* Description      : Host side of the DFU protocol used by the host tools. It
+*                    runs a .mtbdfu command script the same way as the DFU
+*                    Host tool: Enter DFU, the command set of each entry for
+*                    every row of the data file, then Exit DFU.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#include <ctype.h>
+#include <fcntl.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "dfu_container.h"
+#include "dfu_host.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Intel HEX record types */
+#define HEX_DATA                (0x00U)
+#define HEX_EOF                 (0x01U)
+#define HEX_EXT_SEGMENT         (0x02U)
+#define HEX_EXT_LINEAR          (0x04U)
+
+#define HEX_MAX_LINE            (600U)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+
+/* Node of the parsed JSON document */
+typedef enum
+{
+    JSON_OBJECT,
+    JSON_ARRAY,
+    JSON_VALUE      /* String, number or literal, kept as text */
+} json_type_t;
+
+typedef struct json_node
+{
+    json_type_t type;
+    char *key;
+    char *text;
+    struct json_node *child;
+    struct json_node *next;
+} json_node_t;
+
+typedef struct
+{
+    const char *pos;
+    bool error;
+} json_parser_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static json_node_t *json_parse_value(json_parser_t *parser);
+
+/*******************************************************************************
+* Function Name: dfu_packet_checksum_host
+********************************************************************************
+* Summary:
+*  Computes the DFU packet checksum, see dfu_packet_checksum() on the device.
+*
+*******************************************************************************/
+uint16_t dfu_packet_checksum_host(bool crc, const uint8_t buffer[], size_t length)
+{
+    uint16_t sum = 0U;
+
+    if (crc)
+    {
+        uint16_t value = 0xFFFFU;
+        for (size_t i = 0U; i < length; i++)
+        {
+            uint16_t data = buffer[i];
+            for (uint32_t bit = 0U; bit < 8U; bit++)
+            {
+                value = (((value ^ data) & 1U) != 0U) ? (uint16_t)((value >> 1U) ^ 0x8408U) :
+                                                        (uint16_t)(value >> 1U);
+                data >>= 1U;
+            }
+        }
+        value = (uint16_t)~value;
+        sum = (uint16_t)((uint16_t)(value << 8U) | (value >> 8U));
+    }
+    else
+    {
+        for (size_t i = 0U; i < length; i++)
+        {
+            sum = (uint16_t)(sum + buffer[i]);
+        }
+        sum = (uint16_t)(1U + (uint16_t)~sum);
+    }
+
+    return sum;
+}
+
+/*******************************************************************************
+* Function Name: dfu_crc32c
+********************************************************************************
+* Summary:
+*  CRC-32C (Castagnoli) of a row, as carried by Program Data and Verify Data.
+*
+*******************************************************************************/
+uint32_t dfu_crc32c(const uint8_t data[], size_t length)
+{
+    uint32_t crc = 0xFFFFFFFFU;
+
+    for (size_t i = 0U; i < length; i++)
+    {
+        crc ^= data[i];
+        for (uint32_t bit = 0U; bit < 8U; bit++)
+        {
+            crc = ((crc & 1U) != 0U) ? ((crc >> 1U) ^ 0x82F63B78U) : (crc >> 1U);
+        }
+    }
+
+    return ~crc;
+}
+
+/*******************************************************************************
+* Function Name: dfu_packet_build
+********************************************************************************
+* Summary:
+*  Frames a command or a response. code is the command ID or the status.
+*
+* Return:
+*  Packet size
+*
+*******************************************************************************/
+size_t dfu_packet_build(bool crc, uint8_t packet[], uint8_t code, const uint8_t data[], size_t length)
+{
+    uint16_t checksum;
+
+    packet[0] = DFU_PACKET_SOP;
+    packet[1] = code;
+    packet[2] = (uint8_t)length;
+    packet[3] = (uint8_t)(length >> 8U);
+    if (length != 0U)
+    {
+        memcpy(&packet[DFU_PACKET_HEADER_SIZE], data, length);
+    }
+    checksum = dfu_packet_checksum_host(crc, packet, DFU_PACKET_HEADER_SIZE + length);
+    packet[4U + length] = (uint8_t)checksum;
+    packet[5U + length] = (uint8_t)(checksum >> 8U);
+    packet[6U + length] = DFU_PACKET_EOP;
+
+    return length + DFU_PACKET_MIN_SIZE;
+}
+
+/*******************************************************************************
+* Function Name: read_exact
+********************************************************************************
+* Summary:
+*  Reads length bytes or fails after timeout_ms without data.
+*
+*******************************************************************************/
+static int read_exact(dfu_host_t *host, uint8_t buffer[], size_t length)
+{
+    size_t done = 0U;
+    int result = 0;
+
+    while ((done < length) && (result == 0))
+    {
+        int got = host->link.read(host->link.context, &buffer[done], length - done, host->timeout_ms);
+
+        if (got > 0)
+        {
+            done += (size_t)got;
+        }
+        else
+        {
+            result = (got == 0) ? DFU_HOST_ERROR_TIMEOUT : DFU_HOST_ERROR_LINK;
+        }
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: dfu_host_send
+********************************************************************************
+* Summary:
+*  Sends a command that has no response, such as Exit DFU.
+*
+*******************************************************************************/
+int dfu_host_send(dfu_host_t *host, uint8_t command, const uint8_t data[], size_t length)
+{
+    uint8_t packet[DFU_PACKET_MAX_SIZE];
+    size_t size = dfu_packet_build(host->crc, packet, command, data, length);
+
+    return (host->link.write(host->link.context, packet, size) == 0) ? 0 : DFU_HOST_ERROR_LINK;
+}
+
+/*******************************************************************************
+* Function Name: dfu_host_receive
+********************************************************************************
+* Summary:
+*  Receives the response to the oldest command sent.
+*
+* Return:
+*  The response status, or DFU_HOST_ERROR_xxx
+*
+*******************************************************************************/
+int dfu_host_receive(dfu_host_t *host, uint8_t response[], size_t response_size, size_t *response_length)
+{
+    uint8_t packet[DFU_PACKET_MAX_SIZE];
+    size_t rsp_length = 0U;
+    uint16_t checksum;
+    int result = read_exact(host, packet, DFU_PACKET_HEADER_SIZE);
+
+    if (result == 0)
+    {
+        rsp_length = (size_t)packet[2] | ((size_t)packet[3] << 8U);
+        if ((packet[0] != DFU_PACKET_SOP) || (rsp_length > DFU_PACKET_MAX_DATA))
+        {
+            result = DFU_HOST_ERROR_RESPONSE;
+        }
+        else
+        {
+            result = read_exact(host, &packet[DFU_PACKET_HEADER_SIZE], rsp_length + 3U);
+        }
+    }
+    if (result == 0)
+    {
+        checksum = (uint16_t)(packet[4U + rsp_length] | (packet[5U + rsp_length] << 8U));
+        if ((packet[6U + rsp_length] != DFU_PACKET_EOP) ||
+            (checksum != dfu_packet_checksum_host(host->crc, packet, DFU_PACKET_HEADER_SIZE + rsp_length)))
+        {
+            result = DFU_HOST_ERROR_RESPONSE;
+        }
+    }
+    if (result == 0)
+    {
+        rsp_length = (rsp_length > response_size) ? response_size : rsp_length;
+        if ((response != NULL) && (rsp_length != 0U))
+        {
+            memcpy(response, &packet[DFU_PACKET_HEADER_SIZE], rsp_length);
+        }
+        if (response_length != NULL)
+        {
+            *response_length = rsp_length;
+        }
+        host->last_status = packet[1];
+        result = packet[1];
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: dfu_host_transfer
+********************************************************************************
+* Summary:
+*  Sends one command and receives its response.
+*
+* Return:
+*  The response status, or DFU_HOST_ERROR_xxx
+*
+*******************************************************************************/
+int dfu_host_transfer(dfu_host_t *host, uint8_t command, const uint8_t data[], size_t length,
+                      uint8_t response[], size_t response_size, size_t *response_length)
+{
+    int result = dfu_host_send(host, command, data, length);
+
+    if (result == 0)
+    {
+        result = dfu_host_receive(host, response, response_size, response_length);
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: dfu_status_name
+*******************************************************************************/
+const char *dfu_status_name(int status)
+{
+    const char *name = "unknown status";
+
+    switch (status)
+    {
+        case DFU_STATUS_SUCCESS:        name = "success"; break;
+        case DFU_STATUS_VERIFY:         name = "verify error"; break;
+        case DFU_STATUS_LENGTH:         name = "length error"; break;
+        case DFU_STATUS_DATA:           name = "data error"; break;
+        case DFU_STATUS_CMD:            name = "unknown command"; break;
+        case DFU_STATUS_CHECKSUM:       name = "packet checksum error"; break;
+        case DFU_STATUS_ADDRESS:        name = "address error"; break;
+        case DFU_STATUS_UNKNOWN:        name = "unknown error"; break;
+        case DFU_STATUS_IMAGE_HEADER:   name = "image rejected: no image header"; break;
+        case DFU_STATUS_IMAGE_SLOT_FIT: name = "image rejected: larger than the slot"; break;
+        case DFU_STATUS_IMAGE_ROLLBACK: name = "image rejected: older than the running image"; break;
+        case DFU_STATUS_IMAGE_PRODUCT:  name = "image rejected: built for another product"; break;
+        case DFU_STATUS_IMAGE_TLV:      name = "image rejected: malformed protected TLVs"; break;
+        case DFU_HOST_ERROR_LINK:       name = "link error"; break;
+        case DFU_HOST_ERROR_TIMEOUT:    name = "no response"; break;
+        case DFU_HOST_ERROR_RESPONSE:   name = "malformed response"; break;
+        case DFU_HOST_ERROR_FILE:       name = "data file error"; break;
+        default:                        break;
+    }
+
+    return name;
+}
+
+/*******************************************************************************
+* Function Name: dfu_image_init
+*******************************************************************************/
+void dfu_image_init(dfu_image_t *image, uint32_t row_size)
+{
+    memset(image, 0, sizeof(*image));
+    image->row_size = row_size;
+}
+
+/*******************************************************************************
+* Function Name: image_row
+********************************************************************************
+* Summary:
+*  Returns the row that holds address, inserting an erased row if needed.
+*
+*******************************************************************************/
+static uint8_t *image_row(dfu_image_t *image, uint32_t address)
+{
+    uint32_t row_address = address - (address % image->row_size);
+    size_t low = 0U;
+    size_t high = image->rows;
+
+    /* Rows mostly arrive in order, so check the last one first */
+    if ((image->rows != 0U) && (image->address[image->rows - 1U] == row_address))
+    {
+        return &image->data[(image->rows - 1U) * image->row_size];
+    }
+
+    while (low < high)
+    {
+        size_t mid = (low + high) / 2U;
+        if (image->address[mid] < row_address)
+        {
+            low = mid + 1U;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    if ((low < image->rows) && (image->address[low] == row_address))
+    {
+        return &image->data[low * image->row_size];
+    }
+
+    if (image->rows == image->capacity)
+    {
+        size_t capacity = (image->capacity == 0U) ? 256U : (image->capacity * 2U);
+        uint32_t *address_list = realloc(image->address, capacity * sizeof(uint32_t));
+        uint8_t *data = (address_list != NULL) ? realloc(image->data, capacity * image->row_size) : NULL;
+
+        if (address_list != NULL)
+        {
+            image->address = address_list;
+        }
+        if (data == NULL)
+        {
+            return NULL;
+        }
+        image->data = data;
+        image->capacity = capacity;
+    }
+
+    memmove(&image->address[low + 1U], &image->address[low], (image->rows - low) * sizeof(uint32_t));
+    memmove(&image->data[(low + 1U) * image->row_size], &image->data[low * image->row_size],
+            (image->rows - low) * image->row_size);
+    image->address[low] = row_address;
+    memset(&image->data[low * image->row_size], 0xFF, image->row_size);
+    image->rows++;
+
+    return &image->data[low * image->row_size];
+}
+
+/*******************************************************************************
+* Function Name: dfu_image_add
+********************************************************************************
+* Summary:
+*  Adds data at the given address. Later data overwrites earlier data.
+*
+* Return:
+*  0 on success, -1 when out of memory or if the image is mapped
+*
+*******************************************************************************/
+int dfu_image_add(dfu_image_t *image, uint32_t address, const uint8_t data[], size_t length)
+{
+    size_t done = 0U;
+
+    if (image->mapping != NULL)
+    {
+        return -1;
+    }
+
+    while (done < length)
+    {
+        uint32_t offset = (address + (uint32_t)done) % image->row_size;
+        size_t chunk = image->row_size - offset;
+        uint8_t *row = image_row(image, address + (uint32_t)done);
+
+        /* The CRC-32C of the rows are out of date */
+        free(image->crc);
+        image->crc = NULL;
+
+        if (row == NULL)
+        {
+            return -1;
+        }
+        chunk = (chunk > (length - done)) ? (length - done) : chunk;
+        memcpy(&row[offset], &data[done], chunk);
+        done += chunk;
+    }
+
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: hex_byte
+*******************************************************************************/
+static int hex_byte(const char *text)
+{
+    int value = -1;
+
+    if (isxdigit((unsigned char)text[0]) && isxdigit((unsigned char)text[1]))
+    {
+        char pair[3] = { text[0], text[1], '\0' };
+        value = (int)strtol(pair, NULL, 16);
+    }
+
+    return value;
+}
+
+/*******************************************************************************
+* Function Name: dfu_image_load_hex
+********************************************************************************
+* Summary:
+*  Loads an Intel HEX file, such as build/app_combined.hex.
+*
+* Return:
+*  0 on success, -1 on error (reported on stderr)
+*
+*******************************************************************************/
+int dfu_image_load_hex(dfu_image_t *image, const char *path)
+{
+    char line[HEX_MAX_LINE];
+    uint8_t record[(HEX_MAX_LINE / 2U) + 1U];
+    uint32_t base = 0U;
+    unsigned int line_number = 0U;
+    int result = 0;
+    bool done = false;
+    FILE *file = fopen(path, "r");
+
+    if (file == NULL)
+    {
+        fprintf(stderr, "cannot open %s\n", path);
+        return -1;
+    }
+
+    while ((result == 0) && !done && (fgets(line, sizeof(line), file) != NULL))
+    {
+        size_t length = strcspn(line, "\r\n");
+        size_t count = 0U;
+        uint8_t sum = 0U;
+
+        line_number++;
+        line[length] = '\0';
+        if (length == 0U)
+        {
+            continue;
+        }
+        if ((line[0] != ':') || ((length % 2U) == 0U))
+        {
+            result = -1;
+        }
+        for (size_t i = 1U; (result == 0) && (i < length); i += 2U)
+        {
+            int value = hex_byte(&line[i]);
+            if (value < 0)
+            {
+                result = -1;
+            }
+            else
+            {
+                record[count++] = (uint8_t)value;
+                sum = (uint8_t)(sum + (uint8_t)value);
+            }
+        }
+        if ((result == 0) && ((count < 5U) || (count != (record[0] + 5U)) || (sum != 0U)))
+        {
+            result = -1;
+        }
+        if (result != 0)
+        {
+            fprintf(stderr, "%s:%u: malformed HEX record\n", path, line_number);
+            break;
+        }
+
+        switch (record[3])
+        {
+            case HEX_DATA:
+                result = dfu_image_add(image, base + (((uint32_t)record[1] << 8U) | record[2]),
+                                       &record[4], record[0]);
+                break;
+            case HEX_EOF:
+                done = true;
+                break;
+            case HEX_EXT_SEGMENT:
+                base = (((uint32_t)record[4] << 8U) | record[5]) << 4U;
+                break;
+            case HEX_EXT_LINEAR:
+                base = (((uint32_t)record[4] << 8U) | record[5]) << 16U;
+                break;
+            default:
+                /* Start address records do not matter here */
+                break;
+        }
+    }
+
+    fclose(file);
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: get_u32
+*******************************************************************************/
+static uint32_t get_u32(const uint8_t data[])
+{
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8U) | ((uint32_t)data[2] << 16U) | ((uint32_t)data[3] << 24U);
+}
+
+/* Field of a table entry in a mapped update container */
+#define CONTAINER_FIELD(base, type, field)  get_u32(&(base)[offsetof(type, field)])
+
+/*******************************************************************************
+* Function Name: container_check
+********************************************************************************
+* Summary:
+*  Checks the header and the tables of a mapped update container against its
+*  size and its metadata CRC-32C.
+*
+*******************************************************************************/
+static bool container_check(const uint8_t *file, size_t size, uint32_t row_size)
+{
+    uint64_t segments = CONTAINER_FIELD(file, dfu_container_header_t, segment_offset);
+    uint64_t regions = CONTAINER_FIELD(file, dfu_container_header_t, region_offset);
+    uint64_t crcs = CONTAINER_FIELD(file, dfu_container_header_t, row_crc_offset);
+    uint64_t payload = CONTAINER_FIELD(file, dfu_container_header_t, payload_offset);
+    uint64_t rows = CONTAINER_FIELD(file, dfu_container_header_t, row_count);
+    uint8_t *metadata;
+    bool valid;
+
+    valid = (CONTAINER_FIELD(file, dfu_container_header_t, row_size) == row_size) &&
+            (file[offsetof(dfu_container_header_t, version)] == DFU_CONTAINER_VERSION) &&
+            (file[offsetof(dfu_container_header_t, version) + 1U] == 0U) &&
+            ((payload % row_size) == 0U) && ((payload + (rows * row_size)) <= size) &&
+            ((segments + (CONTAINER_FIELD(file, dfu_container_header_t, segment_count) *
+                          (uint64_t)sizeof(dfu_container_segment_t))) <= payload) &&
+            ((regions + (CONTAINER_FIELD(file, dfu_container_header_t, region_count) *
+                         (uint64_t)sizeof(dfu_container_region_t))) <= payload) &&
+            (((CONTAINER_FIELD(file, dfu_container_header_t, flags) & DFU_CONTAINER_FLAG_ROW_CRC) == 0U) ||
+             ((crcs != 0U) && ((crcs + (rows * 4U)) <= payload)));
+    if (!valid)
+    {
+        return false;
+    }
+
+    metadata = malloc((size_t)payload);
+    if (metadata == NULL)
+    {
+        return false;
+    }
+    memcpy(metadata, file, (size_t)payload);
+    memset(&metadata[offsetof(dfu_container_header_t, metadata_crc)], 0, 4U);
+    valid = (dfu_crc32c(metadata, (size_t)payload) == CONTAINER_FIELD(file, dfu_container_header_t, metadata_crc));
+    free(metadata);
+
+    return valid;
+}
+
+/*******************************************************************************
+* Function Name: dfu_image_load_container
+********************************************************************************
+* Summary:
+*  Maps an update container, see proj_cm33_ns/dfu_container.h. The rows stay
+*  in the file; the row CRC-32C come from the file if it has them. The row
+*  size of the container must be the row size of the image.
+*
+* Return:
+*  0 on success, -1 on error (reported on stderr)
+*
+*******************************************************************************/
+int dfu_image_load_container(dfu_image_t *image, const char *path)
+{
+    struct stat st;
+    uint8_t *file = MAP_FAILED;
+    int fd = open(path, O_RDONLY);
+    size_t rows;
+    size_t row = 0U;
+    uint32_t segment_count;
+    const uint8_t *segment;
+
+    if ((fd >= 0) && (fstat(fd, &st) == 0) && ((size_t)st.st_size >= sizeof(dfu_container_header_t)))
+    {
+        file = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    if (file == MAP_FAILED)
+    {
+        fprintf(stderr, "cannot map %s\n", path);
+        return -1;
+    }
+    if ((CONTAINER_FIELD(file, dfu_container_header_t, magic) != DFU_CONTAINER_MAGIC) ||
+        !container_check(file, (size_t)st.st_size, image->row_size))
+    {
+        fprintf(stderr, "%s: not a valid update container with rows of %u bytes\n", path,
+                (unsigned int)image->row_size);
+        munmap(file, (size_t)st.st_size);
+        return -1;
+    }
+
+    dfu_image_free(image);
+    rows = CONTAINER_FIELD(file, dfu_container_header_t, row_count);
+    image->mapping = file;
+    image->mapping_size = (size_t)st.st_size;
+    image->data = &file[CONTAINER_FIELD(file, dfu_container_header_t, payload_offset)];
+    image->address = malloc(((rows != 0U) ? rows : 1U) * sizeof(uint32_t));
+    if ((CONTAINER_FIELD(file, dfu_container_header_t, flags) & DFU_CONTAINER_FLAG_ROW_CRC) != 0U)
+    {
+        image->crc = malloc(((rows != 0U) ? rows : 1U) * sizeof(uint32_t));
+    }
+    if ((image->address == NULL) ||
+        (((CONTAINER_FIELD(file, dfu_container_header_t, flags) & DFU_CONTAINER_FLAG_ROW_CRC) != 0U) &&
+         (image->crc == NULL)))
+    {
+        dfu_image_free(image);
+        return -1;
+    }
+
+    /* The segments must cover the rows in order */
+    segment_count = CONTAINER_FIELD(file, dfu_container_header_t, segment_count);
+    segment = &file[CONTAINER_FIELD(file, dfu_container_header_t, segment_offset)];
+    for (uint32_t s = 0U; s < segment_count; s++, segment += sizeof(dfu_container_segment_t))
+    {
+        uint32_t address = CONTAINER_FIELD(segment, dfu_container_segment_t, address);
+        uint32_t count = CONTAINER_FIELD(segment, dfu_container_segment_t, row_count);
+
+        if ((CONTAINER_FIELD(segment, dfu_container_segment_t, first_row) != row) || (count > (rows - row)) ||
+            ((address % image->row_size) != 0U))
+        {
+            break;
+        }
+        for (uint32_t i = 0U; i < count; i++)
+        {
+            image->address[row++] = address + (i * image->row_size);
+        }
+    }
+    if (row != rows)
+    {
+        fprintf(stderr, "%s: the segments do not match the rows\n", path);
+        dfu_image_free(image);
+        return -1;
+    }
+    for (size_t i = 0U; (image->crc != NULL) && (i < rows); i++)
+    {
+        image->crc[i] = get_u32(&file[CONTAINER_FIELD(file, dfu_container_header_t, row_crc_offset) + (i * 4U)]);
+    }
+    image->rows = rows;
+    image->capacity = rows;
+
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: dfu_image_load
+********************************************************************************
+* Summary:
+*  Loads an update container or an Intel HEX file, whichever path is.
+*
+* Return:
+*  0 on success, -1 on error (reported on stderr)
+*
+*******************************************************************************/
+int dfu_image_load(dfu_image_t *image, const char *path)
+{
+    uint8_t magic[4] = { 0U };
+    FILE *file = fopen(path, "rb");
+
+    if (file == NULL)
+    {
+        fprintf(stderr, "cannot open %s\n", path);
+        return -1;
+    }
+    (void)fread(magic, 1U, sizeof(magic), file);
+    fclose(file);
+
+    return (get_u32(magic) == DFU_CONTAINER_MAGIC) ? dfu_image_load_container(image, path) :
+                                                     dfu_image_load_hex(image, path);
+}
+
+/*******************************************************************************
+* Function Name: dfu_image_seal
+********************************************************************************
+* Summary:
+*  Computes the CRC-32C of every row once, so hosts that program the image do
+*  not. Adding data afterwards drops them again. Images from an update
+*  container with the row CRC-32C table are sealed already.
+*
+* Return:
+*  0 on success, -1 when out of memory
+*
+*******************************************************************************/
+int dfu_image_seal(dfu_image_t *image)
+{
+    uint32_t *crc;
+
+    if (image->crc != NULL)
+    {
+        return 0;
+    }
+    crc = malloc(((image->rows != 0U) ? image->rows : 1U) * sizeof(uint32_t));
+    if (crc == NULL)
+    {
+        return -1;
+    }
+    for (size_t row = 0U; row < image->rows; row++)
+    {
+        crc[row] = dfu_crc32c(&image->data[row * image->row_size], image->row_size);
+    }
+    image->crc = crc;
+
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: dfu_image_free
+*******************************************************************************/
+void dfu_image_free(dfu_image_t *image)
+{
+    free(image->address);
+    if (image->mapping != NULL)
+    {
+        munmap(image->mapping, image->mapping_size);
+    }
+    else
+    {
+        free(image->data);
+    }
+    free(image->crc);
+    dfu_image_init(image, image->row_size);
+}
+
+/*******************************************************************************
+* Function Name: json_skip_space
+*******************************************************************************/
+static void json_skip_space(json_parser_t *parser)
+{
+    while (isspace((unsigned char)*parser->pos))
+    {
+        parser->pos++;
+    }
+}
+
+/*******************************************************************************
+* Function Name: json_parse_string
+********************************************************************************
+* Summary:
+*  Parses a string token. Escapes are kept except for \" and \\, which is
+*  enough for the paths and hex numbers of a .mtbdfu file.
+*
+*******************************************************************************/
+static char *json_parse_string(json_parser_t *parser)
+{
+    const char *start = ++parser->pos;
+    char *text;
+    size_t length = 0U;
+
+    while ((*parser->pos != '"') && (*parser->pos != '\0'))
+    {
+        parser->pos += ((parser->pos[0] == '\\') && (parser->pos[1] != '\0')) ? 2 : 1;
+    }
+    if (*parser->pos != '"')
+    {
+        parser->error = true;
+        return NULL;
+    }
+
+    text = malloc((size_t)(parser->pos - start) + 1U);
+    if (text == NULL)
+    {
+        parser->error = true;
+        return NULL;
+    }
+    for (const char *src = start; src < parser->pos; src++)
+    {
+        if ((src[0] == '\\') && ((src[1] == '"') || (src[1] == '\\')))
+        {
+            src++;
+        }
+        text[length++] = *src;
+    }
+    text[length] = '\0';
+    parser->pos++;
+
+    return text;
+}
+
+/*******************************************************************************
+* Function Name: json_free
+*******************************************************************************/
+static void json_free(json_node_t *node)
+{
+    while (node != NULL)
+    {
+        json_node_t *next = node->next;
+        json_free(node->child);
+        free(node->key);
+        free(node->text);
+        free(node);
+        node = next;
+    }
+}
+
+/*******************************************************************************
+* Function Name: json_parse_members
+********************************************************************************
+* Summary:
+*  Parses the members of an object or the elements of an array.
+*
+*******************************************************************************/
+static void json_parse_members(json_parser_t *parser, json_node_t *parent, char close)
+{
+    json_node_t **tail = &parent->child;
+
+    parser->pos++;
+    json_skip_space(parser);
+    if (*parser->pos == close)
+    {
+        parser->pos++;
+        return;
+    }
+
+    while (!parser->error)
+    {
+        char *key = NULL;
+        json_node_t *node;
+
+        json_skip_space(parser);
+        if (parent->type == JSON_OBJECT)
+        {
+            if (*parser->pos != '"')
+            {
+                parser->error = true;
+                break;
+            }
+            key = json_parse_string(parser);
+            json_skip_space(parser);
+            if ((key == NULL) || (*parser->pos != ':'))
+            {
+                free(key);
+                parser->error = true;
+                break;
+            }
+            parser->pos++;
+        }
+
+        node = json_parse_value(parser);
+        if (node == NULL)
+        {
+            free(key);
+            break;
+        }
+        node->key = key;
+        *tail = node;
+        tail = &node->next;
+
+        json_skip_space(parser);
+        if (*parser->pos == ',')
+        {
+            parser->pos++;
+        }
+        else if (*parser->pos == close)
+        {
+            parser->pos++;
+            break;
+        }
+        else
+        {
+            parser->error = true;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: json_parse_value
+*******************************************************************************/
+static json_node_t *json_parse_value(json_parser_t *parser)
+{
+    json_node_t *node = calloc(1U, sizeof(json_node_t));
+
+    if (node == NULL)
+    {
+        parser->error = true;
+        return NULL;
+    }
+
+    json_skip_space(parser);
+    if (*parser->pos == '{')
+    {
+        node->type = JSON_OBJECT;
+        json_parse_members(parser, node, '}');
+    }
+    else if (*parser->pos == '[')
+    {
+        node->type = JSON_ARRAY;
+        json_parse_members(parser, node, ']');
+    }
+    else if (*parser->pos == '"')
+    {
+        node->type = JSON_VALUE;
+        node->text = json_parse_string(parser);
+    }
+    else
+    {
+        const char *start = parser->pos;
+        while ((*parser->pos != '\0') && (strchr(",}] \t\r\n", *parser->pos) == NULL))
+        {
+            parser->pos++;
+        }
+        node->type = JSON_VALUE;
+        node->text = strndup(start, (size_t)(parser->pos - start));
+        parser->error = parser->error || (parser->pos == start);
+    }
+
+    if (parser->error)
+    {
+        json_free(node);
+        node = NULL;
+    }
+
+    return node;
+}
+
+/*******************************************************************************
+* Function Name: json_get
+*******************************************************************************/
+static const json_node_t *json_get(const json_node_t *object, const char *key)
+{
+    const json_node_t *node = ((object != NULL) && (object->type == JSON_OBJECT)) ? object->child : NULL;
+
+    while ((node != NULL) && (strcmp(node->key, key) != 0))
+    {
+        node = node->next;
+    }
+
+    return node;
+}
+
+/*******************************************************************************
+* Function Name: json_get_number
+********************************************************************************
+* Summary:
+*  Returns a number given as "0x37", "55" or 55.
+*
+*******************************************************************************/
+static bool json_get_number(const json_node_t *object, const char *key, uint32_t *value)
+{
+    const json_node_t *node = json_get(object, key);
+    char *end;
+    bool found = false;
+
+    if ((node != NULL) && (node->type == JSON_VALUE) && (node->text != NULL))
+    {
+        *value = (uint32_t)strtoul(node->text, &end, 0);
+        found = (end != node->text) && (*end == '\0');
+    }
+
+    return found;
+}
+
+/*******************************************************************************
+* Function Name: json_get_bytes
+********************************************************************************
+* Summary:
+*  Returns length bytes given as a string of 2 * length hex digits.
+*
+*******************************************************************************/
+static bool json_get_bytes(const json_node_t *object, const char *key, uint8_t data[], size_t length)
+{
+    const json_node_t *node = json_get(object, key);
+    char digits[3] = { '\0', '\0', '\0' };
+
+    if ((node == NULL) || (node->type != JSON_VALUE) || (node->text == NULL) ||
+        (strlen(node->text) != (2U * length)))
+    {
+        return false;
+    }
+    for (size_t i = 0U; i < length; i++)
+    {
+        memcpy(digits, &node->text[2U * i], 2U);
+        if (!isxdigit((unsigned char)digits[0]) || !isxdigit((unsigned char)digits[1]))
+        {
+            return false;
+        }
+        data[i] = (uint8_t)strtoul(digits, NULL, 16);
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: dfu_script_load
+********************************************************************************
+* Summary:
+*  Parses a .mtbdfu file. A relative "dataFile" is resolved against the
+*  directory of the script.
+*
+* Return:
+*  0 on success, -1 on error (reported on stderr)
+*
+*******************************************************************************/
+int dfu_script_load(dfu_script_t *script, const char *path)
+{
+    json_parser_t parser = { NULL, false };
+    json_node_t *root = NULL;
+    const json_node_t *node;
+    const json_node_t *entry;
+    char *text = NULL;
+    long size;
+    uint32_t value;
+    int result = -1;
+    FILE *file = fopen(path, "rb");
+
+    memset(script, 0, sizeof(*script));
+
+    if (file != NULL)
+    {
+        if ((fseek(file, 0, SEEK_END) == 0) && ((size = ftell(file)) > 0) && (fseek(file, 0, SEEK_SET) == 0))
+        {
+            text = malloc((size_t)size + 1U);
+            if ((text != NULL) && (fread(text, 1U, (size_t)size, file) == (size_t)size))
+            {
+                text[size] = '\0';
+                parser.pos = text;
+                root = json_parse_value(&parser);
+            }
+        }
+        fclose(file);
+    }
+
+    node = json_get(json_get(root, "APPInfo"), "Packet Checksum Type");
+    if (node != NULL)
+    {
+        script->crc = json_get_number(json_get(root, "APPInfo"), "Packet Checksum Type", &value) && (value != 0U);
+    }
+    node = json_get(json_get(root, "APPInfo"), "Product Id");
+    if ((node != NULL) && (node->text != NULL))
+    {
+        script->product_id = (uint32_t)strtoul(node->text, NULL, 16);
+        script->has_product_id = true;
+    }
+
+    node = json_get(root, "commands");
+    for (entry = (node != NULL) ? node->child : NULL;
+         (entry != NULL) && (script->block_count < DFU_SCRIPT_MAX_BLOCKS); entry = entry->next)
+    {
+        dfu_script_block_t *block = &script->blocks[script->block_count];
+        const json_node_t *set = json_get(entry, "commandSet");
+        const json_node_t *data_file = json_get(entry, "dataFile");
+        const json_node_t *repeat = json_get(entry, "repeat");
+
+        for (const json_node_t *cmd = (set != NULL) ? set->child : NULL;
+             (cmd != NULL) && (block->cmd_count < DFU_SCRIPT_MAX_CMDS); cmd = cmd->next)
+        {
+            dfu_script_cmd_t *command = &block->cmds[block->cmd_count++];
+
+            command->repeat = 1U;
+            command->id = json_get_number(cmd, "cmdId", &value) ? (uint8_t)value : 0U;
+            command->data_length = json_get_number(cmd, "dataLength", &value) ? value : 0U;
+            (void)json_get_number(cmd, "repeat", &command->repeat);
+        }
+
+        if ((data_file != NULL) && (data_file->text != NULL))
+        {
+            const char *slash = strrchr(path, '/');
+            if ((data_file->text[0] == '/') || (slash == NULL))
+            {
+                snprintf(block->data_file, sizeof(block->data_file), "%s", data_file->text);
+            }
+            else
+            {
+                snprintf(block->data_file, sizeof(block->data_file), "%.*s/%s",
+                         (int)(slash - path), path, data_file->text);
+            }
+        }
+
+        block->image_id = DFU_SCRIPT_NO_IMAGE;
+        if (json_get_number(entry, "imageId", &value) && (value <= (uint32_t)DFU_SCRIPT_MAX_IMAGE))
+        {
+            block->image_id = (int)value;
+        }
+        if (json_get(entry, "nonce") != NULL)
+        {
+            block->has_nonce = json_get_bytes(entry, "nonce", block->nonce, sizeof(block->nonce));
+            if (!block->has_nonce || (block->image_id == DFU_SCRIPT_NO_IMAGE))
+            {
+                fprintf(stderr, "%s: \"nonce\" needs %u hex digits and an \"imageId\"\n", path,
+                        2U * DFU_SCRIPT_NONCE_SIZE);
+                parser.error = true;
+            }
+        }
+        block->row_length = json_get_number(entry, "flashRowLength", &value) ? value : 0x200U;
+        block->timeout_ms = json_get_number(entry, "timeoutMS", &value) ? value : 1000U;
+        block->repeat = 1U;
+        if ((repeat != NULL) && (repeat->text != NULL) && (strcasecmp(repeat->text, "EoF") == 0))
+        {
+            block->repeat_eof = true;
+        }
+        else
+        {
+            (void)json_get_number(entry, "repeat", &block->repeat);
+        }
+        script->block_count++;
+    }
+
+    if ((root != NULL) && !parser.error && (script->block_count != 0U))
+    {
+        result = 0;
+    }
+    else
+    {
+        fprintf(stderr, "%s: not a valid .mtbdfu file\n", path);
+    }
+
+    json_free(root);
+    free(text);
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: dfu_script_select
+********************************************************************************
+* Summary:
+*  Parses a comma separated list of image IDs, such as "2" or "0,2", into a
+*  selection for dfu_host_t.images. Every ID must be the "imageId" of an entry
+*  of the script.
+*
+* Return:
+*  0 on success, -1 if the list is not valid (reported on stderr)
+*
+*******************************************************************************/
+int dfu_script_select(const dfu_script_t *script, const char *text, uint32_t *images)
+{
+    const char *pos = text;
+
+    *images = 0U;
+    for (;;)
+    {
+        char *end;
+        unsigned long id = strtoul(pos, &end, 0);
+        bool found = false;
+
+        for (size_t b = 0U; (b < script->block_count) && (end != pos) && (id <= (unsigned long)DFU_SCRIPT_MAX_IMAGE);
+             b++)
+        {
+            found = found || (script->blocks[b].image_id == (int)id);
+        }
+        if ((!found) || ((*end != ',') && (*end != '\0')))
+        {
+            fprintf(stderr, "%s: no entry of the script has this imageId\n", text);
+            return -1;
+        }
+        *images |= 1UL << id;
+        if (*end == '\0')
+        {
+            return 0;
+        }
+        pos = end + 1;
+    }
+}
+
+/*******************************************************************************
+* Function Name: dfu_script_selected
+********************************************************************************
+* Summary:
+*  Checks whether an entry runs with a selection of image IDs, see
+*  dfu_host_t.images.
+*
+*******************************************************************************/
+bool dfu_script_selected(const dfu_script_block_t *block, uint32_t images)
+{
+    return (images == 0U) || (block->image_id == DFU_SCRIPT_NO_IMAGE) ||
+           ((images & (1UL << (uint32_t)block->image_id)) != 0U);
+}
+
+/*******************************************************************************
+* Function Name: host_error
+********************************************************************************
+* Summary:
+*  Reports an error on stderr, after the name of the host if it has one.
+*
+*******************************************************************************/
+static void host_error(const dfu_host_t *host, const char *format, ...)
+{
+    va_list args;
+
+    if (host->name != NULL)
+    {
+        fprintf(stderr, "%s: ", host->name);
+    }
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+}
+
+/*******************************************************************************
+* Function Name: pipeline_receive
+********************************************************************************
+* Summary:
+*  Receives the response to the oldest command in flight. The first failure
+*  is kept; after a link error or timeout nothing more is expected.
+*
+*******************************************************************************/
+static void pipeline_receive(dfu_host_t *host, dfu_pipeline_t *pipe)
+{
+    int status = dfu_host_receive(host, NULL, 0U, NULL);
+    const dfu_pipeline_entry_t *entry = &pipe->entries[pipe->oldest];
+
+    if ((status != DFU_STATUS_SUCCESS) && (pipe->status == DFU_STATUS_SUCCESS))
+    {
+        host_error(host, "command 0x%02X at 0x%08X failed: %s\n", entry->command, (unsigned int)entry->address,
+                   dfu_status_name(status));
+        pipe->status = status;
+    }
+    pipe->oldest = (pipe->oldest + 1U) % DFU_HOST_MAX_WINDOW;
+    pipe->in_flight = (status < 0) ? 0U : (pipe->in_flight - 1U);
+}
+
+/*******************************************************************************
+* Function Name: pipeline_send
+********************************************************************************
+* Summary:
+*  Sends a command without waiting for its response, as long as fewer than
+*  host->window commands are in flight.
+*
+*******************************************************************************/
+static void pipeline_send(dfu_host_t *host, dfu_pipeline_t *pipe, uint8_t command, uint32_t address,
+                          const uint8_t data[], size_t length)
+{
+    uint32_t window = (host->window == 0U) ? 1U : host->window;
+
+    window = (window > DFU_HOST_MAX_WINDOW) ? DFU_HOST_MAX_WINDOW : window;
+    if (pipe->status == DFU_STATUS_SUCCESS)
+    {
+        if (dfu_host_send(host, command, data, length) != 0)
+        {
+            pipe->status = DFU_HOST_ERROR_LINK;
+            pipe->in_flight = 0U;
+        }
+        else
+        {
+            dfu_pipeline_entry_t *entry = &pipe->entries[(pipe->oldest + pipe->in_flight) % DFU_HOST_MAX_WINDOW];
+
+            entry->command = command;
+            entry->address = address;
+            pipe->in_flight++;
+        }
+    }
+    while (pipe->in_flight >= window)
+    {
+        pipeline_receive(host, pipe);
+    }
+}
+
+/*******************************************************************************
+* Function Name: pipeline_drain
+*******************************************************************************/
+static int pipeline_drain(dfu_host_t *host, dfu_pipeline_t *pipe)
+{
+    while (pipe->in_flight != 0U)
+    {
+        pipeline_receive(host, pipe);
+    }
+
+    return pipe->status;
+}
+
+/*******************************************************************************
+* Function Name: put_row_header
+********************************************************************************
+* Summary:
+*  Writes the address and CRC-32C of a row, the start of Program Data and
+*  Verify Data.
+*
+*******************************************************************************/
+static void put_row_header(uint8_t data[], uint32_t address, uint32_t crc)
+{
+    data[0] = (uint8_t)address;
+    data[1] = (uint8_t)(address >> 8U);
+    data[2] = (uint8_t)(address >> 16U);
+    data[3] = (uint8_t)(address >> 24U);
+    data[4] = (uint8_t)crc;
+    data[5] = (uint8_t)(crc >> 8U);
+    data[6] = (uint8_t)(crc >> 16U);
+    data[7] = (uint8_t)(crc >> 24U);
+}
+
+/*******************************************************************************
+* Function Name: can_chunk
+********************************************************************************
+* Summary:
+*  A command set can be sent in host->chunk_size pieces if it is Send Data
+*  followed by one Program Data or Verify Data, like Program.mtbdfu.
+*
+*******************************************************************************/
+static bool can_chunk(const dfu_host_t *host, const dfu_script_block_t *block)
+{
+    bool chunk = (host->chunk_size > DFU_ROW_HEADER_SIZE) && (block->cmd_count != 0U) &&
+                 (block->cmds[block->cmd_count - 1U].repeat == 1U) &&
+                 ((block->cmds[block->cmd_count - 1U].id == DFU_CMD_PROGRAM_DATA) ||
+                  (block->cmds[block->cmd_count - 1U].id == DFU_CMD_VERIFY_DATA));
+
+    for (size_t i = 0U; chunk && ((i + 1U) < block->cmd_count); i++)
+    {
+        chunk = (block->cmds[i].id == DFU_CMD_SEND_DATA);
+    }
+
+    return chunk;
+}
+
+/*******************************************************************************
+* Function Name: run_chunked_row
+********************************************************************************
+* Summary:
+*  Sends a row as Send Data commands of host->chunk_size bytes, followed by
+*  Program Data or Verify Data with the rest of the row.
+*
+*******************************************************************************/
+static int run_chunked_row(dfu_host_t *host, const dfu_script_block_t *block, uint32_t address,
+                           const uint8_t row[], uint32_t row_size, uint32_t crc)
+{
+    uint8_t data[DFU_PACKET_MAX_DATA];
+    dfu_pipeline_t *pipe = &host->pipeline;
+    uint32_t chunk = (host->chunk_size > DFU_PACKET_MAX_DATA) ? DFU_PACKET_MAX_DATA : host->chunk_size;
+    uint32_t tail = ((chunk - DFU_ROW_HEADER_SIZE) < row_size) ? (chunk - DFU_ROW_HEADER_SIZE) : row_size;
+    uint32_t offset = 0U;
+
+    while ((offset < (row_size - tail)) && (pipe->status == DFU_STATUS_SUCCESS))
+    {
+        uint32_t take = ((row_size - tail - offset) < chunk) ? (row_size - tail - offset) : chunk;
+
+        pipeline_send(host, pipe, DFU_CMD_SEND_DATA, address, &row[offset], take);
+        offset += take;
+    }
+
+    put_row_header(data, address, crc);
+    memcpy(&data[DFU_ROW_HEADER_SIZE], &row[offset], tail);
+    pipeline_send(host, pipe, block->cmds[block->cmd_count - 1U].id, address, data, DFU_ROW_HEADER_SIZE + tail);
+
+    return pipe->status;
+}
+
+/*******************************************************************************
+* Function Name: run_command_set
+********************************************************************************
+* Summary:
+*  Runs the command set of a script entry. With a row, whose CRC-32C is crc,
+*  each command takes its data from the row in turn: Send Data takes dataLength bytes; Program Data
+*  and Verify Data send the row address and its CRC-32C, followed by
+*  dataLength - 8 bytes of the row; Erase Data sends the row address.
+*
+*  Commands are pipelined up to host->window deep. Responses are collected
+*  before the function returns, except between rows of one entry.
+*
+*******************************************************************************/
+static int run_command_set(dfu_host_t *host, const dfu_script_block_t *block, uint32_t address,
+                           const uint8_t row[], uint32_t row_size, uint32_t crc)
+{
+    uint8_t data[DFU_PACKET_MAX_DATA];
+    dfu_pipeline_t *pipe = &host->pipeline;
+    uint32_t offset = 0U;
+
+    if ((row != NULL) && can_chunk(host, block))
+    {
+        return run_chunked_row(host, block, address, row, row_size, crc);
+    }
+
+    for (size_t i = 0U; (i < block->cmd_count) && (pipe->status == DFU_STATUS_SUCCESS); i++)
+    {
+        const dfu_script_cmd_t *cmd = &block->cmds[i];
+
+        for (uint32_t n = 0U; (n < cmd->repeat) && (pipe->status == DFU_STATUS_SUCCESS); n++)
+        {
+            uint32_t header = 0U;
+            uint32_t length = (cmd->data_length > DFU_PACKET_MAX_DATA) ? DFU_PACKET_MAX_DATA : cmd->data_length;
+            uint32_t take;
+
+            if ((row != NULL) && ((cmd->id == DFU_CMD_PROGRAM_DATA) || (cmd->id == DFU_CMD_VERIFY_DATA) ||
+                                  (cmd->id == DFU_CMD_ERASE_DATA)))
+            {
+                header = (cmd->id == DFU_CMD_ERASE_DATA) ? 4U : DFU_ROW_HEADER_SIZE;
+                put_row_header(data, address, crc);
+                length = (length < header) ? header : length;
+            }
+
+            take = length - header;
+            if (row != NULL)
+            {
+                take = ((offset + take) > row_size) ? (row_size - offset) : take;
+                memcpy(&data[header], &row[offset], take);
+                offset += take;
+            }
+            else
+            {
+                memset(&data[header], 0, take);
+            }
+
+            pipeline_send(host, pipe, cmd->id, address, data, header + take);
+        }
+    }
+
+    return pipe->status;
+}
+
+/*******************************************************************************
+* Function Name: dfu_host_program
+********************************************************************************
+* Summary:
+*  Runs a .mtbdfu script: Enter DFU, every entry of "commands" selected by
+*  host->images, Exit DFU. If host->image is set, it replaces the "dataFile" of
+*  every entry; otherwise data_file does, if it is not NULL.
+*
+* Return:
+*  0 on success, otherwise the failing status or DFU_HOST_ERROR_xxx
+*
+*******************************************************************************/
+int dfu_host_program(dfu_host_t *host, const dfu_script_t *script, const char *data_file)
+{
+    uint8_t product[4];
+    uint8_t response[16];
+    size_t response_length = 0U;
+    int status;
+
+    host->crc = script->crc;
+    host->timeout_ms = (int)script->blocks[0].timeout_ms;
+    memset(&host->pipeline, 0, sizeof(host->pipeline));
+
+    product[0] = (uint8_t)script->product_id;
+    product[1] = (uint8_t)(script->product_id >> 8U);
+    product[2] = (uint8_t)(script->product_id >> 16U);
+    product[3] = (uint8_t)(script->product_id >> 24U);
+    status = dfu_host_transfer(host, DFU_CMD_ENTER, product, script->has_product_id ? 4U : 0U,
+                               response, sizeof(response), &response_length);
+    if (status != DFU_STATUS_SUCCESS)
+    {
+        host_error(host, "Enter DFU failed: %s\n", dfu_status_name(status));
+    }
+
+    for (size_t b = 0U; (b < script->block_count) && (status == DFU_STATUS_SUCCESS); b++)
+    {
+        const dfu_script_block_t *block = &script->blocks[b];
+        const char *path = (data_file != NULL) ? data_file : block->data_file;
+        const dfu_image_t *rows = host->image;
+        dfu_image_t image;
+
+        if (!dfu_script_selected(block, host->images))
+        {
+            continue;
+        }
+        host->timeout_ms = (int)block->timeout_ms;
+
+        if (!block->repeat_eof)
+        {
+            for (uint32_t n = 0U; (n < block->repeat) && (status == DFU_STATUS_SUCCESS); n++)
+            {
+                status = run_command_set(host, block, 0U, NULL, 0U, 0U);
+            }
+            status = pipeline_drain(host, &host->pipeline);
+            continue;
+        }
+
+        dfu_image_init(&image, block->row_length);
+        if (host->image == NULL)
+        {
+            if ((block->row_length == 0U) || (path[0] == '\0') || (dfu_image_load(&image, path) != 0))
+            {
+                status = DFU_HOST_ERROR_FILE;
+            }
+            rows = &image;
+        }
+        else if (host->image->row_size != block->row_length)
+        {
+            host_error(host, "the image has rows of %u bytes, the script %u\n", (unsigned int)host->image->row_size,
+                       (unsigned int)block->row_length);
+            status = DFU_HOST_ERROR_FILE;
+        }
+        if ((status == DFU_STATUS_SUCCESS) && block->has_nonce)
+        {
+            /* The rows of an encrypted dataFile are decrypted by the device */
+            uint8_t start[1U + DFU_SCRIPT_NONCE_SIZE];
+
+            start[0] = (uint8_t)block->image_id;
+            memcpy(&start[1], block->nonce, DFU_SCRIPT_NONCE_SIZE);
+            status = dfu_host_transfer(host, DFU_CMD_DECRYPT_START, start, sizeof(start),
+                                       response, sizeof(response), &response_length);
+            if (status != DFU_STATUS_SUCCESS)
+            {
+                host_error(host, "decryption of image %d not started: %s\n", block->image_id,
+                           dfu_status_name(status));
+            }
+        }
+        for (size_t row = 0U; (row < rows->rows) && (status == DFU_STATUS_SUCCESS); row++)
+        {
+            status = run_command_set(host, block, rows->address[row], &rows->data[row * rows->row_size],
+                                     rows->row_size, (rows->crc != NULL) ? rows->crc[row] :
+                                     dfu_crc32c(&rows->data[row * rows->row_size], rows->row_size));
+            if ((status == DFU_STATUS_SUCCESS) && (host->row_done != NULL))
+            {
+                host->row_done(host->row_context, row, rows->rows, rows->address[row]);
+            }
+        }
+        if (status != DFU_HOST_ERROR_FILE)
+        {
+            status = pipeline_drain(host, &host->pipeline);
+        }
+        dfu_image_free(&image);
+    }
+
+    if (status == DFU_STATUS_SUCCESS)
+    {
+        status = dfu_host_send(host, DFU_CMD_EXIT, NULL, 0U);
+    }
+
+    return status;
+}
+
+/* [] END OF FILE */
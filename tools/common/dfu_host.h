@@ -0,0 +1,234 @@
+/*******************************************************************************
+* File Name        : dfu_host.h
+*
+* Description      : Host side of the DFU protocol used by the host tools:
+*                    packet framing, the .mtbdfu command script, Intel HEX
+*                    images and the program flow of the DFU Host tool.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef DFU_HOST_H
+#define DFU_HOST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* DFU packet layout */
+#define DFU_PACKET_SOP              (0x01U)
+#define DFU_PACKET_EOP              (0x17U)
+#define DFU_PACKET_HEADER_SIZE      (4U)
+#define DFU_PACKET_MIN_SIZE         (7U)
+#define DFU_PACKET_MAX_DATA         (1024U)
+#define DFU_PACKET_MAX_SIZE         (DFU_PACKET_MIN_SIZE + DFU_PACKET_MAX_DATA)
+
+/* DFU command IDs */
+#define DFU_CMD_VERIFY_APP          (0x31U)
+#define DFU_CMD_SYNC                (0x35U)
+#define DFU_CMD_SEND_DATA           (0x37U)
+#define DFU_CMD_ENTER               (0x38U)
+#define DFU_CMD_EXIT                (0x3BU)
+#define DFU_CMD_ERASE_DATA          (0x44U)
+#define DFU_CMD_PROGRAM_DATA        (0x49U)
+#define DFU_CMD_VERIFY_DATA         (0x4AU)
+#define DFU_CMD_DECRYPT_START       (0x54U)     /* SECURE_DECRYPT_CMD_START */
+
+/* Response status, the low byte of cy_en_dfu_status_t */
+#define DFU_STATUS_SUCCESS          (0x00U)
+#define DFU_STATUS_VERIFY           (0x02U)
+#define DFU_STATUS_LENGTH           (0x03U)
+#define DFU_STATUS_DATA             (0x04U)
+#define DFU_STATUS_CMD              (0x05U)
+#define DFU_STATUS_CHECKSUM         (0x08U)
+#define DFU_STATUS_ADDRESS          (0x0AU)
+#define DFU_STATUS_UNKNOWN          (0x0FU)
+
+/* Image rejected by the early image check, see dfu_image_check.h */
+#define DFU_STATUS_IMAGE_HEADER     (0x10U)
+#define DFU_STATUS_IMAGE_SLOT_FIT   (0x11U)
+#define DFU_STATUS_IMAGE_ROLLBACK   (0x12U)
+#define DFU_STATUS_IMAGE_PRODUCT    (0x13U)
+#define DFU_STATUS_IMAGE_TLV        (0x14U)
+
+/* Errors returned instead of a response status */
+#define DFU_HOST_ERROR_LINK         (-1)    /* Link write or read failed */
+#define DFU_HOST_ERROR_TIMEOUT      (-2)    /* No response in time */
+#define DFU_HOST_ERROR_RESPONSE     (-3)    /* Malformed response */
+#define DFU_HOST_ERROR_FILE         (-4)    /* Data file cannot be loaded */
+
+/* Address and CRC-32C at the start of Program Data and Verify Data */
+#define DFU_ROW_HEADER_SIZE         (8U)
+
+/* Most commands in flight, see dfu_host_t.window */
+#define DFU_HOST_MAX_WINDOW         (16U)
+
+/* Limits of a .mtbdfu script */
+#define DFU_SCRIPT_MAX_BLOCKS       (8U)
+#define DFU_SCRIPT_MAX_CMDS         (8U)
+#define DFU_SCRIPT_MAX_PATH         (4096U)
+
+/* image_id of an entry without "imageId". Image IDs are the MCUboot image
+ * IDs: 0 proj_cm33_s, 1 proj_cm33_ns, 2 proj_cm55. */
+#define DFU_SCRIPT_NO_IMAGE         (-1)
+#define DFU_SCRIPT_MAX_IMAGE        (31)
+
+/* Bytes of the "nonce" of an entry, SECURE_DECRYPT_NONCE_SIZE */
+#define DFU_SCRIPT_NONCE_SIZE       (8U)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+
+/* Byte stream to the device. read() returns the number of bytes read, 0 on
+ * timeout or a negative value on error. write() returns 0 on success. */
+typedef struct
+{
+    void *context;
+    int (*write)(void *context, const uint8_t data[], size_t length);
+    int (*read)(void *context, uint8_t data[], size_t length, int timeout_ms);
+} dfu_link_t;
+
+/* One command of a command set, for example Send Data repeated 32 times */
+typedef struct
+{
+    uint8_t id;
+    uint32_t data_length;
+    uint32_t repeat;
+} dfu_script_cmd_t;
+
+/* One entry of the "commands" array */
+typedef struct
+{
+    dfu_script_cmd_t cmds[DFU_SCRIPT_MAX_CMDS];
+    size_t cmd_count;
+    char data_file[DFU_SCRIPT_MAX_PATH];    /* Resolved against the script */
+    uint32_t row_length;
+    bool repeat_eof;                        /* Run the set once per row */
+    uint32_t repeat;                        /* Otherwise run it this often */
+    uint32_t timeout_ms;
+    int image_id;                           /* "imageId", DFU_SCRIPT_NO_IMAGE if none */
+    bool has_nonce;                         /* "nonce": the dataFile is encrypted, see dfu_crypt */
+    uint8_t nonce[DFU_SCRIPT_NONCE_SIZE];
+} dfu_script_block_t;
+
+/* A parsed .mtbdfu file */
+typedef struct
+{
+    bool crc;                               /* "Packet Checksum Type" 1 */
+    bool has_product_id;
+    uint32_t product_id;
+    dfu_script_block_t blocks[DFU_SCRIPT_MAX_BLOCKS];
+    size_t block_count;
+} dfu_script_t;
+
+/* Image split into rows of row_size bytes, sorted by address. Bytes that the
+ * HEX file does not cover are 0xFF. An image loaded from an update container
+ * maps its rows from the file and cannot be added to. */
+typedef struct
+{
+    uint32_t row_size;
+    size_t rows;
+    size_t capacity;
+    uint32_t *address;
+    uint8_t *data;
+    uint32_t *crc;                          /* CRC-32C of each row, see dfu_image_seal() */
+    void *mapping;                          /* Mapped update container, or NULL */
+    size_t mapping_size;
+} dfu_image_t;
+
+/* Command sent, response not received yet */
+typedef struct
+{
+    uint8_t command;
+    uint32_t address;
+} dfu_pipeline_entry_t;
+
+typedef struct
+{
+    dfu_pipeline_entry_t entries[DFU_HOST_MAX_WINDOW];
+    uint32_t oldest;
+    uint32_t in_flight;
+    int status;                             /* First failure */
+} dfu_pipeline_t;
+
+/* Host state */
+typedef struct
+{
+    dfu_link_t link;
+    bool crc;                               /* Packets use CRC-16 */
+    int timeout_ms;                         /* Response timeout */
+    uint8_t last_status;                    /* Status of the last response */
+
+    /* Commands sent before waiting for the first response, 0 or 1 to wait
+     * for each response. The device must buffer that many packets. */
+    uint32_t window;
+    /* Payload bytes per packet when sending rows, 0 to follow the script */
+    uint32_t chunk_size;
+    dfu_pipeline_t pipeline;
+
+    /* Bit n selects the entries with "imageId" n, 0 selects all. Entries
+     * without "imageId" always run. */
+    uint32_t images;
+
+    /* Sealed image to program instead of the dataFile of the script, may be
+     * shared by hosts that run in parallel. NULL to load the dataFile. */
+    const dfu_image_t *image;
+    const char *name;                       /* Prefix of error messages, may be NULL */
+
+    /* Called after each row has been sent, may be NULL. With a window of 1,
+     * the responses of the row have been received as well. */
+    void (*row_done)(void *context, size_t row, size_t rows, uint32_t address);
+    void *row_context;
+} dfu_host_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+uint16_t dfu_packet_checksum_host(bool crc, const uint8_t buffer[], size_t length);
+uint32_t dfu_crc32c(const uint8_t data[], size_t length);
+
+size_t dfu_packet_build(bool crc, uint8_t packet[], uint8_t code, const uint8_t data[], size_t length);
+int dfu_host_send(dfu_host_t *host, uint8_t command, const uint8_t data[], size_t length);
+int dfu_host_receive(dfu_host_t *host, uint8_t response[], size_t response_size, size_t *response_length);
+int dfu_host_transfer(dfu_host_t *host, uint8_t command, const uint8_t data[], size_t length,
+                      uint8_t response[], size_t response_size, size_t *response_length);
+
+void dfu_image_init(dfu_image_t *image, uint32_t row_size);
+int dfu_image_add(dfu_image_t *image, uint32_t address, const uint8_t data[], size_t length);
+int dfu_image_load_hex(dfu_image_t *image, const char *path);
+int dfu_image_load_container(dfu_image_t *image, const char *path);
+int dfu_image_load(dfu_image_t *image, const char *path);
+int dfu_image_seal(dfu_image_t *image);
+void dfu_image_free(dfu_image_t *image);
+
+int dfu_script_load(dfu_script_t *script, const char *path);
+int dfu_script_select(const dfu_script_t *script, const char *text, uint32_t *images);
+bool dfu_script_selected(const dfu_script_block_t *block, uint32_t images);
+
+int dfu_host_program(dfu_host_t *host, const dfu_script_t *script, const char *data_file);
+const char *dfu_status_name(int status);
+
+#endif /* DFU_HOST_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,498 @@
+/*******************************************************************************
+* File Name        : dfu_link.c
+*
+* Description      : Links between the DFU host and the device for the host
+*                    tools: any byte stream file descriptor, such as a socket
+*                    or pseudo terminal, serial devices, USB HID devices
+*                    through hidraw and I2C devices through i2c-dev.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/i2c-dev.h>
+#include "dfu_link.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Report size of the DFU USB HID interface, without the report ID */
+#define HID_REPORT_SIZE         (64U)
+
+/* First read of an I2C response, longer responses are read again whole */
+#define I2C_FIRST_READ          (64U)
+
+/* Time between tries while the I2C device does not acknowledge */
+#define I2C_RETRY_US            (1000U)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    int fd;
+} fd_link_t;
+
+/* HID and I2C move whole messages. Only the bytes of the DFU packet are
+ * passed on, the padding after it is dropped. */
+typedef struct
+{
+    int fd;
+    size_t head;
+    size_t tail;
+    size_t packet_left;             /* Bytes of the current packet not passed on yet */
+    uint8_t buffer[DFU_PACKET_MAX_SIZE + HID_REPORT_SIZE];
+} msg_link_t;
+
+/*******************************************************************************
+* Function Name: fd_write
+*******************************************************************************/
+static int fd_write(void *context, const uint8_t data[], size_t length)
+{
+    fd_link_t *fl = context;
+    size_t done = 0U;
+
+    while (done < length)
+    {
+        ssize_t put = write(fl->fd, &data[done], length - done);
+        if ((put < 0) && ((errno == EINTR) || (errno == EAGAIN)))
+        {
+            continue;
+        }
+        if (put <= 0)
+        {
+            return -1;
+        }
+        done += (size_t)put;
+    }
+
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: fd_read
+*******************************************************************************/
+static int fd_read(void *context, uint8_t data[], size_t length, int timeout_ms)
+{
+    fd_link_t *fl = context;
+    struct pollfd pfd = { .fd = fl->fd, .events = POLLIN };
+    ssize_t got;
+
+    if (poll(&pfd, 1, timeout_ms) <= 0)
+    {
+        return 0;
+    }
+    got = read(fl->fd, data, length);
+    if ((got < 0) && ((errno == EINTR) || (errno == EAGAIN)))
+    {
+        got = 0;
+    }
+
+    return (got >= 0) ? (int)got : -1;
+}
+
+/*******************************************************************************
+* Function Name: baud_constant
+*******************************************************************************/
+static speed_t baud_constant(uint32_t baud)
+{
+    speed_t speed = B115200;
+
+    switch (baud)
+    {
+        case 9600U:     speed = B9600; break;
+        case 19200U:    speed = B19200; break;
+        case 38400U:    speed = B38400; break;
+        case 57600U:    speed = B57600; break;
+        case 230400U:   speed = B230400; break;
+    #ifdef B460800
+        case 460800U:   speed = B460800; break;
+    #endif
+    #ifdef B921600
+        case 921600U:   speed = B921600; break;
+    #endif
+    #ifdef B1000000
+        case 1000000U:  speed = B1000000; break;
+    #endif
+        default:        break;
+    }
+
+    return speed;
+}
+
+/*******************************************************************************
+* Function Name: dfu_link_open_fd
+********************************************************************************
+* Summary:
+*  Uses an open byte stream as the link. dfu_link_close() closes it.
+*
+* Return:
+*  0 on success, -1 if out of memory
+*
+*******************************************************************************/
+int dfu_link_open_fd(dfu_link_t *link, int fd)
+{
+    fd_link_t *fl = malloc(sizeof(*fl));
+
+    if (fl == NULL)
+    {
+        return -1;
+    }
+    fl->fd = fd;
+    link->context = fl;
+    link->write = fd_write;
+    link->read = fd_read;
+
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: dfu_link_open_serial
+********************************************************************************
+* Summary:
+*  Opens a serial device in raw mode at the given bit rate. USB CDC devices
+*  ignore the bit rate.
+*
+* Return:
+*  0 on success, -1 on error (reported on stderr)
+*
+*******************************************************************************/
+int dfu_link_open_serial(dfu_link_t *link, const char *path, uint32_t baud)
+{
+    struct termios tio;
+    int fd = open(path, O_RDWR | O_NOCTTY);
+
+    if (fd < 0)
+    {
+        fprintf(stderr, "cannot open %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    if (tcgetattr(fd, &tio) == 0)
+    {
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, baud_constant(baud));
+        cfsetospeed(&tio, baud_constant(baud));
+        tio.c_cc[VMIN] = 0;
+        tio.c_cc[VTIME] = 0;
+        (void)tcsetattr(fd, TCSANOW, &tio);
+    }
+    (void)tcflush(fd, TCIOFLUSH);
+
+    if (dfu_link_open_fd(link, fd) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: packet_size
+********************************************************************************
+* Summary:
+*  Returns the size of the packet at the start of a message, or 0 if the
+*  message does not start with a packet.
+*
+*******************************************************************************/
+static size_t packet_size(const uint8_t message[], size_t length)
+{
+    size_t size = 0U;
+
+    if ((length >= DFU_PACKET_HEADER_SIZE) && (message[0] == DFU_PACKET_SOP))
+    {
+        size = DFU_PACKET_MIN_SIZE + ((size_t)message[2] | ((size_t)message[3] << 8U));
+        size = (size > DFU_PACKET_MAX_SIZE) ? 0U : size;
+    }
+
+    return size;
+}
+
+/*******************************************************************************
+* Function Name: msg_take
+********************************************************************************
+* Summary:
+*  Passes on buffered packet bytes. Once the packet is complete, the rest of
+*  the message is dropped.
+*
+*******************************************************************************/
+static int msg_take(msg_link_t *ml, uint8_t data[], size_t length)
+{
+    size_t take = ml->tail - ml->head;
+
+    take = (take > length) ? length : take;
+    take = (take > ml->packet_left) ? ml->packet_left : take;
+    memcpy(data, &ml->buffer[ml->head], take);
+    ml->head += take;
+    ml->packet_left -= take;
+    if ((ml->packet_left == 0U) || (ml->head == ml->tail))
+    {
+        ml->head = 0U;
+        ml->tail = 0U;
+    }
+
+    return (int)take;
+}
+
+/*******************************************************************************
+* Function Name: hid_write
+********************************************************************************
+* Summary:
+*  Sends a packet in reports of HID_REPORT_SIZE bytes, the last one padded.
+*  The first byte of each write is the report ID, 0 as the interface has
+*  none.
+*
+*******************************************************************************/
+static int hid_write(void *context, const uint8_t data[], size_t length)
+{
+    msg_link_t *ml = context;
+    uint8_t report[HID_REPORT_SIZE + 1U];
+
+    for (size_t offset = 0U; offset < length; offset += HID_REPORT_SIZE)
+    {
+        size_t take = ((length - offset) > HID_REPORT_SIZE) ? HID_REPORT_SIZE : (length - offset);
+
+        memset(report, 0, sizeof(report));
+        memcpy(&report[1], &data[offset], take);
+        if (write(ml->fd, report, sizeof(report)) != (ssize_t)sizeof(report))
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: hid_read
+*******************************************************************************/
+static int hid_read(void *context, uint8_t data[], size_t length, int timeout_ms)
+{
+    msg_link_t *ml = context;
+
+    if (ml->head == ml->tail)
+    {
+        struct pollfd pfd = { .fd = ml->fd, .events = POLLIN };
+        ssize_t got;
+
+        if (poll(&pfd, 1, timeout_ms) <= 0)
+        {
+            return 0;
+        }
+        got = read(ml->fd, ml->buffer, HID_REPORT_SIZE);
+        if (got <= 0)
+        {
+            return (got == 0) ? 0 : -1;
+        }
+        ml->head = 0U;
+        ml->tail = (size_t)got;
+        if (ml->packet_left == 0U)
+        {
+            /* A report that does not start a packet is dropped whole */
+            ml->packet_left = packet_size(ml->buffer, ml->tail);
+            if (ml->packet_left == 0U)
+            {
+                ml->tail = 0U;
+                return 0;
+            }
+        }
+    }
+
+    return msg_take(ml, data, length);
+}
+
+/*******************************************************************************
+* Function Name: i2c_transfer
+********************************************************************************
+* Summary:
+*  Runs one I2C write or read transaction. While the device is busy, it does
+*  not acknowledge its address; the transaction is tried again until
+*  timeout_ms have passed.
+*
+*******************************************************************************/
+static int i2c_transfer(msg_link_t *ml, bool is_read, uint8_t data[], size_t length, int timeout_ms)
+{
+    struct timespec delay = { 0, I2C_RETRY_US * 1000 };
+    long tries = ((long)timeout_ms * 1000L) / (long)I2C_RETRY_US;
+
+    for (;;)
+    {
+        ssize_t done = is_read ? read(ml->fd, data, length) : write(ml->fd, data, length);
+
+        if (done == (ssize_t)length)
+        {
+            return 0;
+        }
+        if ((done >= 0) || ((errno != ENXIO) && (errno != EIO) && (errno != EREMOTEIO) && (errno != EAGAIN)) ||
+            (tries-- <= 0))
+        {
+            return -1;
+        }
+        (void)nanosleep(&delay, NULL);
+    }
+}
+
+/*******************************************************************************
+* Function Name: i2c_write
+*******************************************************************************/
+static int i2c_write(void *context, const uint8_t data[], size_t length)
+{
+    msg_link_t *ml = context;
+
+    return i2c_transfer(ml, false, (uint8_t *)data, length, DFU_LINK_I2C_WRITE_TIMEOUT_MS);
+}
+
+/*******************************************************************************
+* Function Name: i2c_read
+********************************************************************************
+* Summary:
+*  Reads a response. Every read transaction starts at the beginning of the
+*  response, so a response longer than the first read is read again whole.
+*
+*******************************************************************************/
+static int i2c_read(void *context, uint8_t data[], size_t length, int timeout_ms)
+{
+    msg_link_t *ml = context;
+
+    if (ml->head == ml->tail)
+    {
+        size_t size;
+
+        if (i2c_transfer(ml, true, ml->buffer, I2C_FIRST_READ, timeout_ms) != 0)
+        {
+            return (errno == ENXIO) || (errno == EIO) || (errno == EREMOTEIO) ? 0 : -1;
+        }
+        size = packet_size(ml->buffer, I2C_FIRST_READ);
+        if (size == 0U)
+        {
+            /* Over-read bytes, the response is not ready yet */
+            return 0;
+        }
+        if ((size > I2C_FIRST_READ) && (i2c_transfer(ml, true, ml->buffer, size, timeout_ms) != 0))
+        {
+            return -1;
+        }
+        ml->head = 0U;
+        ml->tail = (size > I2C_FIRST_READ) ? size : I2C_FIRST_READ;
+        ml->packet_left = size;
+    }
+
+    return msg_take(ml, data, length);
+}
+
+/*******************************************************************************
+* Function Name: msg_link_open
+*******************************************************************************/
+static int msg_link_open(dfu_link_t *link, int fd)
+{
+    msg_link_t *ml = calloc(1U, sizeof(*ml));
+
+    if (ml == NULL)
+    {
+        close(fd);
+        return -1;
+    }
+    ml->fd = fd;
+    link->context = ml;
+
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: dfu_link_open_hidraw
+********************************************************************************
+* Summary:
+*  Opens the hidraw node of the DFU USB HID interface.
+*
+* Return:
+*  0 on success, -1 on error (reported on stderr)
+*
+*******************************************************************************/
+int dfu_link_open_hidraw(dfu_link_t *link, const char *path)
+{
+    int fd = open(path, O_RDWR);
+
+    if ((fd < 0) || (msg_link_open(link, fd) != 0))
+    {
+        fprintf(stderr, "cannot open %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    link->write = hid_write;
+    link->read = hid_read;
+
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: dfu_link_open_i2c
+********************************************************************************
+* Summary:
+*  Opens an i2c-dev adapter, such as /dev/i2c-1, to talk to the device at the
+*  given 7-bit address. The bus speed is set by the adapter.
+*
+* Return:
+*  0 on success, -1 on error (reported on stderr)
+*
+*******************************************************************************/
+int dfu_link_open_i2c(dfu_link_t *link, const char *path, uint8_t address)
+{
+    int fd = open(path, O_RDWR);
+
+    if ((fd < 0) || (ioctl(fd, I2C_SLAVE, (unsigned long)address) < 0) || (msg_link_open(link, fd) != 0))
+    {
+        fprintf(stderr, "cannot open %s at 0x%02X: %s\n", path, address, strerror(errno));
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        return -1;
+    }
+    link->write = i2c_write;
+    link->read = i2c_read;
+
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: dfu_link_close
+*******************************************************************************/
+void dfu_link_close(dfu_link_t *link)
+{
+    /* Every link context starts with the file descriptor */
+    int *fd = link->context;
+
+    if (fd != NULL)
+    {
+        close(*fd);
+        free(fd);
+        link->context = NULL;
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,54 @@
+/*******************************************************************************
+* File Name        : dfu_link.h
+*
+* Description      : Links between the DFU host and the device for the host
+*                    tools: byte streams, serial, USB HID (hidraw) and I2C
+*                    (i2c-dev).
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef DFU_LINK_H
+#define DFU_LINK_H
+
+#include <stdint.h>
+#include "dfu_host.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Default 7-bit address of the DFU I2C interface, see proj_cm33_ns/Makefile */
+#define DFU_LINK_I2C_ADDRESS            (0x35U)
+
+/* Time the I2C device may refuse a command while it is busy */
+#define DFU_LINK_I2C_WRITE_TIMEOUT_MS   (1000)
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+int dfu_link_open_fd(dfu_link_t *link, int fd);
+int dfu_link_open_serial(dfu_link_t *link, const char *path, uint32_t baud);
+int dfu_link_open_hidraw(dfu_link_t *link, const char *path);
+int dfu_link_open_i2c(dfu_link_t *link, const char *path, uint8_t address);
+void dfu_link_close(dfu_link_t *link);
+
+#endif /* DFU_LINK_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,132 @@
+/*******************************************************************************
+* File Name        : dfu_report.c
+*
+* Description      : Result of one timed DFU update and its JSON form.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "dfu_report.h"
+
+/*******************************************************************************
+* Function Name: dfu_report_init
+*******************************************************************************/
+void dfu_report_init(dfu_report_t *report, const char *mode, const char *transport, uint32_t row_size)
+{
+    memset(report, 0, sizeof(*report));
+    report->mode = mode;
+    report->transport = transport;
+    report->row_size = row_size;
+}
+
+/*******************************************************************************
+* Function Name: dfu_report_add_row
+********************************************************************************
+* Summary:
+*  Records the end time of the next row.
+*
+* Return:
+*  0 on success, -1 if out of memory
+*
+*******************************************************************************/
+int dfu_report_add_row(dfu_report_t *report, uint64_t end_ns)
+{
+    if (report->rows == report->capacity)
+    {
+        size_t capacity = (report->capacity == 0U) ? 1024U : (report->capacity * 2U);
+        uint64_t *rows = realloc(report->row_end_ns, capacity * sizeof(rows[0]));
+
+        if (rows == NULL)
+        {
+            return -1;
+        }
+        report->row_end_ns = rows;
+        report->capacity = capacity;
+    }
+    report->row_end_ns[report->rows++] = end_ns;
+
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: compare_u64
+*******************************************************************************/
+static int compare_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+/*******************************************************************************
+* Function Name: dfu_report_write_json
+********************************************************************************
+* Summary:
+*  Writes the report as one JSON object. The time of a row is the time since
+*  the end of the previous row; the first row is reported as the time to
+*  first row instead and is not part of the percentiles.
+*
+*******************************************************************************/
+void dfu_report_write_json(FILE *out, const dfu_report_t *report)
+{
+    double total_s = (double)report->total_ns / 1e9;
+    double bytes = (double)report->rows * report->row_size;
+    double p50_ms = 0.0;
+    double p99_ms = 0.0;
+    size_t count = (report->rows > 1U) ? (report->rows - 1U) : 0U;
+    uint64_t *row_ns = (count != 0U) ? malloc(count * sizeof(row_ns[0])) : NULL;
+
+    if (row_ns != NULL)
+    {
+        for (size_t i = 0U; i < count; i++)
+        {
+            row_ns[i] = report->row_end_ns[i + 1U] - report->row_end_ns[i];
+        }
+        qsort(row_ns, count, sizeof(row_ns[0]), compare_u64);
+        /* Nearest rank */
+        p50_ms = (double)row_ns[((count * 50U) + 99U) / 100U - 1U] / 1e6;
+        p99_ms = (double)row_ns[((count * 99U) + 99U) / 100U - 1U] / 1e6;
+        free(row_ns);
+    }
+
+    fprintf(out,
+            "{\"mode\": \"%s\", \"transport\": \"%s\", \"status\": %d, \"rows\": %zu, \"bytes\": %.0f, "
+            "\"total_s\": %.6f, \"mb_per_s\": %.6f, \"first_row_ms\": %.3f, \"row_p50_ms\": %.3f, "
+            "\"row_p99_ms\": %.3f, \"wall_s\": %.3f}",
+            report->mode, report->transport, report->status, report->rows, bytes, total_s,
+            (total_s > 0.0) ? (bytes / 1e6 / total_s) : 0.0,
+            (report->rows != 0U) ? ((double)report->row_end_ns[0] / 1e6) : 0.0, p50_ms, p99_ms,
+            (double)report->wall_ns / 1e9);
+}
+
+/*******************************************************************************
+* Function Name: dfu_report_free
+*******************************************************************************/
+void dfu_report_free(dfu_report_t *report)
+{
+    free(report->row_end_ns);
+    report->row_end_ns = NULL;
+    report->rows = 0U;
+    report->capacity = 0U;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,60 @@
+/*******************************************************************************
+* File Name        : dfu_report.h
+*
+* Description      : Result of one timed DFU update and its JSON form, shared
+*                    by the DFU simulator and the benchmark.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef DFU_REPORT_H
+#define DFU_REPORT_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+
+/* All times in ns from the start of the update, that is from Enter DFU */
+typedef struct
+{
+    const char *mode;               /* "sim" or "hardware" */
+    const char *transport;
+    int status;                     /* 0, the failing status or DFU_HOST_ERROR_xxx */
+    uint32_t row_size;
+    uint64_t total_ns;              /* Until Exit DFU */
+    uint64_t wall_ns;               /* Host time the run took */
+    size_t rows;
+    uint64_t *row_end_ns;           /* End of each row */
+    size_t capacity;
+} dfu_report_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void dfu_report_init(dfu_report_t *report, const char *mode, const char *transport, uint32_t row_size);
+int dfu_report_add_row(dfu_report_t *report, uint64_t end_ns);
+void dfu_report_write_json(FILE *out, const dfu_report_t *report);
+void dfu_report_free(dfu_report_t *report);
+
+#endif /* DFU_REPORT_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,373 @@
+/*******************************************************************************
+* File Name        : dfu_session.c
+*
+* Description      : Recorded DFU sessions: capture files in the format of
+*                    proj_cm33_ns/dfu_record.h and a link wrapper that
+*                    records the packets a DFU host sends and receives.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "dfu_session.h"
+
+/*******************************************************************************
+* Function Name: put_u16
+*******************************************************************************/
+static void put_u16(uint8_t dst[], uint32_t value)
+{
+    dst[0] = (uint8_t)value;
+    dst[1] = (uint8_t)(value >> 8U);
+}
+
+/*******************************************************************************
+* Function Name: put_u32
+*******************************************************************************/
+static void put_u32(uint8_t dst[], uint32_t value)
+{
+    put_u16(&dst[0], value);
+    put_u16(&dst[2], value >> 16U);
+}
+
+/*******************************************************************************
+* Function Name: get_u16
+*******************************************************************************/
+static uint32_t get_u16(const uint8_t src[])
+{
+    return (uint32_t)src[0] | ((uint32_t)src[1] << 8U);
+}
+
+/*******************************************************************************
+* Function Name: get_u32
+*******************************************************************************/
+static uint32_t get_u32(const uint8_t src[])
+{
+    return get_u16(&src[0]) | (get_u16(&src[2]) << 16U);
+}
+
+/*******************************************************************************
+* Function Name: dfu_session_init
+*******************************************************************************/
+void dfu_session_init(dfu_session_t *session, uint16_t source)
+{
+    memset(session, 0, sizeof(*session));
+    session->source = source;
+}
+
+/*******************************************************************************
+* Function Name: dfu_session_add
+********************************************************************************
+* Summary:
+*  Appends a copy of a packet.
+*
+* Return:
+*  0 on success, -1 if out of memory or the packet is too long
+*
+*******************************************************************************/
+int dfu_session_add(dfu_session_t *session, uint32_t time_us, uint8_t direction, uint8_t transport,
+                    const uint8_t packet[], size_t length)
+{
+    dfu_session_entry_t *entry;
+
+    if (length > UINT16_MAX)
+    {
+        return -1;
+    }
+    if (session->count == session->capacity)
+    {
+        size_t capacity = (session->capacity == 0U) ? 256U : (session->capacity * 2U);
+        dfu_session_entry_t *entries = realloc(session->entries, capacity * sizeof(entries[0]));
+
+        if (entries == NULL)
+        {
+            return -1;
+        }
+        session->entries = entries;
+        session->capacity = capacity;
+    }
+
+    entry = &session->entries[session->count];
+    entry->packet = malloc((length != 0U) ? length : 1U);
+    if (entry->packet == NULL)
+    {
+        return -1;
+    }
+    memcpy(entry->packet, packet, length);
+    entry->time_us = time_us;
+    entry->direction = direction;
+    entry->transport = transport;
+    entry->length = (uint16_t)length;
+    session->count++;
+
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: dfu_session_load
+********************************************************************************
+* Summary:
+*  Reads a capture file.
+*
+* Return:
+*  0 on success, -1 on error (reported on stderr)
+*
+*******************************************************************************/
+int dfu_session_load(dfu_session_t *session, const char *path)
+{
+    uint8_t header[DFU_RECORD_FILE_HEADER_SIZE];
+    uint8_t packet[UINT16_MAX];
+    uint32_t count;
+    int result = 0;
+    FILE *in = fopen(path, "rb");
+
+    if (in == NULL)
+    {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    if ((fread(header, 1U, sizeof(header), in) != sizeof(header)) ||
+        (get_u32(&header[0]) != DFU_RECORD_FILE_MAGIC) || (get_u16(&header[4]) != DFU_RECORD_FILE_VERSION))
+    {
+        fprintf(stderr, "%s: not a DFU session capture\n", path);
+        fclose(in);
+        return -1;
+    }
+    dfu_session_init(session, (uint16_t)get_u16(&header[6]));
+    count = get_u32(&header[8]);
+    session->dropped = get_u32(&header[12]);
+
+    for (uint32_t i = 0U; (i < count) && (result == 0); i++)
+    {
+        uint8_t entry[DFU_RECORD_ENTRY_SIZE];
+        size_t length;
+
+        if (fread(entry, 1U, sizeof(entry), in) != sizeof(entry))
+        {
+            result = -1;
+        }
+        else
+        {
+            length = get_u16(&entry[4]);
+            if ((fread(packet, 1U, length, in) != length) ||
+                (dfu_session_add(session, get_u32(&entry[0]), entry[6], entry[7], packet, length) != 0))
+            {
+                result = -1;
+            }
+        }
+    }
+    if (result != 0)
+    {
+        fprintf(stderr, "%s: truncated after %zu packets\n", path, session->count);
+        dfu_session_free(session);
+    }
+    fclose(in);
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: dfu_session_save
+********************************************************************************
+* Summary:
+*  Writes a capture file.
+*
+* Return:
+*  0 on success, -1 on error (reported on stderr)
+*
+*******************************************************************************/
+int dfu_session_save(const dfu_session_t *session, const char *path)
+{
+    uint8_t header[DFU_RECORD_FILE_HEADER_SIZE];
+    bool ok;
+    FILE *out = fopen(path, "wb");
+
+    if (out == NULL)
+    {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    put_u32(&header[0], DFU_RECORD_FILE_MAGIC);
+    put_u16(&header[4], DFU_RECORD_FILE_VERSION);
+    put_u16(&header[6], session->source);
+    put_u32(&header[8], (uint32_t)session->count);
+    put_u32(&header[12], session->dropped);
+    ok = (fwrite(header, 1U, sizeof(header), out) == sizeof(header));
+
+    for (size_t i = 0U; ok && (i < session->count); i++)
+    {
+        const dfu_session_entry_t *entry = &session->entries[i];
+        uint8_t head[DFU_RECORD_ENTRY_SIZE];
+
+        put_u32(&head[0], entry->time_us);
+        put_u16(&head[4], entry->length);
+        head[6] = entry->direction;
+        head[7] = entry->transport;
+        ok = (fwrite(head, 1U, sizeof(head), out) == sizeof(head)) &&
+             (fwrite(entry->packet, 1U, entry->length, out) == entry->length);
+    }
+
+    ok = (fclose(out) == 0) && ok;
+    if (!ok)
+    {
+        fprintf(stderr, "%s: write failed\n", path);
+    }
+
+    return ok ? 0 : -1;
+}
+
+/*******************************************************************************
+* Function Name: dfu_session_free
+*******************************************************************************/
+void dfu_session_free(dfu_session_t *session)
+{
+    for (size_t i = 0U; i < session->count; i++)
+    {
+        free(session->entries[i].packet);
+    }
+    free(session->entries);
+    session->entries = NULL;
+    session->count = 0U;
+    session->capacity = 0U;
+}
+
+/*******************************************************************************
+* Function Name: recorder_time_us
+*******************************************************************************/
+static uint32_t recorder_time_us(const dfu_session_recorder_t *recorder)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)(((((uint64_t)now.tv_sec * 1000000000U) + (uint64_t)now.tv_nsec) - recorder->start_ns) /
+                      1000U);
+}
+
+/*******************************************************************************
+* Function Name: recorder_feed
+********************************************************************************
+* Summary:
+*  Assembles packets from the bytes of one direction and records each
+*  complete packet. Bytes that cannot start a packet are skipped.
+*
+*******************************************************************************/
+static void recorder_feed(dfu_session_recorder_t *recorder, dfu_session_stream_t *stream, uint8_t direction,
+                          const uint8_t data[], size_t length)
+{
+    for (size_t i = 0U; i < length; i++)
+    {
+        size_t size = 0U;
+
+        if ((stream->length == 0U) && (data[i] != DFU_PACKET_SOP))
+        {
+            continue;
+        }
+        stream->packet[stream->length++] = data[i];
+
+        if (stream->length >= DFU_PACKET_HEADER_SIZE)
+        {
+            size = DFU_PACKET_MIN_SIZE + get_u16(&stream->packet[2]);
+            if (size > DFU_PACKET_MAX_SIZE)
+            {
+                /* Not a packet header */
+                stream->length = 0U;
+            }
+            else if (stream->length == size)
+            {
+                if (dfu_session_add(recorder->session, recorder_time_us(recorder), direction, 0U,
+                                    stream->packet, size) != 0)
+                {
+                    recorder->status = -1;
+                }
+                stream->length = 0U;
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: recorder_write
+*******************************************************************************/
+static int recorder_write(void *context, const uint8_t data[], size_t length)
+{
+    dfu_session_recorder_t *recorder = context;
+    int result = recorder->inner.write(recorder->inner.context, data, length);
+
+    if (result == 0)
+    {
+        recorder_feed(recorder, &recorder->sent, DFU_RECORD_TO_DEVICE, data, length);
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: recorder_read
+*******************************************************************************/
+static int recorder_read(void *context, uint8_t data[], size_t length, int timeout_ms)
+{
+    dfu_session_recorder_t *recorder = context;
+    int got = recorder->inner.read(recorder->inner.context, data, length, timeout_ms);
+
+    if (got > 0)
+    {
+        recorder_feed(recorder, &recorder->received, DFU_RECORD_FROM_DEVICE, data, (size_t)got);
+    }
+
+    return got;
+}
+
+/*******************************************************************************
+* Function Name: dfu_session_record_start
+********************************************************************************
+* Summary:
+*  Wraps the link so that every packet sent or received is added to the
+*  session, timed from now. Call dfu_session_record_stop() before the link is
+*  closed.
+*
+*******************************************************************************/
+void dfu_session_record_start(dfu_session_recorder_t *recorder, dfu_link_t *link, dfu_session_t *session)
+{
+    struct timespec now;
+
+    memset(recorder, 0, sizeof(*recorder));
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    recorder->inner = *link;
+    recorder->session = session;
+    recorder->start_ns = ((uint64_t)now.tv_sec * 1000000000U) + (uint64_t)now.tv_nsec;
+
+    link->context = recorder;
+    link->write = recorder_write;
+    link->read = recorder_read;
+}
+
+/*******************************************************************************
+* Function Name: dfu_session_record_stop
+*******************************************************************************/
+void dfu_session_record_stop(dfu_session_recorder_t *recorder, dfu_link_t *link)
+{
+    *link = recorder->inner;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,91 @@
+/*******************************************************************************
+* File Name        : dfu_session.h
+*
+* Description      : Recorded DFU sessions: capture files in the format of
+*                    proj_cm33_ns/dfu_record.h and a link wrapper that
+*                    records the packets a DFU host sends and receives.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef DFU_SESSION_H
+#define DFU_SESSION_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "dfu_host.h"
+#include "dfu_record.h"
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+
+/* One recorded packet */
+typedef struct
+{
+    uint32_t time_us;                       /* Since the start of the recording */
+    uint8_t direction;                      /* DFU_RECORD_TO_DEVICE or DFU_RECORD_FROM_DEVICE */
+    uint8_t transport;                      /* cy_en_dfu_transport_t, 0 if recorded by the host */
+    uint16_t length;
+    uint8_t *packet;
+} dfu_session_entry_t;
+
+typedef struct
+{
+    uint16_t source;                        /* DFU_RECORD_SOURCE_xxx */
+    uint32_t dropped;                       /* Packets missing at the end */
+    size_t count;
+    size_t capacity;
+    dfu_session_entry_t *entries;
+} dfu_session_t;
+
+/* Packet being assembled from the byte stream of one direction */
+typedef struct
+{
+    uint8_t packet[DFU_PACKET_MAX_SIZE];
+    size_t length;
+} dfu_session_stream_t;
+
+/* Link wrapper installed by dfu_session_record_start() */
+typedef struct
+{
+    dfu_link_t inner;
+    dfu_session_t *session;
+    uint64_t start_ns;
+    dfu_session_stream_t sent;
+    dfu_session_stream_t received;
+    int status;                             /* -1 once a packet could not be stored */
+} dfu_session_recorder_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void dfu_session_init(dfu_session_t *session, uint16_t source);
+int dfu_session_add(dfu_session_t *session, uint32_t time_us, uint8_t direction, uint8_t transport,
+                    const uint8_t packet[], size_t length);
+int dfu_session_load(dfu_session_t *session, const char *path);
+int dfu_session_save(const dfu_session_t *session, const char *path);
+void dfu_session_free(dfu_session_t *session);
+
+void dfu_session_record_start(dfu_session_recorder_t *recorder, dfu_link_t *link, dfu_session_t *session);
+void dfu_session_record_stop(dfu_session_recorder_t *recorder, dfu_link_t *link);
+
+#endif /* DFU_SESSION_H */
+
+/* [] END OF FILE */
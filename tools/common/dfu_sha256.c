@@ -0,0 +1,218 @@
+/*******************************************************************************
+* File Name        : dfu_sha256.c
+*
+* Description      : SHA-256 (FIPS 180-4) and HMAC-SHA256 (RFC 2104) for the
+*                    host tools, see dfu_sha256.h. Not hardened against
+*                    timing attacks, the device side uses mbedtls.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#include <string.h>
+#include "dfu_sha256.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define SHA256_ROTR(x, n)           (((x) >> (n)) | ((x) << (32U - (n))))
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static const uint32_t sha256_k[64] =
+{
+    0x428A2F98UL, 0x71374491UL, 0xB5C0FBCFUL, 0xE9B5DBA5UL, 0x3956C25BUL, 0x59F111F1UL, 0x923F82A4UL, 0xAB1C5ED5UL,
+    0xD807AA98UL, 0x12835B01UL, 0x243185BEUL, 0x550C7DC3UL, 0x72BE5D74UL, 0x80DEB1FEUL, 0x9BDC06A7UL, 0xC19BF174UL,
+    0xE49B69C1UL, 0xEFBE4786UL, 0x0FC19DC6UL, 0x240CA1CCUL, 0x2DE92C6FUL, 0x4A7484AAUL, 0x5CB0A9DCUL, 0x76F988DAUL,
+    0x983E5152UL, 0xA831C66DUL, 0xB00327C8UL, 0xBF597FC7UL, 0xC6E00BF3UL, 0xD5A79147UL, 0x06CA6351UL, 0x14292967UL,
+    0x27B70A85UL, 0x2E1B2138UL, 0x4D2C6DFCUL, 0x53380D13UL, 0x650A7354UL, 0x766A0ABBUL, 0x81C2C92EUL, 0x92722C85UL,
+    0xA2BFE8A1UL, 0xA81A664BUL, 0xC24B8B70UL, 0xC76C51A3UL, 0xD192E819UL, 0xD6990624UL, 0xF40E3585UL, 0x106AA070UL,
+    0x19A4C116UL, 0x1E376C08UL, 0x2748774CUL, 0x34B0BCB5UL, 0x391C0CB3UL, 0x4ED8AA4AUL, 0x5B9CCA4FUL, 0x682E6FF3UL,
+    0x748F82EEUL, 0x78A5636FUL, 0x84C87814UL, 0x8CC70208UL, 0x90BEFFFAUL, 0xA4506CEBUL, 0xBEF9A3F7UL, 0xC67178F2UL
+};
+
+/*******************************************************************************
+* Function Name: sha256_block
+********************************************************************************
+* Summary:
+*  Hashes one block of DFU_SHA256_BLOCK_SIZE bytes into the state.
+*
+*******************************************************************************/
+static void sha256_block(uint32_t state[], const uint8_t block[])
+{
+    uint32_t w[64];
+    uint32_t v[8];
+
+    for (uint32_t i = 0U; i < 16U; i++)
+    {
+        w[i] = ((uint32_t)block[4U * i] << 24U) | ((uint32_t)block[(4U * i) + 1U] << 16U) |
+               ((uint32_t)block[(4U * i) + 2U] << 8U) | (uint32_t)block[(4U * i) + 3U];
+    }
+    for (uint32_t i = 16U; i < 64U; i++)
+    {
+        uint32_t s0 = SHA256_ROTR(w[i - 15U], 7U) ^ SHA256_ROTR(w[i - 15U], 18U) ^ (w[i - 15U] >> 3U);
+        uint32_t s1 = SHA256_ROTR(w[i - 2U], 17U) ^ SHA256_ROTR(w[i - 2U], 19U) ^ (w[i - 2U] >> 10U);
+
+        w[i] = w[i - 16U] + s0 + w[i - 7U] + s1;
+    }
+
+    memcpy(v, state, sizeof(v));
+    for (uint32_t i = 0U; i < 64U; i++)
+    {
+        uint32_t s1 = SHA256_ROTR(v[4], 6U) ^ SHA256_ROTR(v[4], 11U) ^ SHA256_ROTR(v[4], 25U);
+        uint32_t ch = (v[4] & v[5]) ^ ((~v[4]) & v[6]);
+        uint32_t t1 = v[7] + s1 + ch + sha256_k[i] + w[i];
+        uint32_t s0 = SHA256_ROTR(v[0], 2U) ^ SHA256_ROTR(v[0], 13U) ^ SHA256_ROTR(v[0], 22U);
+        uint32_t maj = (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
+
+        memmove(&v[1], &v[0], 7U * sizeof(v[0]));
+        v[4] += t1;
+        v[0] = t1 + s0 + maj;
+    }
+    for (uint32_t i = 0U; i < 8U; i++)
+    {
+        state[i] += v[i];
+    }
+}
+
+/*******************************************************************************
+* Function Name: dfu_sha256_init
+*******************************************************************************/
+void dfu_sha256_init(dfu_sha256_t *sha)
+{
+    static const uint32_t initial[8] =
+    {
+        0x6A09E667UL, 0xBB67AE85UL, 0x3C6EF372UL, 0xA54FF53AUL, 0x510E527FUL, 0x9B05688CUL, 0x1F83D9ABUL, 0x5BE0CD19UL
+    };
+
+    memcpy(sha->state, initial, sizeof(initial));
+    sha->length = 0U;
+}
+
+/*******************************************************************************
+* Function Name: dfu_sha256_update
+*******************************************************************************/
+void dfu_sha256_update(dfu_sha256_t *sha, const uint8_t data[], size_t length)
+{
+    for (size_t i = 0U; i < length; i++)
+    {
+        sha->block[sha->length % DFU_SHA256_BLOCK_SIZE] = data[i];
+        sha->length++;
+        if ((sha->length % DFU_SHA256_BLOCK_SIZE) == 0U)
+        {
+            sha256_block(sha->state, sha->block);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: dfu_sha256_finish
+********************************************************************************
+* Summary:
+*  Pads the message with its length in bits and writes the DFU_SHA256_SIZE
+*  bytes of digest.
+*
+*******************************************************************************/
+void dfu_sha256_finish(dfu_sha256_t *sha, uint8_t digest[])
+{
+    uint64_t bits = sha->length * 8U;
+    uint8_t pad = 0x80U;
+    uint8_t length[8];
+
+    dfu_sha256_update(sha, &pad, 1U);
+    pad = 0x00U;
+    while ((sha->length % DFU_SHA256_BLOCK_SIZE) != (DFU_SHA256_BLOCK_SIZE - sizeof(length)))
+    {
+        dfu_sha256_update(sha, &pad, 1U);
+    }
+    for (uint32_t i = 0U; i < sizeof(length); i++)
+    {
+        length[i] = (uint8_t)(bits >> (56U - (8U * i)));
+    }
+    dfu_sha256_update(sha, length, sizeof(length));
+
+    for (uint32_t i = 0U; i < 8U; i++)
+    {
+        digest[4U * i] = (uint8_t)(sha->state[i] >> 24U);
+        digest[(4U * i) + 1U] = (uint8_t)(sha->state[i] >> 16U);
+        digest[(4U * i) + 2U] = (uint8_t)(sha->state[i] >> 8U);
+        digest[(4U * i) + 3U] = (uint8_t)sha->state[i];
+    }
+}
+
+/*******************************************************************************
+* Function Name: dfu_sha256
+*******************************************************************************/
+int dfu_sha256(const uint8_t data[], size_t length, uint8_t digest[])
+{
+    dfu_sha256_t sha;
+
+    dfu_sha256_init(&sha);
+    dfu_sha256_update(&sha, data, length);
+    dfu_sha256_finish(&sha, digest);
+
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: dfu_hmac_sha256
+********************************************************************************
+* Summary:
+*  HMAC-SHA256 of data with key. A key longer than a block is hashed first.
+*
+*******************************************************************************/
+int dfu_hmac_sha256(const uint8_t key[], size_t key_length, const uint8_t data[], size_t length, uint8_t mac[])
+{
+    uint8_t pad[DFU_SHA256_BLOCK_SIZE] = { 0U };
+    uint8_t inner[DFU_SHA256_SIZE];
+    dfu_sha256_t sha;
+
+    if (key_length > DFU_SHA256_BLOCK_SIZE)
+    {
+        (void)dfu_sha256(key, key_length, pad);
+    }
+    else
+    {
+        memcpy(pad, key, key_length);
+    }
+
+    for (uint32_t i = 0U; i < DFU_SHA256_BLOCK_SIZE; i++)
+    {
+        pad[i] ^= 0x36U;
+    }
+    dfu_sha256_init(&sha);
+    dfu_sha256_update(&sha, pad, sizeof(pad));
+    dfu_sha256_update(&sha, data, length);
+    dfu_sha256_finish(&sha, inner);
+
+    for (uint32_t i = 0U; i < DFU_SHA256_BLOCK_SIZE; i++)
+    {
+        pad[i] ^= (uint8_t)(0x36U ^ 0x5CU);
+    }
+    dfu_sha256_init(&sha);
+    dfu_sha256_update(&sha, pad, sizeof(pad));
+    dfu_sha256_update(&sha, inner, sizeof(inner));
+    dfu_sha256_finish(&sha, mac);
+
+    memset(pad, 0, sizeof(pad));
+
+    return 0;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,62 @@
+/*******************************************************************************
+* File Name        : dfu_sha256.h
+*
+* Description      : SHA-256 and HMAC-SHA256 for the host tools: the digest
+*                    and the keyed MAC of the validated-image cache
+*                    (shared/include/boot_cache.h).
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef DFU_SHA256_H
+#define DFU_SHA256_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define DFU_SHA256_SIZE             (32U)
+#define DFU_SHA256_BLOCK_SIZE       (64U)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t state[8];
+    uint64_t length;                        /* Bytes hashed so far */
+    uint8_t block[DFU_SHA256_BLOCK_SIZE];
+} dfu_sha256_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void dfu_sha256_init(dfu_sha256_t *sha);
+void dfu_sha256_update(dfu_sha256_t *sha, const uint8_t data[], size_t length);
+void dfu_sha256_finish(dfu_sha256_t *sha, uint8_t digest[]);
+
+/* One call digest and HMAC, both return 0 like their mbedtls counterparts */
+int dfu_sha256(const uint8_t data[], size_t length, uint8_t digest[]);
+int dfu_hmac_sha256(const uint8_t key[], size_t key_length, const uint8_t data[], size_t length, uint8_t mac[]);
+
+#endif /* DFU_SHA256_H */
+
+/* [] END OF FILE */
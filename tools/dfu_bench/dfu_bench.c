@@ -0,0 +1,632 @@
+/*******************************************************************************
+* File Name        : dfu_bench.c
+*
+* Description      : DFU throughput benchmark. Generates synthetic images of
+*                    several sizes, fill ratios and kinds of content, runs a
+*                    full update of each one and writes the results as JSON.
+*
+*                    Without -d, every update runs in the DFU simulator
+*                    (dfu_sim). With -d, the updates go to the kit through
+*                    each given serial device.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+/* mkdtemp() */
+#define _XOPEN_SOURCE 700
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "dfu_host.h"
+#include "dfu_link.h"
+#include "dfu_report.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define ROW_SIZE                (0x200U)
+#define BLOCK_SIZE              (0x1000U)   /* Granularity of the fill ratio */
+#define SLOT_SIZE               (0x240000U)
+#define SIM_ADDRESS             (0x60340000U)
+
+#define MAX_LIST                (8U)
+#define MAX_DEVICES             (8U)
+#define DEFAULT_BAUD            (115200U)
+#define DEFAULT_RESTART_S       (5U)
+#define RESPONSE_TIMEOUT_MS     (0x600)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef enum
+{
+    KIND_RANDOM,    /* Incompressible */
+    KIND_CODE,      /* Words from a small set, compresses like firmware */
+    KIND_ZERO,      /* Compresses to nothing */
+    KIND_COUNT
+} image_kind_t;
+
+typedef struct
+{
+    char name[32];
+    const char *path;
+    uint32_t baud;
+} device_t;
+
+typedef struct
+{
+    dfu_report_t report;
+    uint64_t start_ns;
+} device_run_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static const char *const kind_names[KIND_COUNT] = { "random", "code", "zero" };
+
+/* Words of KIND_CODE, picked at random */
+static const uint32_t code_words[16] =
+{
+    0x4770BF00U, 0xB5104604U, 0xF8D3E92DU, 0x68DB4B03U, 0x2000BD10U, 0x0000E7FEU, 0x46204601U, 0xF0004628U,
+    0xBD70BF00U, 0x60182301U, 0x3B01D1FBU, 0xE0014630U, 0x7A1B4B02U, 0xF7FF4610U, 0x0800E000U, 0x60000000U,
+};
+
+static char work_dir[64];
+
+/*******************************************************************************
+* Function Name: now_ns
+*******************************************************************************/
+static uint64_t now_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000U) + (uint64_t)now.tv_nsec;
+}
+
+/*******************************************************************************
+* Function Name: xorshift32
+*******************************************************************************/
+static uint32_t xorshift32(uint32_t *state)
+{
+    uint32_t x = *state;
+
+    x ^= x << 13U;
+    x ^= x >> 17U;
+    x ^= x << 5U;
+    *state = x;
+
+    return x;
+}
+
+/*******************************************************************************
+* Function Name: parse_list
+********************************************************************************
+* Summary:
+*  Parses a comma separated list of numbers.
+*
+* Return:
+*  The number of entries, 0 on error
+*
+*******************************************************************************/
+static size_t parse_list(const char *text, uint32_t values[])
+{
+    size_t count = 0U;
+    char *end;
+
+    while ((count < MAX_LIST) && (*text != '\0'))
+    {
+        values[count++] = (uint32_t)strtoul(text, &end, 0);
+        if ((end == text) || ((*end != ',') && (*end != '\0')))
+        {
+            return 0U;
+        }
+        text = (*end == ',') ? (end + 1) : end;
+    }
+
+    return count;
+}
+
+/*******************************************************************************
+* Function Name: parse_kinds
+*******************************************************************************/
+static size_t parse_kinds(const char *text, uint32_t kinds[])
+{
+    size_t count = 0U;
+
+    while ((count < MAX_LIST) && (*text != '\0'))
+    {
+        size_t length = strcspn(text, ",");
+        uint32_t kind;
+
+        for (kind = 0U; kind < KIND_COUNT; kind++)
+        {
+            if ((strlen(kind_names[kind]) == length) && (strncmp(text, kind_names[kind], length) == 0))
+            {
+                break;
+            }
+        }
+        if (kind == KIND_COUNT)
+        {
+            return 0U;
+        }
+        kinds[count++] = kind;
+        text += length + ((text[length] == ',') ? 1U : 0U);
+    }
+
+    return count;
+}
+
+/*******************************************************************************
+* Function Name: parse_device
+********************************************************************************
+* Summary:
+*  Parses name=path[@baud], for example uart=/dev/ttyUSB0@115200.
+*
+*******************************************************************************/
+static bool parse_device(const char *text, device_t *device)
+{
+    const char *path = strchr(text, '=');
+    char *baud;
+
+    if ((path == NULL) || (path == text) || ((size_t)(path - text) >= sizeof(device->name)))
+    {
+        return false;
+    }
+    memcpy(device->name, text, (size_t)(path - text));
+    device->name[path - text] = '\0';
+    device->path = strdup(path + 1);
+    device->baud = DEFAULT_BAUD;
+    baud = strrchr(device->path, '@');
+    if (baud != NULL)
+    {
+        *baud = '\0';
+        device->baud = (uint32_t)strtoul(baud + 1, NULL, 0);
+    }
+
+    return device->path[0] != '\0';
+}
+
+/*******************************************************************************
+* Function Name: hex_record
+*******************************************************************************/
+static void hex_record(FILE *out, uint8_t type, uint16_t address, const uint8_t data[], uint8_t length)
+{
+    uint8_t sum = (uint8_t)(length + (address >> 8U) + address + type);
+
+    fprintf(out, ":%02X%04X%02X", length, address, type);
+    for (uint8_t i = 0U; i < length; i++)
+    {
+        fprintf(out, "%02X", data[i]);
+        sum += data[i];
+    }
+    fprintf(out, "%02X\n", (uint8_t)(0U - sum));
+}
+
+/*******************************************************************************
+* Function Name: write_image
+********************************************************************************
+* Summary:
+*  Writes a synthetic Intel HEX image. With fill below 100 %, only that share
+*  of the 4 KB blocks holds data, spread evenly over the size; the other
+*  blocks are not in the file and are skipped by the update. The content is
+*  the same for every run with the same parameters.
+*
+* Return:
+*  The number of bytes with data, 0 on error
+*
+*******************************************************************************/
+static uint32_t write_image(const char *path, uint32_t address, uint32_t size, uint32_t fill, image_kind_t kind)
+{
+    FILE *out = fopen(path, "w");
+    uint32_t seed = 0x2545F491U ^ size ^ (fill << 24U) ^ (uint32_t)kind;
+    uint32_t upper = 0xFFFFFFFFU;
+    uint32_t bytes = 0U;
+
+    if (out == NULL)
+    {
+        fprintf(stderr, "dfu_bench: cannot write %s: %s\n", path, strerror(errno));
+        return 0U;
+    }
+
+    for (uint32_t block = 0U; block < ((size + BLOCK_SIZE - 1U) / BLOCK_SIZE); block++)
+    {
+        if ((((block + 1U) * fill) / 100U) == ((block * fill) / 100U))
+        {
+            continue;
+        }
+        for (uint32_t offset = block * BLOCK_SIZE; offset < ((block + 1U) * BLOCK_SIZE) && (offset < size);
+             offset += 16U)
+        {
+            uint32_t record = address + offset;
+            uint8_t data[16];
+
+            for (uint32_t i = 0U; i < sizeof(data); i += 4U)
+            {
+                uint32_t word = (kind == KIND_RANDOM) ? xorshift32(&seed) :
+                                (kind == KIND_CODE) ? code_words[xorshift32(&seed) & 0x0FU] : 0U;
+                data[i] = (uint8_t)word;
+                data[i + 1U] = (uint8_t)(word >> 8U);
+                data[i + 2U] = (uint8_t)(word >> 16U);
+                data[i + 3U] = (uint8_t)(word >> 24U);
+            }
+            if ((record >> 16U) != upper)
+            {
+                uint8_t ext[2] = { (uint8_t)(record >> 24U), (uint8_t)(record >> 16U) };
+
+                upper = record >> 16U;
+                hex_record(out, 0x04U, 0U, ext, 2U);
+            }
+            hex_record(out, 0x00U, (uint16_t)record, data, sizeof(data));
+            bytes += sizeof(data);
+        }
+    }
+    hex_record(out, 0x01U, 0U, NULL, 0U);
+
+    return (fclose(out) == 0) ? bytes : 0U;
+}
+
+/*******************************************************************************
+* Function Name: write_script
+********************************************************************************
+* Summary:
+*  Writes the same .mtbdfu script as Program.mtbdfu, for the given data file.
+*
+*******************************************************************************/
+static int write_script(const char *path, const char *data_file, bool crc)
+{
+    FILE *out = fopen(path, "w");
+
+    if (out == NULL)
+    {
+        fprintf(stderr, "dfu_bench: cannot write %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    fprintf(out,
+            "{\n"
+            "    \"APPInfo\": { \"File Version\": \"0x1\", \"Packet Checksum Type\": \"%s\", \"Product Id\": \"01020304\" },\n"
+            "    \"commands\": [\n"
+            "        {\n"
+            "            \"commandSet\": [\n"
+            "                { \"cmdId\": \"0x37\", \"dataLength\": \"0x10\", \"repeat\": \"0x20\" },\n"
+            "                { \"cmdId\": \"0x49\", \"dataLength\": \"0x08\" }\n"
+            "            ],\n"
+            "            \"dataFile\": \"%s\",\n"
+            "            \"flashRowLength\": \"0x%X\",\n"
+            "            \"repeat\": \"EoF\",\n"
+            "            \"timeoutMS\": \"0x%X\"\n"
+            "        }\n"
+            "    ]\n"
+            "}\n",
+            crc ? "0x1" : "0x0", data_file, ROW_SIZE, RESPONSE_TIMEOUT_MS);
+
+    return (fclose(out) == 0) ? 0 : -1;
+}
+
+/*******************************************************************************
+* Function Name: copy_file
+********************************************************************************
+* Summary:
+*  Copies a JSON object written by dfu_sim into the output, without the
+*  trailing newline.
+*
+*******************************************************************************/
+static bool copy_file(FILE *out, const char *path)
+{
+    char buffer[1024];
+    FILE *in = fopen(path, "r");
+    bool copied = false;
+
+    if (in != NULL)
+    {
+        while (fgets(buffer, sizeof(buffer), in) != NULL)
+        {
+            buffer[strcspn(buffer, "\n")] = '\0';
+            fputs(buffer, out);
+            copied = true;
+        }
+        fclose(in);
+    }
+
+    return copied;
+}
+
+/*******************************************************************************
+* Function Name: run_sim
+********************************************************************************
+* Summary:
+*  Runs one update in dfu_sim on a freshly erased flash and copies its JSON
+*  result into the output.
+*
+*******************************************************************************/
+static int run_sim(FILE *out, const char *sim, const char *script, uint32_t baud)
+{
+    char flash[96];
+    char result[96];
+    char rate[16];
+    int status = -1;
+    pid_t pid;
+
+    snprintf(flash, sizeof(flash), "%s/flash.bin", work_dir);
+    snprintf(result, sizeof(result), "%s/result.json", work_dir);
+    snprintf(rate, sizeof(rate), "%u", (unsigned int)baud);
+    (void)unlink(flash);
+    (void)unlink(result);
+
+    pid = fork();
+    if (pid == 0)
+    {
+        /* The result comes from the JSON file, drop the text report */
+        int null_fd = open("/dev/null", O_WRONLY);
+
+        if (null_fd >= 0)
+        {
+            (void)dup2(null_fd, STDOUT_FILENO);
+        }
+        execl(sim, sim, "-p", script, "-m", flash, "-b", rate, "-j", result, (char *)NULL);
+        fprintf(stderr, "dfu_bench: cannot run %s: %s\n", sim, strerror(errno));
+        _exit(127);
+    }
+    if ((pid > 0) && (waitpid(pid, &status, 0) == pid) && WIFEXITED(status))
+    {
+        status = WEXITSTATUS(status);
+    }
+
+    if (!copy_file(out, result))
+    {
+        fprintf(out, "{\"mode\": \"sim\", \"status\": %d}", (status == 0) ? -1 : status);
+        status = (status == 0) ? -1 : status;
+    }
+    (void)unlink(flash);
+    (void)unlink(result);
+
+    return status;
+}
+
+/*******************************************************************************
+* Function Name: row_done
+*******************************************************************************/
+static void row_done(void *context, size_t row, size_t rows, uint32_t address)
+{
+    device_run_t *run = context;
+
+    (void)row;
+    (void)rows;
+    (void)address;
+    (void)dfu_report_add_row(&run->report, now_ns() - run->start_ns);
+}
+
+/*******************************************************************************
+* Function Name: run_device
+********************************************************************************
+* Summary:
+*  Runs one update on the kit and writes its result into the output.
+*
+*******************************************************************************/
+static int run_device(FILE *out, const device_t *device, const char *script_path)
+{
+    dfu_script_t script;
+    device_run_t run;
+    dfu_host_t host;
+    int status;
+
+    dfu_report_init(&run.report, "hardware", device->name, ROW_SIZE);
+    memset(&host, 0, sizeof(host));
+
+    status = dfu_script_load(&script, script_path);
+    if ((status == 0) && (dfu_link_open_serial(&host.link, device->path, device->baud) != 0))
+    {
+        status = DFU_HOST_ERROR_LINK;
+    }
+    if (status == 0)
+    {
+        host.row_done = row_done;
+        host.row_context = &run;
+        run.start_ns = now_ns();
+        status = dfu_host_program(&host, &script, NULL);
+        run.report.total_ns = now_ns() - run.start_ns;
+        run.report.wall_ns = run.report.total_ns;
+        dfu_link_close(&host.link);
+    }
+
+    run.report.status = status;
+    dfu_report_write_json(out, &run.report);
+    dfu_report_free(&run.report);
+
+    return status;
+}
+
+/*******************************************************************************
+* Function Name: usage
+*******************************************************************************/
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  -d name=device[@baud]  run on the kit through this serial device, repeat for more\n"
+            "  -a address             image address, required with -d (0x%08X in the simulator)\n"
+            "  -w seconds             wait for the kit to restart after each update (%u)\n"
+            "  -x path                DFU simulator (dfu_sim next to this tool)\n"
+            "  -b baud                simulated UART bit rate (%u)\n"
+            "  -s sizes               image sizes (0x10000,0x80000,0x%X)\n"
+            "  -f percents            fill ratios (100,50)\n"
+            "  -k kinds               content, of random,code,zero (random,code)\n"
+            "  -c                     packets use CRC-16\n"
+            "  -o file                write the JSON result to file instead of stdout\n",
+            name, SIM_ADDRESS, DEFAULT_RESTART_S, DEFAULT_BAUD, SLOT_SIZE);
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Runs every combination of size, fill ratio and kind, on every device or
+*  in the simulator.
+*
+* Return:
+*  0 if all updates succeeded, 1 otherwise, 2 on usage errors
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    uint32_t sizes[MAX_LIST] = { 0x10000U, 0x80000U, SLOT_SIZE };
+    uint32_t fills[MAX_LIST] = { 100U, 50U };
+    uint32_t kinds[MAX_LIST] = { KIND_RANDOM, KIND_CODE };
+    size_t size_count = 3U;
+    size_t fill_count = 2U;
+    size_t kind_count = 2U;
+    device_t devices[MAX_DEVICES];
+    size_t device_count = 0U;
+    uint32_t address = 0U;
+    uint32_t baud = DEFAULT_BAUD;
+    uint32_t restart_s = DEFAULT_RESTART_S;
+    bool crc = false;
+    const char *out_path = NULL;
+    char sim[4096];
+    char hex[96];
+    char script[96];
+    bool first = true;
+    int result = 0;
+    FILE *out = stdout;
+    int opt;
+
+    /* dfu_sim is built next to this tool */
+    snprintf(sim, sizeof(sim), "%.*sdfu_sim",
+             (strrchr(argv[0], '/') != NULL) ? (int)(strrchr(argv[0], '/') + 1 - argv[0]) : 0, argv[0]);
+
+    while ((opt = getopt(argc, argv, "d:a:w:x:b:s:f:k:co:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'd':
+                if ((device_count == MAX_DEVICES) || !parse_device(optarg, &devices[device_count++]))
+                {
+                    usage(argv[0]);
+                    return 2;
+                }
+                break;
+            case 'a': address = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'w': restart_s = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'x': snprintf(sim, sizeof(sim), "%s", optarg); break;
+            case 'b': baud = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 's': size_count = parse_list(optarg, sizes); break;
+            case 'f': fill_count = parse_list(optarg, fills); break;
+            case 'k': kind_count = parse_kinds(optarg, kinds); break;
+            case 'c': crc = true; break;
+            case 'o': out_path = optarg; break;
+            default: usage(argv[0]); return 2;
+        }
+    }
+    if ((optind != argc) || (size_count == 0U) || (fill_count == 0U) || (kind_count == 0U) || (baud == 0U) ||
+        ((device_count != 0U) && (address == 0U)))
+    {
+        usage(argv[0]);
+        return 2;
+    }
+    address = (address == 0U) ? SIM_ADDRESS : address;
+    for (size_t i = 0U; i < fill_count; i++)
+    {
+        if ((fills[i] == 0U) || (fills[i] > 100U))
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    snprintf(work_dir, sizeof(work_dir), "/tmp/dfu_bench.XXXXXX");
+    if (mkdtemp(work_dir) == NULL)
+    {
+        fprintf(stderr, "dfu_bench: cannot create a work directory: %s\n", strerror(errno));
+        return 1;
+    }
+    snprintf(hex, sizeof(hex), "%s/image.hex", work_dir);
+    snprintf(script, sizeof(script), "%s/bench.mtbdfu", work_dir);
+
+    if ((out_path != NULL) && ((out = fopen(out_path, "w")) == NULL))
+    {
+        fprintf(stderr, "dfu_bench: cannot write %s: %s\n", out_path, strerror(errno));
+        return 1;
+    }
+
+    fprintf(out, "{\"tool\": \"dfu_bench\", \"version\": 1, \"results\": [");
+    for (size_t s = 0U; s < size_count; s++)
+    {
+        for (size_t f = 0U; f < fill_count; f++)
+        {
+            for (size_t k = 0U; k < kind_count; k++)
+            {
+                uint32_t bytes = write_image(hex, address, sizes[s], fills[f], (image_kind_t)kinds[k]);
+
+                if ((bytes == 0U) || (write_script(script, hex, crc) != 0))
+                {
+                    result = 1;
+                    continue;
+                }
+
+                for (size_t d = 0U; d < ((device_count != 0U) ? device_count : 1U); d++)
+                {
+                    int status;
+
+                    fprintf(stderr, "dfu_bench: %s, size 0x%X, fill %u%%, %s\n",
+                            (device_count != 0U) ? devices[d].name : "sim", (unsigned int)sizes[s],
+                            (unsigned int)fills[f], kind_names[kinds[k]]);
+                    fprintf(out,
+                            "%s\n  {\"image\": {\"address\": %u, \"size\": %u, \"fill\": %u, \"kind\": \"%s\", "
+                            "\"bytes\": %u}, \"result\": ",
+                            first ? "" : ",", (unsigned int)address, (unsigned int)sizes[s], (unsigned int)fills[f],
+                            kind_names[kinds[k]], (unsigned int)bytes);
+                    first = false;
+
+                    if (device_count != 0U)
+                    {
+                        status = run_device(out, &devices[d], script);
+                        sleep(restart_s);
+                    }
+                    else
+                    {
+                        status = run_sim(out, sim, script, baud);
+                    }
+                    fprintf(out, "}");
+                    fflush(out);
+                    result = (status != 0) ? 1 : result;
+                }
+            }
+        }
+    }
+    fprintf(out, "\n]}\n");
+
+    if (out != stdout)
+    {
+        fclose(out);
+    }
+    (void)unlink(hex);
+    (void)unlink(script);
+    (void)rmdir(work_dir);
+
+    return result;
+}
+
+/* [] END OF FILE */
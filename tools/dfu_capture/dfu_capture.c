@@ -0,0 +1,343 @@
+/*******************************************************************************
+* File Name        : dfu_capture.c
+*
+* Description      : Host side of the DFU session recorder (proj_cm33_ns built
+*                    with DEFINES+=DFU_RECORD). Reads the debug UART output
+*                    from a serial device, a capture file or stdin, saves the
+*                    next recorded session to a capture file for replay with
+*                    dfu_sim -R and passes everything else, such as printf()
+*                    output or trace frames, through to stdout. Also lists
+*                    the packets of a capture file.
+*
+*                    Usage: dfu_capture -o capture <serial device | file | ->
+*                           dfu_capture -l capture
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include "dfu_session.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Longest frame: an entry with the largest DFU packet */
+#define FRAME_MAX_PAYLOAD   (DFU_RECORD_ENTRY_SIZE + DFU_PACKET_MAX_SIZE)
+#define FRAME_MAX_SIZE      (DFU_RECORD_FRAME_HEADER_SIZE + FRAME_MAX_PAYLOAD + 1U)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    dfu_session_t session;
+    bool started;                           /* START frame seen */
+    uint32_t entries;                       /* Entries announced by START */
+} capture_t;
+
+/*******************************************************************************
+* Function Name: get_u32
+*******************************************************************************/
+static uint32_t get_u32(const uint8_t src[])
+{
+    return (uint32_t)src[0] | ((uint32_t)src[1] << 8U) | ((uint32_t)src[2] << 16U) | ((uint32_t)src[3] << 24U);
+}
+
+/*******************************************************************************
+* Function Name: command_name
+*******************************************************************************/
+static const char *command_name(uint8_t command)
+{
+    switch (command)
+    {
+        case DFU_CMD_VERIFY_APP:    return "Verify App";
+        case DFU_CMD_SYNC:          return "Sync";
+        case DFU_CMD_SEND_DATA:     return "Send Data";
+        case DFU_CMD_ENTER:         return "Enter DFU";
+        case DFU_CMD_EXIT:          return "Exit DFU";
+        case DFU_CMD_ERASE_DATA:    return "Erase Data";
+        case DFU_CMD_PROGRAM_DATA:  return "Program Data";
+        case DFU_CMD_VERIFY_DATA:   return "Verify Data";
+        default:                    return "?";
+    }
+}
+
+/*******************************************************************************
+* Function Name: list_capture
+********************************************************************************
+* Summary:
+*  Prints one line per packet with its time, the time since the previous
+*  packet and the command or response status, then the longest time the
+*  device waited for a command.
+*
+*******************************************************************************/
+static int list_capture(const char *path)
+{
+    dfu_session_t session;
+    uint32_t last_us = 0U;
+    uint32_t last_command_us = 0U;
+    uint32_t max_wait_us = 0U;
+    size_t max_wait_entry = 0U;
+
+    if (dfu_session_load(&session, path) != 0)
+    {
+        return 1;
+    }
+
+    printf("%6s %12s %10s  %-3s %-14s %6s\n", "entry", "time ms", "gap ms", "dir", "packet", "length");
+    for (size_t i = 0U; i < session.count; i++)
+    {
+        const dfu_session_entry_t *entry = &session.entries[i];
+        uint8_t code = (entry->length > 1U) ? entry->packet[1] : 0U;
+        bool to_device = (entry->direction == DFU_RECORD_TO_DEVICE);
+
+        printf("%6zu %12.3f %10.3f  %-3s %-14s %6u\n", i, (double)entry->time_us / 1e3,
+               (double)(entry->time_us - last_us) / 1e3, to_device ? "->" : "<-",
+               to_device ? command_name(code) : dfu_status_name(code), (unsigned int)entry->length);
+        if (to_device)
+        {
+            if ((i != 0U) && ((entry->time_us - last_command_us) > max_wait_us))
+            {
+                max_wait_us = entry->time_us - last_command_us;
+                max_wait_entry = i;
+            }
+            last_command_us = entry->time_us;
+        }
+        last_us = entry->time_us;
+    }
+    printf("%zu packets recorded by the %s, %u not recorded, %.3f s\n", session.count,
+           (session.source == DFU_RECORD_SOURCE_DEVICE) ? "device" : "host", (unsigned int)session.dropped,
+           (double)last_us / 1e6);
+    printf("Longest time between commands %.3f ms, before entry %zu\n", (double)max_wait_us / 1e3, max_wait_entry);
+    dfu_session_free(&session);
+
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: open_input
+********************************************************************************
+* Summary:
+*  Opens the input. Serial devices are set to raw mode at 115200 baud, the
+*  debug UART default.
+*
+*******************************************************************************/
+static int open_input(const char *path)
+{
+    struct termios tio;
+    int fd = (strcmp(path, "-") == 0) ? STDIN_FILENO : open(path, O_RDONLY | O_NOCTTY);
+
+    if ((fd >= 0) && isatty(fd) && (tcgetattr(fd, &tio) == 0))
+    {
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, B115200);
+        cfsetospeed(&tio, B115200);
+        tio.c_cc[VMIN] = 1;
+        tio.c_cc[VTIME] = 0;
+        (void)tcsetattr(fd, TCSANOW, &tio);
+    }
+
+    return fd;
+}
+
+/*******************************************************************************
+* Function Name: handle_frame
+********************************************************************************
+* Summary:
+*  Adds a frame to the capture.
+*
+* Return:
+*  True once the END frame of a complete recording was received
+*
+*******************************************************************************/
+static bool handle_frame(capture_t *capture, uint8_t type, const uint8_t payload[], size_t length)
+{
+    bool complete = false;
+
+    if ((type == DFU_RECORD_FRAME_START) && (length == DFU_RECORD_START_SIZE))
+    {
+        dfu_session_free(&capture->session);
+        dfu_session_init(&capture->session, DFU_RECORD_SOURCE_DEVICE);
+        capture->entries = get_u32(&payload[0]);
+        capture->session.dropped = get_u32(&payload[4]);
+        capture->started = true;
+    }
+    else if ((type == DFU_RECORD_FRAME_ENTRY) && capture->started && (length >= DFU_RECORD_ENTRY_SIZE) &&
+             (length == (DFU_RECORD_ENTRY_SIZE + ((size_t)payload[4] | ((size_t)payload[5] << 8U)))))
+    {
+        if (dfu_session_add(&capture->session, get_u32(&payload[0]), payload[6], payload[7],
+                            &payload[DFU_RECORD_ENTRY_SIZE], length - DFU_RECORD_ENTRY_SIZE) != 0)
+        {
+            capture->started = false;
+        }
+    }
+    else if ((type == DFU_RECORD_FRAME_END) && capture->started)
+    {
+        complete = (capture->session.count == capture->entries);
+        if (!complete)
+        {
+            fprintf(stderr, "dfu_capture: recording incomplete, %zu of %u packets\n", capture->session.count,
+                    (unsigned int)capture->entries);
+        }
+        capture->started = false;
+    }
+
+    return complete;
+}
+
+/*******************************************************************************
+* Function Name: usage
+*******************************************************************************/
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s -o capture <serial device | file | ->  save the next recorded session\n"
+            "       %s -l capture                             list the packets of a capture\n",
+            name, name);
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Scans the input for frames like tools/dfu_trace. A candidate frame whose
+*  checksum does not match is treated as text and scanning resumes at the
+*  next byte.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    static uint8_t window[FRAME_MAX_SIZE];
+    static capture_t capture;
+    uint8_t input[256];
+    const char *out_path = NULL;
+    size_t fill = 0U;
+    bool complete = false;
+    ssize_t got;
+    int fd;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "o:l:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'o': out_path = optarg; break;
+            case 'l': return list_capture(optarg);
+            default: usage(argv[0]); return 2;
+        }
+    }
+    if ((out_path == NULL) || (optind != (argc - 1)))
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    fd = open_input(argv[optind]);
+    if (fd < 0)
+    {
+        fprintf(stderr, "dfu_capture: cannot open %s: %s\n", argv[optind], strerror(errno));
+        return 1;
+    }
+
+    while ((!complete) && ((got = read(fd, input, sizeof(input))) != 0))
+    {
+        if (got < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            fprintf(stderr, "dfu_capture: read failed: %s\n", strerror(errno));
+            break;
+        }
+
+        for (ssize_t i = 0; (i < got) && (!complete); i++)
+        {
+            size_t length;
+
+            window[fill++] = input[i];
+            for (;;)
+            {
+                /* Shift out bytes that cannot start a frame */
+                while ((fill > 0U) &&
+                       ((window[0] != DFU_RECORD_SYNC0) || ((fill > 1U) && (window[1] != DFU_RECORD_SYNC1))))
+                {
+                    putchar(window[0]);
+                    memmove(&window[0], &window[1], --fill);
+                }
+                if (fill < DFU_RECORD_FRAME_HEADER_SIZE)
+                {
+                    break;
+                }
+
+                length = (size_t)window[3] | ((size_t)window[4] << 8U);
+                if (length <= FRAME_MAX_PAYLOAD)
+                {
+                    uint8_t sum = 0U;
+
+                    if (fill < (DFU_RECORD_FRAME_HEADER_SIZE + length + 1U))
+                    {
+                        break;
+                    }
+                    for (size_t j = 2U; j < (DFU_RECORD_FRAME_HEADER_SIZE + length); j++)
+                    {
+                        sum = (uint8_t)(sum + window[j]);
+                    }
+                    if (sum == window[DFU_RECORD_FRAME_HEADER_SIZE + length])
+                    {
+                        complete = handle_frame(&capture, window[2], &window[DFU_RECORD_FRAME_HEADER_SIZE], length);
+                        fill = 0U;
+                        break;
+                    }
+                }
+
+                /* Not a frame, resume at the next byte */
+                putchar(window[0]);
+                memmove(&window[0], &window[1], --fill);
+            }
+        }
+    }
+    fflush(stdout);
+
+    if (!complete)
+    {
+        fprintf(stderr, "dfu_capture: no complete recording in %s\n", argv[optind]);
+        dfu_session_free(&capture.session);
+        return 1;
+    }
+    if (dfu_session_save(&capture.session, out_path) != 0)
+    {
+        dfu_session_free(&capture.session);
+        return 1;
+    }
+    fprintf(stderr, "dfu_capture: %zu packets saved to %s\n", capture.session.count, out_path);
+    dfu_session_free(&capture.session);
+
+    return 0;
+}
+
+/* [] END OF FILE */
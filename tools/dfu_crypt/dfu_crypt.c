@@ -0,0 +1,225 @@
+/*******************************************************************************
+* File Name        : dfu_crypt.c
+*
+* Description      : Encrypts the image of an update slot, an Intel HEX file,
+*                    for an encrypted update (shared/include/secure_decrypt.h),
+*                    and wraps the transport key for SECURE_DECRYPT_WRAPPED_KEY.
+*                    The nonce given here goes into the "nonce" of the script
+*                    entry that sends the image.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "dfu_aes.h"
+#include "dfu_host.h"
+#include "secure_decrypt.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define DEFAULT_ROW_SIZE        (0x200U)    /* flashRowLength of Program.mtbdfu */
+#define HEX_RECORD_SIZE         (16U)
+
+/*******************************************************************************
+* Function Name: write_record
+*******************************************************************************/
+static void write_record(FILE *file, uint8_t type, uint16_t address, const uint8_t data[], size_t length)
+{
+    uint8_t sum = (uint8_t)(length + (address >> 8U) + address + type);
+
+    fprintf(file, ":%02X%04X%02X", (unsigned int)length, (unsigned int)address, (unsigned int)type);
+    for (size_t i = 0U; i < length; i++)
+    {
+        fprintf(file, "%02X", data[i]);
+        sum = (uint8_t)(sum + data[i]);
+    }
+    fprintf(file, "%02X\n", (unsigned int)(uint8_t)(0U - sum));
+}
+
+/*******************************************************************************
+* Function Name: write_hex
+********************************************************************************
+* Summary:
+*  Writes the rows of an image as an Intel HEX file.
+*
+* Return:
+*  0 on success, -1 on error (reported on stderr)
+*
+*******************************************************************************/
+static int write_hex(const dfu_image_t *image, const char *path)
+{
+    uint32_t upper = 0xFFFFFFFFU;
+    FILE *file = fopen(path, "w");
+
+    if (file == NULL)
+    {
+        perror(path);
+        return -1;
+    }
+
+    for (size_t row = 0U; row < image->rows; row++)
+    {
+        for (uint32_t done = 0U; done < image->row_size; done += HEX_RECORD_SIZE)
+        {
+            uint32_t address = image->address[row] + done;
+            uint32_t length = image->row_size - done;
+            uint8_t extended[2] = { (uint8_t)(address >> 24U), (uint8_t)(address >> 16U) };
+
+            if ((address >> 16U) != upper)
+            {
+                upper = address >> 16U;
+                write_record(file, 0x04U, 0U, extended, sizeof(extended));
+            }
+            write_record(file, 0x00U, (uint16_t)address, &image->data[(row * image->row_size) + done],
+                         (length < HEX_RECORD_SIZE) ? length : HEX_RECORD_SIZE);
+        }
+    }
+    write_record(file, 0x01U, 0U, NULL, 0U);
+
+    if (fclose(file) != 0)
+    {
+        perror(path);
+        return -1;
+    }
+
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: print_wrapped_key
+********************************************************************************
+* Summary:
+*  Prints the transport key wrapped with the key encryption key, in the form
+*  of SECURE_DECRYPT_WRAPPED_KEY.
+*
+*******************************************************************************/
+static void print_wrapped_key(const uint8_t kek[], const uint8_t key[])
+{
+    uint8_t wrapped[SECURE_DECRYPT_WRAPPED_KEY_SIZE];
+
+    dfu_aes_wrap(kek, key, wrapped);
+    for (uint32_t i = 0U; i < SECURE_DECRYPT_WRAPPED_KEY_SIZE; i++)
+    {
+        printf("%s0x%02X", (i == 0U) ? "" : ",", wrapped[i]);
+    }
+    printf("\n");
+}
+
+/*******************************************************************************
+* Function Name: usage
+*******************************************************************************/
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [-r row_size] [-b base] -k key -n nonce -i image_id in.hex out.hex\n"
+            "       %s -w -k key -K kek\n"
+            "  -k hex     transport key, %u bytes\n"
+            "  -n hex     nonce, %u bytes, new for every image encrypted with the key\n"
+            "  -i id      MCUboot image ID of the update slot\n"
+            "  -b address start of the update slot (first address of in.hex)\n"
+            "  -r bytes   row size, flashRowLength of the script (0x%X)\n"
+            "  -w         print the key wrapped with kek for SECURE_DECRYPT_WRAPPED_KEY\n",
+            name, name, SECURE_DECRYPT_KEY_SIZE, SECURE_DECRYPT_NONCE_SIZE, DEFAULT_ROW_SIZE);
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Return:
+*  0 on success, 1 on errors, 2 on usage errors
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    uint8_t key[SECURE_DECRYPT_KEY_SIZE];
+    uint8_t kek[SECURE_DECRYPT_KEY_SIZE];
+    uint8_t nonce[SECURE_DECRYPT_NONCE_SIZE];
+    bool has_key = false;
+    bool has_kek = false;
+    bool has_nonce = false;
+    bool has_base = false;
+    bool wrap = false;
+    uint32_t row_size = DEFAULT_ROW_SIZE;
+    uint32_t image_id = (uint32_t)DFU_SCRIPT_MAX_IMAGE + 1U;    /* Required */
+    uint32_t base = 0U;
+    dfu_aes_t aes;
+    dfu_image_t image;
+    int result;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "r:b:k:K:n:i:w")) != -1)
+    {
+        switch (opt)
+        {
+            case 'r': row_size = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'b': base = (uint32_t)strtoul(optarg, NULL, 0); has_base = true; break;
+            case 'k': has_key = (dfu_aes_parse(optarg, key, sizeof(key)) == 0); break;
+            case 'K': has_kek = (dfu_aes_parse(optarg, kek, sizeof(kek)) == 0); break;
+            case 'n': has_nonce = (dfu_aes_parse(optarg, nonce, sizeof(nonce)) == 0); break;
+            case 'i': image_id = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'w': wrap = true; break;
+            default: usage(argv[0]); return 2;
+        }
+    }
+    if (wrap && has_key && has_kek && (optind == argc))
+    {
+        print_wrapped_key(kek, key);
+        return 0;
+    }
+    if (wrap || !has_key || !has_nonce || (image_id > (uint32_t)DFU_SCRIPT_MAX_IMAGE) ||
+        (optind != (argc - 2)) || (row_size == 0U) || ((row_size % SECURE_DECRYPT_BLOCK_SIZE) != 0U))
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    dfu_image_init(&image, row_size);
+    result = dfu_image_load_hex(&image, argv[optind]);
+    if ((result == 0) && (image.rows != 0U))
+    {
+        base = has_base ? base : image.address[0];
+        if ((image.address[0] < base) || ((base % SECURE_DECRYPT_BLOCK_SIZE) != 0U))
+        {
+            fprintf(stderr, "dfu_crypt: %s does not start in the update slot\n", argv[optind]);
+            result = -1;
+        }
+    }
+
+    if (result == 0)
+    {
+        dfu_aes_init(&aes, key);
+        for (size_t row = 0U; row < image.rows; row++)
+        {
+            dfu_aes_ctr(&aes, nonce, image_id, image.address[row] - base, &image.data[row * row_size], row_size);
+        }
+        memset(&aes, 0, sizeof(aes));
+        result = write_hex(&image, argv[optind + 1]);
+    }
+    dfu_image_free(&image);
+
+    return (result == 0) ? 0 : 1;
+}
+
+/* [] END OF FILE */
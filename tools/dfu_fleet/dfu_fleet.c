@@ -0,0 +1,889 @@
+/*******************************************************************************
+* File Name        : dfu_fleet.c
+*
+* Description      : Updates many kits at once, for example in production
+*                    through USB hubs and shared I2C buses. Each kit gets a
+*                    worker thread with its own DFU host; all of them share
+*                    one image that is loaded and sealed once. Kits on one
+*                    bus share its bandwidth limit.
+*
+*                    Simulated kits run in dfu_sim, one process each, so the
+*                    tool can be tried on one Linux machine.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+/* mkdtemp() */
+#define _XOPEN_SOURCE 700
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "dfu_host.h"
+#include "dfu_link.h"
+#include "dfu_report.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define MAX_DEVICES             (64U)
+#define MAX_BUSES               (16U)
+#define MAX_NAME                (32U)
+#define MAX_DATA_FILES          (DFU_SCRIPT_MAX_BLOCKS)
+#define DEFAULT_BAUD            (115200U)
+#define PROGRESS_PERIOD_MS      (1000U)
+#define SIM_CONNECT_MS          (5000U)     /* Time dfu_sim gets to listen */
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef enum
+{
+    LINK_SERIAL,
+    LINK_HID,
+    LINK_I2C,
+    LINK_SIM,
+    LINK_COUNT
+} link_kind_t;
+
+/* Kits that share a bus share its bandwidth. Each transfer reserves the
+ * bus for its bytes at the limit; the next transfer starts after that. */
+typedef struct
+{
+    char name[MAX_NAME * 8U];
+    uint32_t bytes_per_s;                   /* 0 for no limit */
+    pthread_mutex_t lock;
+    uint64_t free_ns;                       /* Bus time reserved until */
+} bus_t;
+
+typedef struct
+{
+    dfu_link_t inner;
+    bus_t *bus;
+} bus_link_t;
+
+typedef struct
+{
+    char name[MAX_NAME];
+    link_kind_t kind;
+    char path[256];
+    uint32_t arg;                           /* Bit rate or I2C address */
+    bus_t *bus;                             /* NULL if not on a shared bus */
+
+    pid_t sim_pid;
+    char sim_result[128];                   /* JSON result of dfu_sim */
+
+    pthread_t thread;
+    dfu_host_t host;
+    bus_link_t bus_link;
+    dfu_report_t report;
+    uint64_t start_ns;
+    atomic_size_t rows_done;
+    atomic_size_t rows_total;
+    atomic_bool finished;
+    int status;
+} device_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static const char *const kind_names[LINK_COUNT] = { "serial", "hid", "i2c", "sim" };
+
+static device_t devices[MAX_DEVICES];
+static size_t device_count;
+static bus_t buses[MAX_BUSES];
+static size_t bus_count;
+
+/* Shared by all workers, read only while they run */
+static dfu_script_t script;
+static dfu_image_t image;
+static uint32_t window = 1U;
+static uint32_t chunk_size;
+static char sim_path[4096];
+static char work_dir[64];
+
+/*******************************************************************************
+* Function Name: now_ns
+*******************************************************************************/
+static uint64_t now_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000U) + (uint64_t)now.tv_nsec;
+}
+
+/*******************************************************************************
+* Function Name: sleep_ns
+*******************************************************************************/
+static void sleep_ns(uint64_t ns)
+{
+    struct timespec delay = { (time_t)(ns / 1000000000U), (long)(ns % 1000000000U) };
+
+    while ((nanosleep(&delay, &delay) != 0) && (errno == EINTR))
+    {
+    }
+}
+
+/*******************************************************************************
+* Function Name: find_bus
+********************************************************************************
+* Summary:
+*  Returns the bus with the given name, adding it if needed.
+*
+*******************************************************************************/
+static bus_t *find_bus(const char *name)
+{
+    for (size_t i = 0U; i < bus_count; i++)
+    {
+        if (strcmp(buses[i].name, name) == 0)
+        {
+            return &buses[i];
+        }
+    }
+    if (bus_count == MAX_BUSES)
+    {
+        return NULL;
+    }
+    snprintf(buses[bus_count].name, sizeof(buses[bus_count].name), "%s", name);
+    (void)pthread_mutex_init(&buses[bus_count].lock, NULL);
+
+    return &buses[bus_count++];
+}
+
+/*******************************************************************************
+* Function Name: bus_reserve
+********************************************************************************
+* Summary:
+*  Reserves the bus for length bytes and waits until the reservation starts.
+*
+*******************************************************************************/
+static void bus_reserve(bus_t *bus, size_t length)
+{
+    uint64_t now;
+    uint64_t start;
+
+    if (bus->bytes_per_s == 0U)
+    {
+        return;
+    }
+    (void)pthread_mutex_lock(&bus->lock);
+    now = now_ns();
+    start = (bus->free_ns > now) ? bus->free_ns : now;
+    bus->free_ns = start + (((uint64_t)length * 1000000000U) / bus->bytes_per_s);
+    (void)pthread_mutex_unlock(&bus->lock);
+
+    if (start > now)
+    {
+        sleep_ns(start - now);
+    }
+}
+
+/*******************************************************************************
+* Function Name: bus_write
+*******************************************************************************/
+static int bus_write(void *context, const uint8_t data[], size_t length)
+{
+    bus_link_t *bl = context;
+
+    bus_reserve(bl->bus, length);
+    return bl->inner.write(bl->inner.context, data, length);
+}
+
+/*******************************************************************************
+* Function Name: bus_read
+********************************************************************************
+* Summary:
+*  Reads from the kit. The bytes read are charged to the bus afterwards, as
+*  their number is not known before.
+*
+*******************************************************************************/
+static int bus_read(void *context, uint8_t data[], size_t length, int timeout_ms)
+{
+    bus_link_t *bl = context;
+    int got = bl->inner.read(bl->inner.context, data, length, timeout_ms);
+
+    if (got > 0)
+    {
+        bus_reserve(bl->bus, (size_t)got);
+    }
+
+    return got;
+}
+
+/*******************************************************************************
+* Function Name: split_suffix
+********************************************************************************
+* Summary:
+*  Splits "path@value" into the path and the value, if there is one.
+*
+*******************************************************************************/
+static void split_suffix(char *text, uint32_t *value)
+{
+    char *at = strrchr(text, '@');
+
+    if (at != NULL)
+    {
+        *at = '\0';
+        *value = (uint32_t)strtoul(&at[1], NULL, 0);
+    }
+}
+
+/*******************************************************************************
+* Function Name: add_device
+********************************************************************************
+* Summary:
+*  Parses "name=kind[:path[@value]][,bus=name]". Kits on one I2C adapter are
+*  on one bus unless another is given.
+*
+*******************************************************************************/
+static bool add_device(const char *text)
+{
+    char spec[512];
+    char *link;
+    char *bus_name;
+    device_t *dev;
+
+    if ((device_count == MAX_DEVICES) || (snprintf(spec, sizeof(spec), "%s", text) >= (int)sizeof(spec)))
+    {
+        return false;
+    }
+    dev = &devices[device_count];
+    link = strchr(spec, '=');
+    if ((link == NULL) || (link == spec) || ((size_t)(link - spec) >= MAX_NAME))
+    {
+        return false;
+    }
+    *link++ = '\0';
+    memcpy(dev->name, spec, (size_t)(link - spec));
+
+    bus_name = strstr(link, ",bus=");
+    if (bus_name != NULL)
+    {
+        *bus_name = '\0';
+        bus_name += strlen(",bus=");
+    }
+
+    if (strcmp(link, "sim") == 0)
+    {
+        dev->kind = LINK_SIM;
+    }
+    else if (strncmp(link, "serial:", 7U) == 0)
+    {
+        dev->kind = LINK_SERIAL;
+        dev->arg = DEFAULT_BAUD;
+        snprintf(dev->path, sizeof(dev->path), "%s", &link[7]);
+    }
+    else if (strncmp(link, "hid:", 4U) == 0)
+    {
+        dev->kind = LINK_HID;
+        snprintf(dev->path, sizeof(dev->path), "%s", &link[4]);
+    }
+    else if (strncmp(link, "i2c:", 4U) == 0)
+    {
+        dev->kind = LINK_I2C;
+        dev->arg = DFU_LINK_I2C_ADDRESS;
+        snprintf(dev->path, sizeof(dev->path), "%s", &link[4]);
+    }
+    else
+    {
+        return false;
+    }
+    if ((dev->kind == LINK_SERIAL) || (dev->kind == LINK_I2C))
+    {
+        split_suffix(dev->path, &dev->arg);
+    }
+    if ((dev->kind != LINK_SIM) && (dev->path[0] == '\0'))
+    {
+        return false;
+    }
+
+    if ((bus_name == NULL) && (dev->kind == LINK_I2C))
+    {
+        bus_name = dev->path;
+    }
+    if (bus_name != NULL)
+    {
+        dev->bus = find_bus(bus_name);
+        if (dev->bus == NULL)
+        {
+            return false;
+        }
+    }
+    device_count++;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: set_bus_limit
+********************************************************************************
+* Summary:
+*  Parses "bus=bytes_per_s".
+*
+*******************************************************************************/
+static bool set_bus_limit(const char *text)
+{
+    char spec[512];
+    char *rate;
+    bus_t *bus;
+
+    snprintf(spec, sizeof(spec), "%s", text);
+    rate = strrchr(spec, '=');
+    if ((rate == NULL) || (rate == spec))
+    {
+        return false;
+    }
+    *rate++ = '\0';
+    bus = find_bus(spec);
+    if (bus == NULL)
+    {
+        return false;
+    }
+    bus->bytes_per_s = (uint32_t)strtoul(rate, NULL, 0);
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: start_sim
+********************************************************************************
+* Summary:
+*  Starts dfu_sim on an erased flash and connects to its Unix socket.
+*
+* Return:
+*  0 on success, -1 on error (reported on stderr)
+*
+*******************************************************************************/
+static int start_sim(device_t *dev)
+{
+    struct sockaddr_un addr;
+    char flash[128];
+    int fd = -1;
+
+    snprintf(dev->path, sizeof(dev->path), "%s/%s.sock", work_dir, dev->name);
+    snprintf(flash, sizeof(flash), "%s/%s.bin", work_dir, dev->name);
+    snprintf(dev->sim_result, sizeof(dev->sim_result), "%s/%s.json", work_dir, dev->name);
+
+    dev->sim_pid = fork();
+    if (dev->sim_pid == 0)
+    {
+        /* The result comes from the JSON file, drop the text report */
+        int null_fd = open("/dev/null", O_WRONLY);
+
+        if (null_fd >= 0)
+        {
+            (void)dup2(null_fd, STDOUT_FILENO);
+        }
+        execl(sim_path, sim_path, "-u", dev->path, "-m", flash, "-j", dev->sim_result, (char *)NULL);
+        fprintf(stderr, "dfu_fleet: cannot run %s: %s\n", sim_path, strerror(errno));
+        _exit(127);
+    }
+    if (dev->sim_pid < 0)
+    {
+        fprintf(stderr, "%s: cannot start dfu_sim: %s\n", dev->name, strerror(errno));
+        return -1;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, dev->path, strnlen(dev->path, sizeof(addr.sun_path) - 1U));
+    for (uint32_t waited = 0U; (fd < 0) && (waited < SIM_CONNECT_MS); waited += 10U)
+    {
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if ((fd >= 0) && (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0))
+        {
+            close(fd);
+            fd = -1;
+            sleep_ns(10000000U);
+        }
+    }
+    if ((fd < 0) || (dfu_link_open_fd(&dev->bus_link.inner, fd) != 0))
+    {
+        fprintf(stderr, "%s: cannot connect to dfu_sim\n", dev->name);
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        return -1;
+    }
+
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: stop_sim
+********************************************************************************
+* Summary:
+*  Waits for dfu_sim to finish. It only finishes by itself after Exit DFU,
+*  so it is stopped if the update failed.
+*
+* Return:
+*  The exit code of dfu_sim, 0 if the image was written without conflicts
+*
+*******************************************************************************/
+static int stop_sim(device_t *dev)
+{
+    int status = -1;
+
+    if (dev->sim_pid <= 0)
+    {
+        return -1;
+    }
+    if (dev->status != 0)
+    {
+        (void)kill(dev->sim_pid, SIGTERM);
+    }
+    if ((waitpid(dev->sim_pid, &status, 0) == dev->sim_pid) && WIFEXITED(status))
+    {
+        status = WEXITSTATUS(status);
+    }
+    else
+    {
+        status = -1;
+    }
+    dev->sim_pid = 0;
+
+    return status;
+}
+
+/*******************************************************************************
+* Function Name: open_link
+*******************************************************************************/
+static int open_link(device_t *dev)
+{
+    dfu_link_t *inner = &dev->bus_link.inner;
+    int result;
+
+    switch (dev->kind)
+    {
+        case LINK_SERIAL: result = dfu_link_open_serial(inner, dev->path, dev->arg); break;
+        case LINK_HID:    result = dfu_link_open_hidraw(inner, dev->path); break;
+        case LINK_I2C:    result = dfu_link_open_i2c(inner, dev->path, (uint8_t)dev->arg); break;
+        default:          result = start_sim(dev); break;
+    }
+
+    if ((result == 0) && (dev->bus != NULL))
+    {
+        dev->bus_link.bus = dev->bus;
+        dev->host.link.context = &dev->bus_link;
+        dev->host.link.write = bus_write;
+        dev->host.link.read = bus_read;
+    }
+    else
+    {
+        dev->host.link = *inner;
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: row_done
+*******************************************************************************/
+static void row_done(void *context, size_t row, size_t rows, uint32_t address)
+{
+    device_t *dev = context;
+
+    (void)address;
+    (void)dfu_report_add_row(&dev->report, now_ns() - dev->start_ns);
+    atomic_store(&dev->rows_total, rows);
+    atomic_store(&dev->rows_done, row + 1U);
+}
+
+/*******************************************************************************
+* Function Name: worker
+********************************************************************************
+* Summary:
+*  Updates one kit.
+*
+*******************************************************************************/
+static void *worker(void *arg)
+{
+    device_t *dev = arg;
+
+    dev->status = DFU_HOST_ERROR_LINK;
+    dev->start_ns = now_ns();
+    if (open_link(dev) == 0)
+    {
+        /* Times are from Enter DFU, like in dfu_sim */
+        dev->start_ns = now_ns();
+        dev->status = dfu_host_program(&dev->host, &script, NULL);
+        dfu_link_close(&dev->bus_link.inner);
+    }
+    dev->report.total_ns = now_ns() - dev->start_ns;
+    dev->report.wall_ns = dev->report.total_ns;
+
+    if (dev->kind == LINK_SIM)
+    {
+        int sim_status = stop_sim(dev);
+
+        if ((dev->status == 0) && (sim_status != 0))
+        {
+            fprintf(stderr, "%s: dfu_sim failed with %d\n", dev->name, sim_status);
+            dev->status = DFU_HOST_ERROR_RESPONSE;
+        }
+    }
+    dev->report.status = dev->status;
+    atomic_store(&dev->finished, true);
+
+    return NULL;
+}
+
+/*******************************************************************************
+* Function Name: show_progress
+********************************************************************************
+* Summary:
+*  Prints one line with the share of rows each running kit has sent, and a
+*  line for each kit that finished since the last call.
+*
+* Return:
+*  true while any kit is running
+*
+*******************************************************************************/
+static bool show_progress(bool reported[])
+{
+    bool running = false;
+
+    for (size_t i = 0U; i < device_count; i++)
+    {
+        device_t *dev = &devices[i];
+
+        if (!atomic_load(&dev->finished))
+        {
+            size_t total = atomic_load(&dev->rows_total);
+
+            fprintf(stderr, "%s%s %zu%%", running ? "  " : "", dev->name,
+                    (total != 0U) ? ((atomic_load(&dev->rows_done) * 100U) / total) : 0U);
+            running = true;
+        }
+    }
+    if (running)
+    {
+        fprintf(stderr, "\n");
+    }
+
+    for (size_t i = 0U; i < device_count; i++)
+    {
+        device_t *dev = &devices[i];
+
+        if (!reported[i] && atomic_load(&dev->finished))
+        {
+            reported[i] = true;
+            fprintf(stderr, "%s: %s in %.1f s\n", dev->name, (dev->status == 0) ? "done" : dfu_status_name(dev->status),
+                    (double)dev->report.total_ns / 1e9);
+        }
+    }
+
+    return running;
+}
+
+/*******************************************************************************
+* Function Name: copy_file
+*******************************************************************************/
+static void copy_file(FILE *out, const char *path)
+{
+    char buffer[4096];
+    size_t length;
+    FILE *in = fopen(path, "r");
+
+    if (in == NULL)
+    {
+        fprintf(out, "null");
+        return;
+    }
+    while ((length = fread(buffer, 1U, sizeof(buffer), in)) != 0U)
+    {
+        (void)fwrite(buffer, 1U, length, out);
+    }
+    fclose(in);
+}
+
+/*******************************************************************************
+* Function Name: write_json
+*******************************************************************************/
+static void write_json(FILE *out)
+{
+    fprintf(out, "{\"tool\": \"dfu_fleet\", \"version\": 1, \"rows\": %zu, \"devices\": [", image.rows);
+    for (size_t i = 0U; i < device_count; i++)
+    {
+        device_t *dev = &devices[i];
+
+        fprintf(out, "%s\n  {\"name\": \"%s\", \"bus\": \"%s\", \"result\": ", (i == 0U) ? "" : ",", dev->name,
+                (dev->bus != NULL) ? dev->bus->name : "");
+        dfu_report_write_json(out, &dev->report);
+        if (dev->kind == LINK_SIM)
+        {
+            fprintf(out, ", \"sim\": ");
+            copy_file(out, dev->sim_result);
+        }
+        fprintf(out, "}");
+    }
+    fprintf(out, "\n]}\n");
+}
+
+/*******************************************************************************
+* Function Name: usage
+*******************************************************************************/
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [options] script.mtbdfu\n"
+            "  -d name=link[,bus=name]  kit to update, repeat for more. link is one of\n"
+            "                           serial:device[@baud]     (%u)\n"
+            "                           hid:/dev/hidrawN\n"
+            "                           i2c:/dev/i2c-N[@address] (0x%02X), on bus /dev/i2c-N\n"
+            "                           sim                      a dfu_sim process\n"
+            "  -n count                 add count simulated kits, sim0, sim1, ...\n"
+            "  -B bus=bytes_per_s       bandwidth limit of a bus\n"
+            "  -f file                  image to program instead of the dataFile of the script\n"
+            "  -I id[,id...]            program only the entries with these imageId values (all)\n"
+            "  -w window                commands in flight per kit (1, max %u)\n"
+            "  -c bytes                 payload per packet when sending rows (as the script)\n"
+            "  -x path                  DFU simulator (dfu_sim next to this tool)\n"
+            "  -o file                  write the JSON result of every kit to file\n",
+            name, DEFAULT_BAUD, DFU_LINK_I2C_ADDRESS, DFU_HOST_MAX_WINDOW);
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Loads the image once, updates all kits in parallel and prints a summary.
+*
+* Return:
+*  0 if all updates succeeded, 1 otherwise, 2 on usage errors
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    const char *data_file = NULL;
+    const char *data_files[MAX_DATA_FILES];
+    const char *image_ids = NULL;
+    const char *out_path = NULL;
+    uint32_t images = 0U;
+    size_t file_count = 0U;
+    size_t kept = 0U;
+    bool reported[MAX_DEVICES] = { false };
+    uint32_t sim_count = 0U;
+    uint32_t row_size = 0U;
+    size_t failed = 0U;
+    uint64_t start_ns;
+    int opt;
+
+    /* dfu_sim is built next to this tool */
+    snprintf(sim_path, sizeof(sim_path), "%.*sdfu_sim",
+             (strrchr(argv[0], '/') != NULL) ? (int)(strrchr(argv[0], '/') + 1 - argv[0]) : 0, argv[0]);
+
+    while ((opt = getopt(argc, argv, "d:n:B:f:I:w:c:x:o:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'd':
+                if (!add_device(optarg))
+                {
+                    usage(argv[0]);
+                    return 2;
+                }
+                break;
+            case 'n': sim_count = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'B':
+                if (!set_bus_limit(optarg))
+                {
+                    usage(argv[0]);
+                    return 2;
+                }
+                break;
+            case 'f': data_file = optarg; break;
+            case 'I': image_ids = optarg; break;
+            case 'w': window = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'c': chunk_size = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'x': snprintf(sim_path, sizeof(sim_path), "%s", optarg); break;
+            case 'o': out_path = optarg; break;
+            default: usage(argv[0]); return 2;
+        }
+    }
+    for (uint32_t i = 0U; i < sim_count; i++)
+    {
+        char spec[MAX_NAME + 8U];
+
+        snprintf(spec, sizeof(spec), "sim%u=sim", (unsigned int)i);
+        if (!add_device(spec))
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if ((optind != (argc - 1)) || (device_count == 0U) || (window == 0U) || (window > DFU_HOST_MAX_WINDOW) ||
+        ((chunk_size != 0U) && ((chunk_size <= DFU_ROW_HEADER_SIZE) || (chunk_size > DFU_PACKET_MAX_DATA))))
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    /* Load and seal the image once for all kits. The data files of the
+     * selected entries are merged into it, and only the first of these
+     * entries is kept to program the merged image. */
+    if ((dfu_script_load(&script, argv[optind]) != 0) ||
+        ((image_ids != NULL) && (dfu_script_select(&script, image_ids, &images) != 0)))
+    {
+        return 1;
+    }
+    for (size_t b = 0U; b < script.block_count; b++)
+    {
+        const dfu_script_block_t *block = &script.blocks[b];
+
+        if (!dfu_script_selected(block, images))
+        {
+            continue;
+        }
+        if (block->repeat_eof)
+        {
+            if ((row_size != 0U) && (block->row_length != row_size))
+            {
+                fprintf(stderr, "dfu_fleet: all entries must use the same row size\n");
+                return 1;
+            }
+            if (file_count == MAX_DATA_FILES)
+            {
+                fprintf(stderr, "dfu_fleet: more than %u data files\n", (unsigned int)MAX_DATA_FILES);
+                return 1;
+            }
+            data_files[file_count++] = block->data_file;
+            if (row_size != 0U)
+            {
+                continue;
+            }
+            row_size = block->row_length;
+        }
+        script.blocks[kept++] = *block;
+    }
+    script.block_count = kept;
+    file_count = (data_file != NULL) ? 1U : file_count;
+    data_files[0] = (data_file != NULL) ? data_file : data_files[0];
+
+    dfu_image_init(&image, row_size);
+    for (size_t i = 0U; (row_size != 0U) && (i < file_count); i++)
+    {
+        /* A container replaces the rows loaded so far, so only HEX files
+         * can be merged */
+        if (((file_count == 1U) ? dfu_image_load(&image, data_files[i]) :
+                                  dfu_image_load_hex(&image, data_files[i])) != 0)
+        {
+            return 1;
+        }
+    }
+    if ((row_size != 0U) && (dfu_image_seal(&image) != 0))
+    {
+        return 1;
+    }
+
+    snprintf(work_dir, sizeof(work_dir), "/tmp/dfu_fleet.XXXXXX");
+    if (mkdtemp(work_dir) == NULL)
+    {
+        fprintf(stderr, "dfu_fleet: cannot create a work directory: %s\n", strerror(errno));
+        return 1;
+    }
+
+    start_ns = now_ns();
+    for (size_t i = 0U; i < device_count; i++)
+    {
+        device_t *dev = &devices[i];
+
+        dev->host.window = window;
+        dev->host.chunk_size = chunk_size;
+        dev->host.image = &image;
+        dev->host.name = dev->name;
+        dev->host.row_done = row_done;
+        dev->host.row_context = dev;
+        dfu_report_init(&dev->report, (dev->kind == LINK_SIM) ? "sim" : "hardware", kind_names[dev->kind], row_size);
+        atomic_init(&dev->rows_done, 0U);
+        atomic_init(&dev->rows_total, 0U);
+        atomic_init(&dev->finished, false);
+        if (pthread_create(&dev->thread, NULL, worker, dev) != 0)
+        {
+            fprintf(stderr, "%s: cannot start a worker\n", dev->name);
+            dev->status = DFU_HOST_ERROR_LINK;
+            atomic_store(&dev->finished, true);
+        }
+    }
+
+    while (show_progress(reported))
+    {
+        sleep_ns((uint64_t)PROGRESS_PERIOD_MS * 1000000U);
+    }
+
+    printf("%-*s %-7s %-20s %8s %9s %10s\n", (int)MAX_NAME / 2, "kit", "link", "status", "rows", "time s", "KiB/s");
+    for (size_t i = 0U; i < device_count; i++)
+    {
+        device_t *dev = &devices[i];
+        double seconds = (double)dev->report.total_ns / 1e9;
+
+        (void)pthread_join(dev->thread, NULL);
+        printf("%-*s %-7s %-20s %8zu %9.3f %10.1f\n", (int)MAX_NAME / 2, dev->name, kind_names[dev->kind],
+               (dev->status == 0) ? "done" : dfu_status_name(dev->status), dev->report.rows, seconds,
+               (seconds > 0.0) ? (((double)dev->report.rows * row_size) / 1024.0 / seconds) : 0.0);
+        failed += (dev->status != 0) ? 1U : 0U;
+    }
+    printf("%zu of %zu kits updated in %.3f s\n", device_count - failed, device_count,
+           (double)(now_ns() - start_ns) / 1e9);
+
+    if (out_path != NULL)
+    {
+        FILE *out = fopen(out_path, "w");
+
+        if (out == NULL)
+        {
+            fprintf(stderr, "dfu_fleet: cannot write %s: %s\n", out_path, strerror(errno));
+            failed++;
+        }
+        else
+        {
+            write_json(out);
+            fclose(out);
+        }
+    }
+
+    for (size_t i = 0U; i < device_count; i++)
+    {
+        char flash[128];
+
+        snprintf(flash, sizeof(flash), "%s/%.*s.bin", work_dir, (int)MAX_NAME, devices[i].name);
+        (void)unlink(flash);
+        (void)unlink(devices[i].sim_result);
+        dfu_report_free(&devices[i].report);
+    }
+    (void)rmdir(work_dir);
+    dfu_image_free(&image);
+
+    return (failed == 0U) ? 0 : 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,324 @@
+/*******************************************************************************
+* File Name        : dfu_pack.c
+*
+* Description      : Packs an Intel HEX image, such as build/app_combined.hex,
+*                    into a DFU update container (proj_cm33_ns/dfu_container.h)
+*                    and lists the contents of containers. Hosts map the
+*                    container instead of parsing the HEX file on every update.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "dfu_container.h"
+#include "dfu_host.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define DEFAULT_ROW_SIZE        (0x200U)    /* flashRowLength of Program.mtbdfu */
+
+/*******************************************************************************
+* Function Name: put_u32
+*******************************************************************************/
+static void put_u32(uint8_t data[], uint32_t value)
+{
+    data[0] = (uint8_t)value;
+    data[1] = (uint8_t)(value >> 8U);
+    data[2] = (uint8_t)(value >> 16U);
+    data[3] = (uint8_t)(value >> 24U);
+}
+
+/*******************************************************************************
+* Function Name: get_u32
+*******************************************************************************/
+static uint32_t get_u32(const uint8_t data[])
+{
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8U) | ((uint32_t)data[2] << 16U) | ((uint32_t)data[3] << 24U);
+}
+
+/*******************************************************************************
+* Function Name: row_is_erased
+*******************************************************************************/
+static bool row_is_erased(const dfu_image_t *image, size_t row)
+{
+    const uint8_t *data = &image->data[row * image->row_size];
+
+    for (uint32_t i = 0U; i < image->row_size; i++)
+    {
+        if (data[i] != 0xFFU)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: is_next_row
+*******************************************************************************/
+static bool is_next_row(const dfu_image_t *image, size_t row)
+{
+    return (row != 0U) && (image->address[row] == (image->address[row - 1U] + image->row_size));
+}
+
+/*******************************************************************************
+* Function Name: write_container
+********************************************************************************
+* Summary:
+*  Writes the image as an update container, with the row CRC-32C table if
+*  row_crc is set.
+*
+* Return:
+*  0 on success, -1 on error (reported on stderr)
+*
+*******************************************************************************/
+static int write_container(const dfu_image_t *image, const char *path, bool row_crc)
+{
+    size_t segments = 0U;
+    size_t regions = 0U;
+    size_t segment_offset = sizeof(dfu_container_header_t);
+    size_t region_offset;
+    size_t crc_offset;
+    size_t payload_offset;
+    uint8_t *metadata;
+    uint8_t *entry;
+    int result = 0;
+    FILE *out;
+
+    for (size_t row = 0U; row < image->rows; row++)
+    {
+        bool erased = row_is_erased(image, row);
+
+        segments += is_next_row(image, row) ? 0U : 1U;
+        regions += (!erased && (!is_next_row(image, row) || row_is_erased(image, row - 1U))) ? 1U : 0U;
+    }
+    region_offset = segment_offset + (segments * sizeof(dfu_container_segment_t));
+    crc_offset = region_offset + (regions * sizeof(dfu_container_region_t));
+    payload_offset = crc_offset + (row_crc ? (image->rows * sizeof(uint32_t)) : 0U);
+    payload_offset = ((payload_offset + image->row_size - 1U) / image->row_size) * image->row_size;
+
+    metadata = calloc(1U, payload_offset);
+    if (metadata == NULL)
+    {
+        fprintf(stderr, "dfu_pack: out of memory\n");
+        return -1;
+    }
+
+    put_u32(&metadata[offsetof(dfu_container_header_t, magic)], DFU_CONTAINER_MAGIC);
+    metadata[offsetof(dfu_container_header_t, version)] = (uint8_t)DFU_CONTAINER_VERSION;
+    metadata[offsetof(dfu_container_header_t, header_size)] = (uint8_t)sizeof(dfu_container_header_t);
+    put_u32(&metadata[offsetof(dfu_container_header_t, flags)], row_crc ? DFU_CONTAINER_FLAG_ROW_CRC : 0U);
+    put_u32(&metadata[offsetof(dfu_container_header_t, row_size)], image->row_size);
+    put_u32(&metadata[offsetof(dfu_container_header_t, row_count)], (uint32_t)image->rows);
+    put_u32(&metadata[offsetof(dfu_container_header_t, segment_count)], (uint32_t)segments);
+    put_u32(&metadata[offsetof(dfu_container_header_t, region_count)], (uint32_t)regions);
+    put_u32(&metadata[offsetof(dfu_container_header_t, segment_offset)], (uint32_t)segment_offset);
+    put_u32(&metadata[offsetof(dfu_container_header_t, region_offset)], (uint32_t)region_offset);
+    put_u32(&metadata[offsetof(dfu_container_header_t, row_crc_offset)], row_crc ? (uint32_t)crc_offset : 0U);
+    put_u32(&metadata[offsetof(dfu_container_header_t, payload_offset)], (uint32_t)payload_offset);
+
+    /* Segments are runs of consecutive rows, regions runs of consecutive
+     * rows that are not erased */
+    segments = 0U;
+    regions = 0U;
+    for (size_t row = 0U; row < image->rows; row++)
+    {
+        bool next = is_next_row(image, row);
+
+        if (!next)
+        {
+            entry = &metadata[segment_offset + (segments++ * sizeof(dfu_container_segment_t))];
+            put_u32(&entry[offsetof(dfu_container_segment_t, address)], image->address[row]);
+            put_u32(&entry[offsetof(dfu_container_segment_t, first_row)], (uint32_t)row);
+        }
+        entry = &metadata[segment_offset + ((segments - 1U) * sizeof(dfu_container_segment_t))];
+        put_u32(&entry[offsetof(dfu_container_segment_t, row_count)],
+                (uint32_t)(row + 1U - get_u32(&entry[offsetof(dfu_container_segment_t, first_row)])));
+
+        if (!row_is_erased(image, row))
+        {
+            if (!next || row_is_erased(image, row - 1U))
+            {
+                entry = &metadata[region_offset + (regions++ * sizeof(dfu_container_region_t))];
+                put_u32(&entry[offsetof(dfu_container_region_t, address)], image->address[row]);
+            }
+            entry = &metadata[region_offset + ((regions - 1U) * sizeof(dfu_container_region_t))];
+            put_u32(&entry[offsetof(dfu_container_region_t, length)],
+                    image->address[row] + image->row_size - get_u32(&entry[offsetof(dfu_container_region_t, address)]));
+        }
+
+        if (row_crc)
+        {
+            put_u32(&metadata[crc_offset + (row * sizeof(uint32_t))], image->crc[row]);
+        }
+    }
+    put_u32(&metadata[offsetof(dfu_container_header_t, metadata_crc)], dfu_crc32c(metadata, payload_offset));
+
+    out = fopen(path, "wb");
+    if ((out == NULL) || (fwrite(metadata, 1U, payload_offset, out) != payload_offset) ||
+        (fwrite(image->data, image->row_size, image->rows, out) != image->rows))
+    {
+        fprintf(stderr, "dfu_pack: cannot write %s\n", path);
+        result = -1;
+    }
+    if ((out != NULL) && (fclose(out) != 0))
+    {
+        result = -1;
+    }
+    if (result == 0)
+    {
+        printf("%s: %zu rows of %u bytes in %zu segments, %zu regions with data\n", path, image->rows,
+               (unsigned int)image->row_size, segments, regions);
+    }
+    free(metadata);
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: list_container
+********************************************************************************
+* Summary:
+*  Prints the header and the tables of a container.
+*
+* Return:
+*  0 on success, -1 on error (reported on stderr)
+*
+*******************************************************************************/
+static int list_container(const char *path)
+{
+    uint8_t header[sizeof(dfu_container_header_t)];
+    dfu_image_t image;
+    uint32_t row_size;
+    FILE *in = fopen(path, "rb");
+
+    if ((in == NULL) || (fread(header, 1U, sizeof(header), in) != sizeof(header)))
+    {
+        fprintf(stderr, "dfu_pack: cannot read %s\n", path);
+        if (in != NULL)
+        {
+            fclose(in);
+        }
+        return -1;
+    }
+    fclose(in);
+
+    /* Map it like a host does, which checks it */
+    row_size = get_u32(&header[offsetof(dfu_container_header_t, row_size)]);
+    dfu_image_init(&image, (row_size != 0U) ? row_size : DEFAULT_ROW_SIZE);
+    if (dfu_image_load_container(&image, path) != 0)
+    {
+        return -1;
+    }
+
+    printf("version %u, rows of %u bytes, %zu rows, row CRC-32C %s, payload at 0x%X\n",
+           (unsigned int)header[offsetof(dfu_container_header_t, version)], (unsigned int)image.row_size, image.rows,
+           (image.crc != NULL) ? "yes" : "no",
+           (unsigned int)get_u32(&header[offsetof(dfu_container_header_t, payload_offset)]));
+    for (size_t row = 0U; row < image.rows; row++)
+    {
+        size_t end = row;
+
+        while (((end + 1U) < image.rows) && (image.address[end + 1U] == (image.address[end] + image.row_size)))
+        {
+            end++;
+        }
+        printf("  segment 0x%08X-0x%08X, %zu rows\n", (unsigned int)image.address[row],
+               (unsigned int)(image.address[end] + image.row_size - 1U), end - row + 1U);
+        row = end;
+    }
+    dfu_image_free(&image);
+
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: usage
+*******************************************************************************/
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [-r row_size] [-n] image.hex container\n"
+            "       %s -l container\n"
+            "  -r bytes   row size, flashRowLength of the script (0x%X)\n"
+            "  -n         leave out the row CRC-32C table\n"
+            "  -l         list a container\n",
+            name, name, DEFAULT_ROW_SIZE);
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Return:
+*  0 on success, 1 on errors, 2 on usage errors
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    uint32_t row_size = DEFAULT_ROW_SIZE;
+    bool row_crc = true;
+    bool list = false;
+    dfu_image_t image;
+    int result;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "r:nl")) != -1)
+    {
+        switch (opt)
+        {
+            case 'r': row_size = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'n': row_crc = false; break;
+            case 'l': list = true; break;
+            default: usage(argv[0]); return 2;
+        }
+    }
+    if (list && (optind == (argc - 1)))
+    {
+        return (list_container(argv[optind]) == 0) ? 0 : 1;
+    }
+    if (list || (optind != (argc - 2)) || (row_size == 0U) || (row_size > DFU_PACKET_MAX_DATA))
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    dfu_image_init(&image, row_size);
+    result = dfu_image_load_hex(&image, argv[optind]);
+    if ((result == 0) && (dfu_image_seal(&image) != 0))
+    {
+        fprintf(stderr, "dfu_pack: out of memory\n");
+        result = -1;
+    }
+    if (result == 0)
+    {
+        result = write_container(&image, argv[optind + 1], row_crc);
+    }
+    dfu_image_free(&image);
+
+    return (result == 0) ? 0 : 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,614 @@
+/*******************************************************************************
+* File Name        : dfu_sim.c
+*
+* Description      : Host simulation of the DFU application. Runs the DFU
+*                    main loop of proj_cm33_ns/main.c with dfu_user.c on a
+*                    file backed serial flash model and reports the
+*                    simulated duration of the update.
+*
+*                    The host side is either an external DFU host on a
+*                    pseudo terminal or Unix socket, the .mtbdfu script
+*                    given with -p, run in a thread of the simulator, or the
+*                    session capture given with -R, replayed with its
+*                    recorded timing.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+/* posix_openpt() and friends */
+#define _XOPEN_SOURCE 700
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "sim.h"
+#include "dfu_aes.h"
+#include "dfu_host.h"
+#include "dfu_link.h"
+#include "dfu_perf.h"
+#include "dfu_record.h"
+#include "dfu_trace.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Same values as proj_cm33_ns/main.c */
+#define DFU_SESSION_TIMEOUT_MS  (20U)
+#define DFU_COMMAND_TIMEOUT_MS  (5000U)
+#define DFU_LOOP_DELAY_US       (1000U)
+
+#define DEFAULT_FLASH_FILE      "dfu_sim_flash.bin"
+#define DEFAULT_BIT_RATE        (115200U)
+
+/* External flash of the kit: 64 MB, 256 KB sectors, 256 B pages */
+#define DEFAULT_FLASH_SIZE      (CY_XIP_PORT0_SIZE)
+#define DEFAULT_SECTOR_SIZE     (0x40000U)
+#define DEFAULT_PAGE_SIZE       (256U)
+#define DEFAULT_ERASE_US        (520000U)
+#define DEFAULT_PROGRAM_US      (340U)
+#define DEFAULT_READ_NS         (20U)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    int fd;
+    dfu_script_t script;
+    const char *data_file;
+    uint32_t images;                        /* See dfu_host_t.images */
+    int status;
+    atomic_bool done;
+} script_host_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static uint64_t sim_time_ns;
+
+/*******************************************************************************
+* Function Name: sim_clock_now
+*******************************************************************************/
+uint64_t sim_clock_now(void)
+{
+    return sim_time_ns;
+}
+
+/*******************************************************************************
+* Function Name: sim_clock_advance
+*******************************************************************************/
+void sim_clock_advance(uint64_t ns)
+{
+    sim_time_ns += ns;
+}
+
+/*******************************************************************************
+* Function Name: wall_time_ns
+*******************************************************************************/
+static uint64_t wall_time_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000U) + (uint64_t)now.tv_nsec;
+}
+
+/*******************************************************************************
+* Function Name: parse_u32
+*******************************************************************************/
+static uint32_t parse_u32(const char *text)
+{
+    return (uint32_t)strtoul(text, NULL, 0);
+}
+
+/*******************************************************************************
+* Function Name: open_pty
+********************************************************************************
+* Summary:
+*  Opens a pseudo terminal for an external DFU host. The slave side stays
+*  open so that the master does not see a hangup between host sessions.
+*
+* Return:
+*  The master file descriptor, or -1 on error
+*
+*******************************************************************************/
+static int open_pty(void)
+{
+    struct termios tio;
+    const char *name;
+    int slave;
+    int fd = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if ((fd < 0) || (grantpt(fd) != 0) || (unlockpt(fd) != 0) || ((name = ptsname(fd)) == NULL))
+    {
+        fprintf(stderr, "dfu_sim: cannot create a pseudo terminal: %s\n", strerror(errno));
+        return -1;
+    }
+
+    slave = open(name, O_RDWR | O_NOCTTY);
+    if ((slave >= 0) && (tcgetattr(slave, &tio) == 0))
+    {
+        cfmakeraw(&tio);
+        (void)tcsetattr(slave, TCSANOW, &tio);
+    }
+    printf("dfu_sim: DFU UART on %s\n", name);
+    fflush(stdout);
+
+    return fd;
+}
+
+/*******************************************************************************
+* Function Name: open_socket
+********************************************************************************
+* Summary:
+*  Listens on a Unix stream socket and waits for the DFU host to connect.
+*
+* Return:
+*  The connection, or -1 on error
+*
+*******************************************************************************/
+static int open_socket(const char *path)
+{
+    struct sockaddr_un addr;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    int conn = -1;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1U);
+    (void)unlink(path);
+
+    if ((fd < 0) || (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) || (listen(fd, 1) != 0))
+    {
+        fprintf(stderr, "dfu_sim: cannot listen on %s: %s\n", path, strerror(errno));
+    }
+    else
+    {
+        printf("dfu_sim: waiting for the DFU host on %s\n", path);
+        fflush(stdout);
+        conn = accept(fd, NULL, NULL);
+    }
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+
+    return conn;
+}
+
+/*******************************************************************************
+* Function Name: script_host_thread
+********************************************************************************
+* Summary:
+*  Runs the .mtbdfu script against the simulated device, like the DFU Host
+*  tool does against the kit.
+*
+*******************************************************************************/
+static void *script_host_thread(void *arg)
+{
+    script_host_t *sh = arg;
+    dfu_host_t host;
+
+    memset(&host, 0, sizeof(host));
+    host.images = sh->images;
+    if (dfu_link_open_fd(&host.link, sh->fd) == 0)
+    {
+        sh->status = dfu_host_program(&host, &sh->script, sh->data_file);
+        dfu_link_close(&host.link);
+    }
+    else
+    {
+        sh->status = DFU_HOST_ERROR_LINK;
+    }
+    atomic_store(&sh->done, true);
+
+    return NULL;
+}
+
+/*******************************************************************************
+* Function Name: print_report
+*******************************************************************************/
+static void print_report(uint64_t wall_ns)
+{
+    const sim_flash_stats_t *flash = sim_flash_get_stats();
+    const sim_link_stats_t *link = sim_transport_get_stats();
+    const sim_engine_stats_t *engine = sim_engine_get_stats();
+    double total_s = (double)sim_clock_now() / 1e9;
+    double bytes = (double)engine->rows_programmed * CY_NVM_SIZEOF_ROW;
+
+    printf("Simulated update time  %10.3f s\n", total_s);
+    printf("  Link                 %10.3f s  %llu packets in, %llu out, %llu bytes\n", (double)link->link_ns / 1e9,
+           (unsigned long long)link->packets_received, (unsigned long long)link->packets_sent,
+           (unsigned long long)(link->bytes_received + link->bytes_sent));
+    printf("  Flash erase          %10.3f s  %llu sectors\n", (double)flash->erase_ns / 1e9,
+           (unsigned long long)flash->sectors_erased);
+    printf("  Flash program        %10.3f s  %llu pages\n", (double)flash->program_ns / 1e9,
+           (unsigned long long)flash->pages_programmed);
+    printf("  Flash read           %10.3f s  %llu bytes\n", (double)flash->read_ns / 1e9,
+           (unsigned long long)flash->bytes_read);
+    printf("  Main loop            %10.3f s\n", (double)engine->loop_ns / 1e9);
+    printf("Rows programmed        %10llu\n", (unsigned long long)engine->rows_programmed);
+    printf("Rows verified          %10llu\n", (unsigned long long)engine->rows_verified);
+    printf("Command errors         %10llu\n", (unsigned long long)engine->errors);
+    printf("Program conflicts      %10llu\n", (unsigned long long)flash->conflicts);
+    printf("Throughput             %10.1f KiB/s\n", (total_s > 0.0) ? (bytes / 1024.0 / total_s) : 0.0);
+    printf("Wall time              %10.3f s\n", (double)wall_ns / 1e9);
+}
+
+/*******************************************************************************
+* Function Name: print_replay_report
+********************************************************************************
+* Summary:
+*  Prints the outcome of a session replay.
+*
+* Return:
+*  True if every recorded response was received unchanged
+*
+*******************************************************************************/
+static bool print_replay_report(const dfu_session_t *session, const sim_replay_stats_t *stats,
+                                uint32_t restarts, uint64_t wall_ns)
+{
+    const sim_engine_stats_t *engine = sim_engine_get_stats();
+
+    printf("Replayed packets       %10llu  of %zu recorded, %u not recorded\n", (unsigned long long)stats->sent,
+           session->count, (unsigned int)session->dropped);
+    printf("Responses matched      %10llu\n", (unsigned long long)stats->matched);
+    printf("Responses different    %10llu\n", (unsigned long long)stats->different);
+    printf("Responses missing      %10llu\n", (unsigned long long)stats->missing);
+    printf("Responses unexpected   %10llu\n", (unsigned long long)stats->unexpected);
+    if (stats->different != 0U)
+    {
+        printf("First difference       %10zu  command 0x%02X, recorded %s, replayed %s\n", stats->first_entry,
+               stats->first_command, dfu_status_name(stats->first_expected),
+               dfu_status_name(stats->first_received));
+    }
+    if (stats->timed != 0U)
+    {
+        printf("Response time capture  %10.3f ms average, %.3f ms max\n",
+               (double)stats->capture_ns / 1e6 / (double)stats->timed, (double)stats->capture_max_ns / 1e6);
+        printf("Response time replay   %10.3f ms average, %.3f ms max\n",
+               (double)stats->replay_ns / 1e6 / (double)stats->timed, (double)stats->replay_max_ns / 1e6);
+    }
+    printf("Session restarts       %10u  no command for %u ms\n", (unsigned int)restarts, DFU_COMMAND_TIMEOUT_MS);
+    printf("Rows programmed        %10llu\n", (unsigned long long)engine->rows_programmed);
+    printf("Wall time              %10.3f s\n", (double)wall_ns / 1e9);
+
+    return (stats->different == 0U) && (stats->missing == 0U) && (stats->unexpected == 0U);
+}
+
+/*******************************************************************************
+* Function Name: usage
+*******************************************************************************/
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  -p script.mtbdfu  run the script in the simulator instead of waiting for a host\n"
+            "  -f file.hex       data file, replaces the dataFile of the script\n"
+            "  -I id[,id...]     run only the script entries with these imageId values (all)\n"
+            "  -R capture        replay a recorded session instead of waiting for a host\n"
+            "  -x speed          replay speed, 1 as recorded, 0 without waiting (1)\n"
+            "  -u path           listen on a Unix socket instead of a pseudo terminal\n"
+            "  -m file           flash image file (" DEFAULT_FLASH_FILE ")\n"
+            "  -b bps            UART bit rate (%u)\n"
+            "  -l us             host turnaround per command (0)\n"
+            "  -s bytes          sector size (%u)\n"
+            "  -g bytes          program page size (%u)\n"
+            "  -e us             sector erase time (%u)\n"
+            "  -w us             page program time (%u)\n"
+            "  -r ns             read time per byte (%u)\n"
+            "  -j file           also write the result as JSON, - for stdout only\n"
+            "  -k key            transport key of encrypted updates, 32 hex digits (SECURE_DECRYPT)\n"
+            "  -d file           debug UART output, the DFU_TRACE and DFU_RECORD frames\n",
+            name, DEFAULT_BIT_RATE, DEFAULT_SECTOR_SIZE, DEFAULT_PAGE_SIZE, DEFAULT_ERASE_US,
+            DEFAULT_PROGRAM_US, DEFAULT_READ_NS);
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Runs the DFU loop until the host sends Exit DFU, then prints the report.
+*
+* Return:
+*  0 if the update finished without program conflicts or the replay matched
+*  the capture, 1 otherwise, 2 on usage errors
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    static uint8_t dfu_buffer[CY_DFU_SIZEOF_DATA_BUFFER];
+    static uint8_t dfu_packet[CY_DFU_SIZEOF_CMD_BUFFER];
+    static script_host_t script_host;
+    static dfu_session_t session;
+    cy_stc_dfu_params_t dfu_params =
+    {
+        .timeout = DFU_SESSION_TIMEOUT_MS,
+        .dataBuffer = &dfu_buffer[0],
+        .packetBuffer = &dfu_packet[0],
+    };
+    sim_flash_model_t flash_model =
+    {
+        .sector_size = DEFAULT_SECTOR_SIZE,
+        .page_size = DEFAULT_PAGE_SIZE,
+        .erase_us = DEFAULT_ERASE_US,
+        .program_us = DEFAULT_PROGRAM_US,
+        .read_ns_per_byte = DEFAULT_READ_NS,
+    };
+    sim_link_model_t link_model = { .bit_rate = DEFAULT_BIT_RATE, .latency_us = 0U };
+    mtb_serial_memory_t flash;
+    const char *script_path = NULL;
+    const char *replay_path = NULL;
+    const char *image_ids = NULL;
+    double replay_speed = 1.0;
+    sim_replay_stats_t replay_stats;
+    uint32_t restarts = 0U;
+    const char *socket_path = NULL;
+    const char *flash_path = DEFAULT_FLASH_FILE;
+    const char *json_path = NULL;
+    dfu_report_t report;
+    cy_en_dfu_status_t dfu_status;
+    uint32_t dfu_state = CY_DFU_STATE_NONE;
+    uint32_t count = 0U;
+    pthread_t host_thread;
+    uint64_t wall_start;
+    int fd;
+    uint8_t key[DFU_AES_KEY_SIZE];
+    int opt;
+    int result = 1;
+
+    while ((opt = getopt(argc, argv, "p:f:I:R:x:u:m:b:l:s:g:e:w:r:j:k:d:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'p': script_path = optarg; break;
+            case 'f': script_host.data_file = optarg; break;
+            case 'I': image_ids = optarg; break;
+            case 'R': replay_path = optarg; break;
+            case 'x': replay_speed = strtod(optarg, NULL); break;
+            case 'u': socket_path = optarg; break;
+            case 'm': flash_path = optarg; break;
+            case 'b': link_model.bit_rate = parse_u32(optarg); break;
+            case 'l': link_model.latency_us = parse_u32(optarg); break;
+            case 's': flash_model.sector_size = parse_u32(optarg); break;
+            case 'g': flash_model.page_size = parse_u32(optarg); break;
+            case 'e': flash_model.erase_us = parse_u32(optarg); break;
+            case 'w': flash_model.program_us = parse_u32(optarg); break;
+            case 'r': flash_model.read_ns_per_byte = parse_u32(optarg); break;
+            case 'j': json_path = optarg; break;
+            case 'k':
+                if (dfu_aes_parse(optarg, key, sizeof(key)) != 0)
+                {
+                    usage(argv[0]);
+                    return 2;
+                }
+                sim_secure_set_key(key);
+                break;
+            case 'd':
+                if (sim_uart_open(optarg) != 0)
+                {
+                    return 1;
+                }
+                break;
+            default: usage(argv[0]); return 2;
+        }
+    }
+    if ((optind != argc) || (link_model.bit_rate == 0U) || (flash_model.sector_size == 0U) ||
+        (flash_model.page_size == 0U) || ((flash_model.sector_size % flash_model.page_size) != 0U) ||
+        ((replay_path != NULL) && ((script_path != NULL) || (json_path != NULL))) || (replay_speed < 0.0))
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if ((script_path != NULL) &&
+        ((dfu_script_load(&script_host.script, script_path) != 0) ||
+         ((image_ids != NULL) && (dfu_script_select(&script_host.script, image_ids, &script_host.images) != 0))))
+    {
+        return 1;
+    }
+    if ((replay_path != NULL) && (dfu_session_load(&session, replay_path) != 0))
+    {
+        return 1;
+    }
+    if (sim_flash_open(&flash, flash_path, DEFAULT_FLASH_SIZE, &flash_model) != 0)
+    {
+        return 1;
+    }
+
+    /* Same start up as main.c. The transport drops pending input when it
+     * starts, so it starts before a host can connect. */
+#if defined(DFU_PERF)
+    dfu_perf_init();
+#endif /* defined(DFU_PERF) */
+#if defined(DFU_TRACE)
+    dfu_trace_init();
+#endif /* defined(DFU_TRACE) */
+#if defined(DFU_RECORD)
+    dfu_record_init();
+#endif /* defined(DFU_RECORD) */
+    Cy_DFU_AddExtMemory(&flash);
+    (void)Cy_DFU_Init(&dfu_state, &dfu_params);
+    dfu_report_init(&report, "sim", "uart", CY_NVM_SIZEOF_ROW);
+    sim_engine_set_report(&report);
+    Cy_DFU_TransportStart(CY_DFU_UART);
+
+    /* Connect the host */
+    if ((script_path != NULL) || (replay_path != NULL))
+    {
+        int pair[2];
+
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0)
+        {
+            fprintf(stderr, "dfu_sim: socketpair: %s\n", strerror(errno));
+            return 1;
+        }
+        fd = pair[0];
+        script_host.fd = pair[1];
+        atomic_init(&script_host.done, false);
+    }
+    else
+    {
+        fd = (socket_path != NULL) ? open_socket(socket_path) : open_pty();
+    }
+    if (fd < 0)
+    {
+        return 1;
+    }
+
+    sim_transport_attach(fd, &link_model);
+
+    wall_start = wall_time_ns();
+    if ((script_path != NULL) && (pthread_create(&host_thread, NULL, script_host_thread, &script_host) != 0))
+    {
+        fprintf(stderr, "dfu_sim: cannot start the host thread\n");
+        return 1;
+    }
+    if ((replay_path != NULL) && (sim_replay_start(script_host.fd, &session, replay_speed) != 0))
+    {
+        fprintf(stderr, "dfu_sim: cannot start the replay\n");
+        return 1;
+    }
+
+    for (;;)
+    {
+        dfu_status = Cy_DFU_Continue(&dfu_state, &dfu_params);
+        count++;
+        if (CY_DFU_STATE_FINISHED == dfu_state)
+        {
+            break;
+        }
+        else if (CY_DFU_STATE_FAILED == dfu_state)
+        {
+            count = 0U;
+            (void)Cy_DFU_Init(&dfu_state, &dfu_params);
+        }
+        else if ((dfu_state == CY_DFU_STATE_UPDATING) && (dfu_status == CY_DFU_ERROR_TIMEOUT))
+        {
+            if (count >= (DFU_COMMAND_TIMEOUT_MS / DFU_SESSION_TIMEOUT_MS))
+            {
+                restarts++;
+                count = 0U;
+                (void)Cy_DFU_Init(&dfu_state, &dfu_params);
+            }
+        }
+        else
+        {
+            count = 0U;
+        }
+
+        if (dfu_status == CY_DFU_ERROR_TIMEOUT)
+        {
+            /* The script host gave up or the capture ended, nothing more
+             * will arrive */
+            if (((script_path != NULL) && atomic_load(&script_host.done)) ||
+                ((replay_path != NULL) && sim_replay_done()))
+            {
+                break;
+            }
+        }
+        else
+        {
+            /* Idle time depends on the host, only count busy iterations */
+            sim_engine_loop_delay(DFU_LOOP_DELAY_US);
+        }
+#if defined(DFU_TRACE)
+        dfu_trace_drain();
+#endif /* defined(DFU_TRACE) */
+    }
+
+    /* As dfu_finish() of main.c */
+#if defined(DFU_TRACE)
+    dfu_trace_flush();
+#endif /* defined(DFU_TRACE) */
+#if defined(DFU_RECORD)
+    dfu_record_dump();
+#endif /* defined(DFU_RECORD) */
+    sim_uart_close();
+
+    if (script_path != NULL)
+    {
+        (void)pthread_join(host_thread, NULL);
+    }
+    if (replay_path != NULL)
+    {
+        sim_replay_finish(&replay_stats);
+    }
+
+    report.total_ns = sim_clock_now();
+    report.wall_ns = wall_time_ns() - wall_start;
+    if (replay_path != NULL)
+    {
+        /* A replay of a failed session is expected to end unfinished */
+        result = print_replay_report(&session, &replay_stats, restarts, report.wall_ns) ? 0 : 1;
+        dfu_session_free(&session);
+    }
+    else if (CY_DFU_STATE_FINISHED == dfu_state)
+    {
+        if ((json_path == NULL) || (strcmp(json_path, "-") != 0))
+        {
+            print_report(report.wall_ns);
+        }
+        result = (sim_flash_get_stats()->conflicts == 0U) ? 0 : 1;
+    }
+    else
+    {
+        report.status = (script_host.status != 0) ? script_host.status : DFU_HOST_ERROR_LINK;
+        fprintf(stderr, "dfu_sim: update failed: %s\n", dfu_status_name(report.status));
+    }
+
+    if (json_path != NULL)
+    {
+        FILE *out = (strcmp(json_path, "-") == 0) ? stdout : fopen(json_path, "w");
+
+        if (out == NULL)
+        {
+            fprintf(stderr, "dfu_sim: cannot write %s: %s\n", json_path, strerror(errno));
+            result = 1;
+        }
+        else
+        {
+            dfu_report_write_json(out, &report);
+            fputc('\n', out);
+            if (out != stdout)
+            {
+                fclose(out);
+            }
+        }
+    }
+    dfu_report_free(&report);
+
+    Cy_DFU_TransportStop();
+    sim_flash_close(&flash);
+
+    return result;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,36 @@
+/*******************************************************************************
+* File Name        : cy_device_headers.h
+*
+* Description      : Host stand-in for the device headers: the XIP address
+*                    windows of PSOC Edge that the external memory maps to.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef CY_DEVICE_HEADERS_H
+#define CY_DEVICE_HEADERS_H
+
+#define CY_XIP_PORT0_BASE               (0x60000000UL)
+#define CY_XIP_PORT0_SIZE               (0x04000000UL)
+#define CY_XIP_PORT1_BASE               (0x64000000UL)
+#define CY_XIP_PORT1_SIZE               (0x04000000UL)
+
+#endif /* CY_DEVICE_HEADERS_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,94 @@
+/*******************************************************************************
+* File Name        : cy_dfu.h
+*
+* Description      : Host stand-in for the DFU middleware API. The types and
+*                    names match the middleware so that dfu_user.c builds
+*                    unchanged; Cy_DFU_Init() and Cy_DFU_Continue() are
+*                    implemented by sim_engine.c.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef CY_DFU_H
+#define CY_DFU_H
+
+#include "cy_syslib.h"
+#include "dfu_user.h"
+
+/* Status codes. Only the low byte goes on the wire as the response status. */
+typedef enum
+{
+    CY_DFU_SUCCESS              = 0x00,
+    CY_DFU_ERROR_VERIFY         = 0x02,
+    CY_DFU_ERROR_LENGTH         = 0x03,
+    CY_DFU_ERROR_DATA           = 0x04,
+    CY_DFU_ERROR_CMD            = 0x05,
+    CY_DFU_ERROR_CHECKSUM       = 0x08,
+    CY_DFU_ERROR_ADDRESS        = 0x0A,
+    CY_DFU_ERROR_TIMEOUT        = 0x0F40,
+    CY_DFU_ERROR_BAD_PARAM      = 0x0F41,
+    CY_DFU_ERROR_READ_EXT       = 0x0B,
+    CY_DFU_ERROR_WRITE_EXT      = 0x0C,
+    CY_DFU_ERROR_UNKNOWN        = 0x0F
+} cy_en_dfu_status_t;
+
+typedef enum
+{
+    CY_DFU_I2C,
+    CY_DFU_UART,
+    CY_DFU_SPI,
+    CY_DFU_USB_CDC,
+    CY_DFU_USB_HID,
+    CY_DFU_CANFD
+} cy_en_dfu_transport_t;
+
+typedef struct
+{
+    uint32_t timeout;           /* Transport read timeout in milliseconds */
+    uint8_t *dataBuffer;        /* CY_DFU_SIZEOF_DATA_BUFFER bytes */
+    uint8_t *packetBuffer;      /* CY_DFU_SIZEOF_CMD_BUFFER bytes */
+} cy_stc_dfu_params_t;
+
+/* ctl argument of Cy_DFU_WriteData() and Cy_DFU_ReadData() */
+#define CY_DFU_IOCTL_WRITE              (0x00U)
+#define CY_DFU_IOCTL_ERASE              (0x01U)
+#define CY_DFU_IOCTL_READ               (0x00U)
+#define CY_DFU_IOCTL_COMPARE            (0x01U)
+
+/* DFU states */
+#define CY_DFU_STATE_NONE               (0U)
+#define CY_DFU_STATE_UPDATING           (1U)
+#define CY_DFU_STATE_FINISHED           (2U)
+#define CY_DFU_STATE_FAILED             (3U)
+
+cy_en_dfu_status_t Cy_DFU_Init(uint32_t *state, cy_stc_dfu_params_t *params);
+cy_en_dfu_status_t Cy_DFU_Continue(uint32_t *state, cy_stc_dfu_params_t *params);
+
+/* Implemented by dfu_user.c */
+cy_en_dfu_status_t Cy_DFU_WriteData(uint32_t address, uint32_t length, uint32_t ctl, cy_stc_dfu_params_t *params);
+cy_en_dfu_status_t Cy_DFU_ReadData(uint32_t address, uint32_t length, uint32_t ctl, cy_stc_dfu_params_t *params);
+void Cy_DFU_TransportStart(cy_en_dfu_transport_t transport);
+void Cy_DFU_TransportStop(void);
+void Cy_DFU_TransportReset(void);
+cy_en_dfu_status_t Cy_DFU_TransportRead(uint8_t buffer[], uint32_t size, uint32_t *count, uint32_t timeout);
+cy_en_dfu_status_t Cy_DFU_TransportWrite(uint8_t buffer[], uint32_t size, uint32_t *count, uint32_t timeout);
+
+#endif /* CY_DFU_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,47 @@
+/*******************************************************************************
+* File Name        : cy_dfu_logging.h
+*
+* Description      : Host stand-in for the DFU middleware logging. Messages
+*                    at or above CY_DFU_LOG_LEVEL go to stderr.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef CY_DFU_LOGGING_H
+#define CY_DFU_LOGGING_H
+
+#include <stdio.h>
+
+#define CY_DFU_LOG_LEVEL_OFF            (0)
+#define CY_DFU_LOG_LEVEL_ERROR          (1)
+#define CY_DFU_LOG_LEVEL_WARNING        (2)
+#define CY_DFU_LOG_LEVEL_INFO           (3)
+#define CY_DFU_LOG_LEVEL_DEBUG          (4)
+
+#define CY_DFU_LOG_AT(level, ...) \
+    do { if (CY_DFU_LOG_LEVEL >= (level)) { fprintf(stderr, __VA_ARGS__); fputc('\n', stderr); } } while (0)
+
+#define CY_DFU_LOG_ERR(...)             CY_DFU_LOG_AT(CY_DFU_LOG_LEVEL_ERROR, __VA_ARGS__)
+#define CY_DFU_LOG_WRN(...)             CY_DFU_LOG_AT(CY_DFU_LOG_LEVEL_WARNING, __VA_ARGS__)
+#define CY_DFU_LOG_INF(...)             CY_DFU_LOG_AT(CY_DFU_LOG_LEVEL_INFO, __VA_ARGS__)
+#define CY_DFU_LOG_DBG(...)             CY_DFU_LOG_AT(CY_DFU_LOG_LEVEL_DEBUG, __VA_ARGS__)
+
+#endif /* CY_DFU_LOGGING_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,79 @@
+/*******************************************************************************
+* File Name        : cy_pdl.h
+*
+* Description      : Host stand-in for the parts of the PDL that DFU_PERF,
+*                    DFU_TRACE and DFU_RECORD use. The DWT cycle counter
+*                    follows the simulated time, and the debug UART writes
+*                    to the file given with dfu_sim -d.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef CY_PDL_H
+#define CY_PDL_H
+
+#include <stdint.h>
+#include "cy_syslib.h"
+
+/* DWT cycle counter and its enables */
+typedef struct
+{
+    uint32_t CTRL;
+    uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+    uint32_t DEMCR;
+} CoreDebug_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk          (1UL)
+#define CoreDebug_DEMCR_TRCENA_Msk      (1UL << 24U)
+
+/* CYCCNT is updated from the simulated time on every access */
+#define DWT                             (sim_dwt())
+#define CoreDebug                       (&sim_core_debug)
+
+#define __CLZ(x)                        ((uint8_t)(((x) == 0U) ? 32 : __builtin_clz(x)))
+#define __STATIC_INLINE                 static inline
+#define __disable_irq()                 ((void)0)
+
+/* The simulator runs one thread, an exclusive store always succeeds */
+#define __LDREXW(addr)                  (*(volatile uint32_t *)(addr))
+#define __STREXW(value, addr)           ((*(volatile uint32_t *)(addr) = (value)), 0U)
+#define __CLREX()                       ((void)0)
+#define __DMB()                         __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+extern uint32_t SystemCoreClock;
+extern CoreDebug_Type sim_core_debug;
+DWT_Type *sim_dwt(void);
+
+/* Debug UART */
+typedef void CySCB_Type;
+
+uint32_t Cy_SysLib_EnterCriticalSection(void);
+void Cy_SysLib_ExitCriticalSection(uint32_t savedIntrStatus);
+uint32_t Cy_SCB_GetFifoSize(CySCB_Type const *base);
+uint32_t Cy_SCB_UART_GetNumInTxFifo(CySCB_Type const *base);
+uint32_t Cy_SCB_UART_PutArray(CySCB_Type *base, void *buffer, uint32_t size);
+void Cy_SCB_UART_PutArrayBlocking(CySCB_Type *base, void *buffer, uint32_t size);
+
+#endif /* CY_PDL_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,48 @@
+/*******************************************************************************
+* File Name        : cy_syslib.h
+*
+* Description      : Host stand-in for the PDL system library, the subset that
+*                    dfu_user.c uses.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef CY_SYSLIB_H
+#define CY_SYSLIB_H
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint32_t cy_rslt_t;
+
+#define CY_RSLT_SUCCESS                 ((cy_rslt_t)0x00000000U)
+#define CY_RSLT_GET_MODULE(x)           (((x) >> 16U) & 0x0FFFU)
+#define CY_RSLT_GET_CODE(x)             ((x) & 0xFFFFU)
+
+#define CY_ASSERT(x)                    assert(x)
+#define CY_UNUSED_PARAMETER(x)          ((void)(x))
+#define CY_MISRA_DEVIATE_LINE(id, txt)
+#define CY_SECTION(name)                __attribute__((section(name)))
+#define __USED                          __attribute__((used))
+
+#endif /* CY_SYSLIB_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,51 @@
+/*******************************************************************************
+* File Name        : cybsp.h
+*
+* Description      : Host stand-in for the board support package: the regions
+*                    of the memory map that dfu_user.c takes its update slots
+*                    from: three update slots of 256 KB in the external
+*                    memory. Define DFU_UPDATE_SLOTS in SIM_DEFINES for
+*                    another layout. The primary slots are empty, the
+*                    simulator has no running images to read. The debug
+*                    UART is a placeholder for the stand-ins of sim_pdl.c.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef CYBSP_H
+#define CYBSP_H
+
+#define CYMEM_CM33_0_m33s_upgrade_slot_START    (0x601C0000U)
+#define CYMEM_CM33_0_m33s_upgrade_slot_SIZE     (0x00040000U)
+#define CYMEM_CM33_0_m33_upgrade_slot_START     (0x60200000U)
+#define CYMEM_CM33_0_m33_upgrade_slot_SIZE      (0x00040000U)
+#define CYMEM_CM33_0_m55_upgrade_slot_START     (0x60240000U)
+#define CYMEM_CM33_0_m55_upgrade_slot_SIZE      (0x00040000U)
+
+#define CYMEM_CM33_0_m33_nvm_START              (0U)
+#define CYMEM_CM33_0_m33_nvm_SIZE               (0U)
+#define CYMEM_CM33_0_m55_nvm_START              (0U)
+#define CYMEM_CM33_0_m55_nvm_SIZE               (0U)
+
+/* Debug UART, see Cy_SCB_UART_PutArray() in sim_pdl.c */
+#define CYBSP_DEBUG_UART_HW                     ((void *)0)
+
+#endif /* CYBSP_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,31 @@
+/*******************************************************************************
+* File Name        : mtb_hal.h
+*
+* Description      : Empty host stand-in, so that retarget_io_init.h of the
+*                    application can be included by the simulator.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef MTB_HAL_H
+#define MTB_HAL_H
+
+#endif /* MTB_HAL_H */
+
+/* [] END OF FILE */
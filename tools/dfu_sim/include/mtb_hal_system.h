@@ -0,0 +1,44 @@
+/*******************************************************************************
+* File Name        : mtb_hal_system.h
+*
+* Description      : Host stand-in for the HAL system driver. The simulation
+*                    is single threaded on the device side, so critical
+*                    sections do nothing.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef MTB_HAL_SYSTEM_H
+#define MTB_HAL_SYSTEM_H
+
+#include "cy_syslib.h"
+
+static inline uint32_t mtb_hal_system_critical_section_enter(void)
+{
+    return 0U;
+}
+
+static inline void mtb_hal_system_critical_section_exit(uint32_t old_state)
+{
+    (void)old_state;
+}
+
+#endif /* MTB_HAL_SYSTEM_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,50 @@
+/*******************************************************************************
+* File Name        : mtb_serial_memory.h
+*
+* Description      : Host stand-in for the serial-memory middleware. The
+*                    memory is a file mapped into the simulator, see
+*                    sim_flash.c.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef MTB_SERIAL_MEMORY_H
+#define MTB_SERIAL_MEMORY_H
+
+#include "cy_syslib.h"
+
+/* Error returned for an access outside of the memory */
+#define MTB_SERIAL_MEMORY_RSLT_ERR_ADDRESS  ((cy_rslt_t)0x04A10001U)
+
+typedef struct
+{
+    uint8_t *data;              /* Mapped memory file */
+    size_t size;
+} mtb_serial_memory_t;
+
+size_t mtb_serial_memory_get_erase_size(mtb_serial_memory_t *obj, uint32_t addr);
+uint32_t mtb_serial_memory_get_sector_start_address(mtb_serial_memory_t *obj, uint32_t addr);
+size_t mtb_serial_memory_get_prog_size(mtb_serial_memory_t *obj, uint32_t addr);
+cy_rslt_t mtb_serial_memory_erase(mtb_serial_memory_t *obj, uint32_t addr, size_t length);
+cy_rslt_t mtb_serial_memory_write(mtb_serial_memory_t *obj, uint32_t addr, size_t length, const uint8_t *buf);
+cy_rslt_t mtb_serial_memory_read(mtb_serial_memory_t *obj, uint32_t addr, size_t length, uint8_t *buf);
+
+#endif /* MTB_SERIAL_MEMORY_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,40 @@
+/*******************************************************************************
+* File Name        : transport_uart.h
+*
+* Description      : Host stand-in for the DFU UART transport. The simulator
+*                    serves it over a pty or a socket, see sim_transport.c.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef TRANSPORT_UART_H
+#define TRANSPORT_UART_H
+
+#include "cy_dfu.h"
+
+void UART_UartCyBtldrCommStart(void);
+void UART_UartCyBtldrCommStop(void);
+void UART_UartCyBtldrCommReset(void);
+cy_en_dfu_status_t UART_UartCyBtldrCommRead(uint8_t pData[], uint32_t size, uint32_t *count, uint32_t timeout);
+cy_en_dfu_status_t UART_UartCyBtldrCommWrite(const uint8_t pData[], uint32_t size, uint32_t *count,
+                                             uint32_t timeout);
+
+#endif /* TRANSPORT_UART_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,133 @@
+/*******************************************************************************
+* File Name        : sim.h
+*
+* Description      : Interface between the parts of the DFU simulator: the
+*                    simulated clock, the serial flash model, the transport
+*                    and the DFU command engine.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "cy_dfu.h"
+#include "mtb_serial_memory.h"
+#include "dfu_report.h"
+#include "dfu_session.h"
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+
+/* Serial flash geometry and timing */
+typedef struct
+{
+    uint32_t sector_size;           /* Erase granularity in bytes */
+    uint32_t page_size;             /* Program granularity in bytes */
+    uint32_t erase_us;              /* Time to erase one sector */
+    uint32_t program_us;            /* Time to program one page */
+    uint32_t read_ns_per_byte;      /* Read time per byte */
+} sim_flash_model_t;
+
+typedef struct
+{
+    uint64_t sectors_erased;
+    uint64_t pages_programmed;
+    uint64_t bytes_read;
+    uint64_t erase_ns;
+    uint64_t program_ns;
+    uint64_t read_ns;
+    uint64_t conflicts;             /* Programmed bytes that were not erased */
+} sim_flash_stats_t;
+
+/* Link between host and device */
+typedef struct
+{
+    uint32_t bit_rate;              /* Bits per second, 10 bits per byte */
+    uint32_t latency_us;            /* Turnaround added to every packet */
+} sim_link_model_t;
+
+typedef struct
+{
+    uint64_t packets_received;
+    uint64_t packets_sent;
+    uint64_t bytes_received;
+    uint64_t bytes_sent;
+    uint64_t link_ns;
+} sim_link_stats_t;
+
+typedef struct
+{
+    uint64_t rows_programmed;
+    uint64_t rows_verified;
+    uint64_t errors;
+    uint64_t loop_ns;               /* Main loop delay */
+} sim_engine_stats_t;
+
+/* Outcome of a session replay */
+typedef struct
+{
+    uint64_t sent;                  /* Host packets sent */
+    uint64_t matched;               /* Responses equal to the recorded ones */
+    uint64_t different;
+    uint64_t missing;               /* Recorded responses that did not come */
+    uint64_t unexpected;            /* Responses beyond the recorded ones */
+    size_t first_entry;             /* Capture entry of the first difference */
+    uint8_t first_command;          /* Its command, recorded status and status */
+    uint8_t first_expected;
+    uint8_t first_received;
+    uint64_t timed;                 /* Responses with both response times */
+    uint64_t capture_ns;            /* Sum and maximum of the response times */
+    uint64_t capture_max_ns;
+    uint64_t replay_ns;
+    uint64_t replay_max_ns;
+} sim_replay_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+uint64_t sim_clock_now(void);
+void sim_clock_advance(uint64_t ns);
+
+int sim_flash_open(mtb_serial_memory_t *obj, const char *path, size_t size, const sim_flash_model_t *model);
+void sim_flash_close(mtb_serial_memory_t *obj);
+const sim_flash_stats_t *sim_flash_get_stats(void);
+
+void sim_transport_attach(int fd, const sim_link_model_t *model);
+const sim_link_stats_t *sim_transport_get_stats(void);
+
+const sim_engine_stats_t *sim_engine_get_stats(void);
+void sim_engine_loop_delay(uint32_t delay_us);
+void sim_engine_set_report(dfu_report_t *report);
+
+void sim_secure_set_key(const uint8_t key[]);
+
+int sim_uart_open(const char *path);
+void sim_uart_close(void);
+
+int sim_replay_start(int fd, const dfu_session_t *session, double speed);
+bool sim_replay_done(void);
+void sim_replay_finish(sim_replay_stats_t *stats);
+
+#endif /* SIM_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,345 @@
+/*******************************************************************************
+* File Name        : sim_engine.c
+*
+* Description      : DFU command engine of the simulator. Stands in for
+*                    Cy_DFU_Init() and Cy_DFU_Continue() of the DFU
+*                    middleware, which is not part of this repository, with
+*                    the subset of commands the .mtbdfu scripts of the MCUboot
+*                    flow use. Packets are received and answered through the
+*                    Cy_DFU_Transport* calls and rows are written through
+*                    Cy_DFU_WriteData() of dfu_user.c.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#include <string.h>
+#include "sim.h"
+#include "dfu_crc.h"
+#include "dfu_host.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define PACKET_CMD_IDX          (1U)
+#define PACKET_DATA_IDX         (4U)
+#define ROW_HEADER_SIZE         (8U)    /* Address and CRC-32C of the row */
+
+/* Enter DFU response: silicon ID (4), silicon revision (1), DFU SDK version (3) */
+#define ENTER_RESPONSE_SIZE     (8U)
+
+/* Time allowed to send a response */
+#define RESPONSE_TIMEOUT_MS     (20U)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static uint32_t data_length;            /* Bytes collected by Send Data */
+static sim_engine_stats_t engine_stats;
+static dfu_report_t *row_report;       /* Receives the end time of each row */
+
+/*******************************************************************************
+* Function Name: get_u32
+*******************************************************************************/
+static uint32_t get_u32(const uint8_t data[])
+{
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8U) | ((uint32_t)data[2] << 16U) | ((uint32_t)data[3] << 24U);
+}
+
+/*******************************************************************************
+* Function Name: send_response
+*******************************************************************************/
+static void send_response(cy_stc_dfu_params_t *params, uint8_t status, const uint8_t data[], uint32_t length)
+{
+    uint8_t *packet = params->packetBuffer;
+    uint32_t count = 0U;
+    uint16_t checksum;
+
+    packet[0] = DFU_PACKET_SOP;
+    packet[1] = status;
+    packet[2] = (uint8_t)length;
+    packet[3] = (uint8_t)(length >> 8U);
+    if (length != 0U)
+    {
+        memcpy(&packet[PACKET_DATA_IDX], data, length);
+    }
+    checksum = dfu_packet_checksum(packet, PACKET_DATA_IDX + length);
+    packet[PACKET_DATA_IDX + length] = (uint8_t)checksum;
+    packet[PACKET_DATA_IDX + length + 1U] = (uint8_t)(checksum >> 8U);
+    packet[PACKET_DATA_IDX + length + 2U] = DFU_PACKET_EOP;
+
+    (void)Cy_DFU_TransportWrite(packet, length + DFU_PACKET_MIN_SIZE, &count, RESPONSE_TIMEOUT_MS);
+}
+
+/*******************************************************************************
+* Function Name: check_packet
+********************************************************************************
+* Summary:
+*  Checks the framing and checksum of a received packet.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t check_packet(const uint8_t packet[], uint32_t count, uint32_t *length)
+{
+    cy_en_dfu_status_t status = CY_DFU_SUCCESS;
+
+    *length = 0U;
+    if ((count < DFU_PACKET_MIN_SIZE) || (packet[0] != DFU_PACKET_SOP))
+    {
+        status = CY_DFU_ERROR_DATA;
+    }
+    else
+    {
+        *length = (uint32_t)packet[2] | ((uint32_t)packet[3] << 8U);
+        if ((*length + DFU_PACKET_MIN_SIZE) != count)
+        {
+            status = CY_DFU_ERROR_LENGTH;
+        }
+        else if (packet[count - 1U] != DFU_PACKET_EOP)
+        {
+            status = CY_DFU_ERROR_DATA;
+        }
+        else if (dfu_packet_checksum(packet, PACKET_DATA_IDX + *length) !=
+                 (uint16_t)(packet[count - 3U] | ((uint16_t)packet[count - 2U] << 8U)))
+        {
+            status = CY_DFU_ERROR_CHECKSUM;
+        }
+    }
+
+    return status;
+}
+
+/*******************************************************************************
+* Function Name: collect_data
+********************************************************************************
+* Summary:
+*  Appends the payload of Send Data, Program Data or Verify Data to the row
+*  being assembled in the data buffer.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t collect_data(cy_stc_dfu_params_t *params, const uint8_t data[], uint32_t length)
+{
+    cy_en_dfu_status_t status = CY_DFU_SUCCESS;
+
+    if ((data_length + length) > CY_DFU_SIZEOF_DATA_BUFFER)
+    {
+        data_length = 0U;
+        status = CY_DFU_ERROR_LENGTH;
+    }
+    else
+    {
+        memcpy(&params->dataBuffer[data_length], data, length);
+        data_length += length;
+    }
+
+    return status;
+}
+
+/*******************************************************************************
+* Function Name: command_row
+********************************************************************************
+* Summary:
+*  Program Data and Verify Data: completes the row, checks its CRC-32C and
+*  writes or compares it.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t command_row(uint8_t command, cy_stc_dfu_params_t *params, const uint8_t data[],
+                                      uint32_t length)
+{
+    cy_en_dfu_status_t status = CY_DFU_ERROR_LENGTH;
+
+    if (length >= ROW_HEADER_SIZE)
+    {
+        uint32_t address = get_u32(&data[0]);
+        uint32_t crc = get_u32(&data[4]);
+
+        status = collect_data(params, &data[ROW_HEADER_SIZE], length - ROW_HEADER_SIZE);
+        if ((status == CY_DFU_SUCCESS) && (dfu_crc32c(params->dataBuffer, data_length) != crc))
+        {
+            status = CY_DFU_ERROR_CHECKSUM;
+        }
+        if (status == CY_DFU_SUCCESS)
+        {
+            if (command == DFU_CMD_PROGRAM_DATA)
+            {
+                status = Cy_DFU_WriteData(address, data_length, CY_DFU_IOCTL_WRITE, params);
+                if (status == CY_DFU_SUCCESS)
+                {
+                    engine_stats.rows_programmed++;
+                    if (row_report != NULL)
+                    {
+                        (void)dfu_report_add_row(row_report, sim_clock_now());
+                    }
+                }
+            }
+            else
+            {
+                status = Cy_DFU_ReadData(address, data_length, CY_DFU_IOCTL_COMPARE, params);
+                engine_stats.rows_verified += (status == CY_DFU_SUCCESS) ? 1U : 0U;
+            }
+        }
+        data_length = 0U;
+    }
+
+    return status;
+}
+
+/*******************************************************************************
+* Function Name: sim_engine_get_stats
+*******************************************************************************/
+const sim_engine_stats_t *sim_engine_get_stats(void)
+{
+    return &engine_stats;
+}
+
+/*******************************************************************************
+* Function Name: sim_engine_set_report
+*******************************************************************************/
+void sim_engine_set_report(dfu_report_t *report)
+{
+    row_report = report;
+}
+
+/*******************************************************************************
+* Function Name: sim_engine_loop_delay
+********************************************************************************
+* Summary:
+*  Accounts for the delay the main loop spends outside of Cy_DFU_Continue().
+*
+*******************************************************************************/
+void sim_engine_loop_delay(uint32_t delay_us)
+{
+    engine_stats.loop_ns += (uint64_t)delay_us * 1000U;
+    sim_clock_advance((uint64_t)delay_us * 1000U);
+}
+
+/*******************************************************************************
+* Function Name: Cy_DFU_Init
+*******************************************************************************/
+cy_en_dfu_status_t Cy_DFU_Init(uint32_t *state, cy_stc_dfu_params_t *params)
+{
+    cy_en_dfu_status_t status = CY_DFU_ERROR_BAD_PARAM;
+
+    if ((state != NULL) && (params != NULL) && (params->dataBuffer != NULL) && (params->packetBuffer != NULL))
+    {
+        *state = CY_DFU_STATE_NONE;
+        data_length = 0U;
+        status = CY_DFU_SUCCESS;
+    }
+
+    return status;
+}
+
+/*******************************************************************************
+* Function Name: Cy_DFU_Continue
+********************************************************************************
+* Summary:
+*  Receives and runs one command. Exit DFU moves to CY_DFU_STATE_FINISHED
+*  without a response, like the middleware does before the device resets.
+*
+*******************************************************************************/
+cy_en_dfu_status_t Cy_DFU_Continue(uint32_t *state, cy_stc_dfu_params_t *params)
+{
+    uint8_t *packet = params->packetBuffer;
+    uint8_t response[ENTER_RESPONSE_SIZE] = { 0U };
+    uint32_t response_length = 0U;
+    uint32_t count = 0U;
+    uint32_t length;
+    cy_en_dfu_status_t status;
+
+    status = Cy_DFU_TransportRead(packet, CY_DFU_SIZEOF_CMD_BUFFER, &count, params->timeout);
+    if (status != CY_DFU_SUCCESS)
+    {
+        return status;
+    }
+
+    status = check_packet(packet, count, &length);
+    if (status == CY_DFU_SUCCESS)
+    {
+        uint8_t command = packet[PACKET_CMD_IDX];
+        const uint8_t *data = &packet[PACKET_DATA_IDX];
+
+        if ((*state != CY_DFU_STATE_UPDATING) && (command != DFU_CMD_ENTER))
+        {
+            status = CY_DFU_ERROR_CMD;
+        }
+        else
+        {
+            switch (command)
+            {
+                case DFU_CMD_ENTER:
+                    if (((length != 0U) && (length != 4U)) || ((length == 4U) && (get_u32(data) != CY_DFU_PRODUCT)))
+                    {
+                        status = CY_DFU_ERROR_DATA;
+                    }
+                    else
+                    {
+                        *state = CY_DFU_STATE_UPDATING;
+                        data_length = 0U;
+                        response_length = ENTER_RESPONSE_SIZE;
+                    }
+                    break;
+
+                case DFU_CMD_SYNC:
+                    data_length = 0U;
+                    break;
+
+                case DFU_CMD_SEND_DATA:
+                    status = collect_data(params, data, length);
+                    break;
+
+                case DFU_CMD_PROGRAM_DATA:
+                case DFU_CMD_VERIFY_DATA:
+                    status = command_row(command, params, data, length);
+                    break;
+
+                case DFU_CMD_ERASE_DATA:
+                    status = (length == 4U) ? Cy_DFU_WriteData(get_u32(data), 0U, CY_DFU_IOCTL_ERASE, params) :
+                                              CY_DFU_ERROR_LENGTH;
+                    break;
+
+                case DFU_CMD_VERIFY_APP:
+                    response_length = 1U;
+                    response[0] = 1U;
+                    break;
+
+                case DFU_CMD_EXIT:
+                    *state = CY_DFU_STATE_FINISHED;
+                    return CY_DFU_SUCCESS;
+
+                default:
+                    status = CY_DFU_ERROR_CMD;
+                    break;
+            }
+        }
+    }
+
+    if (status != CY_DFU_SUCCESS)
+    {
+        engine_stats.errors++;
+    }
+
+    /* Sync DFU has no response */
+    if ((status != CY_DFU_SUCCESS) || (packet[PACKET_CMD_IDX] != DFU_CMD_SYNC))
+    {
+        send_response(params, (uint8_t)status, response, (status == CY_DFU_SUCCESS) ? response_length : 0U);
+    }
+
+    return status;
+}
+
+/* [] END OF FILE */
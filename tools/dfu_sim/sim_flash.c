@@ -0,0 +1,251 @@
+/*******************************************************************************
+* File Name        : sim_flash.c
+*
+* Description      : Serial flash model of the DFU simulator. Implements the
+*                    mtb_serial_memory_* calls of dfu_user.c on a memory
+*                    mapped file with NOR semantics: erase sets a sector to
+*                    0xFF, program can only clear bits. Every operation
+*                    advances the simulated clock by its modeled duration.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "sim.h"
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static sim_flash_model_t flash_model;
+static sim_flash_stats_t flash_stats;
+
+/*******************************************************************************
+* Function Name: in_range
+*******************************************************************************/
+static bool in_range(const mtb_serial_memory_t *obj, uint32_t addr, size_t length)
+{
+    return (obj->data != NULL) && (addr <= obj->size) && (length <= (obj->size - addr));
+}
+
+/*******************************************************************************
+* Function Name: sim_flash_open
+********************************************************************************
+* Summary:
+*  Maps the memory file, creating it erased if it does not exist yet.
+*
+* Return:
+*  0 on success, -1 on error (reported on stderr)
+*
+*******************************************************************************/
+int sim_flash_open(mtb_serial_memory_t *obj, const char *path, size_t size, const sim_flash_model_t *model)
+{
+    struct stat st;
+    bool fresh;
+    void *map;
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+
+    memset(obj, 0, sizeof(*obj));
+    memset(&flash_stats, 0, sizeof(flash_stats));
+    flash_model = *model;
+
+    if ((fd < 0) || (fstat(fd, &st) != 0))
+    {
+        fprintf(stderr, "dfu_sim: cannot open %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    fresh = (st.st_size == 0);
+    if ((st.st_size != (off_t)size) && (ftruncate(fd, (off_t)size) != 0))
+    {
+        fprintf(stderr, "dfu_sim: cannot size %s: %s\n", path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        fprintf(stderr, "dfu_sim: cannot map %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    obj->data = map;
+    obj->size = size;
+    if (fresh)
+    {
+        memset(obj->data, 0xFF, size);
+    }
+
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: sim_flash_close
+*******************************************************************************/
+void sim_flash_close(mtb_serial_memory_t *obj)
+{
+    if (obj->data != NULL)
+    {
+        (void)msync(obj->data, obj->size, MS_SYNC);
+        (void)munmap(obj->data, obj->size);
+        obj->data = NULL;
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_flash_get_stats
+*******************************************************************************/
+const sim_flash_stats_t *sim_flash_get_stats(void)
+{
+    return &flash_stats;
+}
+
+/*******************************************************************************
+* Function Name: mtb_serial_memory_get_erase_size
+*******************************************************************************/
+size_t mtb_serial_memory_get_erase_size(mtb_serial_memory_t *obj, uint32_t addr)
+{
+    (void)obj;
+    (void)addr;
+
+    return flash_model.sector_size;
+}
+
+/*******************************************************************************
+* Function Name: mtb_serial_memory_get_sector_start_address
+*******************************************************************************/
+uint32_t mtb_serial_memory_get_sector_start_address(mtb_serial_memory_t *obj, uint32_t addr)
+{
+    (void)obj;
+
+    return addr - (addr % flash_model.sector_size);
+}
+
+/*******************************************************************************
+* Function Name: mtb_serial_memory_get_prog_size
+*******************************************************************************/
+size_t mtb_serial_memory_get_prog_size(mtb_serial_memory_t *obj, uint32_t addr)
+{
+    (void)obj;
+    (void)addr;
+
+    return flash_model.page_size;
+}
+
+/*******************************************************************************
+* Function Name: mtb_serial_memory_erase
+********************************************************************************
+* Summary:
+*  Erases whole sectors. Like the real memory, the range must be sector
+*  aligned.
+*
+*******************************************************************************/
+cy_rslt_t mtb_serial_memory_erase(mtb_serial_memory_t *obj, uint32_t addr, size_t length)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+
+    if (!in_range(obj, addr, length) || ((addr % flash_model.sector_size) != 0U) ||
+        ((length % flash_model.sector_size) != 0U))
+    {
+        result = MTB_SERIAL_MEMORY_RSLT_ERR_ADDRESS;
+    }
+    else
+    {
+        uint64_t sectors = length / flash_model.sector_size;
+        uint64_t ns = sectors * flash_model.erase_us * 1000U;
+
+        memset(&obj->data[addr], 0xFF, length);
+        flash_stats.sectors_erased += sectors;
+        flash_stats.erase_ns += ns;
+        sim_clock_advance(ns);
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: mtb_serial_memory_write
+********************************************************************************
+* Summary:
+*  Programs pages. Bits can only go from 1 to 0; bytes that would need a 1
+*  where the memory holds a 0 are counted as conflicts, which show a missing
+*  erase.
+*
+*******************************************************************************/
+cy_rslt_t mtb_serial_memory_write(mtb_serial_memory_t *obj, uint32_t addr, size_t length, const uint8_t *buf)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+
+    if (!in_range(obj, addr, length))
+    {
+        result = MTB_SERIAL_MEMORY_RSLT_ERR_ADDRESS;
+    }
+    else
+    {
+        uint32_t first_page = addr / flash_model.page_size;
+        uint32_t last_page = (uint32_t)((addr + length + flash_model.page_size - 1U) / flash_model.page_size);
+        uint64_t ns = (uint64_t)(last_page - first_page) * flash_model.program_us * 1000U;
+
+        for (size_t i = 0U; i < length; i++)
+        {
+            if ((buf[i] & (uint8_t)~obj->data[addr + i]) != 0U)
+            {
+                flash_stats.conflicts++;
+            }
+            obj->data[addr + i] &= buf[i];
+        }
+        flash_stats.pages_programmed += (uint64_t)(last_page - first_page);
+        flash_stats.program_ns += ns;
+        sim_clock_advance(ns);
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: mtb_serial_memory_read
+*******************************************************************************/
+cy_rslt_t mtb_serial_memory_read(mtb_serial_memory_t *obj, uint32_t addr, size_t length, uint8_t *buf)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+
+    if (!in_range(obj, addr, length))
+    {
+        result = MTB_SERIAL_MEMORY_RSLT_ERR_ADDRESS;
+    }
+    else
+    {
+        uint64_t ns = (uint64_t)length * flash_model.read_ns_per_byte;
+
+        memcpy(buf, &obj->data[addr], length);
+        flash_stats.bytes_read += length;
+        flash_stats.read_ns += ns;
+        sim_clock_advance(ns);
+    }
+
+    return result;
+}
+
+/* [] END OF FILE */
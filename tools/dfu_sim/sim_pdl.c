@@ -0,0 +1,159 @@
+/*******************************************************************************
+* File Name        : sim_pdl.c
+*
+* Description      : Host stand-ins for the PDL parts declared in
+*                    include/cy_pdl.h and for retarget_io_flush(). The DWT
+*                    cycle counter runs at SystemCoreClock in simulated time.
+*                    Bytes sent to the debug UART, such as DFU_TRACE and
+*                    DFU_RECORD frames, go to the file set with
+*                    sim_uart_open(), or nowhere without one.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#include <stdio.h>
+#include "cy_pdl.h"
+#include "retarget_io_init.h"
+#include "sim.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* TX FIFO of the SCB, the trace frames are only sent if they fit */
+#define SIM_UART_FIFO_SIZE      (128U)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+
+/* CPU clock of the CM33 in the kit */
+uint32_t SystemCoreClock = 200000000U;
+CoreDebug_Type sim_core_debug;
+
+static DWT_Type sim_dwt_regs;
+static FILE *sim_uart;
+
+/*******************************************************************************
+* Function Name: sim_dwt
+*******************************************************************************/
+DWT_Type *sim_dwt(void)
+{
+    sim_dwt_regs.CYCCNT = (uint32_t)((sim_clock_now() * (SystemCoreClock / 1000000U)) / 1000U);
+
+    return &sim_dwt_regs;
+}
+
+/*******************************************************************************
+* Function Name: sim_uart_open
+*******************************************************************************/
+int sim_uart_open(const char *path)
+{
+    sim_uart = fopen(path, "wb");
+    if (sim_uart == NULL)
+    {
+        perror(path);
+    }
+
+    return (sim_uart != NULL) ? 0 : -1;
+}
+
+/*******************************************************************************
+* Function Name: sim_uart_close
+*******************************************************************************/
+void sim_uart_close(void)
+{
+    if (sim_uart != NULL)
+    {
+        fclose(sim_uart);
+        sim_uart = NULL;
+    }
+}
+
+/*******************************************************************************
+* Function Name: Cy_SysLib_EnterCriticalSection
+*******************************************************************************/
+uint32_t Cy_SysLib_EnterCriticalSection(void)
+{
+    return 0U;
+}
+
+/*******************************************************************************
+* Function Name: Cy_SysLib_ExitCriticalSection
+*******************************************************************************/
+void Cy_SysLib_ExitCriticalSection(uint32_t savedIntrStatus)
+{
+    (void)savedIntrStatus;
+}
+
+/*******************************************************************************
+* Function Name: Cy_SCB_GetFifoSize
+*******************************************************************************/
+uint32_t Cy_SCB_GetFifoSize(CySCB_Type const *base)
+{
+    (void)base;
+
+    return SIM_UART_FIFO_SIZE;
+}
+
+/*******************************************************************************
+* Function Name: Cy_SCB_UART_GetNumInTxFifo
+*******************************************************************************/
+uint32_t Cy_SCB_UART_GetNumInTxFifo(CySCB_Type const *base)
+{
+    (void)base;
+
+    return 0U;
+}
+
+/*******************************************************************************
+* Function Name: Cy_SCB_UART_PutArray
+*******************************************************************************/
+uint32_t Cy_SCB_UART_PutArray(CySCB_Type *base, void *buffer, uint32_t size)
+{
+    (void)base;
+
+    if (sim_uart != NULL)
+    {
+        (void)fwrite(buffer, 1U, size, sim_uart);
+    }
+
+    return size;
+}
+
+/*******************************************************************************
+* Function Name: Cy_SCB_UART_PutArrayBlocking
+*******************************************************************************/
+void Cy_SCB_UART_PutArrayBlocking(CySCB_Type *base, void *buffer, uint32_t size)
+{
+    (void)Cy_SCB_UART_PutArray(base, buffer, size);
+}
+
+/*******************************************************************************
+* Function Name: retarget_io_flush
+*******************************************************************************/
+void retarget_io_flush(void)
+{
+    if (sim_uart != NULL)
+    {
+        (void)fflush(sim_uart);
+    }
+}
+
+/* [] END OF FILE */
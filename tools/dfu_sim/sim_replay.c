@@ -0,0 +1,357 @@
+/*******************************************************************************
+* File Name        : sim_replay.c
+*
+* Description      : Session replay of the DFU simulator. Sends the host
+*                    packets of a capture recorded on the device
+*                    (DEFINES+=DFU_RECORD) or by dfuh -r to the simulated
+*                    device with the recorded timing, optionally sped up,
+*                    and compares the responses with the recorded ones.
+*                    Responses are compared in order, so after the first
+*                    difference the rest may differ as well.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sim.h"
+#include "dfu_link.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Wait for a response that the capture has but the replay did not get yet */
+#define REPLAY_RESPONSE_TIMEOUT_MS  (1000)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    dfu_link_t link;
+    const dfu_session_t *session;
+    double speed;
+    uint64_t *sent_ns;                      /* Replay send time of each entry */
+    size_t expected;                        /* Next recorded response to compare */
+    uint8_t packet[DFU_PACKET_MAX_SIZE];
+    size_t length;                          /* Bytes of packet received so far */
+    sim_replay_stats_t stats;
+    pthread_t thread;
+    atomic_bool done;
+} replay_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static replay_t replay;
+
+/*******************************************************************************
+* Function Name: now_ns
+*******************************************************************************/
+static uint64_t now_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000U) + (uint64_t)now.tv_nsec;
+}
+
+/*******************************************************************************
+* Function Name: next_response
+********************************************************************************
+* Summary:
+*  Returns the index of the first recorded response at or after index, or the
+*  number of entries if there is none.
+*
+*******************************************************************************/
+static size_t next_response(size_t index)
+{
+    while ((index < replay.session->count) && (replay.session->entries[index].direction != DFU_RECORD_FROM_DEVICE))
+    {
+        index++;
+    }
+
+    return index;
+}
+
+/*******************************************************************************
+* Function Name: compare_response
+********************************************************************************
+* Summary:
+*  Compares a received response with the next recorded one and updates the
+*  response times.
+*
+*******************************************************************************/
+static void compare_response(const uint8_t packet[], size_t length, uint64_t received_ns)
+{
+    const dfu_session_t *session = replay.session;
+    sim_replay_stats_t *stats = &replay.stats;
+    const dfu_session_entry_t *entry;
+    size_t command;
+
+    replay.expected = next_response(replay.expected);
+    if (replay.expected == session->count)
+    {
+        stats->unexpected++;
+        return;
+    }
+    entry = &session->entries[replay.expected];
+
+    /* The command is the last host packet before the response */
+    for (command = replay.expected; (command > 0U) &&
+         (session->entries[command].direction != DFU_RECORD_TO_DEVICE); command--)
+    {
+    }
+    if ((session->entries[command].direction == DFU_RECORD_TO_DEVICE) && (replay.sent_ns[command] != 0U))
+    {
+        uint64_t capture_ns = (uint64_t)(entry->time_us - session->entries[command].time_us) * 1000U;
+        uint64_t replay_ns = received_ns - replay.sent_ns[command];
+
+        stats->capture_ns += capture_ns;
+        stats->replay_ns += replay_ns;
+        stats->capture_max_ns = (capture_ns > stats->capture_max_ns) ? capture_ns : stats->capture_max_ns;
+        stats->replay_max_ns = (replay_ns > stats->replay_max_ns) ? replay_ns : stats->replay_max_ns;
+        stats->timed++;
+    }
+
+    if ((length == entry->length) && (memcmp(packet, entry->packet, length) == 0))
+    {
+        stats->matched++;
+    }
+    else
+    {
+        if ((stats->different++ == 0U) && (length > 1U) && (entry->length > 1U))
+        {
+            stats->first_entry = replay.expected;
+            stats->first_command = session->entries[command].packet[1];
+            stats->first_expected = entry->packet[1];
+            stats->first_received = packet[1];
+        }
+    }
+    replay.expected++;
+}
+
+/*******************************************************************************
+* Function Name: receive
+********************************************************************************
+* Summary:
+*  Receives response bytes for up to timeout_ms and compares every complete
+*  response.
+*
+* Return:
+*  True if bytes were received, false on timeout or link error
+*
+*******************************************************************************/
+static bool receive(int timeout_ms)
+{
+    size_t size = DFU_PACKET_HEADER_SIZE;
+    int got;
+
+    if (replay.length >= DFU_PACKET_HEADER_SIZE)
+    {
+        size = DFU_PACKET_MIN_SIZE + ((size_t)replay.packet[2] | ((size_t)replay.packet[3] << 8U));
+    }
+    got = replay.link.read(replay.link.context, &replay.packet[replay.length], size - replay.length, timeout_ms);
+    if (got <= 0)
+    {
+        return false;
+    }
+    replay.length += (size_t)got;
+
+    if ((replay.length == DFU_PACKET_HEADER_SIZE) &&
+        ((replay.packet[0] != DFU_PACKET_SOP) || (DFU_PACKET_MIN_SIZE + ((size_t)replay.packet[2] |
+                                                  ((size_t)replay.packet[3] << 8U)) > DFU_PACKET_MAX_SIZE)))
+    {
+        /* Not a packet, resynchronize on the next byte */
+        memmove(&replay.packet[0], &replay.packet[1], --replay.length);
+    }
+    else if ((replay.length > DFU_PACKET_HEADER_SIZE) && (replay.length == size))
+    {
+        compare_response(replay.packet, replay.length, now_ns());
+        replay.length = 0U;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: wait_responses
+********************************************************************************
+* Summary:
+*  Waits until all recorded responses before entry end have been received.
+*  Gives up after REPLAY_RESPONSE_TIMEOUT_MS without a response and counts
+*  the rest as missing.
+*
+*******************************************************************************/
+static void wait_responses(size_t end)
+{
+    uint64_t deadline = now_ns() + ((uint64_t)REPLAY_RESPONSE_TIMEOUT_MS * 1000000U);
+
+    while ((replay.expected = next_response(replay.expected)) < end)
+    {
+        uint64_t now = now_ns();
+
+        if (now >= deadline)
+        {
+            replay.stats.missing++;
+            replay.expected++;
+        }
+        else if (receive((int)((deadline - now + 999999U) / 1000000U)))
+        {
+            deadline = now_ns() + ((uint64_t)REPLAY_RESPONSE_TIMEOUT_MS * 1000000U);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: replay_thread
+********************************************************************************
+* Summary:
+*  Sends every host packet at its recorded time divided by the speed, and
+*  compares the responses that arrive in the meantime. With speed 0, each
+*  packet is sent as soon as the responses recorded before it are in.
+*
+*******************************************************************************/
+static void *replay_thread(void *arg)
+{
+    const dfu_session_t *session = replay.session;
+    uint64_t start_ns = now_ns();
+    uint32_t first_us = 0U;
+    bool started = false;
+
+    (void)arg;
+
+    for (size_t i = 0U; i < session->count; i++)
+    {
+        const dfu_session_entry_t *entry = &session->entries[i];
+
+        if (entry->direction != DFU_RECORD_TO_DEVICE)
+        {
+            continue;
+        }
+        if (!started)
+        {
+            /* Responses recorded before the first command are not replayed */
+            first_us = entry->time_us;
+            replay.expected = i;
+            started = true;
+        }
+
+        /* Take what has arrived, a replay that falls behind must not stop
+         * reading or both sides block on a full socket */
+        while (receive(0))
+        {
+        }
+
+        if (replay.speed > 0.0)
+        {
+            uint64_t due_ns = start_ns + (uint64_t)((double)(entry->time_us - first_us) * 1000.0 / replay.speed);
+            uint64_t now;
+
+            while ((now = now_ns()) < due_ns)
+            {
+                (void)receive((int)((due_ns - now + 999999U) / 1000000U));
+            }
+        }
+        else
+        {
+            wait_responses(i);
+        }
+
+        if (replay.link.write(replay.link.context, entry->packet, entry->length) != 0)
+        {
+            break;
+        }
+        replay.sent_ns[i] = now_ns();
+        replay.stats.sent++;
+    }
+    wait_responses(session->count);
+
+    atomic_store(&replay.done, true);
+
+    return NULL;
+}
+
+/*******************************************************************************
+* Function Name: sim_replay_start
+********************************************************************************
+* Summary:
+*  Starts replaying the session on the host side of the simulated UART.
+*
+* Parameters:
+*  fd      : Host side of the simulated UART, closed by sim_replay_finish()
+*  session : Recorded session, must stay valid until sim_replay_finish()
+*  speed   : 1 for the recorded timing, 10 for ten times faster, 0 to send
+*            each packet as soon as the recorded responses before it are in
+*
+* Return:
+*  0 on success, -1 on error
+*
+*******************************************************************************/
+int sim_replay_start(int fd, const dfu_session_t *session, double speed)
+{
+    memset(&replay, 0, sizeof(replay));
+    replay.session = session;
+    replay.speed = speed;
+    replay.sent_ns = calloc((session->count != 0U) ? session->count : 1U, sizeof(replay.sent_ns[0]));
+    atomic_init(&replay.done, false);
+
+    if ((replay.sent_ns == NULL) || (dfu_link_open_fd(&replay.link, fd) != 0))
+    {
+        free(replay.sent_ns);
+        return -1;
+    }
+    if (pthread_create(&replay.thread, NULL, replay_thread, NULL) != 0)
+    {
+        dfu_link_close(&replay.link);
+        free(replay.sent_ns);
+        return -1;
+    }
+
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: sim_replay_done
+*******************************************************************************/
+bool sim_replay_done(void)
+{
+    return atomic_load(&replay.done);
+}
+
+/*******************************************************************************
+* Function Name: sim_replay_finish
+********************************************************************************
+* Summary:
+*  Waits for the replay to end and returns its statistics.
+*
+*******************************************************************************/
+void sim_replay_finish(sim_replay_stats_t *stats)
+{
+    (void)pthread_join(replay.thread, NULL);
+    dfu_link_close(&replay.link);
+    free(replay.sent_ns);
+    *stats = replay.stats;
+}
+
+/* [] END OF FILE */
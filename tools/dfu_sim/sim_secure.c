@@ -0,0 +1,102 @@
+/*******************************************************************************
+* File Name        : sim_secure.c
+*
+* Description      : Secure image model of the DFU simulator. Implements the
+*                    secure_decrypt_* calls of dfu_user.c with the transport
+*                    key given on the command line instead of a wrapped key.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#include <stdbool.h>
+#include <string.h>
+#include "dfu_aes.h"
+#include "secure_decrypt.h"
+#include "sim.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define SIM_SECURE_SLOTS        (3U)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static bool secure_key_set = false;
+static dfu_aes_t secure_aes;
+static uint8_t secure_nonces[SIM_SECURE_SLOTS][SECURE_DECRYPT_NONCE_SIZE];
+static bool secure_started[SIM_SECURE_SLOTS];
+
+/*******************************************************************************
+* Function Name: sim_secure_set_key
+*******************************************************************************/
+void sim_secure_set_key(const uint8_t key[])
+{
+    dfu_aes_init(&secure_aes, key);
+    secure_key_set = true;
+}
+
+/*******************************************************************************
+* Function Name: secure_decrypt_start
+*******************************************************************************/
+uint32_t secure_decrypt_start(uint32_t image_id, uint32_t nonce_low, uint32_t nonce_high)
+{
+    if (image_id >= SIM_SECURE_SLOTS)
+    {
+        return SECURE_DECRYPT_STATUS_IMAGE_ID;
+    }
+    if (!secure_key_set)
+    {
+        return SECURE_DECRYPT_STATUS_KEY;
+    }
+
+    for (uint32_t i = 0U; i < 4U; i++)
+    {
+        secure_nonces[image_id][i] = (uint8_t)(nonce_low >> (8U * i));
+        secure_nonces[image_id][4U + i] = (uint8_t)(nonce_high >> (8U * i));
+    }
+    secure_started[image_id] = true;
+
+    return SECURE_DECRYPT_STATUS_OK;
+}
+
+/*******************************************************************************
+* Function Name: secure_decrypt_row
+*******************************************************************************/
+uint32_t secure_decrypt_row(uint32_t image_id, uint32_t offset, uint8_t row[], uint32_t length)
+{
+    if (image_id >= SIM_SECURE_SLOTS)
+    {
+        return SECURE_DECRYPT_STATUS_IMAGE_ID;
+    }
+    if (!secure_started[image_id])
+    {
+        return SECURE_DECRYPT_STATUS_STATE;
+    }
+    if ((offset % SECURE_DECRYPT_BLOCK_SIZE) != 0U)
+    {
+        return SECURE_DECRYPT_STATUS_BUFFER;
+    }
+
+    dfu_aes_ctr(&secure_aes, secure_nonces[image_id], image_id, offset, row, length);
+
+    return SECURE_DECRYPT_STATUS_OK;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,235 @@
+/*******************************************************************************
+* File Name        : sim_transport.c
+*
+* Description      : UART transport of the DFU simulator. Implements the
+*                    UART_UartCyBtldrComm* calls of dfu_user.c on a file
+*                    descriptor (pty, Unix socket or socket pair). The time a
+*                    packet spends on the wire at the modeled bit rate is
+*                    added to the simulated clock; time spent waiting for the
+*                    host is not, so the result does not depend on the host.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include "sim.h"
+#include "transport_uart.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define PACKET_HEADER_SIZE      (4U)    /* SOP, command, length */
+#define PACKET_TRAILER_SIZE     (3U)    /* Checksum, EOP */
+#define PACKET_SOP              (0x01U)
+
+/* Once the start of a packet arrived, the rest must follow within this time */
+#define PACKET_BYTE_TIMEOUT_MS  (100)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static int link_fd = -1;
+static sim_link_model_t link_model;
+static sim_link_stats_t link_stats;
+
+/*******************************************************************************
+* Function Name: wire_time
+********************************************************************************
+* Summary:
+*  Returns the time in ns that length bytes take on the wire, 8N1 framing.
+*
+*******************************************************************************/
+static uint64_t wire_time(uint32_t length)
+{
+    return ((uint64_t)length * 10U * 1000000000U) / link_model.bit_rate;
+}
+
+/*******************************************************************************
+* Function Name: read_bytes
+********************************************************************************
+* Summary:
+*  Reads exactly length bytes, waiting at most timeout_ms for each chunk.
+*
+* Return:
+*  The number of bytes read, less than length on timeout or error
+*
+*******************************************************************************/
+static uint32_t read_bytes(uint8_t buffer[], uint32_t length, int timeout_ms)
+{
+    uint32_t done = 0U;
+
+    while (done < length)
+    {
+        struct pollfd pfd = { .fd = link_fd, .events = POLLIN };
+        ssize_t got;
+
+        if (poll(&pfd, 1, timeout_ms) <= 0)
+        {
+            break;
+        }
+        got = read(link_fd, &buffer[done], length - done);
+        if ((got < 0) && ((errno == EINTR) || (errno == EAGAIN)))
+        {
+            continue;
+        }
+        if (got <= 0)
+        {
+            break;
+        }
+        done += (uint32_t)got;
+    }
+
+    return done;
+}
+
+/*******************************************************************************
+* Function Name: sim_transport_attach
+*******************************************************************************/
+void sim_transport_attach(int fd, const sim_link_model_t *model)
+{
+    link_fd = fd;
+    link_model = *model;
+}
+
+/*******************************************************************************
+* Function Name: sim_transport_get_stats
+*******************************************************************************/
+const sim_link_stats_t *sim_transport_get_stats(void)
+{
+    return &link_stats;
+}
+
+/*******************************************************************************
+* Function Name: UART_UartCyBtldrCommStart
+*******************************************************************************/
+void UART_UartCyBtldrCommStart(void)
+{
+    UART_UartCyBtldrCommReset();
+}
+
+/*******************************************************************************
+* Function Name: UART_UartCyBtldrCommStop
+*******************************************************************************/
+void UART_UartCyBtldrCommStop(void)
+{
+}
+
+/*******************************************************************************
+* Function Name: UART_UartCyBtldrCommReset
+********************************************************************************
+* Summary:
+*  Drops whatever is pending on the link, like clearing the RX FIFO.
+*
+*******************************************************************************/
+void UART_UartCyBtldrCommReset(void)
+{
+    uint8_t drain;
+
+    while (read_bytes(&drain, 1U, 0) == 1U)
+    {
+    }
+}
+
+/*******************************************************************************
+* Function Name: UART_UartCyBtldrCommRead
+********************************************************************************
+* Summary:
+*  Receives one DFU packet. Bytes before a start of packet are dropped.
+*
+* Return:
+*  CY_DFU_SUCCESS with the packet in pData, CY_DFU_ERROR_TIMEOUT if nothing
+*  arrived in time, CY_DFU_ERROR_LENGTH if the packet does not fit.
+*
+*******************************************************************************/
+cy_en_dfu_status_t UART_UartCyBtldrCommRead(uint8_t pData[], uint32_t size, uint32_t *count, uint32_t timeout)
+{
+    cy_en_dfu_status_t status = CY_DFU_ERROR_TIMEOUT;
+    uint32_t length;
+
+    *count = 0U;
+
+    do
+    {
+        if (read_bytes(pData, 1U, (int)timeout) != 1U)
+        {
+            return CY_DFU_ERROR_TIMEOUT;
+        }
+    } while (pData[0] != PACKET_SOP);
+
+    if (read_bytes(&pData[1], PACKET_HEADER_SIZE - 1U, PACKET_BYTE_TIMEOUT_MS) == (PACKET_HEADER_SIZE - 1U))
+    {
+        length = PACKET_HEADER_SIZE + ((uint32_t)pData[2] | ((uint32_t)pData[3] << 8U)) + PACKET_TRAILER_SIZE;
+        if (length > size)
+        {
+            UART_UartCyBtldrCommReset();
+            status = CY_DFU_ERROR_LENGTH;
+        }
+        else if (read_bytes(&pData[PACKET_HEADER_SIZE], length - PACKET_HEADER_SIZE, PACKET_BYTE_TIMEOUT_MS) ==
+                 (length - PACKET_HEADER_SIZE))
+        {
+            uint64_t ns = wire_time(length) + ((uint64_t)link_model.latency_us * 1000U);
+
+            *count = length;
+            link_stats.packets_received++;
+            link_stats.bytes_received += length;
+            link_stats.link_ns += ns;
+            sim_clock_advance(ns);
+            status = CY_DFU_SUCCESS;
+        }
+    }
+
+    return status;
+}
+
+/*******************************************************************************
+* Function Name: UART_UartCyBtldrCommWrite
+*******************************************************************************/
+cy_en_dfu_status_t UART_UartCyBtldrCommWrite(const uint8_t pData[], uint32_t size, uint32_t *count,
+                                             uint32_t timeout)
+{
+    uint32_t done = 0U;
+
+    (void)timeout;
+
+    while (done < size)
+    {
+        ssize_t put = write(link_fd, &pData[done], size - done);
+        if ((put < 0) && (errno == EINTR))
+        {
+            continue;
+        }
+        if (put <= 0)
+        {
+            break;
+        }
+        done += (uint32_t)put;
+    }
+
+    *count = done;
+    link_stats.packets_sent++;
+    link_stats.bytes_sent += done;
+    link_stats.link_ns += wire_time(done);
+    sim_clock_advance(wire_time(done));
+
+    return (done == size) ? CY_DFU_SUCCESS : CY_DFU_ERROR_TIMEOUT;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,646 @@
+/*******************************************************************************
+* File Name        : dfu_stats.c
+*
+* Description      : Host tool that reads the DFU performance counters of the
+*                    device (proj_cm33_ns built with DEFINES+=DFU_PERF) over a
+*                    serial port, such as the USB-CDC DFU transport, and prints
+*                    a per-phase breakdown of the last DFU session and the
+*                    latency of each DFU command ID. Also reads the boot
+*                    timeline (DEFINES+=BOOT_TIME in common.mk).
+*
+*                    Usage: dfu_stats [-c] [-r] [-b] <serial device>
+*                      -c  packets use CRC-16 (CY_DFU_OPT_PACKET_CRC=1)
+*                      -r  clear the counters after printing them
+*                      -b  print the boot timeline instead of the counters
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include "boot_time.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Must match proj_cm33_ns/dfu_perf.h */
+#define DFU_PERF_CMD_GET_STATS      (0x50U)
+#define DFU_PERF_CMD_RESET_STATS    (0x51U)
+#define DFU_PERF_CMD_GET_CMD_STATS  (0x52U)
+#define DFU_PERF_CMD_SLOTS          (8U)
+#define DFU_PERF_HIST_BUCKETS       (20U)
+#define DFU_PERF_STATS_SIZE         (24U + (4U * DFU_PERF_HIST_BUCKETS))
+#define DFU_PERF_CMD_STATS_SIZE     (4U + DFU_PERF_STATS_SIZE)
+
+#define PACKET_SOP                  (0x01U)
+#define PACKET_EOP                  (0x17U)
+#define PACKET_MIN_SIZE             (7U)
+#define PACKET_MAX_SIZE             (7U + 512U)
+
+#define RESPONSE_TIMEOUT_MS         (1000)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+
+/* Must match dfu_perf_phase_t */
+typedef enum
+{
+    PHASE_CONTINUE,
+    PHASE_TRANSPORT_READ,
+    PHASE_TRANSPORT_WRITE,
+    PHASE_WRITE_DATA,
+    PHASE_FLASH_ERASE,
+    PHASE_FLASH_PROGRAM,
+    PHASE_READ_DATA,
+    PHASE_LOOP_DELAY,
+    PHASE_COUNT
+} phase_t;
+
+typedef struct
+{
+    uint32_t cycles_per_us;
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+    uint32_t histogram[DFU_PERF_HIST_BUCKETS];
+} phase_stats_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+
+static const char *const phase_names[PHASE_COUNT] =
+{
+    "Cy_DFU_Continue",
+    "Transport read",
+    "Transport write",
+    "Cy_DFU_WriteData",
+    "  Flash erase",
+    "  Flash program",
+    "Cy_DFU_ReadData",
+    "Main loop delay",
+};
+
+/* DFU command names, for the per command latency */
+static const struct
+{
+    uint8_t id;
+    const char *name;
+} command_names[] =
+{
+    { 0x31U, "Verify App" },
+    { 0x35U, "Sync" },
+    { 0x37U, "Send Data" },
+    { 0x38U, "Enter" },
+    { 0x3BU, "Exit" },
+    { 0x44U, "Erase Data" },
+    { 0x49U, "Program Data" },
+    { 0x4AU, "Verify Data" },
+};
+
+#define BOOT_TIME_NAME(mark, name)  name,
+
+static const char *const boot_time_names[BOOT_TIME_MARK_COUNT] =
+{
+    BOOT_TIME_MARKS(BOOT_TIME_NAME)
+};
+
+#undef BOOT_TIME_NAME
+
+static bool use_crc = false;
+
+/*******************************************************************************
+* Function Name: packet_checksum
+********************************************************************************
+* Summary:
+*  Computes the DFU packet checksum, see dfu_packet_checksum() on the device.
+*
+*******************************************************************************/
+static uint16_t packet_checksum(const uint8_t buffer[], size_t length)
+{
+    uint16_t sum = 0U;
+
+    if (use_crc)
+    {
+        uint16_t crc = 0xFFFFU;
+        for (size_t i = 0U; i < length; i++)
+        {
+            uint16_t data = buffer[i];
+            for (uint32_t bit = 0U; bit < 8U; bit++)
+            {
+                crc = (((crc ^ data) & 1U) != 0U) ? (uint16_t)((crc >> 1U) ^ 0x8408U) : (uint16_t)(crc >> 1U);
+                data >>= 1U;
+            }
+        }
+        crc = (uint16_t)~crc;
+        sum = (uint16_t)((uint16_t)(crc << 8U) | (crc >> 8U));
+    }
+    else
+    {
+        for (size_t i = 0U; i < length; i++)
+        {
+            sum = (uint16_t)(sum + buffer[i]);
+        }
+        sum = (uint16_t)(1U + (uint16_t)~sum);
+    }
+
+    return sum;
+}
+
+/*******************************************************************************
+* Function Name: serial_open
+********************************************************************************
+* Summary:
+*  Opens a serial device in raw mode.
+*
+*******************************************************************************/
+static int serial_open(const char *path)
+{
+    struct termios tio;
+    int fd = open(path, O_RDWR | O_NOCTTY);
+
+    if (fd >= 0)
+    {
+        if (tcgetattr(fd, &tio) == 0)
+        {
+            cfmakeraw(&tio);
+            cfsetispeed(&tio, B115200);
+            cfsetospeed(&tio, B115200);
+            tio.c_cc[VMIN] = 0;
+            tio.c_cc[VTIME] = 0;
+            (void)tcsetattr(fd, TCSANOW, &tio);
+        }
+        (void)tcflush(fd, TCIOFLUSH);
+    }
+
+    return fd;
+}
+
+/*******************************************************************************
+* Function Name: read_exact
+********************************************************************************
+* Summary:
+*  Reads length bytes or fails after RESPONSE_TIMEOUT_MS without data.
+*
+*******************************************************************************/
+static bool read_exact(int fd, uint8_t buffer[], size_t length)
+{
+    size_t done = 0U;
+    struct pollfd pfd = { .fd = fd, .events = POLLIN };
+
+    while (done < length)
+    {
+        ssize_t got;
+
+        if (poll(&pfd, 1, RESPONSE_TIMEOUT_MS) <= 0)
+        {
+            return false;
+        }
+        got = read(fd, &buffer[done], length - done);
+        if ((got < 0) && (errno != EINTR) && (errno != EAGAIN))
+        {
+            return false;
+        }
+        done += (got > 0) ? (size_t)got : 0U;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: transfer
+********************************************************************************
+* Summary:
+*  Sends one command and receives its response.
+*
+* Return:
+*  Response data length, or -1 on a transport error or error status
+*
+*******************************************************************************/
+static int transfer(int fd, uint8_t command, const uint8_t data[], size_t length, uint8_t response[])
+{
+    uint8_t packet[PACKET_MAX_SIZE];
+    uint16_t checksum;
+    size_t rsp_length;
+
+    packet[0] = PACKET_SOP;
+    packet[1] = command;
+    packet[2] = (uint8_t)length;
+    packet[3] = (uint8_t)(length >> 8U);
+    if (length != 0U)
+    {
+        memcpy(&packet[4], data, length);
+    }
+    checksum = packet_checksum(packet, 4U + length);
+    packet[4U + length] = (uint8_t)checksum;
+    packet[5U + length] = (uint8_t)(checksum >> 8U);
+    packet[6U + length] = PACKET_EOP;
+
+    if (write(fd, packet, length + PACKET_MIN_SIZE) != (ssize_t)(length + PACKET_MIN_SIZE))
+    {
+        return -1;
+    }
+
+    if (!read_exact(fd, packet, 4U))
+    {
+        fprintf(stderr, "dfu_stats: no response to command 0x%02X\n", command);
+        return -1;
+    }
+    rsp_length = (size_t)packet[2] | ((size_t)packet[3] << 8U);
+    if ((packet[0] != PACKET_SOP) || ((rsp_length + PACKET_MIN_SIZE) > PACKET_MAX_SIZE) ||
+        !read_exact(fd, &packet[4], rsp_length + 3U))
+    {
+        fprintf(stderr, "dfu_stats: malformed response to command 0x%02X\n", command);
+        return -1;
+    }
+    checksum = (uint16_t)(packet[4U + rsp_length] | (packet[5U + rsp_length] << 8U));
+    if ((packet[6U + rsp_length] != PACKET_EOP) || (checksum != packet_checksum(packet, 4U + rsp_length)))
+    {
+        fprintf(stderr, "dfu_stats: bad response checksum, check the -c option\n");
+        return -1;
+    }
+    if (packet[1] != 0U)
+    {
+        fprintf(stderr, "dfu_stats: command 0x%02X failed with status 0x%02X\n", command, packet[1]);
+        return -1;
+    }
+
+    memcpy(response, &packet[4], rsp_length);
+    return (int)rsp_length;
+}
+
+/*******************************************************************************
+* Function Name: get_u32
+*******************************************************************************/
+static uint32_t get_u32(const uint8_t src[])
+{
+    return (uint32_t)src[0] | ((uint32_t)src[1] << 8U) | ((uint32_t)src[2] << 16U) | ((uint32_t)src[3] << 24U);
+}
+
+/*******************************************************************************
+* Function Name: read_stats
+********************************************************************************
+* Summary:
+*  Reads one serialized statistics record in chunks.
+*
+* Parameters:
+*  command : DFU_PERF_CMD_GET_STATS, DFU_PERF_CMD_GET_CMD_STATS or
+*            BOOT_TIME_CMD_GET
+*  index   : Phase or command slot, 0 for the boot timeline
+*  size    : Expected size of the record
+*  record  : Destination, size bytes
+*
+* Return:
+*  Number of phases, command slots or boot marks reported by the device, or
+*  -1 on error
+*
+*******************************************************************************/
+static int read_stats(int fd, uint8_t command, uint32_t index, uint32_t size, uint8_t record[])
+{
+    uint8_t response[PACKET_MAX_SIZE];
+    uint32_t offset = 0U;
+    int entries = -1;
+
+    while (offset < size)
+    {
+        const uint8_t request[3] = { (uint8_t)index, (uint8_t)offset, (uint8_t)(offset >> 8U) };
+        int length = transfer(fd, command, request, sizeof(request), response);
+
+        if ((length < 3) || ((uint32_t)(response[1] | (response[2] << 8U)) != size))
+        {
+            fprintf(stderr, "dfu_stats: unexpected statistics format, is the firmware built with %s?\n",
+                    (command == BOOT_TIME_CMD_GET) ? "BOOT_TIME" : "DFU_PERF");
+            return -1;
+        }
+        entries = response[0];
+        if ((length == 3) || (index >= (uint32_t)entries))
+        {
+            break;
+        }
+        memcpy(&record[offset], &response[3], (size_t)length - 3U);
+        offset += (uint32_t)length - 3U;
+    }
+
+    return entries;
+}
+
+/*******************************************************************************
+* Function Name: parse_stats
+********************************************************************************
+* Summary:
+*  Decodes a serialized statistics record, see DFU_PERF_STATS_SIZE.
+*
+*******************************************************************************/
+static void parse_stats(const uint8_t serialized[], phase_stats_t *stats)
+{
+    stats->cycles_per_us = get_u32(&serialized[0]);
+    stats->count = get_u32(&serialized[4]);
+    stats->min = get_u32(&serialized[8]);
+    stats->max = get_u32(&serialized[12]);
+    stats->total = (uint64_t)get_u32(&serialized[16]) | ((uint64_t)get_u32(&serialized[20]) << 32U);
+    for (uint32_t bucket = 0U; bucket < DFU_PERF_HIST_BUCKETS; bucket++)
+    {
+        stats->histogram[bucket] = get_u32(&serialized[24U + (4U * bucket)]);
+    }
+}
+
+/*******************************************************************************
+* Function Name: percentile_us
+********************************************************************************
+* Summary:
+*  Returns the upper bound of the histogram bucket that holds the given
+*  percentile, or the maximum if that is lower, in microseconds.
+*
+*******************************************************************************/
+static uint32_t percentile_us(const phase_stats_t *stats, uint32_t percent)
+{
+    uint64_t rank = (((uint64_t)stats->count * percent) + 99U) / 100U;
+    uint64_t seen = 0U;
+    uint32_t bucket = 0U;
+    uint32_t upper;
+    uint32_t max;
+
+    while (bucket < (DFU_PERF_HIST_BUCKETS - 1U))
+    {
+        seen += stats->histogram[bucket];
+        if (seen >= rank)
+        {
+            break;
+        }
+        bucket++;
+    }
+
+    upper = (bucket == (DFU_PERF_HIST_BUCKETS - 1U)) ? UINT32_MAX : ((2U << bucket) - 1U);
+    max = stats->max / stats->cycles_per_us;
+
+    return (upper < max) ? upper : max;
+}
+
+/*******************************************************************************
+* Function Name: command_name
+*******************************************************************************/
+static const char *command_name(uint8_t id)
+{
+    const char *name = "Custom";
+
+    for (size_t i = 0U; i < (sizeof(command_names) / sizeof(command_names[0])); i++)
+    {
+        if (command_names[i].id == id)
+        {
+            name = command_names[i].name;
+        }
+    }
+
+    return name;
+}
+
+/*******************************************************************************
+* Function Name: print_histogram
+*******************************************************************************/
+static void print_histogram(const phase_stats_t *stats)
+{
+    for (uint32_t bucket = 0U; bucket < DFU_PERF_HIST_BUCKETS; bucket++)
+    {
+        if (stats->histogram[bucket] != 0U)
+        {
+            uint32_t low = (bucket == 0U) ? 0U : (1U << bucket);
+
+            if (bucket == (DFU_PERF_HIST_BUCKETS - 1U))
+            {
+                printf("    %8u and more : %u\n", low, stats->histogram[bucket]);
+            }
+            else
+            {
+                printf("    %8u - %8u us : %u\n", low, (2U << bucket) - 1U, stats->histogram[bucket]);
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: print_boot_time
+********************************************************************************
+* Summary:
+*  Reads the boot timeline record and prints the time of each start up phase
+*  and the time since the secure main(), the same way as boot_time_print() on
+*  the device.
+*
+* Return:
+*  0 on success, -1 on error
+*
+*******************************************************************************/
+static int print_boot_time(int fd)
+{
+    uint8_t record[BOOT_TIME_RECORD_SIZE];
+    uint32_t last_cycles = 0U;
+    uint32_t marks;
+    double total_us = 0.0;
+    int reported = read_stats(fd, BOOT_TIME_CMD_GET, 0U, BOOT_TIME_RECORD_SIZE, record);
+
+    if (reported != (int)BOOT_TIME_MARK_COUNT)
+    {
+        if (reported >= 0)
+        {
+            fprintf(stderr, "dfu_stats: device reports %d boot marks, expected %d\n", reported,
+                    (int)BOOT_TIME_MARK_COUNT);
+        }
+        return -1;
+    }
+    if (get_u32(&record[0]) != BOOT_TIME_MAGIC)
+    {
+        fprintf(stderr, "dfu_stats: no boot timeline record\n");
+        return -1;
+    }
+    marks = get_u32(&record[12]);
+
+    printf("Boot %u, reset reason 0x%08X\n", get_u32(&record[4]), get_u32(&record[8]));
+    printf("%-42s %10s %10s %10s\n", "Phase", "ms", "Total ms", "CPU MHz");
+    for (uint32_t mark = 1U; mark < (uint32_t)BOOT_TIME_MARK_COUNT; mark++)
+    {
+        uint32_t cycles = get_u32(&record[16U + (4U * mark)]);
+        uint32_t clock_hz = get_u32(&record[16U + (4U * BOOT_TIME_MARK_COUNT) + (4U * mark)]);
+        double phase_us;
+
+        if (((marks & (1UL << mark)) == 0U) || (clock_hz == 0U))
+        {
+            continue;
+        }
+        phase_us = (double)(cycles - last_cycles) * 1e6 / (double)clock_hz;
+        total_us += phase_us;
+        last_cycles = cycles;
+
+        printf("%-42s %10.3f %10.3f %10.1f\n", boot_time_names[mark], phase_us / 1e3, total_us / 1e3,
+               (double)clock_hz / 1e6);
+    }
+
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    phase_stats_t stats[PHASE_COUNT];
+    phase_stats_t cmd_stats[DFU_PERF_CMD_SLOTS];
+    uint8_t cmd_ids[DFU_PERF_CMD_SLOTS];
+    uint32_t cmd_slots = DFU_PERF_CMD_SLOTS;
+    uint8_t record[DFU_PERF_CMD_STATS_SIZE];
+    uint8_t response[PACKET_MAX_SIZE];
+    uint32_t phases = PHASE_COUNT;
+    bool reset = false;
+    bool boot_time = false;
+    const char *device = NULL;
+    double other_us;
+    int opt;
+    int fd;
+
+    while ((opt = getopt(argc, argv, "crb")) != -1)
+    {
+        switch (opt)
+        {
+            case 'c': use_crc = true; break;
+            case 'r': reset = true; break;
+            case 'b': boot_time = true; break;
+            default: device = NULL; optind = argc + 1; break;
+        }
+    }
+    if (optind == (argc - 1))
+    {
+        device = argv[optind];
+    }
+    if (device == NULL)
+    {
+        fprintf(stderr, "usage: %s [-c] [-r] [-b] <serial device>\n", argv[0]);
+        return 2;
+    }
+
+    fd = serial_open(device);
+    if (fd < 0)
+    {
+        fprintf(stderr, "dfu_stats: cannot open %s: %s\n", device, strerror(errno));
+        return 1;
+    }
+
+    if (boot_time)
+    {
+        int result = print_boot_time(fd);
+
+        close(fd);
+        return (result == 0) ? 0 : 1;
+    }
+
+    for (uint32_t phase = 0U; phase < phases; phase++)
+    {
+        int reported = read_stats(fd, DFU_PERF_CMD_GET_STATS, phase, DFU_PERF_STATS_SIZE, record);
+        if (reported < 0)
+        {
+            close(fd);
+            return 1;
+        }
+        parse_stats(record, &stats[phase]);
+        if ((uint32_t)reported < phases)
+        {
+            phases = (uint32_t)reported;
+        }
+    }
+
+    for (uint32_t slot = 0U; slot < cmd_slots; slot++)
+    {
+        int reported = read_stats(fd, DFU_PERF_CMD_GET_CMD_STATS, slot, DFU_PERF_CMD_STATS_SIZE, record);
+        if (reported < 0)
+        {
+            close(fd);
+            return 1;
+        }
+        cmd_slots = ((uint32_t)reported < cmd_slots) ? (uint32_t)reported : cmd_slots;
+        if (slot < cmd_slots)
+        {
+            cmd_ids[slot] = record[0];
+            parse_stats(&record[4], &cmd_stats[slot]);
+        }
+    }
+
+    printf("%-18s %8s %12s %10s %10s %10s\n", "Phase", "Count", "Total ms", "Avg us", "Min us", "Max us");
+    for (uint32_t phase = 0U; phase < phases; phase++)
+    {
+        const phase_stats_t *s = &stats[phase];
+        double cpu = (double)s->cycles_per_us;
+
+        printf("%-18s %8u %12.3f %10.1f %10.1f %10.1f\n", phase_names[phase], s->count,
+               (double)s->total / cpu / 1000.0,
+               (s->count != 0U) ? ((double)s->total / cpu / (double)s->count) : 0.0,
+               (double)s->min / cpu, (double)s->max / cpu);
+    }
+
+    /* What Cy_DFU_Continue() spends outside of the timed calls is packet
+     * parsing, checksums and command dispatch in the DFU middleware */
+    other_us = (double)stats[PHASE_CONTINUE].total - (double)stats[PHASE_TRANSPORT_READ].total -
+               (double)stats[PHASE_TRANSPORT_WRITE].total - (double)stats[PHASE_WRITE_DATA].total -
+               (double)stats[PHASE_READ_DATA].total;
+    printf("%-18s %8s %12.3f\n", "Command handling", "",
+           other_us / (double)stats[PHASE_CONTINUE].cycles_per_us / 1000.0);
+
+    printf("\nHistograms:\n");
+    for (uint32_t phase = 0U; phase < phases; phase++)
+    {
+        if (stats[phase].count != 0U)
+        {
+            printf("  %s\n", phase_names[phase]);
+            print_histogram(&stats[phase]);
+        }
+    }
+
+    printf("\n%-4s %-14s %8s %10s %10s %10s %10s\n", "ID", "Command", "Count", "Avg us", "p50 us", "p99 us", "Max us");
+    for (uint32_t slot = 0U; slot < cmd_slots; slot++)
+    {
+        const phase_stats_t *s = &cmd_stats[slot];
+
+        printf("0x%02X %-14s %8u %10.1f %10u %10u %10.1f\n", cmd_ids[slot], command_name(cmd_ids[slot]), s->count,
+               (s->count != 0U) ? ((double)s->total / (double)s->cycles_per_us / (double)s->count) : 0.0,
+               percentile_us(s, 50U), percentile_us(s, 99U), (double)s->max / (double)s->cycles_per_us);
+    }
+    for (uint32_t slot = 0U; slot < cmd_slots; slot++)
+    {
+        printf("  0x%02X %s\n", cmd_ids[slot], command_name(cmd_ids[slot]));
+        print_histogram(&cmd_stats[slot]);
+    }
+
+    if (reset && (transfer(fd, DFU_PERF_CMD_RESET_STATS, NULL, 0U, response) < 0))
+    {
+        close(fd);
+        return 1;
+    }
+
+    close(fd);
+    return 0;
+}
+
+/* [] END OF FILE */
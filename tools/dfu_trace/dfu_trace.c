@@ -0,0 +1,235 @@
+/*******************************************************************************
+* File Name        : dfu_trace.c
+*
+* Description      : Host decoder for the DFU binary trace (proj_cm33_ns built
+*                    with DEFINES+=DFU_TRACE). Reads the debug UART output from
+*                    a serial device, a capture file or stdin. Trace frames are
+*                    printed as text using the formats in dfu_trace_ids.h, and
+*                    everything else, such as printf() output, is passed
+*                    through unchanged.
+*
+*                    Usage: dfu_trace <serial device | capture file | ->
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include "dfu_trace_ids.h"
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+#define DFU_TRACE_NAME(event)   { #event, DFU_TRACE_FMT_##event },
+
+static const struct
+{
+    const char *name;
+    const char *format;
+} trace_events[] =
+{
+    DFU_TRACE_EVENTS(DFU_TRACE_NAME)
+};
+
+static const char *const trace_levels[] = { "???", "ERR", "WRN", "INF", "DBG" };
+
+/* Last character written, records start on a new line */
+static int last_char = '\n';
+
+/*******************************************************************************
+* Function Name: put_text
+*******************************************************************************/
+static void put_text(uint8_t c)
+{
+    putchar(c);
+    last_char = c;
+}
+
+/*******************************************************************************
+* Function Name: get_u32
+*******************************************************************************/
+static uint32_t get_u32(const uint8_t src[])
+{
+    return (uint32_t)src[0] | ((uint32_t)src[1] << 8U) | ((uint32_t)src[2] << 16U) | ((uint32_t)src[3] << 24U);
+}
+
+/*******************************************************************************
+* Function Name: print_record
+********************************************************************************
+* Summary:
+*  Prints one record, see dfu_trace_record_t in dfu_trace.c for the layout.
+*
+*******************************************************************************/
+static void print_record(const uint8_t record[])
+{
+    uint32_t timestamp = get_u32(&record[0]);
+    uint32_t id = (uint32_t)record[4] | ((uint32_t)record[5] << 8U);
+    uint32_t level = record[6];
+    uint32_t args[DFU_TRACE_MAX_ARGS];
+
+    for (uint32_t i = 0U; i < DFU_TRACE_MAX_ARGS; i++)
+    {
+        args[i] = get_u32(&record[8U + (4U * i)]);
+    }
+
+    if (last_char != '\n')
+    {
+        putchar('\n');
+    }
+    printf("[%6u.%06u] %s ", timestamp / 1000000U, timestamp % 1000000U,
+           trace_levels[(level < (sizeof(trace_levels) / sizeof(trace_levels[0]))) ? level : 0U]);
+    if (id < (uint32_t)DFU_TRACE_ID_COUNT)
+    {
+        printf(trace_events[id].format, args[0], args[1], args[2], args[3]);
+    }
+    else
+    {
+        printf("Unknown event %u: 0x%08X 0x%08X 0x%08X 0x%08X", id, args[0], args[1], args[2], args[3]);
+    }
+    printf("\n");
+    last_char = '\n';
+}
+
+/*******************************************************************************
+* Function Name: open_input
+********************************************************************************
+* Summary:
+*  Opens the input. Serial devices are set to raw mode at 115200 baud, the
+*  debug UART default.
+*
+*******************************************************************************/
+static int open_input(const char *path)
+{
+    struct termios tio;
+    int fd = (strcmp(path, "-") == 0) ? STDIN_FILENO : open(path, O_RDONLY | O_NOCTTY);
+
+    if ((fd >= 0) && isatty(fd) && (tcgetattr(fd, &tio) == 0))
+    {
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, B115200);
+        cfsetospeed(&tio, B115200);
+        tio.c_cc[VMIN] = 1;
+        tio.c_cc[VTIME] = 0;
+        (void)tcsetattr(fd, TCSANOW, &tio);
+    }
+
+    return fd;
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Scans the input for frames. A candidate frame whose checksum does not match
+*  is treated as text and scanning resumes at the next byte.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    uint8_t window[DFU_TRACE_FRAME_SIZE];
+    uint8_t input[256];
+    size_t fill = 0U;
+    ssize_t got;
+    int fd;
+
+    if (argc != 2)
+    {
+        fprintf(stderr, "usage: %s <serial device | capture file | ->\n", argv[0]);
+        return 2;
+    }
+
+    fd = open_input(argv[1]);
+    if (fd < 0)
+    {
+        fprintf(stderr, "dfu_trace: cannot open %s: %s\n", argv[1], strerror(errno));
+        return 1;
+    }
+
+    while ((got = read(fd, input, sizeof(input))) != 0)
+    {
+        if (got < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            fprintf(stderr, "dfu_trace: read failed: %s\n", strerror(errno));
+            break;
+        }
+
+        for (ssize_t i = 0; i < got; i++)
+        {
+            window[fill++] = input[i];
+
+            /* Shift out bytes that cannot start a frame */
+            while ((fill > 0U) &&
+                   ((window[0] != DFU_TRACE_SYNC0) || ((fill > 1U) && (window[1] != DFU_TRACE_SYNC1))))
+            {
+                put_text(window[0]);
+                memmove(&window[0], &window[1], --fill);
+            }
+
+            if (fill == DFU_TRACE_FRAME_SIZE)
+            {
+                uint8_t sum = 0U;
+
+                for (size_t j = 2U; j < (DFU_TRACE_FRAME_SIZE - 1U); j++)
+                {
+                    sum = (uint8_t)(sum + window[j]);
+                }
+
+                if (sum == window[DFU_TRACE_FRAME_SIZE - 1U])
+                {
+                    print_record(&window[2]);
+                    fill = 0U;
+                }
+                else
+                {
+                    /* Not a frame after all: emit the first byte as text and
+                     * rescan the rest */
+                    put_text(window[0]);
+                    memmove(&window[0], &window[1], --fill);
+                    while ((fill > 0U) &&
+                           ((window[0] != DFU_TRACE_SYNC0) || ((fill > 1U) && (window[1] != DFU_TRACE_SYNC1))))
+                    {
+                        put_text(window[0]);
+                        memmove(&window[0], &window[1], --fill);
+                    }
+                }
+            }
+        }
+        fflush(stdout);
+    }
+
+    fwrite(window, 1U, fill, stdout);
+    if (fd != STDIN_FILENO)
+    {
+        close(fd);
+    }
+
+    return 0;
+}
+
+/* [] END OF FILE */
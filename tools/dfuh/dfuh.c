@@ -0,0 +1,289 @@
+/*******************************************************************************
+* File Name        : dfuh.c
+*
+* Description      : Linux DFU host. Runs a .mtbdfu script, such as
+*                    Program.mtbdfu, with the image of the build over a serial
+*                    or USB CDC device, a USB HID device (hidraw), an I2C
+*                    adapter (i2c-dev) or a device model in a thread.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "dfu_host.h"
+#include "dfu_link.h"
+#include "dfu_session.h"
+#include "loopback.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define DEFAULT_BAUD            (115200U)
+#define PROGRESS_STEP           (64U)       /* Rows between progress updates */
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef enum
+{
+    LINK_NONE,
+    LINK_SERIAL,
+    LINK_HID,
+    LINK_I2C,
+    LINK_LOOPBACK
+} link_kind_t;
+
+typedef struct
+{
+    bool quiet;
+    uint32_t row_size;
+    size_t rows;
+    uint64_t bytes;
+} progress_t;
+
+/*******************************************************************************
+* Function Name: now_ns
+*******************************************************************************/
+static uint64_t now_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000U) + (uint64_t)now.tv_nsec;
+}
+
+/*******************************************************************************
+* Function Name: row_done
+*******************************************************************************/
+static void row_done(void *context, size_t row, size_t rows, uint32_t address)
+{
+    progress_t *progress = context;
+
+    progress->rows++;
+    progress->bytes += progress->row_size;
+    if (!progress->quiet && ((((row + 1U) % PROGRESS_STEP) == 0U) || ((row + 1U) == rows)))
+    {
+        fprintf(stderr, "\r%zu/%zu rows, 0x%08X", row + 1U, rows, (unsigned int)address);
+        if ((row + 1U) == rows)
+        {
+            fprintf(stderr, "\n");
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: split_suffix
+********************************************************************************
+* Summary:
+*  Splits "path@value" into the path and the value, if there is one.
+*
+*******************************************************************************/
+static const char *split_suffix(char *text, uint32_t *value)
+{
+    char *at = strrchr(text, '@');
+
+    if (at != NULL)
+    {
+        *at = '\0';
+        *value = (uint32_t)strtoul(&at[1], NULL, 0);
+    }
+
+    return text;
+}
+
+/*******************************************************************************
+* Function Name: usage
+*******************************************************************************/
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [options] script.mtbdfu\n"
+            "  -f file               image to program instead of the dataFile of the script\n"
+            "  -I id[,id...]         program only the entries with these imageId values (all)\n"
+            "  -s device[@baud]      serial or USB CDC device (%u)\n"
+            "  -H device             USB HID device, /dev/hidrawN\n"
+            "  -i device[@address]   I2C adapter, /dev/i2c-N (0x%02X)\n"
+            "  -l                    device model in a thread, for testing without a kit\n"
+            "  -w window             commands in flight, 1 waits for each response (1, max %u)\n"
+            "  -c bytes              payload per packet when sending rows (as the script, max %u)\n"
+            "  -t ms                 response timeout (as the script)\n"
+            "  -r file               record the session to a capture file for dfu_sim -R\n"
+            "  -q                    no progress\n",
+            name, DEFAULT_BAUD, DFU_LINK_I2C_ADDRESS, DFU_HOST_MAX_WINDOW, DFU_PACKET_MAX_DATA);
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Opens the link, runs the script and prints a summary.
+*
+* Return:
+*  0 if the update succeeded, 1 otherwise, 2 on usage errors
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    static dfu_script_t script;
+    link_kind_t kind = LINK_NONE;
+    char *device = NULL;
+    const char *data_file = NULL;
+    const char *record_path = NULL;
+    const char *image_ids = NULL;
+    uint32_t images = 0U;
+    uint32_t window = 1U;
+    uint32_t chunk_size = 0U;
+    uint32_t timeout_ms = 0U;
+    progress_t progress = { false, 0U, 0U, 0U };
+    loopback_stats_t loopback_stats;
+    dfu_session_recorder_t recorder;
+    dfu_session_t session;
+    dfu_host_t host;
+    uint64_t start_ns;
+    double seconds;
+    int status;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "f:I:s:H:i:lw:c:t:r:q")) != -1)
+    {
+        switch (opt)
+        {
+            case 'f': data_file = optarg; break;
+            case 'I': image_ids = optarg; break;
+            case 's': kind = LINK_SERIAL; device = optarg; break;
+            case 'H': kind = LINK_HID; device = optarg; break;
+            case 'i': kind = LINK_I2C; device = optarg; break;
+            case 'l': kind = LINK_LOOPBACK; break;
+            case 'w': window = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'c': chunk_size = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 't': timeout_ms = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'r': record_path = optarg; break;
+            case 'q': progress.quiet = true; break;
+            default: usage(argv[0]); return 2;
+        }
+    }
+    if ((optind != (argc - 1)) || (kind == LINK_NONE) || (window == 0U) || (window > DFU_HOST_MAX_WINDOW) ||
+        ((chunk_size != 0U) && ((chunk_size <= DFU_ROW_HEADER_SIZE) || (chunk_size > DFU_PACKET_MAX_DATA))))
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if ((dfu_script_load(&script, argv[optind]) != 0) ||
+        ((image_ids != NULL) && (dfu_script_select(&script, image_ids, &images) != 0)))
+    {
+        return 1;
+    }
+    for (size_t b = 0U; b < script.block_count; b++)
+    {
+        script.blocks[b].timeout_ms = (timeout_ms != 0U) ? timeout_ms : script.blocks[b].timeout_ms;
+        if (script.blocks[b].repeat_eof && (progress.row_size == 0U))
+        {
+            progress.row_size = script.blocks[b].row_length;
+        }
+    }
+
+    memset(&host, 0, sizeof(host));
+    switch (kind)
+    {
+        case LINK_SERIAL:
+        {
+            uint32_t baud = DEFAULT_BAUD;
+            const char *path = split_suffix(device, &baud);
+
+            status = dfu_link_open_serial(&host.link, path, baud);
+            break;
+        }
+        case LINK_HID:
+            status = dfu_link_open_hidraw(&host.link, device);
+            break;
+        case LINK_I2C:
+        {
+            uint32_t address = DFU_LINK_I2C_ADDRESS;
+            const char *path = split_suffix(device, &address);
+
+            status = dfu_link_open_i2c(&host.link, path, (uint8_t)address);
+            break;
+        }
+        default:
+            status = loopback_start(&host.link, script.crc);
+            break;
+    }
+    if (status != 0)
+    {
+        return 1;
+    }
+
+    host.window = window;
+    host.chunk_size = chunk_size;
+    host.images = images;
+    host.row_done = row_done;
+    host.row_context = &progress;
+
+    if (record_path != NULL)
+    {
+        dfu_session_init(&session, DFU_RECORD_SOURCE_HOST);
+        dfu_session_record_start(&recorder, &host.link, &session);
+    }
+
+    start_ns = now_ns();
+    status = dfu_host_program(&host, &script, data_file);
+    seconds = (double)(now_ns() - start_ns) / 1e9;
+
+    if (record_path != NULL)
+    {
+        dfu_session_record_stop(&recorder, &host.link);
+        if ((recorder.status != 0) || (dfu_session_save(&session, record_path) != 0))
+        {
+            fprintf(stderr, "dfuh: session not recorded\n");
+            status = (status == 0) ? DFU_HOST_ERROR_FILE : status;
+        }
+        dfu_session_free(&session);
+    }
+
+    if (kind == LINK_LOOPBACK)
+    {
+        loopback_stop(&host.link, &loopback_stats);
+        printf("loopback: %u packets, %u bad packets, %u rows programmed, %u rows verified, %u bad rows%s\n",
+               (unsigned int)loopback_stats.packets, (unsigned int)loopback_stats.bad_packets,
+               (unsigned int)loopback_stats.rows_programmed, (unsigned int)loopback_stats.rows_verified,
+               (unsigned int)loopback_stats.bad_rows, loopback_stats.exited ? "" : ", no Exit DFU");
+        if ((status == 0) && (!loopback_stats.exited || (loopback_stats.bad_packets != 0U) ||
+                              (loopback_stats.bad_rows != 0U)))
+        {
+            status = DFU_HOST_ERROR_RESPONSE;
+        }
+    }
+    else
+    {
+        dfu_link_close(&host.link);
+    }
+
+    printf("%s: %zu rows, %llu bytes, %.3f s, %.1f KiB/s\n", (status == 0) ? "done" : dfu_status_name(status), progress.rows,
+           (unsigned long long)progress.bytes, seconds, (seconds > 0.0) ? ((double)progress.bytes / 1024.0 / seconds) : 0.0);
+
+    return (status == 0) ? 0 : 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,297 @@
+/*******************************************************************************
+* File Name        : loopback.c
+*
+* Description      : DFU device model that runs in a thread of the host. It checks
+*                    the framing and checksum of every command and the CRC-32C
+*                    of every row, and answers like the DFU middleware, so the
+*                    host and its pipelining can be tested without a kit.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "dfu_link.h"
+#include "loopback.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+
+/* Largest row the model collects with Send Data */
+#define MAX_ROW_SIZE            (0x1000U)
+
+/* Enter DFU response: silicon ID (4), silicon revision (1), DFU SDK version (3) */
+#define ENTER_RESPONSE_SIZE     (8U)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    int fd;                         /* Device end of the socket pair */
+    bool crc;
+    pthread_t thread;
+    uint8_t row[MAX_ROW_SIZE];
+    uint32_t row_length;            /* Bytes collected by Send Data */
+    loopback_stats_t stats;
+} loopback_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static loopback_t loopback;
+
+/*******************************************************************************
+* Function Name: read_all
+*******************************************************************************/
+static bool read_all(int fd, uint8_t buffer[], size_t length)
+{
+    size_t done = 0U;
+
+    while (done < length)
+    {
+        ssize_t got = read(fd, &buffer[done], length - done);
+
+        if (got <= 0)
+        {
+            return false;
+        }
+        done += (size_t)got;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: respond
+*******************************************************************************/
+static void respond(loopback_t *lb, uint8_t status, const uint8_t data[], size_t length)
+{
+    uint8_t packet[DFU_PACKET_MIN_SIZE + ENTER_RESPONSE_SIZE];
+    size_t size = dfu_packet_build(lb->crc, packet, status, data, length);
+
+    (void)write(lb->fd, packet, size);
+}
+
+/*******************************************************************************
+* Function Name: take_row
+********************************************************************************
+* Summary:
+*  Handles Program Data and Verify Data: appends the data after the row
+*  header to the bytes collected by Send Data and checks the CRC-32C of the
+*  row.
+*
+*******************************************************************************/
+static uint8_t take_row(loopback_t *lb, const uint8_t data[], size_t length)
+{
+    uint32_t crc;
+
+    if ((length < DFU_ROW_HEADER_SIZE) || ((lb->row_length + length - DFU_ROW_HEADER_SIZE) > MAX_ROW_SIZE))
+    {
+        lb->row_length = 0U;
+        return DFU_STATUS_LENGTH;
+    }
+    memcpy(&lb->row[lb->row_length], &data[DFU_ROW_HEADER_SIZE], length - DFU_ROW_HEADER_SIZE);
+    lb->row_length += (uint32_t)(length - DFU_ROW_HEADER_SIZE);
+
+    crc = (uint32_t)data[4] | ((uint32_t)data[5] << 8U) | ((uint32_t)data[6] << 16U) | ((uint32_t)data[7] << 24U);
+    if (crc != dfu_crc32c(lb->row, lb->row_length))
+    {
+        lb->stats.bad_rows++;
+        lb->row_length = 0U;
+        return DFU_STATUS_CHECKSUM;
+    }
+    lb->row_length = 0U;
+
+    return DFU_STATUS_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: handle_command
+********************************************************************************
+* Summary:
+*  Answers one command. Returns false after Exit DFU.
+*
+*******************************************************************************/
+static bool handle_command(loopback_t *lb, uint8_t command, const uint8_t data[], size_t length)
+{
+    static const uint8_t enter_response[ENTER_RESPONSE_SIZE] = { 0U };
+    uint8_t verify_app = 1U;
+    uint8_t status;
+
+    switch (command)
+    {
+        case DFU_CMD_ENTER:
+            lb->row_length = 0U;
+            respond(lb, DFU_STATUS_SUCCESS, enter_response, sizeof(enter_response));
+            break;
+
+        case DFU_CMD_SEND_DATA:
+            if ((lb->row_length + length) > MAX_ROW_SIZE)
+            {
+                lb->row_length = 0U;
+                respond(lb, DFU_STATUS_LENGTH, NULL, 0U);
+            }
+            else
+            {
+                memcpy(&lb->row[lb->row_length], data, length);
+                lb->row_length += (uint32_t)length;
+                respond(lb, DFU_STATUS_SUCCESS, NULL, 0U);
+            }
+            break;
+
+        case DFU_CMD_PROGRAM_DATA:
+        case DFU_CMD_VERIFY_DATA:
+            status = take_row(lb, data, length);
+            if (status == DFU_STATUS_SUCCESS)
+            {
+                if (command == DFU_CMD_PROGRAM_DATA)
+                {
+                    lb->stats.rows_programmed++;
+                }
+                else
+                {
+                    lb->stats.rows_verified++;
+                }
+            }
+            respond(lb, status, NULL, 0U);
+            break;
+
+        case DFU_CMD_ERASE_DATA:
+            respond(lb, (length == 4U) ? DFU_STATUS_SUCCESS : DFU_STATUS_LENGTH, NULL, 0U);
+            break;
+
+        case DFU_CMD_VERIFY_APP:
+            respond(lb, DFU_STATUS_SUCCESS, &verify_app, 1U);
+            break;
+
+        case DFU_CMD_SYNC:
+            /* Drops the collected data and has no response */
+            lb->row_length = 0U;
+            break;
+
+        case DFU_CMD_EXIT:
+            lb->stats.exited = true;
+            return false;
+
+        default:
+            respond(lb, DFU_STATUS_CMD, NULL, 0U);
+            break;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: device_thread
+*******************************************************************************/
+static void *device_thread(void *arg)
+{
+    loopback_t *lb = arg;
+    uint8_t packet[DFU_PACKET_MAX_SIZE];
+    bool running = true;
+
+    while (running && read_all(lb->fd, packet, DFU_PACKET_HEADER_SIZE))
+    {
+        size_t length = (size_t)packet[2] | ((size_t)packet[3] << 8U);
+        uint16_t checksum;
+
+        if ((packet[0] != DFU_PACKET_SOP) || (length > DFU_PACKET_MAX_DATA))
+        {
+            /* Framing is lost, a kit would wait for the command timeout */
+            lb->stats.bad_packets++;
+            break;
+        }
+        if (!read_all(lb->fd, &packet[DFU_PACKET_HEADER_SIZE], length + 3U))
+        {
+            break;
+        }
+        lb->stats.packets++;
+
+        checksum = (uint16_t)(packet[4U + length] | (packet[5U + length] << 8U));
+        if ((packet[6U + length] != DFU_PACKET_EOP) ||
+            (checksum != dfu_packet_checksum_host(lb->crc, packet, DFU_PACKET_HEADER_SIZE + length)))
+        {
+            lb->stats.bad_packets++;
+            respond(lb, (packet[6U + length] != DFU_PACKET_EOP) ? DFU_STATUS_DATA : DFU_STATUS_CHECKSUM, NULL, 0U);
+            continue;
+        }
+
+        running = handle_command(lb, packet[1], &packet[DFU_PACKET_HEADER_SIZE], length);
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+* Function Name: loopback_start
+********************************************************************************
+* Summary:
+*  Starts the device model and opens the host end of the link to it. crc
+*  selects the packet checksum, as "Packet Checksum Type" of the script.
+*
+* Return:
+*  0 on success, -1 on error (reported on stderr)
+*
+*******************************************************************************/
+int loopback_start(dfu_link_t *link, bool crc)
+{
+    int fds[2];
+
+    memset(&loopback, 0, sizeof(loopback));
+    loopback.crc = crc;
+
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+    {
+        perror("socketpair");
+        return -1;
+    }
+    loopback.fd = fds[1];
+    if ((dfu_link_open_fd(link, fds[0]) != 0) || (pthread_create(&loopback.thread, NULL, device_thread, &loopback) != 0))
+    {
+        fprintf(stderr, "cannot start the loopback device\n");
+        close(fds[0]);
+        close(fds[1]);
+        return -1;
+    }
+
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: loopback_stop
+********************************************************************************
+* Summary:
+*  Closes the host end of the link, waits for the device model to finish and
+*  returns what it saw.
+*
+*******************************************************************************/
+void loopback_stop(dfu_link_t *link, loopback_stats_t *stats)
+{
+    dfu_link_close(link);
+    (void)pthread_join(loopback.thread, NULL);
+    close(loopback.fd);
+    *stats = loopback.stats;
+}
+
+/* [] END OF FILE */
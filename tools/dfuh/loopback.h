@@ -0,0 +1,54 @@
+/*******************************************************************************
+* File Name        : loopback.h
+*
+* Description      : DFU device model that runs in a thread of the host, for testing
+*                    the host without a kit.
+*
+* Related Document : See README.md
+*
+********************************************************************************
+ * (c) 2023-2026, Infineon Technologies AG, or an affiliate of Infineon
+ * Technologies AG.  SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*******************************************************************************/
+
+#ifndef LOOPBACK_H
+#define LOOPBACK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "dfu_host.h"
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t packets;               /* Commands received */
+    uint32_t bad_packets;           /* Framing or checksum errors */
+    uint32_t rows_programmed;
+    uint32_t rows_verified;
+    uint32_t bad_rows;              /* Row CRC-32C mismatches */
+    bool exited;                    /* Exit DFU received */
+} loopback_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+int loopback_start(dfu_link_t *link, bool crc);
+void loopback_stop(dfu_link_t *link, loopback_stats_t *stats);
+
+#endif /* LOOPBACK_H */
+
+/* [] END OF FILE */